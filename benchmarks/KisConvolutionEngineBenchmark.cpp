@@ -0,0 +1,154 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisConvolutionEngineBenchmark.h"
+
+#include <QtConcurrent>
+
+#include <Eigen/Core>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_convolution_kernel.h>
+#include <kis_convolution_painter.h>
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+
+#include "kis_benchmark_values.h"
+
+Q_DECLARE_METATYPE(KisConvolutionPainter::EnginePreference)
+
+namespace {
+
+const QRect imageRect(0, 0, NO_TILE_EXACT_BOUNDARY_WIDTH, NO_TILE_EXACT_BOUNDARY_HEIGHT);
+
+KisPaintDeviceSP createNoiseDevice()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    srand(31524744);
+
+    KoColor color(cs);
+
+    KisSequentialIterator it(dev, imageRect);
+    while (it.nextPixel()) {
+        color.fromQColor(QColor(rand() % 255, rand() % 255, rand() % 255, rand() % 255));
+        memcpy(it.rawData(), color.data(), cs->pixelSize());
+    }
+
+    return dev;
+}
+
+KisConvolutionKernelSP createCustomKernel(int size)
+{
+    srand(1234);
+
+    Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> matrix(size, size);
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            matrix(y, x) = qreal(rand() % 100);
+        }
+    }
+
+    return KisConvolutionKernel::fromMatrix(matrix, 0, matrix.sum());
+}
+
+void convolve(KisPaintDeviceSP dev, KisConvolutionKernelSP kernel,
+              KisConvolutionPainter::EnginePreference engine)
+{
+    KisPaintDeviceSP dst = new KisPaintDevice(dev->colorSpace());
+
+    KisConvolutionPainter painter(dst, engine);
+    painter.applyMatrix(kernel, dev, imageRect.topLeft(), imageRect.topLeft(),
+                        imageRect.size(), BORDER_IGNORE);
+}
+
+QString engineName(KisConvolutionPainter::EnginePreference engine)
+{
+    return engine == KisConvolutionPainter::SPATIAL ? "spatial" :
+        engine == KisConvolutionPainter::FFTW ? "fftw-tiled" :
+        "fftw-single";
+}
+
+}
+
+void KisConvolutionEngineBenchmark::benchmarkEngine_data()
+{
+    QTest::addColumn<KisConvolutionPainter::EnginePreference>("engine");
+    QTest::addColumn<int>("kernelSize");
+
+    const QVector<KisConvolutionPainter::EnginePreference> engines = {
+        KisConvolutionPainter::SPATIAL,
+        KisConvolutionPainter::FFTW,
+        KisConvolutionPainter::FFTW_SINGLE_PASS
+    };
+
+    Q_FOREACH (KisConvolutionPainter::EnginePreference engine, engines) {
+        if (engine != KisConvolutionPainter::SPATIAL &&
+            !KisConvolutionPainter::supportsFFTW()) continue;
+
+        for (int size : {3, 5, 7, 9, 15, 31, 63, 127}) {
+            // spatial convolution with big kernels takes ages
+            if (engine == KisConvolutionPainter::SPATIAL && size > 31) continue;
+
+            QTest::addRow("%s-%d", engineName(engine).toLatin1().data(), size) << engine << size;
+        }
+    }
+}
+
+void KisConvolutionEngineBenchmark::benchmarkEngine()
+{
+    QFETCH(KisConvolutionPainter::EnginePreference, engine);
+    QFETCH(int, kernelSize);
+
+    KisPaintDeviceSP dev = createNoiseDevice();
+    KisConvolutionKernelSP kernel = createCustomKernel(kernelSize);
+
+    QBENCHMARK {
+        convolve(dev, kernel, engine);
+    }
+}
+
+void KisConvolutionEngineBenchmark::benchmarkConcurrentConvolutions_data()
+{
+    QTest::addColumn<KisConvolutionPainter::EnginePreference>("engine");
+    QTest::addColumn<int>("numDevices");
+
+    if (!KisConvolutionPainter::supportsFFTW()) {
+        QSKIP("FFTW is not available");
+    }
+
+    for (int numDevices : {1, 4}) {
+        QTest::addRow("fftw-tiled-%d", numDevices) << KisConvolutionPainter::FFTW << numDevices;
+        QTest::addRow("fftw-single-%d", numDevices) << KisConvolutionPainter::FFTW_SINGLE_PASS << numDevices;
+    }
+}
+
+void KisConvolutionEngineBenchmark::benchmarkConcurrentConvolutions()
+{
+    QFETCH(KisConvolutionPainter::EnginePreference, engine);
+    QFETCH(int, numDevices);
+
+    QVector<KisPaintDeviceSP> devices;
+    for (int i = 0; i < numDevices; i++) {
+        devices << createNoiseDevice();
+    }
+
+    KisConvolutionKernelSP kernel = createCustomKernel(63);
+
+    QBENCHMARK {
+        QtConcurrent::blockingMap(devices,
+            [kernel, engine] (KisPaintDeviceSP dev) {
+                convolve(dev, kernel, engine);
+            });
+    }
+}
+
+SIMPLE_TEST_MAIN(KisConvolutionEngineBenchmark)
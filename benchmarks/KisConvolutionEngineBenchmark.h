@@ -0,0 +1,32 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_CONVOLUTION_ENGINE_BENCHMARK_H
+#define KIS_CONVOLUTION_ENGINE_BENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Compares the convolution engines of KisConvolutionPainter for
+ * different kernel sizes. The results are used for tuning the
+ * automatic engine selection.
+ */
+class KisConvolutionEngineBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkEngine_data();
+    void benchmarkEngine();
+
+    /**
+     * Convolves several devices at once, the same way as
+     * the updater threads process several filter masks
+     */
+    void benchmarkConcurrentConvolutions_data();
+    void benchmarkConcurrentConvolutions();
+};
+
+#endif // KIS_CONVOLUTION_ENGINE_BENCHMARK_H
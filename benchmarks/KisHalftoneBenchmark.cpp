@@ -0,0 +1,76 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHalftoneBenchmark.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <filter/kis_filter.h>
+#include <filter/kis_filter_configuration.h>
+#include <filter/kis_filter_registry.h>
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+#include <KisGlobalResourcesInterface.h>
+
+namespace {
+
+const QRect imageRect(0, 0, 10000, 10000);
+
+/**
+ * A diagonal gradient, so that the screen produces
+ * dots of all the possible sizes
+ */
+KisPaintDeviceSP createGradientDevice(const KoColorSpace *cs)
+{
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    KoColor color(cs);
+
+    KisSequentialIterator it(dev, imageRect);
+    while (it.nextPixel()) {
+        const int value = (it.x() + it.y()) * 255 / (imageRect.width() + imageRect.height());
+        color.fromQColor(QColor(value, 255 - value, value / 2));
+        memcpy(it.rawData(), color.data(), cs->pixelSize());
+    }
+
+    return dev;
+}
+
+void runHalftone(KisPaintDeviceSP dev, const QString &mode)
+{
+    KisFilterSP filter = KisFilterRegistry::instance()->value("halftone");
+    QVERIFY(filter);
+
+    KisFilterConfigurationSP config = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    config->setProperty("mode", mode);
+    config->setProperty("color_model_id", dev->colorSpace()->colorModelId().id());
+    config->createLocalResourcesSnapshot();
+
+    QBENCHMARK_ONCE {
+        filter->process(dev, imageRect, config);
+    }
+}
+
+}
+
+void KisHalftoneBenchmark::initTestCase()
+{
+    m_grayDevice = createGradientDevice(KoColorSpaceRegistry::instance()->graya8());
+    m_rgbDevice = createGradientDevice(KoColorSpaceRegistry::instance()->rgb8());
+}
+
+void KisHalftoneBenchmark::benchmarkIntensity()
+{
+    runHalftone(m_grayDevice, "intensity");
+}
+
+void KisHalftoneBenchmark::benchmarkIndependentChannels()
+{
+    runHalftone(m_rgbDevice, "independent_channels");
+}
+
+SIMPLE_TEST_MAIN(KisHalftoneBenchmark)
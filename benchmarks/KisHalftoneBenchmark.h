@@ -0,0 +1,32 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_HALFTONE_BENCHMARK_H
+#define KIS_HALFTONE_BENCHMARK_H
+
+#include <simpletest.h>
+#include <kis_types.h>
+
+/**
+ * Measures the halftone filter with the default screentone generator
+ * on a 10000x10000 grayscale image, the typical size of a print job
+ * at 600 dpi
+ */
+class KisHalftoneBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkIntensity();
+    void benchmarkIndependentChannels();
+
+private:
+    KisPaintDeviceSP m_grayDevice;
+    KisPaintDeviceSP m_rgbDevice;
+};
+
+#endif // KIS_HALFTONE_BENCHMARK_H
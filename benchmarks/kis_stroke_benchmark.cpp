@@ -15,6 +15,7 @@ inline double drand48()
 #endif
 
 #include <QPainterPath>
+#include <QElapsedTimer>
 #include <simpletest.h>
 
 #include "kis_stroke_benchmark.h"
@@ -39,6 +40,7 @@ inline double drand48()
 #include <brushengine/kis_paintop_registry.h>
 
 #include <KisGlobalResourcesInterface.h>
+#include <kis_global.h>
 
 //#define SAVE_OUTPUT
 
@@ -152,6 +154,12 @@ void KisStrokeBenchmark::deformBrushRL()
     benchmarkRandomLines(presetFileName);
 }
 
+void KisStrokeBenchmark::deformBrush500px()
+{
+    QString presetFileName = "deform-default.kpp";
+    benchmarkStroke(presetFileName, 500);
+}
+
 void KisStrokeBenchmark::pixelbrush300px()
 {
     QString presetFileName = "autobrush_300px.kpp";
@@ -298,6 +306,52 @@ void KisStrokeBenchmark::hairy30InkDepletionRL()
     benchmarkRandomLines(presetFileName);
 }
 
+void KisStrokeBenchmark::hairyBristleCount_data()
+{
+    QTest::addColumn<qreal>("size");
+
+    QTest::newRow("30px") << 30.0;
+    QTest::newRow("60px") << 60.0;
+    QTest::newRow("120px") << 120.0;
+    QTest::newRow("240px") << 240.0;
+}
+
+void KisStrokeBenchmark::hairyBristleCount()
+{
+    QFETCH(qreal, size);
+
+    QString presetFileName = "hairybrush_thesis30px1.kpp";
+    KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
+    bool loadedOk = preset->load(KisGlobalResourcesInterface::instance());
+    KIS_ASSERT_RECOVER_RETURN(loadedOk);
+
+    preset->settings()->setPaintOpSize(size);
+    m_painter->setPaintOpPreset(preset, m_layer, m_image);
+
+    const int numDabs = 200;
+    const QPointF step(5.0, 2.0);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    KisDistanceInformation currentDistance;
+    KisPaintInformation pi1(QPointF(100.0, 100.0), 1.0);
+    for (int i = 0; i < numDabs; i++) {
+        KisPaintInformation pi2(pi1.pos() + step, 1.0);
+        m_painter->paintLine(pi1, pi2, &currentDistance);
+        pi1 = pi2;
+    }
+
+    const qint64 elapsed = qMax(qint64(1), timer.nsecsElapsed());
+
+    // the bristles are generated from the pixels of a round dab
+    const int bristles = qRound(M_PI * pow2(0.5 * size));
+
+    qDebug() << "size:" << size
+             << "bristles:" << bristles
+             << "dabs/sec:" << qreal(numDabs) * 1e9 / elapsed;
+}
+
 
 void KisStrokeBenchmark::softbrushOpacity()
 {
@@ -347,6 +401,13 @@ void KisStrokeBenchmark::colorsmudgeRL()
     benchmarkStroke(presetFileName);
 }
 
+void KisStrokeBenchmark::colorsmudge300px()
+{
+    // big dabs are blended in stripes in multiple threads
+    QString presetFileName = "colorsmudge.kpp";
+    benchmarkStroke(presetFileName, 300);
+}
+
 
 void KisStrokeBenchmark::roundMarker()
 {
@@ -559,7 +620,7 @@ void KisStrokeBenchmark::benchmarkRectangle(QString presetFileName)
 #endif
 }
 
-void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
+void KisStrokeBenchmark::benchmarkStroke(QString presetFileName, qreal paintOpSize)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
     bool loadedOk = preset->load(KisGlobalResourcesInterface::instance());
@@ -570,6 +631,10 @@ void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
         dbgKrita << "preset : " << presetFileName;
     }
 
+    if (paintOpSize > 0) {
+        preset->settings()->setPaintOpSize(paintOpSize);
+    }
+
     m_painter->setPaintOpPreset(preset, m_layer, m_image);
 
     QBENCHMARK{
@@ -52,7 +52,7 @@ private:
 
     private:
         inline void benchmarkRandomLines(QString presetFileName);
-        inline void benchmarkStroke(QString presetFileName);
+        inline void benchmarkStroke(QString presetFileName, qreal paintOpSize = -1.0);
         inline void benchmarkLine(QString presetFileName);
         inline void benchmarkCircle(QString presetFileName);
         inline void benchmarkRectangle(QString presetFileName);
@@ -90,6 +90,9 @@ private Q_SLOTS:
     void hairy30InkDepletion();
     void hairy30InkDepletionRL();
 
+    void hairyBristleCount_data();
+    void hairyBristleCount();
+
     // Spray brush benchmark1
     void spray30px21particles();
     void spray30px21particlesRL();
@@ -108,12 +111,14 @@ private Q_SLOTS:
 
     void deformBrush();
     void deformBrushRL();
+    void deformBrush500px();
 
     void experimental();
     void experimentalCircle();
 
     void colorsmudge();
     void colorsmudgeRL();
+    void colorsmudge300px();
 
     void roundMarker();
     void roundMarkerRandomLines();
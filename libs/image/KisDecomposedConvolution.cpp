@@ -0,0 +1,277 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDecomposedConvolution.h"
+
+#include <QAtomicInt>
+#include <QBitArray>
+#include <QMutexLocker>
+#include <QRect>
+#include <QScopedPointer>
+
+#include <KoColorSpace.h>
+#include <KoUpdater.h>
+
+#include "kis_convolution_worker.h"
+#include "kis_default_bounds.h"
+#include "kis_paint_device.h"
+#include "KisDecomposedConvolutionOps.h"
+#include "KisPremultipliedChannelsInfo_p.h"
+#include "krita_utils.h"
+
+namespace {
+
+/**
+ * The runs shorter than that are cheaper to add as separate taps
+ */
+const int minimalRunLength = 4;
+
+template <class _IteratorFactory_>
+void readRows(KisPaintDeviceSP device, const QRect &srcRect, const QRect &dataRect,
+              const KisPremultipliedChannelsInfo &info, float *buffer)
+{
+    const int numChannels = info.numChannels();
+
+    typename _IteratorFactory_::HLineConstIterator it =
+        _IteratorFactory_::createHLineConstIterator(device,
+                                                    srcRect.x(), srcRect.y(), srcRect.width(),
+                                                    dataRect);
+
+    for (int y = 0; y < srcRect.height(); y++) {
+        for (int x = 0; x < srcRect.width(); x++) {
+            info.readPixel(it->oldRawData(), buffer);
+            buffer += numChannels;
+            it->nextPixel();
+        }
+
+        it->nextRow();
+    }
+}
+
+}
+
+KisDecomposedKernel::KisDecomposedKernel(int width, int height)
+    : m_width(width),
+      m_height(height)
+{
+}
+
+KisDecomposedKernelSP KisDecomposedKernel::fromMatrix(const Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> &matrix)
+{
+    KisDecomposedKernelSP kernel = new KisDecomposedKernel(matrix.cols(), matrix.rows());
+
+    const qreal sum = matrix.sum();
+    const qreal factor = sum != 0.0 ? 1.0 / sum : 1.0;
+
+    for (int row = 0; row < matrix.rows(); row++) {
+        for (int col = 0; col < matrix.cols();) {
+            const qreal value = matrix(row, col);
+
+            int end = col + 1;
+            while (end < matrix.cols() && matrix(row, end) == value) {
+                end++;
+            }
+
+            if (value != 0.0) {
+                Run run;
+                run.row = row;
+                run.weight = value * factor;
+
+                if (end - col >= minimalRunLength) {
+                    run.column = col;
+                    run.length = end - col;
+                    kernel->m_runs << run;
+                } else {
+                    run.length = 1;
+
+                    for (int i = col; i < end; i++) {
+                        run.column = i;
+                        kernel->m_taps << run;
+                    }
+                }
+            }
+
+            col = end;
+        }
+    }
+
+    return kernel;
+}
+
+int KisDecomposedKernel::width() const
+{
+    return m_width;
+}
+
+int KisDecomposedKernel::height() const
+{
+    return m_height;
+}
+
+bool KisDecomposedKernel::isEmpty() const
+{
+    return m_runs.isEmpty() && m_taps.isEmpty();
+}
+
+const QVector<KisDecomposedKernel::Run>& KisDecomposedKernel::runs() const
+{
+    return m_runs;
+}
+
+const QVector<KisDecomposedKernel::Run>& KisDecomposedKernel::taps() const
+{
+    return m_taps;
+}
+
+KisDecomposedKernelCache::KisDecomposedKernelCache(int maxSize)
+    : m_maxSize(maxSize)
+{
+}
+
+KisDecomposedKernelSP KisDecomposedKernelCache::fetch(const QString &key, KernelFactory factory)
+{
+    QMutexLocker l(&m_mutex);
+
+    for (int i = 0; i < m_kernels.size(); i++) {
+        if (m_kernels[i].first == key) {
+            // keep the recently used kernels in the front of the list
+            m_kernels.move(i, 0);
+            return m_kernels.first().second;
+        }
+    }
+
+    KisDecomposedKernelSP kernel = factory();
+
+    m_kernels.prepend(qMakePair(key, kernel));
+    while (m_kernels.size() > m_maxSize) {
+        m_kernels.removeLast();
+    }
+
+    return kernel;
+}
+
+void KisDecomposedConvolution::apply(KisPaintDeviceSP device,
+                                     const QRect &rect,
+                                     KisDecomposedKernelSP kernel,
+                                     const QBitArray &channelFlags,
+                                     KoUpdater *progressUpdater,
+                                     KisConvolutionBorderOp borderOp)
+{
+    if (rect.isEmpty()) return;
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(kernel);
+    if (kernel->isEmpty()) return;
+
+    /**
+     * The same border handling as KisConvolutionPainter::applyMatrix() does
+     */
+    if (device->defaultBounds()->wrapAroundMode()) {
+        borderOp = BORDER_IGNORE;
+    }
+
+    QRect dataRect;
+
+    if (borderOp == BORDER_REPEAT) {
+        const QRect boundsRect = device->defaultBounds()->bounds();
+        dataRect = rect | boundsRect;
+
+        KIS_SAFE_ASSERT_RECOVER(boundsRect != KisDefaultBounds().bounds()) {
+            dataRect = rect | device->exactBounds();
+        }
+    }
+
+    const KisPremultipliedChannelsInfo info(device->colorSpace(), channelFlags);
+    const int numChannels = info.numChannels();
+    if (!numChannels) return;
+
+    // the same placement of the center as in KisConvolutionWorkerSpatial
+    const int halfWidth = (kernel->width() - 1) / 2;
+    const int halfHeight = (kernel->height() - 1) / 2;
+
+    const QVector<KisDecomposedKernel::Run> &runs = kernel->runs();
+    const QVector<KisDecomposedKernel::Run> &taps = kernel->taps();
+
+    QScopedPointer<KisDecomposedConvolutionOpsBase> ops(KisDecomposedConvolutionOpsFactory::create());
+
+    KisPaintDeviceSP source = new KisPaintDevice(*device);
+
+    const QVector<QRect> blocks = KritaUtils::splitRectIntoPatches(rect, QSize(256, 64));
+    QAtomicInt numProcessedBlocks;
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(0);
+    }
+
+    KritaUtils::parallelMap(blocks,
+        [&] (const QRect &block) {
+            if (progressUpdater && progressUpdater->interrupted()) return;
+
+            const QRect srcRect =
+                block.adjusted(-halfWidth, -halfHeight,
+                               kernel->width() - 1 - halfWidth,
+                               kernel->height() - 1 - halfHeight);
+
+            const int srcStride = srcRect.width() * numChannels;
+            QVector<float> srcBuffer(srcStride * srcRect.height());
+
+            if (borderOp == BORDER_REPEAT) {
+                readRows<RepeatIteratorFactory>(source, srcRect, dataRect, info, srcBuffer.data());
+            } else {
+                readRows<StandardIteratorFactory>(source, srcRect, dataRect, info, srcBuffer.data());
+            }
+
+            const int sumsStride = srcStride + numChannels;
+            QVector<float> sums;
+
+            if (!runs.isEmpty()) {
+                sums.resize(sumsStride * srcRect.height());
+
+                for (int y = 0; y < srcRect.height(); y++) {
+                    ops->runningSums(srcBuffer.constData() + y * srcStride,
+                                     sums.data() + y * sumsStride,
+                                     srcRect.width(), numChannels);
+                }
+            }
+
+            const int dstStride = block.width() * numChannels;
+            QVector<float> dstBuffer(dstStride * block.height(), 0.0f);
+
+            for (int y = 0; y < block.height(); y++) {
+                float *dst = dstBuffer.data() + y * dstStride;
+
+                Q_FOREACH (const KisDecomposedKernel::Run &tap, taps) {
+                    const float *src = srcBuffer.constData() +
+                        (y + tap.row) * srcStride + tap.column * numChannels;
+
+                    ops->addScaled(dst, src, tap.weight, dstStride);
+                }
+
+                Q_FOREACH (const KisDecomposedKernel::Run &run, runs) {
+                    const float *begin = sums.constData() +
+                        (y + run.row) * sumsStride + run.column * numChannels;
+                    const float *end = begin + run.length * numChannels;
+
+                    ops->addScaledDifference(dst, end, begin, run.weight, dstStride);
+                }
+            }
+
+            KisHLineIteratorSP it = device->createHLineIteratorNG(block.x(), block.y(), block.width());
+            const float *src = dstBuffer.constData();
+
+            for (int y = 0; y < block.height(); y++) {
+                do {
+                    info.writePixel(src, it->rawData());
+                    src += numChannels;
+                } while (it->nextPixel());
+
+                it->nextRow();
+            }
+
+            if (progressUpdater) {
+                progressUpdater->setProgress(100 * (numProcessedBlocks.fetchAndAddOrdered(1) + 1) / blocks.size());
+            }
+        });
+}
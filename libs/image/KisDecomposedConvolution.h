@@ -0,0 +1,139 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_DECOMPOSED_CONVOLUTION_H
+#define KIS_DECOMPOSED_CONVOLUTION_H
+
+#include <functional>
+
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include <Eigen/Core>
+
+#include "kritaimage_export.h"
+#include "kis_shared.h"
+#include "kis_shared_ptr.h"
+#include "kis_types.h"
+#include "kis_convolution_painter.h"
+
+class QRect;
+class QBitArray;
+class KoUpdater;
+
+class KisDecomposedKernel;
+typedef KisSharedPtr<KisDecomposedKernel> KisDecomposedKernelSP;
+
+/**
+ * @brief A convolution kernel decomposed into runs of equal weights
+ *
+ * The kernels of the lens and motion blur filters are rasterized shapes:
+ * the rows of a polygonal aperture consist of a long run of equal weights
+ * with a couple of antialiased pixels on the borders, a motion line has
+ * only a few non-zero pixels in every row. The decomposition stores the
+ * long runs of every row separately, so that KisDecomposedConvolution can
+ * add them with two reads of the running sums of the source row,
+ * independently of the length of the run. All the other non-zero weights
+ * are stored as single taps.
+ *
+ * The weights are normalized by the sum of the kernel, the same way
+ * as KisConvolutionKernel::fromMatrix(matrix, 0, matrix.sum()) does.
+ */
+class KRITAIMAGE_EXPORT KisDecomposedKernel : public KisShared
+{
+public:
+    /**
+     * \p length pixels of row \p row of the kernel starting from column
+     * \p column have weight \p weight
+     */
+    struct Run {
+        int row = 0;
+        int column = 0;
+        int length = 0;
+        float weight = 0.0f;
+    };
+
+public:
+    static KisDecomposedKernelSP fromMatrix(const Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> &matrix);
+
+    int width() const;
+    int height() const;
+    bool isEmpty() const;
+
+    /// the runs long enough to be added via running sums
+    const QVector<Run>& runs() const;
+
+    /// the rest of non-zero weights, every tap is a run of length 1
+    const QVector<Run>& taps() const;
+
+private:
+    KisDecomposedKernel(int width, int height);
+
+private:
+    int m_width;
+    int m_height;
+    QVector<Run> m_runs;
+    QVector<Run> m_taps;
+};
+
+/**
+ * A small cache of the prepared kernels. The filters keep the kernels
+ * for the last few configurations, so that they are not rasterized and
+ * decomposed again for every processed rect.
+ *
+ * The class is thread-safe.
+ */
+class KRITAIMAGE_EXPORT KisDecomposedKernelCache
+{
+public:
+    using KernelFactory = std::function<KisDecomposedKernelSP()>;
+
+    KisDecomposedKernelCache(int maxSize = 8);
+
+    /**
+     * Returns the kernel stored under \p key or creates it with
+     * \p factory if it is not in the cache yet
+     */
+    KisDecomposedKernelSP fetch(const QString &key, KernelFactory factory);
+
+private:
+    QMutex m_mutex;
+    QList<QPair<QString, KisDecomposedKernelSP>> m_kernels;
+    int m_maxSize;
+};
+
+/**
+ * @brief Convolution with the kernels made of long runs of equal weights
+ *
+ * The engine produces the same result as KisConvolutionPainter does for
+ * the same kernel, but its cost depends on the number of runs and taps of
+ * the kernel rather than on its area. The runs are added using the running
+ * sums of the source rows. The inner loops are vectorized (see
+ * KisDecomposedConvolutionOps).
+ *
+ * The rect is split into tile-aligned blocks which are processed in
+ * parallel. The source pixels are read from a copy-on-write snapshot of
+ * the device, so the result is written in-place.
+ */
+class KRITAIMAGE_EXPORT KisDecomposedConvolution
+{
+public:
+    /**
+     * Convolves \p rect of \p device with \p kernel in-place. The center
+     * of the kernel is placed the same way as in KisConvolutionPainter.
+     */
+    static void apply(KisPaintDeviceSP device,
+                      const QRect &rect,
+                      KisDecomposedKernelSP kernel,
+                      const QBitArray &channelFlags,
+                      KoUpdater *progressUpdater,
+                      KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+};
+
+#endif // KIS_DECOMPOSED_CONVOLUTION_H
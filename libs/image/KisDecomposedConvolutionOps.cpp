@@ -0,0 +1,34 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDecomposedConvolutionOps.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+KisDecomposedConvolutionOpsBase::~KisDecomposedConvolutionOpsBase()
+{
+}
+
+void KisDecomposedConvolutionOpsBase::runningSums(const float *src, float *dst, int numPixels, int numChannels) const
+{
+    for (int c = 0; c < numChannels; c++) {
+        dst[c] = 0.0f;
+    }
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int c = 0; c < numChannels; c++) {
+            dst[numChannels + c] = dst[c] + src[c];
+        }
+
+        src += numChannels;
+        dst += numChannels;
+    }
+}
+
+KisDecomposedConvolutionOpsBase *KisDecomposedConvolutionOpsFactory::create()
+{
+    return createOptimizedClass<KisDecomposedConvolutionOpsFactoryImpl>();
+}
@@ -0,0 +1,65 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_DECOMPOSED_CONVOLUTION_OPS_H
+#define KIS_DECOMPOSED_CONVOLUTION_OPS_H
+
+#include <QtGlobal>
+#include "kritaimage_export.h"
+
+/**
+ * @brief Inner loops of KisDecomposedConvolution
+ *
+ * The operations accumulate whole rows of a float buffer into the
+ * destination row. Every float of a row is processed independently,
+ * so the rows can be processed with vector instructions regardless of
+ * the number of channels of the pixels.
+ *
+ * The actual implementation is placed in class KisDecomposedConvolutionOps,
+ * which is compiled for every supported CPU architecture. Use
+ * KisDecomposedConvolutionOpsFactory::create() to create a version
+ * optimized for the current CPU.
+ */
+class KRITAIMAGE_EXPORT KisDecomposedConvolutionOpsBase
+{
+public:
+    virtual ~KisDecomposedConvolutionOpsBase();
+
+    /**
+     * Calculates running sums of the pixels of the row \p src. The row
+     * \p dst should have space for \p numPixels + 1 pixels: pixel i of
+     * \p dst is the sum of the pixels [0, i) of \p src.
+     */
+    void runningSums(const float *src, float *dst, int numPixels, int numChannels) const;
+
+    /**
+     * dst[i] += weight * src[i] for the floats [0, \p size)
+     */
+    virtual void addScaled(float *dst, const float *src, float weight, int size) const = 0;
+
+    /**
+     * dst[i] += weight * (end[i] - begin[i]) for the floats [0, \p size)
+     *
+     * Used to add a run of pixels with equal weights using the running
+     * sums of the source row.
+     */
+    virtual void addScaledDifference(float *dst, const float *end, const float *begin, float weight, int size) const = 0;
+};
+
+class KRITAIMAGE_EXPORT KisDecomposedConvolutionOpsFactory
+{
+public:
+    static KisDecomposedConvolutionOpsBase* create();
+};
+
+class KRITAIMAGE_EXPORT KisDecomposedConvolutionOpsFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisDecomposedConvolutionOpsBase* create();
+};
+
+#endif // KIS_DECOMPOSED_CONVOLUTION_OPS_H
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDecomposedConvolutionOps.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisDecomposedConvolutionOpsImpl.h"
+
+template<>
+KisDecomposedConvolutionOpsBase *
+KisDecomposedConvolutionOpsFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisDecomposedConvolutionOps<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
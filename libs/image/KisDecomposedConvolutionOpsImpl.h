@@ -0,0 +1,100 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_DECOMPOSED_CONVOLUTION_OPS_IMPL_H
+#define KIS_DECOMPOSED_CONVOLUTION_OPS_IMPL_H
+
+#include "KisDecomposedConvolutionOps.h"
+
+#include <type_traits>
+
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+/**
+ * Generic scalar implementation of the operations. It is used
+ * for the `xsimd::generic` architecture and as a tail-processor for
+ * the vectorized version.
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KisDecomposedConvolutionOps : public KisDecomposedConvolutionOpsBase
+{
+public:
+    void addScaled(float *dst, const float *src, float weight, int size) const override
+    {
+        addScaledScalar(dst, src, weight, 0, size);
+    }
+
+    void addScaledDifference(float *dst, const float *end, const float *begin, float weight, int size) const override
+    {
+        addScaledDifferenceScalar(dst, end, begin, weight, 0, size);
+    }
+
+protected:
+    static void addScaledScalar(float *dst, const float *src, float weight, int first, int size)
+    {
+        for (int i = first; i < size; i++) {
+            dst[i] += weight * src[i];
+        }
+    }
+
+    static void addScaledDifferenceScalar(float *dst, const float *end, const float *begin, float weight, int first, int size)
+    {
+        for (int i = first; i < size; i++) {
+            dst[i] += weight * (end[i] - begin[i]);
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the operations. The row is processed
+ * in batches, the tail of the row is processed by the scalar version.
+ */
+template<typename _impl>
+class KisDecomposedConvolutionOps<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisDecomposedConvolutionOps<xsimd::generic>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using base_class = KisDecomposedConvolutionOps<xsimd::generic>;
+
+public:
+    void addScaled(float *dst, const float *src, float weight, int size) const override
+    {
+        const float_v w(weight);
+
+        int i = 0;
+        for (; i + static_cast<int>(float_v::size) <= size; i += float_v::size) {
+            const float_v value = xsimd::fma(w, float_v::load_unaligned(src + i),
+                                             float_v::load_unaligned(dst + i));
+            value.store_unaligned(dst + i);
+        }
+
+        base_class::addScaledScalar(dst, src, weight, i, size);
+    }
+
+    void addScaledDifference(float *dst, const float *end, const float *begin, float weight, int size) const override
+    {
+        const float_v w(weight);
+
+        int i = 0;
+        for (; i + static_cast<int>(float_v::size) <= size; i += float_v::size) {
+            const float_v diff = float_v::load_unaligned(end + i) - float_v::load_unaligned(begin + i);
+            const float_v value = xsimd::fma(w, diff, float_v::load_unaligned(dst + i));
+            value.store_unaligned(dst + i);
+        }
+
+        base_class::addScaledDifferenceScalar(dst, end, begin, weight, i, size);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KIS_DECOMPOSED_CONVOLUTION_OPS_IMPL_H
@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisEdgeDetectionOps.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+KisEdgeDetectionOpsBase::~KisEdgeDetectionOpsBase()
+{
+}
+
+KisEdgeDetectionOpsBase *KisEdgeDetectionOpsFactory::create()
+{
+    return createOptimizedClass<KisEdgeDetectionOpsFactoryImpl>();
+}
@@ -0,0 +1,75 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_EDGE_DETECTION_OPS_H
+#define KIS_EDGE_DETECTION_OPS_H
+
+#include <QtGlobal>
+#include "kritaimage_export.h"
+
+/**
+ * @brief Inner loops of the fused gradient filters
+ *
+ * The operations convert the rows of the convolved gradients into
+ * the values of the filters' output: the channel values as
+ * KisConvolutionWorkerSpatial would write them, the magnitude of
+ * the gradient and the normal vectors of a heightmap. Used by
+ * KisEdgeDetectionKernel and the Phong bumpmap filter.
+ *
+ * The actual implementation is placed in class KisEdgeDetectionOps,
+ * which is compiled for every supported CPU architecture. Use
+ * KisEdgeDetectionOpsFactory::create() to create a version optimized
+ * for the current CPU.
+ */
+class KRITAIMAGE_EXPORT KisEdgeDetectionOpsBase
+{
+public:
+    virtual ~KisEdgeDetectionOpsBase();
+
+    /**
+     * Converts the convolved (premultiplied) values of a channel into
+     * the value of the channel the way KisConvolutionWorkerSpatial does:
+     *
+     * value = clamp(src[i] * factor / alpha[i] + offset, minValue, maxValue)
+     *
+     * When \p alpha is null, the division is skipped. When alpha[i] is
+     * zero, the value is zero. If \p quantize is true, the value is
+     * rounded the same way as it is rounded when written into an integer
+     * channel. The result is written as dst[i] = value * scale + shift.
+     */
+    virtual void resolveChannel(const float *src, const float *alpha,
+                                float factor, float offset,
+                                float minValue, float maxValue,
+                                bool quantize,
+                                float scale, float shift,
+                                float *dst, int size) const = 0;
+
+    /**
+     * dst[i] = 2 * sqrt(dx[i]^2 + dy[i]^2)
+     */
+    virtual void magnitude(const float *dx, const float *dy, float *dst, int size) const = 0;
+
+    /**
+     * Normalizes the vectors (x[i], y[i], zValue) in-place, the
+     * z-component of the normalized vectors is written into \p z
+     */
+    virtual void normalize(float *x, float *y, float *z, float zValue, int size) const = 0;
+};
+
+class KRITAIMAGE_EXPORT KisEdgeDetectionOpsFactory
+{
+public:
+    static KisEdgeDetectionOpsBase* create();
+};
+
+class KRITAIMAGE_EXPORT KisEdgeDetectionOpsFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisEdgeDetectionOpsBase* create();
+};
+
+#endif // KIS_EDGE_DETECTION_OPS_H
@@ -0,0 +1,208 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_EDGE_DETECTION_OPS_IMPL_H
+#define KIS_EDGE_DETECTION_OPS_IMPL_H
+
+#include "KisEdgeDetectionOps.h"
+
+#include <cmath>
+#include <type_traits>
+
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+/**
+ * Generic scalar implementation of the operations. It is used
+ * for the `xsimd::generic` architecture and as a tail-processor for
+ * the vectorized version.
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KisEdgeDetectionOps : public KisEdgeDetectionOpsBase
+{
+public:
+    void resolveChannel(const float *src, const float *alpha,
+                        float factor, float offset,
+                        float minValue, float maxValue,
+                        bool quantize,
+                        float scale, float shift,
+                        float *dst, int size) const override
+    {
+        resolveChannelScalar(src, alpha, factor, offset, minValue, maxValue, quantize, scale, shift, dst, 0, size);
+    }
+
+    void magnitude(const float *dx, const float *dy, float *dst, int size) const override
+    {
+        magnitudeScalar(dx, dy, dst, 0, size);
+    }
+
+    void normalize(float *x, float *y, float *z, float zValue, int size) const override
+    {
+        normalizeScalar(x, y, z, zValue, 0, size);
+    }
+
+protected:
+    static void resolveChannelScalar(const float *src, const float *alpha,
+                                     float factor, float offset,
+                                     float minValue, float maxValue,
+                                     bool quantize,
+                                     float scale, float shift,
+                                     float *dst, int first, int size)
+    {
+        for (int i = first; i < size; i++) {
+            float value = 0.0f;
+
+            if (!alpha || alpha[i] != 0.0f) {
+                value = src[i] * factor;
+                if (alpha) {
+                    value /= alpha[i];
+                }
+
+                value = qBound(minValue, value + offset, maxValue);
+
+                if (quantize) {
+                    // the values are never negative, so it is the same as qRound()
+                    value = std::floor(value + 0.5f);
+                }
+            }
+
+            dst[i] = value * scale + shift;
+        }
+    }
+
+    static void magnitudeScalar(const float *dx, const float *dy, float *dst, int first, int size)
+    {
+        for (int i = first; i < size; i++) {
+            dst[i] = 2.0f * std::sqrt(dx[i] * dx[i] + dy[i] * dy[i]);
+        }
+    }
+
+    static void normalizeScalar(float *x, float *y, float *z, float zValue, int first, int size)
+    {
+        for (int i = first; i < size; i++) {
+            const float length = std::sqrt(x[i] * x[i] + y[i] * y[i] + zValue * zValue);
+
+            if (length > 0.0f) {
+                x[i] /= length;
+                y[i] /= length;
+                z[i] = zValue / length;
+            } else {
+                z[i] = zValue;
+            }
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the operations. The row is processed
+ * in batches, the tail of the row is processed by the scalar version.
+ */
+template<typename _impl>
+class KisEdgeDetectionOps<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisEdgeDetectionOps<xsimd::generic>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using base_class = KisEdgeDetectionOps<xsimd::generic>;
+
+public:
+    void resolveChannel(const float *src, const float *alpha,
+                        float factor, float offset,
+                        float minValue, float maxValue,
+                        bool quantize,
+                        float scale, float shift,
+                        float *dst, int size) const override
+    {
+        const float_v vFactor(factor);
+        const float_v vOffset(offset);
+        const float_v vMin(minValue);
+        const float_v vMax(maxValue);
+        const float_v vScale(scale);
+        const float_v vShift(shift);
+        const float_v zero(0.0f);
+        const float_v one(1.0f);
+        const float_v half(0.5f);
+
+        int i = 0;
+        for (; i + static_cast<int>(float_v::size) <= size; i += float_v::size) {
+            float_v value = float_v::load_unaligned(src + i) * vFactor;
+
+            if (alpha) {
+                const float_v alphaValue = float_v::load_unaligned(alpha + i);
+                const auto isNull = alphaValue == zero;
+
+                value = value / xsimd::select(isNull, one, alphaValue);
+                value = xsimd::min(xsimd::max(value + vOffset, vMin), vMax);
+
+                if (quantize) {
+                    value = xsimd::floor(value + half);
+                }
+
+                value = xsimd::select(isNull, zero, value);
+            } else {
+                value = xsimd::min(xsimd::max(value + vOffset, vMin), vMax);
+
+                if (quantize) {
+                    value = xsimd::floor(value + half);
+                }
+            }
+
+            xsimd::fma(value, vScale, vShift).store_unaligned(dst + i);
+        }
+
+        base_class::resolveChannelScalar(src, alpha, factor, offset, minValue, maxValue, quantize, scale, shift, dst, i, size);
+    }
+
+    void magnitude(const float *dx, const float *dy, float *dst, int size) const override
+    {
+        const float_v two(2.0f);
+
+        int i = 0;
+        for (; i + static_cast<int>(float_v::size) <= size; i += float_v::size) {
+            const float_v x = float_v::load_unaligned(dx + i);
+            const float_v y = float_v::load_unaligned(dy + i);
+
+            const float_v value = two * xsimd::sqrt(xsimd::fma(x, x, y * y));
+            value.store_unaligned(dst + i);
+        }
+
+        base_class::magnitudeScalar(dx, dy, dst, i, size);
+    }
+
+    void normalize(float *x, float *y, float *z, float zValue, int size) const override
+    {
+        // zValue is never zero for our filters, but we still should not divide by zero
+        if (zValue == 0.0f) {
+            base_class::normalizeScalar(x, y, z, zValue, 0, size);
+            return;
+        }
+
+        const float_v vZ(zValue);
+        const float_v vZ2(zValue * zValue);
+
+        int i = 0;
+        for (; i + static_cast<int>(float_v::size) <= size; i += float_v::size) {
+            const float_v vx = float_v::load_unaligned(x + i);
+            const float_v vy = float_v::load_unaligned(y + i);
+
+            const float_v invLength = float_v(1.0f) / xsimd::sqrt(xsimd::fma(vx, vx, xsimd::fma(vy, vy, vZ2)));
+
+            (vx * invLength).store_unaligned(x + i);
+            (vy * invLength).store_unaligned(y + i);
+            (vZ * invLength).store_unaligned(z + i);
+        }
+
+        base_class::normalizeScalar(x, y, z, zValue, i, size);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KIS_EDGE_DETECTION_OPS_IMPL_H
@@ -0,0 +1,137 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFFTWPlanCache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGlobalStatic>
+#include <QMutexLocker>
+#include <QStandardPaths>
+
+#include <kis_debug.h>
+
+Q_GLOBAL_STATIC(KisFFTWPlanCache, s_instance)
+Q_GLOBAL_STATIC(QMutex, s_plannerMutex)
+
+KisFFTWPlanCache::KisFFTWPlanCache()
+{
+}
+
+KisFFTWPlanCache::~KisFFTWPlanCache()
+{
+    // no other threads are running when the global statics are destroyed
+    Q_FOREACH (const Plans &plans, m_plans) {
+        fftw_destroy_plan(plans.forward);
+        fftw_destroy_plan(plans.backward);
+    }
+
+    if (m_wisdomChanged) {
+        saveWisdom();
+    }
+}
+
+KisFFTWPlanCache *KisFFTWPlanCache::instance()
+{
+    return s_instance;
+}
+
+QMutex &KisFFTWPlanCache::plannerMutex()
+{
+    return *s_plannerMutex;
+}
+
+KisFFTWPlanCache::Plans KisFFTWPlanCache::plans(int width, int height)
+{
+    const QPair<int, int> key(width, height);
+
+    {
+        QMutexLocker l(&m_mutex);
+
+        auto it = m_plans.constFind(key);
+        if (it != m_plans.constEnd()) {
+            return *it;
+        }
+    }
+
+    QMutexLocker plannerLocker(&plannerMutex());
+
+    /**
+     * Some other thread could have created the plans while
+     * we were waiting for the planner
+     */
+    {
+        QMutexLocker l(&m_mutex);
+
+        auto it = m_plans.constFind(key);
+        if (it != m_plans.constEnd()) {
+            return *it;
+        }
+    }
+
+    if (!m_wisdomLoaded) {
+        loadWisdom();
+        m_wisdomLoaded = true;
+    }
+
+    /**
+     * The planner is called under the global planner mutex, so it
+     * should never measure anything here, otherwise all other threads
+     * that need a plan would be blocked for the whole measurement.
+     * Measured plans are used only if they are already known from the
+     * loaded wisdom, otherwise the plans are estimated.
+     */
+    const int length = height * (width / 2 + 1);
+    fftw_complex *scratch = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * length);
+
+    Plans plans;
+    plans.forward = fftw_plan_dft_r2c_2d(height, width, (double*)scratch, scratch, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+    if (!plans.forward) {
+        plans.forward = fftw_plan_dft_r2c_2d(height, width, (double*)scratch, scratch, FFTW_ESTIMATE);
+    }
+
+    plans.backward = fftw_plan_dft_c2r_2d(height, width, scratch, (double*)scratch, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+    if (!plans.backward) {
+        plans.backward = fftw_plan_dft_c2r_2d(height, width, scratch, (double*)scratch, FFTW_ESTIMATE);
+    }
+
+    fftw_free(scratch);
+
+    m_wisdomChanged = true;
+
+    {
+        QMutexLocker l(&m_mutex);
+        m_plans.insert(key, plans);
+    }
+
+    return plans;
+}
+
+QString KisFFTWPlanCache::wisdomFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) + "/kritafftwwisdom";
+}
+
+void KisFFTWPlanCache::loadWisdom()
+{
+    const QString fileName = wisdomFilePath();
+    if (!QFile::exists(fileName)) return;
+
+    if (!fftw_import_wisdom_from_filename(QFile::encodeName(fileName).constData())) {
+        warnKrita << "KisFFTWPlanCache: failed to load FFTW wisdom from" << fileName;
+    }
+}
+
+void KisFFTWPlanCache::saveWisdom()
+{
+    const QString fileName = wisdomFilePath();
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    if (!fftw_export_wisdom_to_filename(QFile::encodeName(fileName).constData())) {
+        warnKrita << "KisFFTWPlanCache: failed to save FFTW wisdom to" << fileName;
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_FFTW_PLAN_CACHE_H
+#define KIS_FFTW_PLAN_CACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+
+#include <fftw3.h>
+
+#include "kritaimage_export.h"
+
+/**
+ * @brief A process-wide cache of FFTW plans
+ *
+ * The FFTW planner is not thread-safe, so every call to it must be
+ * guarded by plannerMutex(). Execution of an existing plan is thread-safe
+ * though, so the cached plans can be executed by several threads at once
+ * via fftw_execute_dft_r2c() and fftw_execute_dft_c2r().
+ *
+ * The plans are never measured on the rendering path, because the
+ * planner runs under the global plannerMutex(). The wisdom is loaded
+ * from the user config directory on the first request, so measured
+ * plans are used when the wisdom file has them, otherwise the plans
+ * are estimated. The wisdom is saved back only once, on shutdown.
+ */
+class KRITAIMAGE_EXPORT KisFFTWPlanCache
+{
+public:
+    struct Plans {
+        fftw_plan forward {nullptr};
+        fftw_plan backward {nullptr};
+    };
+
+public:
+    KisFFTWPlanCache();
+    ~KisFFTWPlanCache();
+
+    static KisFFTWPlanCache* instance();
+
+    /**
+     * The mutex that must guard all calls to the FFTW planner,
+     * including creation and destruction of the plans not owned
+     * by the cache
+     */
+    static QMutex& plannerMutex();
+
+    /**
+     * Returns in-place 2D real-to-complex and complex-to-real plans
+     * for an array of \p height rows of \p width real values. The rows
+     * of the array are padded to `2 * (width / 2 + 1)` values.
+     *
+     * The plans are owned by the cache. They can be executed with any
+     * array of the same layout allocated by fftw_malloc().
+     */
+    Plans plans(int width, int height);
+
+private:
+    void loadWisdom();
+    void saveWisdom();
+
+    static QString wisdomFilePath();
+
+private:
+    QMutex m_mutex;
+    QHash<QPair<int, int>, Plans> m_plans;
+    bool m_wisdomLoaded {false};
+    bool m_wisdomChanged {false};
+};
+
+#endif // KIS_FFTW_PLAN_CACHE_H
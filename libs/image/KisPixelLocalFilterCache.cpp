@@ -0,0 +1,279 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPixelLocalFilterCache.h"
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <KoColorSpace.h>
+
+#include "kis_node.h"
+#include "kis_paint_device.h"
+#include "kis_default_bounds_base.h"
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+
+namespace {
+
+const int cacheTileSize = 64;
+
+inline int alignDown(int value)
+{
+    return value >= 0 ? value / cacheTileSize * cacheTileSize
+                      : -((-value + cacheTileSize - 1) / cacheTileSize) * cacheTileSize;
+}
+
+inline int alignUp(int value)
+{
+    return alignDown(value + cacheTileSize - 1);
+}
+
+inline quint64 tileKey(const QPoint &pt)
+{
+    return (quint64(quint32(pt.x())) << 32) | quint64(quint32(pt.y()));
+}
+
+/**
+ * Merges consecutive tiles of the same row into a single rect to
+ * minimize the number of calls to the filter
+ */
+QVector<QRect> mergeTileRows(const QVector<QRect> &tiles)
+{
+    QVector<QRect> result;
+
+    Q_FOREACH (const QRect &tile, tiles) {
+        if (!result.isEmpty() &&
+            result.last().top() == tile.top() &&
+            result.last().right() + 1 == tile.left()) {
+
+            result.last().setRight(tile.right());
+        } else {
+            result.append(tile);
+        }
+    }
+
+    return result;
+}
+
+}
+
+const int KisPixelLocalFilterCache::defaultMaxCacheSize = 32 * 1024 * 1024;
+
+struct KisPixelLocalFilterCache::Private
+{
+    Private(int maxCacheSize)
+    {
+        tiles.setMaxCost(maxCacheSize);
+    }
+
+    QMutex mutex;
+
+    /**
+     * The filtered pixels of the tiles, the cost of every
+     * tile is its size in bytes
+     */
+    QCache<quint64, QByteArray> tiles;
+
+    /**
+     * Incremented on every reset, so that the tiles filtered
+     * with an outdated configuration are not put into the cache
+     */
+    int generation = 0;
+
+    KisFilterConfigurationSP config;
+    const KoColorSpace *srcColorSpace = 0;
+    const KoColorSpace *dstColorSpace = 0;
+    quint64 sourceSignature = 0;
+
+    QAtomicInteger<qint64> filteredArea {0};
+
+    void resetUnlocked() {
+        tiles.clear();
+        generation++;
+        config = 0;
+        srcColorSpace = 0;
+        dstColorSpace = 0;
+        sourceSignature = 0;
+    }
+
+    void invalidateUnlocked(const QRect &rc) {
+        for (int y = alignDown(rc.top()); y <= rc.bottom(); y += cacheTileSize) {
+            for (int x = alignDown(rc.left()); x <= rc.right(); x += cacheTileSize) {
+                tiles.remove(tileKey(QPoint(x, y)));
+            }
+        }
+    }
+
+    void filterRects(KisFilterSP filter,
+                     KisPaintDeviceSP src,
+                     KisPaintDeviceSP dst,
+                     const QVector<QRect> &rects,
+                     KisFilterConfigurationSP config)
+    {
+        Q_FOREACH (const QRect &rc, rects) {
+            if (rc.isEmpty()) continue;
+
+            filter->process(src, dst, 0, rc, config, 0);
+            filteredArea.fetchAndAddOrdered(qint64(rc.width()) * rc.height());
+        }
+    }
+};
+
+KisPixelLocalFilterCache::KisPixelLocalFilterCache(int maxCacheSize)
+    : m_d(new Private(maxCacheSize))
+{
+}
+
+KisPixelLocalFilterCache::~KisPixelLocalFilterCache()
+{
+}
+
+void KisPixelLocalFilterCache::process(KisFilterSP filter,
+                                       KisPaintDeviceSP src,
+                                       KisPaintDeviceSP dst,
+                                       const QRect &applyRect,
+                                       KisFilterConfigurationSP config,
+                                       quint64 sourceSignature,
+                                       bool sourceChanged)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(src != dst);
+
+    if (applyRect.isEmpty()) return;
+
+    const bool canUseCache =
+        filter->isPixelLocal() &&
+        src->defaultBounds()->currentLevelOfDetail() == 0 &&
+        dst->defaultBounds()->currentLevelOfDetail() == 0;
+
+    if (!canUseCache) {
+        m_d->filterRects(filter, src, dst, {applyRect}, config);
+        return;
+    }
+
+    const QRect innerRect(QPoint(alignUp(applyRect.left()),
+                                 alignUp(applyRect.top())),
+                          QPoint(alignDown(applyRect.right() + 1) - 1,
+                                 alignDown(applyRect.bottom() + 1) - 1));
+
+    const int tileBytes = cacheTileSize * cacheTileSize * dst->pixelSize();
+
+    QVector<QRect> missedTiles;
+    QVector<QPair<QRect, QByteArray>> hitTiles;
+    int generation = 0;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        if (m_d->config != config ||
+            m_d->srcColorSpace != src->colorSpace() ||
+            m_d->dstColorSpace != dst->colorSpace() ||
+            m_d->sourceSignature != sourceSignature) {
+
+            m_d->resetUnlocked();
+            m_d->config = config;
+            m_d->srcColorSpace = src->colorSpace();
+            m_d->dstColorSpace = dst->colorSpace();
+            m_d->sourceSignature = sourceSignature;
+        }
+
+        if (sourceChanged) {
+            // the tiles only partially covered by the rect are outdated as well
+            m_d->invalidateUnlocked(applyRect);
+        }
+
+        generation = m_d->generation;
+
+        if (!innerRect.isEmpty()) {
+            for (int y = innerRect.top(); y <= innerRect.bottom(); y += cacheTileSize) {
+                for (int x = innerRect.left(); x <= innerRect.right(); x += cacheTileSize) {
+                    const QRect tileRect(x, y, cacheTileSize, cacheTileSize);
+
+                    QByteArray *data = m_d->tiles.object(tileKey(tileRect.topLeft()));
+
+                    if (data) {
+                        hitTiles.append(qMakePair(tileRect, *data));
+                    } else {
+                        missedTiles.append(tileRect);
+                    }
+                }
+            }
+        }
+    }
+
+    if (innerRect.isEmpty()) {
+        m_d->filterRects(filter, src, dst, {applyRect}, config);
+        return;
+    }
+
+    /**
+     * The borders of the rect are not aligned to the cache tiles, so
+     * they are filtered directly
+     */
+    QVector<QRect> borderRects;
+    borderRects << QRect(applyRect.left(), applyRect.top(),
+                         applyRect.width(), innerRect.top() - applyRect.top());
+    borderRects << QRect(applyRect.left(), innerRect.bottom() + 1,
+                         applyRect.width(), applyRect.bottom() - innerRect.bottom());
+    borderRects << QRect(applyRect.left(), innerRect.top(),
+                         innerRect.left() - applyRect.left(), innerRect.height());
+    borderRects << QRect(innerRect.right() + 1, innerRect.top(),
+                         applyRect.right() - innerRect.right(), innerRect.height());
+
+    m_d->filterRects(filter, src, dst, borderRects, config);
+    m_d->filterRects(filter, src, dst, mergeTileRows(missedTiles), config);
+
+    for (auto it = hitTiles.constBegin(); it != hitTiles.constEnd(); ++it) {
+        dst->writeBytes(reinterpret_cast<const quint8*>(it->second.constData()), it->first);
+    }
+
+    QVector<QByteArray> missedData;
+    missedData.reserve(missedTiles.size());
+
+    Q_FOREACH (const QRect &rc, missedTiles) {
+        QByteArray data(tileBytes, Qt::Uninitialized);
+        dst->readBytes(reinterpret_cast<quint8*>(data.data()), rc);
+        missedData.append(data);
+    }
+
+    QMutexLocker l(&m_d->mutex);
+
+    // the cache might have been reset while we were filtering
+    if (m_d->generation != generation) return;
+
+    for (int i = 0; i < missedTiles.size(); i++) {
+        m_d->tiles.insert(tileKey(missedTiles[i].topLeft()), new QByteArray(missedData[i]), tileBytes);
+    }
+}
+
+void KisPixelLocalFilterCache::reset()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->resetUnlocked();
+    m_d->filteredArea.storeRelease(0);
+}
+
+qint64 KisPixelLocalFilterCache::filteredArea() const
+{
+    return m_d->filteredArea.loadAcquire();
+}
+
+quint64 KisPixelLocalFilterCache::sourceSignature(const KisNode *node)
+{
+    quint64 signature = qHash(node->parent().data());
+
+    for (KisNodeSP below = node->prevSibling(); below; below = below->prevSibling()) {
+        if (!below->visible()) continue;
+        signature = signature * 31 + qHash(below.data());
+    }
+
+    return signature;
+}
@@ -0,0 +1,100 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPIXELLOCALFILTERCACHE_H
+#define KISPIXELLOCALFILTERCACHE_H
+
+#include <QScopedPointer>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KisNode;
+
+/**
+ * A per-tile cache of the output of a pixel-local filter (see
+ * KisBaseProcessor::isPixelLocal()) used by filter masks and
+ * adjustment layers.
+ *
+ * The update walkers often ask a node to re-filter rects whose source
+ * pixels have not changed, e.g. when the opacity of an adjustment
+ * layer is changed or when a filter mask above the current one is
+ * edited. The owner of the cache tells process() whether the source
+ * of the rect might have changed, which it knows from the position of
+ * the node relative to the filthy node of the walker. When the source
+ * is unchanged, the tiles filtered earlier are copied from the cache
+ * and only the missing ones are passed to the filter. When the source
+ * has changed, the cached tiles touching the rect are dropped and the
+ * rect is filtered again.
+ *
+ * Only the tiles fully covered by the processed rect are cached, the
+ * borders of the rect are always filtered directly. The size of the
+ * cache is limited, the least recently used tiles are evicted first.
+ * The cache is disabled for level-of-detail devices and for
+ * non-pixel-local filters, in which case process() just calls
+ * KisFilter::process().
+ *
+ * The class is thread-safe: the walkers may process different
+ * rects of the same node concurrently.
+ */
+class KRITAIMAGE_EXPORT KisPixelLocalFilterCache
+{
+public:
+    /**
+     * The default limit of the memory used by the cached tiles
+     * of a single node, in bytes
+     */
+    static const int defaultMaxCacheSize;
+
+    KisPixelLocalFilterCache(int maxCacheSize = defaultMaxCacheSize);
+    ~KisPixelLocalFilterCache();
+
+    /**
+     * Filters \p applyRect of \p src into \p dst reusing the cached
+     * tiles when possible. \p src must be different from \p dst.
+     *
+     * \p sourceChanged should be true if the pixels of \p src in
+     * \p applyRect might have changed since the previous call.
+     *
+     * \p sourceSignature identifies the nodes the source is composed
+     * from, see sourceSignature(). The cache is dropped when it changes.
+     */
+    void process(KisFilterSP filter,
+                 KisPaintDeviceSP src,
+                 KisPaintDeviceSP dst,
+                 const QRect &applyRect,
+                 KisFilterConfigurationSP config,
+                 quint64 sourceSignature,
+                 bool sourceChanged);
+
+    /**
+     * Drops all the cached tiles. Should be called when the filter
+     * configuration of the node changes or when the node is hidden,
+     * because the walkers don't report the changes of the source to
+     * hidden nodes.
+     */
+    void reset();
+
+    /**
+     * The number of pixels actually passed to the filter since the
+     * construction of the cache (or the last reset()). Used for
+     * testing purposes.
+     */
+    qint64 filteredArea() const;
+
+    /**
+     * The signature of the source of \p node, that is, of its parent
+     * and of the visible nodes below it. It changes when the node is
+     * moved or when the nodes below it are reordered.
+     */
+    static quint64 sourceSignature(const KisNode *node);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISPIXELLOCALFILTERCACHE_H
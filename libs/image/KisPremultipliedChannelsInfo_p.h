@@ -0,0 +1,130 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_PREMULTIPLIED_CHANNELS_INFO_P_H
+#define KIS_PREMULTIPLIED_CHANNELS_INFO_P_H
+
+#include <QBitArray>
+#include <QList>
+#include <QVector>
+
+#include <limits>
+
+#include <KoChannelInfo.h>
+#include <KoColorSpace.h>
+
+#include "kis_assert.h"
+#include "kis_math_toolbox.h"
+
+/**
+ * Converts the pixels of a color space into arrays of floats and back.
+ * Only the channels enabled in the channel flags are converted. The float
+ * engines (KisRecursiveGaussianBlur, KisDecomposedConvolution) use it to
+ * keep their source areas in memory.
+ */
+struct KisPremultipliedChannelsInfo {
+    KisPremultipliedChannelsInfo(const KoColorSpace *cs, const QBitArray &channelFlags)
+    {
+        const QList<KoChannelInfo*> channelInfo = cs->channels();
+
+        for (int c = 0; c < channelInfo.count(); ++c) {
+            if (channelFlags.isEmpty() || channelFlags.testBit(c)) {
+                channels.append(channelInfo[c]);
+            }
+        }
+
+        KisMathToolbox mathToolbox;
+
+        for (int i = 0; i < channels.count(); ++i) {
+            minClamp.append(mathToolbox.minChannelValue(channels[i]));
+            maxClamp.append(mathToolbox.maxChannelValue(channels[i]));
+
+            if (channels[i]->channelType() == KoChannelInfo::ALPHA) {
+                alphaCachePos = i;
+                alphaRealPos = channels[i]->pos();
+            }
+        }
+
+        toDoubleFuncPtr.resize(channels.count());
+        fromDoubleFuncPtr.resize(channels.count());
+        fromDoubleCheckNullFuncPtr.resize(channels.count());
+
+        bool result = mathToolbox.getToDoubleChannelPtr(channels, toDoubleFuncPtr);
+        result &= mathToolbox.getFromDoubleChannelPtr(channels, fromDoubleFuncPtr);
+        result &= mathToolbox.getFromDoubleCheckNullChannelPtr(channels, fromDoubleCheckNullFuncPtr);
+
+        KIS_ASSERT(result);
+    }
+
+    inline int numChannels() const {
+        return channels.size();
+    }
+
+    /**
+     * The channels are stored premultiplied by alpha, the same way
+     * as KisConvolutionWorkerFFT does
+     */
+    inline void readPixel(const quint8 *data, float *dst) const {
+        const qreal alphaValue = alphaRealPos >= 0 ?
+            toDoubleFuncPtr[alphaCachePos](data, alphaRealPos) : 1.0;
+
+        for (int k = 0; k < channels.size(); k++) {
+            dst[k] = k != alphaCachePos ?
+                toDoubleFuncPtr[k](data, channels[k]->pos()) * alphaValue :
+                alphaValue;
+        }
+    }
+
+    inline void writePixel(const float *src, quint8 *data) const {
+        if (alphaCachePos >= 0) {
+            bool alphaIsNullInDstSpace = false;
+
+            const qreal alphaValue = qBound(minClamp[alphaCachePos],
+                                            qreal(src[alphaCachePos]),
+                                            maxClamp[alphaCachePos]);
+
+            fromDoubleCheckNullFuncPtr[alphaCachePos](data, alphaRealPos, alphaValue, &alphaIsNullInDstSpace);
+
+            if (!alphaIsNullInDstSpace &&
+                alphaValue > std::numeric_limits<qreal>::epsilon()) {
+
+                const qreal alphaValueInv = 1.0 / alphaValue;
+
+                for (int k = 0; k < channels.size(); k++) {
+                    if (k == alphaCachePos) continue;
+
+                    const qreal value = qBound(minClamp[k], src[k] * alphaValueInv, maxClamp[k]);
+                    fromDoubleFuncPtr[k](data, channels[k]->pos(), value);
+                }
+            } else {
+                for (int k = 0; k < channels.size(); k++) {
+                    if (k == alphaCachePos) continue;
+
+                    fromDoubleFuncPtr[k](data, channels[k]->pos(), 0.0);
+                }
+            }
+        } else {
+            for (int k = 0; k < channels.size(); k++) {
+                const qreal value = qBound(minClamp[k], qreal(src[k]), maxClamp[k]);
+                fromDoubleFuncPtr[k](data, channels[k]->pos(), value);
+            }
+        }
+    }
+
+    QList<KoChannelInfo*> channels;
+
+    QVector<qreal> minClamp;
+    QVector<qreal> maxClamp;
+
+    QVector<PtrToDouble> toDoubleFuncPtr;
+    QVector<PtrFromDouble> fromDoubleFuncPtr;
+    QVector<PtrFromDoubleCheckNull> fromDoubleCheckNullFuncPtr;
+
+    int alphaCachePos {-1};
+    int alphaRealPos {-1};
+};
+
+#endif // KIS_PREMULTIPLIED_CHANNELS_INFO_P_H
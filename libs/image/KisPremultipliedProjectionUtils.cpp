@@ -0,0 +1,141 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPremultipliedProjectionUtils.h"
+
+#include <algorithm>
+
+#include <QScopedPointer>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoOptimizedPremultipliedAlphaOpsFactory.h>
+
+#include "kis_paint_device.h"
+#include "kis_random_accessor_ng.h"
+#include "kis_sequential_iterator.h"
+
+namespace {
+
+const KoOptimizedPremultipliedAlphaOpsBase *premultipliedOps()
+{
+    static const QScopedPointer<KoOptimizedPremultipliedAlphaOpsBase>
+        ops(KoOptimizedPremultipliedAlphaOpsFactory::create());
+
+    return ops.data();
+}
+
+template <typename Func>
+void processRect(KisPaintDeviceSP device, const QRect &rect, Func func)
+{
+    const QRect processRect = rect & device->extent();
+    if (processRect.isEmpty()) return;
+
+    KisSequentialIterator it(device, processRect);
+
+    int numConseqPixels = it.nConseqPixels();
+    while (it.nextPixels(numConseqPixels)) {
+        numConseqPixels = it.nConseqPixels();
+        func(it.rawData(), numConseqPixels);
+    }
+}
+
+}
+
+namespace KisPremultipliedProjectionUtils
+{
+
+bool isSupportedColorSpace(const KoColorSpace *cs)
+{
+    return cs->colorModelId() == RGBAColorModelID &&
+        cs->colorDepthId() == Float32BitsColorDepthID;
+}
+
+bool canBePremultiplied(KisPaintDeviceSP device)
+{
+    if (!isSupportedColorSpace(device->colorSpace())) return false;
+
+    const KoColor defaultPixel = device->defaultPixel();
+    const float *pixel = reinterpret_cast<const float*>(defaultPixel.data());
+
+    return pixel[3] == 1.0f ||
+        (pixel[0] == 0.0f && pixel[1] == 0.0f && pixel[2] == 0.0f && pixel[3] == 0.0f);
+}
+
+void premultiply(KisPaintDeviceSP device, const QRect &rect)
+{
+    const KoOptimizedPremultipliedAlphaOpsBase *ops = premultipliedOps();
+
+    processRect(device, rect,
+        [ops] (quint8 *pixels, int numPixels) {
+            ops->premultiply(pixels, numPixels);
+        });
+}
+
+void unpremultiply(KisPaintDeviceSP device, const QRect &rect)
+{
+    const KoOptimizedPremultipliedAlphaOpsBase *ops = premultipliedOps();
+
+    processRect(device, rect,
+        [ops] (quint8 *pixels, int numPixels) {
+            ops->unpremultiply(pixels, numPixels);
+        });
+}
+
+void compositeOver(KisPaintDeviceSP dst, KisPaintDeviceSP src, const QRect &rect, quint8 opacity)
+{
+    const QRect rc = rect & src->extent();
+    if (rc.isEmpty() || opacity == OPACITY_TRANSPARENT_U8) return;
+
+    const KoOptimizedPremultipliedAlphaOpsBase *ops = premultipliedOps();
+
+    KisRandomConstAccessorSP srcIt = src->createRandomConstAccessorNG();
+    KisRandomAccessorSP dstIt = dst->createRandomAccessorNG();
+
+    KoCompositeOp::ParameterInfo params;
+    params.opacity = float(opacity) / 255.0f;
+    params.flow = 1.0f;
+
+    qint32 y = rc.y();
+    qint32 rowsRemaining = rc.height();
+
+    while (rowsRemaining > 0) {
+        const qint32 numContiguousSrcRows = srcIt->numContiguousRows(y);
+        const qint32 numContiguousDstRows = dstIt->numContiguousRows(y);
+        const qint32 rows = std::min({rowsRemaining, numContiguousSrcRows, numContiguousDstRows});
+
+        qint32 x = rc.x();
+        qint32 columnsRemaining = rc.width();
+
+        while (columnsRemaining > 0) {
+            const qint32 numContiguousSrcColumns = srcIt->numContiguousColumns(x);
+            const qint32 numContiguousDstColumns = dstIt->numContiguousColumns(x);
+            const qint32 columns = std::min({columnsRemaining, numContiguousSrcColumns, numContiguousDstColumns});
+
+            params.srcRowStride = srcIt->rowStride(x, y);
+            params.dstRowStride = dstIt->rowStride(x, y);
+
+            srcIt->moveTo(x, y);
+            dstIt->moveTo(x, y);
+
+            params.srcRowStart = srcIt->rawDataConst();
+            params.dstRowStart = dstIt->rawData();
+            params.rows = rows;
+            params.cols = columns;
+
+            ops->compositeOver(params);
+
+            x += columns;
+            columnsRemaining -= columns;
+        }
+
+        y += rows;
+        rowsRemaining -= rows;
+    }
+}
+
+}
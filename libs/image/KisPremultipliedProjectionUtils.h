@@ -0,0 +1,52 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPREMULTIPLIEDPROJECTIONUTILS_H
+#define KISPREMULTIPLIEDPROJECTIONUTILS_H
+
+#include <kis_types.h>
+#include "kritaimage_export.h"
+
+class QRect;
+class KoColorSpace;
+
+/**
+ * Helpers for compositing layers into a projection in premultiplied
+ * alpha form. The projection is premultiplied before the first layer
+ * is composited and converted back after the last one, so the layers
+ * themselves are composited without the per-pixel division of the
+ * normal "Over" composite op.
+ *
+ * Only RGBA F32 devices are supported.
+ */
+namespace KisPremultipliedProjectionUtils
+{
+
+/**
+ * \return true if \p device can be switched into premultiplied form.
+ * The default pixel of the device should not be changed by premultiplication,
+ * because the tiles created during the composition are not converted.
+ */
+bool KRITAIMAGE_EXPORT canBePremultiplied(KisPaintDeviceSP device);
+
+/**
+ * \return true if \p cs is supported by the premultiplied composition
+ */
+bool KRITAIMAGE_EXPORT isSupportedColorSpace(const KoColorSpace *cs);
+
+void KRITAIMAGE_EXPORT premultiply(KisPaintDeviceSP device, const QRect &rect);
+void KRITAIMAGE_EXPORT unpremultiply(KisPaintDeviceSP device, const QRect &rect);
+
+/**
+ * Composite straight pixels of \p src over premultiplied pixels of \p dst
+ * in \p rect with the "normal" blending mode. Both devices should have
+ * the same color space.
+ */
+void KRITAIMAGE_EXPORT compositeOver(KisPaintDeviceSP dst, KisPaintDeviceSP src, const QRect &rect, quint8 opacity);
+
+}
+
+#endif // KISPREMULTIPLIEDPROJECTIONUTILS_H
@@ -0,0 +1,284 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRecursiveGaussianBlur.h"
+
+#include <QBitArray>
+#include <QRect>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <cmath>
+
+#include <KoColorSpace.h>
+#include <KoUpdater.h>
+
+#include "kis_convolution_worker.h"
+#include "kis_default_bounds.h"
+#include "kis_gaussian_kernel.h"
+#include "kis_paint_device.h"
+#include "krita_utils.h"
+#include "KisPremultipliedChannelsInfo_p.h"
+
+namespace {
+
+/**
+ * The size of the tiles of the paint device
+ */
+const int bandSize = 64;
+
+/**
+ * The number of floats of a row processed by a single job
+ * of the recursive filter
+ */
+const int columnBlockSize = 256;
+
+/**
+ * Reads \p patch of \p srcRect into the transposed buffer, that is,
+ * every column of the device becomes a row of the buffer
+ */
+template <class _IteratorFactory_>
+void readColumns(KisPaintDeviceSP device, const QRect &srcRect, const QRect &dataRect,
+                 const KisPremultipliedChannelsInfo &info, float *buffer, int rowStride,
+                 const QRect &patch)
+{
+    const int numChannels = info.numChannels();
+
+    typename _IteratorFactory_::VLineConstIterator it =
+        _IteratorFactory_::createVLineConstIterator(device,
+                                                    patch.x(), patch.y(), patch.height(),
+                                                    dataRect);
+
+    for (int x = patch.left(); x <= patch.right(); x++) {
+        float *dst = buffer + qint64(x - srcRect.x()) * rowStride +
+            (patch.y() - srcRect.y()) * numChannels;
+
+        for (int y = 0; y < patch.height(); y++) {
+            info.readPixel(it->oldRawData(), dst);
+            dst += numChannels;
+            it->nextPixel();
+        }
+
+        it->nextColumn();
+    }
+}
+
+void runFilter(const KisRecursiveGaussianKernelsBase *kernels,
+               float *buffer, int rowStride, int numRows,
+               const KisRecursiveGaussianCoefficients &c)
+{
+    QVector<QRect> blocks =
+        KritaUtils::splitRectIntoPatchesTight(QRect(0, 0, rowStride, 1),
+                                              QSize(columnBlockSize, 1));
+
+    KritaUtils::parallelMap(blocks,
+        [&] (const QRect &block) {
+            kernels->filterColumns(buffer, rowStride, numRows, block.left(), block.right() + 1, c);
+        });
+}
+
+bool isInterrupted(KoUpdater *progressUpdater)
+{
+    return progressUpdater && progressUpdater->interrupted();
+}
+
+void setProgress(KoUpdater *progressUpdater, int value)
+{
+    if (progressUpdater) {
+        progressUpdater->setProgress(value);
+    }
+}
+
+}
+
+qreal KisRecursiveGaussianBlur::minimalRadius()
+{
+    return 50.0;
+}
+
+bool KisRecursiveGaussianBlur::isApplicable(qreal radius)
+{
+    return radius >= minimalRadius();
+}
+
+KisRecursiveGaussianCoefficients KisRecursiveGaussianBlur::coefficientsFromSigma(qreal sigma)
+{
+    /**
+     * The approximation is valid for sigma >= 0.5 only, the smaller
+     * values are too close to the identity filter to be noticed
+     */
+    sigma = qMax(0.5, sigma);
+
+    const qreal q = sigma >= 2.5 ?
+        0.98711 * sigma - 0.96330 :
+        3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+
+    const qreal q2 = q * q;
+    const qreal q3 = q2 * q;
+
+    const qreal b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const qreal b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    const qreal b2 = -(1.4281 * q2 + 1.26661 * q3);
+    const qreal b3 = 0.422205 * q3;
+
+    KisRecursiveGaussianCoefficients c;
+    c.a1 = b1 / b0;
+    c.a2 = b2 / b0;
+    c.a3 = b3 / b0;
+
+    // normalize the filter so that it preserves a constant signal
+    c.b = 1.0 - (c.a1 + c.a2 + c.a3);
+
+    return c;
+}
+
+void KisRecursiveGaussianBlur::apply(KisPaintDeviceSP device,
+                                     const QRect &rect,
+                                     qreal xRadius, qreal yRadius,
+                                     const QBitArray &channelFlags,
+                                     KoUpdater *progressUpdater,
+                                     KisConvolutionBorderOp borderOp)
+{
+    if (rect.isEmpty() || (xRadius <= 0.0 && yRadius <= 0.0)) return;
+
+    /**
+     * The same border handling as KisConvolutionPainter::applyMatrix() does
+     */
+    if (device->defaultBounds()->wrapAroundMode()) {
+        borderOp = BORDER_IGNORE;
+    }
+
+    QRect dataRect;
+
+    if (borderOp == BORDER_REPEAT) {
+        const QRect boundsRect = device->defaultBounds()->bounds();
+        dataRect = rect | boundsRect;
+
+        KIS_SAFE_ASSERT_RECOVER(boundsRect != KisDefaultBounds().bounds()) {
+            dataRect = rect | device->exactBounds();
+        }
+    }
+
+    const KisPremultipliedChannelsInfo info(device->colorSpace(), channelFlags);
+    const int numChannels = info.numChannels();
+    if (!numChannels) return;
+
+    const int halfWidth = xRadius > 0.0 ? KisGaussianKernel::kernelSizeFromRadius(xRadius) / 2 : 0;
+    const int halfHeight = yRadius > 0.0 ? KisGaussianKernel::kernelSizeFromRadius(yRadius) / 2 : 0;
+
+    const QRect srcRect = rect.adjusted(-halfWidth, -halfHeight, halfWidth, halfHeight);
+
+    QScopedPointer<KisRecursiveGaussianKernelsBase> kernels(KisRecursiveGaussianKernelsFactory::create());
+
+    setProgress(progressUpdater, 0);
+
+    /**
+     * 1) Read the source area into a transposed buffer. The rows of the
+     *    buffer are the columns of the device, so the horizontal pass
+     *    runs along the columns of the buffer, the same way as the
+     *    vertical one does.
+     */
+    const int transposedStride = srcRect.height() * numChannels;
+    QVector<float> transposed(qint64(transposedStride) * srcRect.width());
+
+    {
+        QVector<QRect> patches =
+            KritaUtils::splitRectIntoPatches(srcRect, QSize(bandSize, bandSize));
+
+        KritaUtils::parallelMap(patches,
+            [&] (const QRect &patch) {
+                if (borderOp == BORDER_REPEAT) {
+                    readColumns<RepeatIteratorFactory>(device, srcRect, dataRect, info,
+                                                       transposed.data(), transposedStride, patch);
+                } else {
+                    readColumns<StandardIteratorFactory>(device, srcRect, dataRect, info,
+                                                         transposed.data(), transposedStride, patch);
+                }
+            });
+    }
+
+    setProgress(progressUpdater, 20);
+    if (isInterrupted(progressUpdater)) return;
+
+    // 2) Horizontal pass
+
+    if (xRadius > 0.0) {
+        runFilter(kernels.data(), transposed.data(), transposedStride, srcRect.width(),
+                  coefficientsFromSigma(KisGaussianKernel::sigmaFromRadius(xRadius)));
+    }
+
+    setProgress(progressUpdater, 45);
+    if (isInterrupted(progressUpdater)) return;
+
+    /**
+     * 3) Transpose the columns that belong to the destination rect
+     *    back into the normal order
+     */
+    const int stride = rect.width() * numChannels;
+    QVector<float> buffer(qint64(stride) * srcRect.height());
+
+    {
+        QVector<QRect> patches =
+            KritaUtils::splitRectIntoPatchesTight(QRect(0, 0, rect.width(), srcRect.height()),
+                                                  QSize(bandSize, bandSize));
+
+        KritaUtils::parallelMap(patches,
+            [&] (const QRect &patch) {
+                for (int y = patch.top(); y <= patch.bottom(); y++) {
+                    float *dst = buffer.data() + qint64(y) * stride + patch.x() * numChannels;
+                    const float *src = transposed.constData() +
+                        qint64(halfWidth + patch.x()) * transposedStride + y * numChannels;
+
+                    for (int x = 0; x < patch.width(); x++) {
+                        memcpy(dst, src, numChannels * sizeof(float));
+                        dst += numChannels;
+                        src += transposedStride;
+                    }
+                }
+            });
+    }
+
+    transposed = QVector<float>();
+
+    setProgress(progressUpdater, 55);
+    if (isInterrupted(progressUpdater)) return;
+
+    // 4) Vertical pass
+
+    if (yRadius > 0.0) {
+        runFilter(kernels.data(), buffer.data(), stride, srcRect.height(),
+                  coefficientsFromSigma(KisGaussianKernel::sigmaFromRadius(yRadius)));
+    }
+
+    setProgress(progressUpdater, 80);
+    if (isInterrupted(progressUpdater)) return;
+
+    // 5) Write the result into the device
+
+    {
+        QVector<QRect> patches =
+            KritaUtils::splitRectIntoPatches(rect, QSize(bandSize, bandSize));
+
+        KritaUtils::parallelMap(patches,
+            [&] (const QRect &patch) {
+                KisHLineIteratorSP it = device->createHLineIteratorNG(patch.x(), patch.y(), patch.width());
+
+                for (int y = patch.top(); y <= patch.bottom(); y++) {
+                    const float *src = buffer.constData() + qint64(y - srcRect.y()) * stride +
+                        (patch.x() - rect.x()) * numChannels;
+
+                    do {
+                        info.writePixel(src, it->rawData());
+                        src += numChannels;
+                    } while (it->nextPixel());
+
+                    it->nextRow();
+                }
+            });
+    }
+
+    setProgress(progressUpdater, 100);
+}
@@ -0,0 +1,66 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_RECURSIVE_GAUSSIAN_BLUR_H
+#define KIS_RECURSIVE_GAUSSIAN_BLUR_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+#include "kis_convolution_painter.h"
+#include "KisRecursiveGaussianKernels.h"
+
+class QRect;
+class QBitArray;
+class KoUpdater;
+
+/**
+ * @brief Gaussian blur with constant cost per pixel
+ *
+ * The blur is implemented as a third-order recursive (IIR) filter
+ * described by Young and van Vliet ("Recursive implementation of the
+ * Gaussian filter", Signal Processing 44, 1995). The filter runs forward
+ * and backward along the rows and then along the columns of the image,
+ * so its cost doesn't depend on the radius of the blur.
+ *
+ * The recursive filter is an approximation of the Gaussian, its error is
+ * about 1.5% on sharp edges. KisGaussianKernel::applyGaussian() uses it
+ * only when the caller explicitly allows the approximation, and only for
+ * the axes with big radii, where the convolution becomes too expensive.
+ */
+class KRITAIMAGE_EXPORT KisRecursiveGaussianBlur
+{
+public:
+    /**
+     * The minimal radius of the blur, starting from which
+     * KisGaussianKernel::applyGaussian() may switch to the recursive filter
+     */
+    static qreal minimalRadius();
+
+    /**
+     * \return true if the blur along a single axis with \p radius
+     *         may be approximated with the recursive filter
+     */
+    static bool isApplicable(qreal radius);
+
+    static KisRecursiveGaussianCoefficients coefficientsFromSigma(qreal sigma);
+
+    /**
+     * Blurs \p rect of \p device in-place. The radii have the same meaning
+     * as in KisGaussianKernel, the pixels needed for processing are read
+     * from the area returned by KisGaussianKernel::kernelSizeFromRadius().
+     *
+     * The whole area is loaded into memory before writing the result,
+     * so no transaction is needed for the operation.
+     */
+    static void apply(KisPaintDeviceSP device,
+                      const QRect& rect,
+                      qreal xRadius, qreal yRadius,
+                      const QBitArray &channelFlags,
+                      KoUpdater *progressUpdater,
+                      KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+};
+
+#endif // KIS_RECURSIVE_GAUSSIAN_BLUR_H
@@ -0,0 +1,62 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRecursiveGaussianKernels.h"
+
+#include <QVarLengthArray>
+
+#include <KoMultiArchBuildSupport.h>
+
+KisRecursiveGaussianKernelsBase::~KisRecursiveGaussianKernelsBase()
+{
+}
+
+void KisRecursiveGaussianKernelsBase::filterColumns(float *data, int rowStride, int numRows,
+                                                    int begin, int end,
+                                                    const KisRecursiveGaussianCoefficients &c) const
+{
+    if (numRows <= 0 || begin >= end) return;
+
+    /**
+     * The rows are filtered in-place, so the edge row is copied
+     * into a separate buffer before it gets overwritten
+     */
+    QVarLengthArray<float, 1024> edgeBuffer(end - begin);
+    const float *edge = edgeBuffer.data() - begin;
+
+    // forward pass
+
+    memcpy(edgeBuffer.data(), data + begin, (end - begin) * sizeof(float));
+
+    for (int r = 0; r < numRows; r++) {
+        float *row = data + qint64(r) * rowStride;
+
+        filterRow(row,
+                  r >= 1 ? row - rowStride : edge,
+                  r >= 2 ? row - 2 * rowStride : edge,
+                  r >= 3 ? row - 3 * rowStride : edge,
+                  begin, end, c);
+    }
+
+    // backward pass
+
+    memcpy(edgeBuffer.data(), data + qint64(numRows - 1) * rowStride + begin, (end - begin) * sizeof(float));
+
+    for (int r = numRows - 1; r >= 0; r--) {
+        float *row = data + qint64(r) * rowStride;
+
+        filterRow(row,
+                  r < numRows - 1 ? row + rowStride : edge,
+                  r < numRows - 2 ? row + 2 * rowStride : edge,
+                  r < numRows - 3 ? row + 3 * rowStride : edge,
+                  begin, end, c);
+    }
+}
+
+KisRecursiveGaussianKernelsBase *KisRecursiveGaussianKernelsFactory::create()
+{
+    return createOptimizedClass<KisRecursiveGaussianKernelsFactoryImpl>();
+}
@@ -0,0 +1,78 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_RECURSIVE_GAUSSIAN_KERNELS_H
+#define KIS_RECURSIVE_GAUSSIAN_KERNELS_H
+
+#include <QtGlobal>
+#include "kritaimage_export.h"
+
+/**
+ * The coefficients of the third-order recursive filter:
+ *
+ * y[n] = b * x[n] + a1 * y[n-1] + a2 * y[n-2] + a3 * y[n-3]
+ */
+struct KisRecursiveGaussianCoefficients
+{
+    float b {1.0f};
+    float a1 {0.0f};
+    float a2 {0.0f};
+    float a3 {0.0f};
+};
+
+/**
+ * @brief Inner loops of KisRecursiveGaussianBlur
+ *
+ * The kernels run the recursive filter along the columns of a float
+ * buffer. Every float of a row is considered to be an independent signal,
+ * so the rows can be processed with vector instructions regardless of
+ * the number of channels of the pixels.
+ *
+ * The actual implementation is placed in class KisRecursiveGaussianKernels,
+ * which is compiled for every supported CPU architecture. Use
+ * KisRecursiveGaussianKernelsFactory::create() to create a version
+ * optimized for the current CPU.
+ */
+class KRITAIMAGE_EXPORT KisRecursiveGaussianKernelsBase
+{
+public:
+    virtual ~KisRecursiveGaussianKernelsBase();
+
+    /**
+     * Runs the filter forward and backward along the columns [\p begin, \p end)
+     * of \p numRows rows of \p data. The samples outside the buffer are
+     * considered to be equal to the nearest sample of the column.
+     */
+    void filterColumns(float *data, int rowStride, int numRows,
+                       int begin, int end,
+                       const KisRecursiveGaussianCoefficients &c) const;
+
+protected:
+    /**
+     * Calculates one step of the recursion for the floats [\p begin, \p end)
+     * of \p row in-place. \p prev1, \p prev2 and \p prev3 point to the rows
+     * filtered at the previous steps.
+     */
+    virtual void filterRow(float *row,
+                           const float *prev1, const float *prev2, const float *prev3,
+                           int begin, int end,
+                           const KisRecursiveGaussianCoefficients &c) const = 0;
+};
+
+class KRITAIMAGE_EXPORT KisRecursiveGaussianKernelsFactory
+{
+public:
+    static KisRecursiveGaussianKernelsBase* create();
+};
+
+class KRITAIMAGE_EXPORT KisRecursiveGaussianKernelsFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisRecursiveGaussianKernelsBase* create();
+};
+
+#endif // KIS_RECURSIVE_GAUSSIAN_KERNELS_H
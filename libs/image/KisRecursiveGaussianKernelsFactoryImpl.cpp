@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRecursiveGaussianKernels.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisRecursiveGaussianKernelsImpl.h"
+
+template<>
+KisRecursiveGaussianKernelsBase *
+KisRecursiveGaussianKernelsFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisRecursiveGaussianKernels<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
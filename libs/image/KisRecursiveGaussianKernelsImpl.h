@@ -0,0 +1,87 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_RECURSIVE_GAUSSIAN_KERNELS_IMPL_H
+#define KIS_RECURSIVE_GAUSSIAN_KERNELS_IMPL_H
+
+#include "KisRecursiveGaussianKernels.h"
+
+#include <type_traits>
+
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+/**
+ * Generic scalar implementation of the recursive filter. It is used
+ * for the `xsimd::generic` architecture and as a tail-processor for
+ * the vectorized version.
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KisRecursiveGaussianKernels : public KisRecursiveGaussianKernelsBase
+{
+protected:
+    void filterRow(float *row,
+                   const float *prev1, const float *prev2, const float *prev3,
+                   int begin, int end,
+                   const KisRecursiveGaussianCoefficients &c) const override
+    {
+        filterRowScalar(row, prev1, prev2, prev3, begin, end, c);
+    }
+
+    static void filterRowScalar(float *row,
+                                const float *prev1, const float *prev2, const float *prev3,
+                                int begin, int end,
+                                const KisRecursiveGaussianCoefficients &c)
+    {
+        for (int i = begin; i < end; i++) {
+            row[i] = c.b * row[i] + c.a1 * prev1[i] + c.a2 * prev2[i] + c.a3 * prev3[i];
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the recursive filter. The row is processed
+ * in batches, the tail of the row is processed by the scalar version.
+ */
+template<typename _impl>
+class KisRecursiveGaussianKernels<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisRecursiveGaussianKernels<xsimd::generic>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using base_class = KisRecursiveGaussianKernels<xsimd::generic>;
+
+protected:
+    void filterRow(float *row,
+                   const float *prev1, const float *prev2, const float *prev3,
+                   int begin, int end,
+                   const KisRecursiveGaussianCoefficients &c) const override
+    {
+        const float_v b(c.b);
+        const float_v a1(c.a1);
+        const float_v a2(c.a2);
+        const float_v a3(c.a3);
+
+        int i = begin;
+        for (; i + static_cast<int>(float_v::size) <= end; i += float_v::size) {
+            float_v value = b * float_v::load_unaligned(row + i);
+            value = xsimd::fma(a1, float_v::load_unaligned(prev1 + i), value);
+            value = xsimd::fma(a2, float_v::load_unaligned(prev2 + i), value);
+            value = xsimd::fma(a3, float_v::load_unaligned(prev3 + i), value);
+            value.store_unaligned(row + i);
+        }
+
+        base_class::filterRowScalar(row, prev1, prev2, prev3, i, end, c);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KIS_RECURSIVE_GAUSSIAN_KERNELS_IMPL_H
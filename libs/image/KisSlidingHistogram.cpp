@@ -0,0 +1,211 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSlidingHistogram.h"
+
+#include <QAtomicInt>
+#include <QRect>
+
+#include <KoUpdater.h>
+
+#include "kis_assert.h"
+#include "kis_paint_device.h"
+#include "krita_utils.h"
+
+namespace {
+
+template<typename T>
+inline void addArray(T *dst, const T *src, int size)
+{
+    for (int i = 0; i < size; i++) {
+        dst[i] += src[i];
+    }
+}
+
+template<typename T>
+inline void subtractArray(T *dst, const T *src, int size)
+{
+    for (int i = 0; i < size; i++) {
+        dst[i] -= src[i];
+    }
+}
+
+/**
+ * A set of histograms with the accumulated values: a single column
+ * histogram or the histogram of the whole window
+ */
+struct HistogramSet {
+    HistogramSet(int numHistograms, int numBins, int numValues)
+        : counts(numHistograms * numBins, 0),
+          sums(numHistograms * numBins * numValues, 0.0f),
+          totals(numHistograms, 0)
+    {
+    }
+
+    void clear() {
+        counts.fill(0);
+        sums.fill(0.0f);
+        totals.fill(0);
+    }
+
+    void add(const HistogramSet &rhs) {
+        addArray(counts.data(), rhs.counts.constData(), counts.size());
+        addArray(sums.data(), rhs.sums.constData(), sums.size());
+        addArray(totals.data(), rhs.totals.constData(), totals.size());
+    }
+
+    void subtract(const HistogramSet &rhs) {
+        subtractArray(counts.data(), rhs.counts.constData(), counts.size());
+        subtractArray(sums.data(), rhs.sums.constData(), sums.size());
+        subtractArray(totals.data(), rhs.totals.constData(), totals.size());
+    }
+
+    QVector<int> counts;
+    QVector<float> sums;
+    QVector<int> totals;
+};
+
+}
+
+KisSlidingHistogram::KisSlidingHistogram(int numHistograms, int numBins, int numValues)
+    : m_numHistograms(numHistograms),
+      m_numBins(numBins),
+      m_numValues(numValues)
+{
+}
+
+void KisSlidingHistogram::apply(KisPaintDeviceSP device,
+                                const QRect &rect,
+                                int radius,
+                                BinningFunction binningFunction,
+                                ResultFunction resultFunction,
+                                KoUpdater *progressUpdater) const
+{
+    if (rect.isEmpty()) return;
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(radius >= 0);
+
+    const int numHistograms = m_numHistograms;
+    const int numBins = m_numBins;
+    const int numValues = m_numValues;
+    const int pixelSize = device->pixelSize();
+    const int windowSize = 2 * radius + 1;
+
+    KisPaintDeviceSP source = new KisPaintDevice(*device);
+
+    const QVector<QRect> blocks = KritaUtils::splitRectIntoPatches(rect, QSize(256, 64));
+    QAtomicInt numProcessedBlocks;
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(0);
+    }
+
+    KritaUtils::parallelMap(blocks,
+        [&] (const QRect &block) {
+            if (progressUpdater && progressUpdater->interrupted()) return;
+
+            const QRect srcRect = block.adjusted(-radius, -radius, radius, radius);
+            const int srcWidth = srcRect.width();
+            const int srcHeight = srcRect.height();
+
+            QVector<quint8> pixels(srcWidth * srcHeight * pixelSize);
+            source->readBytes(pixels.data(), srcRect);
+
+            QVector<int> bins(srcWidth * srcHeight * numHistograms);
+            QVector<float> values(srcWidth * srcHeight * numHistograms * numValues);
+
+            for (int row = 0; row < srcHeight; row++) {
+                const int offset = row * srcWidth;
+                binningFunction(pixels.constData() + offset * pixelSize, srcWidth,
+                                bins.data() + offset * numHistograms,
+                                values.data() + offset * numHistograms * numValues);
+            }
+
+            auto updateColumn = [&] (HistogramSet &column, int x, int y, int sign) {
+                const int offset = y * srcWidth + x;
+                const int *pixelBins = bins.constData() + offset * numHistograms;
+                const float *pixelValues = values.constData() + offset * numHistograms * numValues;
+
+                for (int h = 0; h < numHistograms; h++) {
+                    const int bin = pixelBins[h];
+                    if (bin < 0) continue;
+
+                    KIS_SAFE_ASSERT_RECOVER(bin < numBins) { continue; }
+
+                    const int index = h * numBins + bin;
+                    column.counts[index] += sign;
+                    column.totals[h] += sign;
+
+                    float *sums = column.sums.data() + index * numValues;
+                    const float *src = pixelValues + h * numValues;
+                    for (int v = 0; v < numValues; v++) {
+                        sums[v] += sign * src[v];
+                    }
+                }
+            };
+
+            QVector<HistogramSet> columns(srcWidth, HistogramSet(numHistograms, numBins, numValues));
+
+            for (int x = 0; x < srcWidth; x++) {
+                for (int y = 0; y < windowSize; y++) {
+                    updateColumn(columns[x], x, y, 1);
+                }
+            }
+
+            HistogramSet kernel(numHistograms, numBins, numValues);
+
+            Window window;
+            window.numBins = numBins;
+            window.numValues = numValues;
+            window.counts = kernel.counts.constData();
+            window.sums = kernel.sums.constData();
+            window.totals = kernel.totals.constData();
+
+            QVector<quint8> result(block.width() * block.height() * pixelSize);
+            QVector<float> scratch;
+
+            for (int row = 0; row < block.height(); row++) {
+                if (row > 0) {
+                    for (int x = 0; x < srcWidth; x++) {
+                        updateColumn(columns[x], x, row - 1, -1);
+                        updateColumn(columns[x], x, row - 1 + windowSize, 1);
+                    }
+                }
+
+                /**
+                 * The window histogram is recalculated from scratch in
+                 * the beginning of every row to avoid accumulating the
+                 * errors in the float sums
+                 */
+                kernel.clear();
+                for (int x = 0; x < windowSize; x++) {
+                    kernel.add(columns[x]);
+                }
+
+                const quint8 *srcPixel =
+                    pixels.constData() + ((row + radius) * srcWidth + radius) * pixelSize;
+                quint8 *dstPixel = result.data() + row * block.width() * pixelSize;
+
+                for (int col = 0; col < block.width(); col++) {
+                    if (col > 0) {
+                        kernel.subtract(columns[col - 1]);
+                        kernel.add(columns[col - 1 + windowSize]);
+                    }
+
+                    resultFunction(window, srcPixel, dstPixel, scratch);
+
+                    srcPixel += pixelSize;
+                    dstPixel += pixelSize;
+                }
+            }
+
+            device->writeBytes(result.constData(), block);
+
+            if (progressUpdater) {
+                progressUpdater->setProgress(100 * (numProcessedBlocks.fetchAndAddOrdered(1) + 1) / blocks.size());
+            }
+        });
+}
@@ -0,0 +1,109 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_SLIDING_HISTOGRAM_H
+#define KIS_SLIDING_HISTOGRAM_H
+
+#include <functional>
+
+#include <QVector>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class QRect;
+class KoUpdater;
+
+/**
+ * @brief Histograms of a square window sliding over a paint device
+ *
+ * The engine calculates the histograms of a (2 * radius + 1)^2 window
+ * around every pixel of the processed rect with constant cost per pixel,
+ * as described by Perreault and Hébert ("Median Filtering in Constant
+ * Time", IEEE Transactions on Image Processing 16, 2007). A histogram is
+ * kept for every column of the window; when moving to the next row, each
+ * column histogram gets one pixel added and one removed, and when moving
+ * to the next pixel, the window histogram gets one column histogram added
+ * and one removed.
+ *
+ * Every pixel may contribute to several independent histograms (e.g. one
+ * per color channel) and every bin may accumulate a few float values
+ * besides the number of pixels (e.g. the sums of the color channels of
+ * the pixels that fell into this bin).
+ *
+ * The rect is split into tile-aligned blocks which are processed in
+ * parallel. The source pixels are read from a copy-on-write snapshot of
+ * the device, so the filters may write the result in-place.
+ */
+class KRITAIMAGE_EXPORT KisSlidingHistogram
+{
+public:
+    /**
+     * The histograms of the window around the current pixel
+     */
+    struct Window {
+        int numBins = 0;
+        int numValues = 0;
+
+        const int *counts = 0;
+        const float *sums = 0;
+        const int *totals = 0;
+
+        /// the number of pixels in every bin of histogram \p histogram
+        inline const int* histogramCounts(int histogram) const {
+            return counts + histogram * numBins;
+        }
+
+        /// the values accumulated in bin \p bin of histogram \p histogram
+        inline const float* binSums(int histogram, int bin) const {
+            return sums + (histogram * numBins + bin) * numValues;
+        }
+
+        /// the total number of pixels counted in histogram \p histogram
+        inline int total(int histogram) const {
+            return totals[histogram];
+        }
+    };
+
+    /**
+     * Converts \p numPixels pixels into the bins of every histogram
+     * (\p bins has numHistograms values per pixel) and the values
+     * accumulated in the bins (\p values has numHistograms * numValues
+     * values per pixel). A negative bin means that the pixel should not
+     * be counted in the histogram.
+     */
+    using BinningFunction = std::function<void(const quint8 *pixels, int numPixels, int *bins, float *values)>;
+
+    /**
+     * Calculates the resulting pixel \p dst from the histograms of the
+     * window around the source pixel \p src. \p scratch is a temporary
+     * storage owned by the calling thread.
+     */
+    using ResultFunction = std::function<void(const Window &window, const quint8 *src, quint8 *dst, QVector<float> &scratch)>;
+
+public:
+    KisSlidingHistogram(int numHistograms, int numBins, int numValues);
+
+    /**
+     * Processes \p rect of \p device in-place. The pixels needed for
+     * the processing are read from \p rect grown by \p radius.
+     *
+     * The functions are called from several threads concurrently.
+     */
+    void apply(KisPaintDeviceSP device,
+               const QRect &rect,
+               int radius,
+               BinningFunction binningFunction,
+               ResultFunction resultFunction,
+               KoUpdater *progressUpdater) const;
+
+private:
+    int m_numHistograms;
+    int m_numBins;
+    int m_numValues;
+};
+
+#endif // KIS_SLIDING_HISTOGRAM_H
@@ -0,0 +1,117 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisThreadBudget.h"
+
+#include <QAtomicInt>
+#include <QGlobalStatic>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "kis_image_config.h"
+
+Q_GLOBAL_STATIC(KisThreadBudget, s_instance)
+
+namespace {
+
+class BudgetedRunnable : public QRunnable
+{
+public:
+    BudgetedRunnable(KisThreadBudget *budget, std::function<void()> func)
+        : m_budget(budget),
+          m_func(func)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override {
+        m_func();
+        m_budget->releaseThread();
+    }
+
+private:
+    KisThreadBudget *m_budget;
+    std::function<void()> m_func;
+};
+
+}
+
+struct KisThreadBudget::Private
+{
+    QAtomicInt limit;
+    QAtomicInt busyThreads;
+
+    /**
+     * The number of running helpers never exceeds the limit,
+     * so the pool just needs to be big enough for all of them
+     */
+    QThreadPool pool;
+};
+
+KisThreadBudget::KisThreadBudget()
+    : m_d(new Private)
+{
+    setLimit(KisImageConfig(true).maxNumberOfThreads());
+}
+
+KisThreadBudget::~KisThreadBudget()
+{
+    m_d->pool.waitForDone();
+}
+
+KisThreadBudget* KisThreadBudget::instance()
+{
+    return s_instance;
+}
+
+void KisThreadBudget::setLimit(int limit)
+{
+    limit = qMax(1, limit);
+
+    m_d->limit.storeRelease(limit);
+    m_d->pool.setMaxThreadCount(limit);
+}
+
+int KisThreadBudget::limit() const
+{
+    return m_d->limit.loadAcquire();
+}
+
+int KisThreadBudget::busyThreads() const
+{
+    return m_d->busyThreads.loadAcquire();
+}
+
+void KisThreadBudget::acquireThread()
+{
+    m_d->busyThreads.ref();
+}
+
+void KisThreadBudget::releaseThread()
+{
+    m_d->busyThreads.deref();
+}
+
+bool KisThreadBudget::tryStart(std::function<void()> func)
+{
+    int busy = m_d->busyThreads.loadAcquire();
+
+    do {
+        if (busy >= m_d->limit.loadAcquire()) {
+            return false;
+        }
+    } while (!m_d->busyThreads.testAndSetOrdered(busy, busy + 1, busy));
+
+    BudgetedRunnable *runnable = new BudgetedRunnable(this, func);
+
+    if (!m_d->pool.tryStart(runnable)) {
+        delete runnable;
+        releaseThread();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,69 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTHREADBUDGET_H
+#define KISTHREADBUDGET_H
+
+#include <functional>
+
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+/**
+ * The number of threads Krita may use for the image processing,
+ * shared by the threads of the updater context and the helper threads
+ * of KritaUtils::runParallelJobs().
+ *
+ * The updater threads are already limited by KisUpdaterContext, so
+ * they just mark themselves busy with acquireThread() and
+ * releaseThread(). The helper threads are started with tryStart()
+ * only when the number of busy threads is below the limit, that is,
+ * when some of the updater threads are idle.
+ *
+ * The limit is read from KisImageConfig::maxNumberOfThreads() once and
+ * then updated by KisUpdateScheduler when the configuration changes.
+ */
+class KRITAIMAGE_EXPORT KisThreadBudget
+{
+public:
+    KisThreadBudget();
+    ~KisThreadBudget();
+
+    static KisThreadBudget* instance();
+
+    void setLimit(int limit);
+    int limit() const;
+
+    /**
+     * The number of threads currently marked as busy
+     */
+    int busyThreads() const;
+
+    /**
+     * Marks the calling thread busy. The thread is counted even when
+     * the limit is already reached, so it should be used only by the
+     * threads that are limited by some other means.
+     */
+    void acquireThread();
+    void releaseThread();
+
+    /**
+     * Runs \p func in a helper thread if the number of busy threads is
+     * below the limit. The helper thread is counted as busy until
+     * \p func returns.
+     *
+     * \return false if there are no free threads, \p func is not
+     *         called in this case
+     */
+    bool tryStart(std::function<void()> func);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTHREADBUDGET_H
@@ -47,6 +47,9 @@ struct Q_DECL_HIDDEN KisPaintOp::Private {
 
     bool fanCornersEnabled {false};
     qreal fanCornersStep {1.0};
+
+    bool batchedPaintingEnabled {true};
+    QVector<KisPaintInformation> dabsBatch;
 };
 
 
@@ -80,6 +83,11 @@ void KisPaintOp::setFanCornersInfo(bool fanCornersEnabled, qreal fanCornersStep)
     d->fanCornersStep = fanCornersStep;
 }
 
+void KisPaintOp::setBatchedPaintingEnabled(bool value)
+{
+    d->batchedPaintingEnabled = value;
+}
+
 void KisPaintOp::splitCoordinate(qreal coordinate, qint32 *whole, qreal *fraction)
 {
     const qint32 i = qFloor(coordinate);
@@ -139,11 +147,88 @@ void KisPaintOp::paintLine(const KisPaintInformation &pi1,
                            const KisPaintInformation &pi2,
                            KisDistanceInformation *currentDistance)
 {
+    if (!d->fanCornersEnabled && d->batchedPaintingEnabled && supportsBatchedPainting()) {
+        paintLineBatched(pi1, pi2, currentDistance);
+        return;
+    }
+
     KisPaintOpUtils::paintLine(*this, pi1, pi2, currentDistance,
                                d->fanCornersEnabled,
                                d->fanCornersStep);
 }
 
+void KisPaintOp::paintLineBatched(const KisPaintInformation &pi1,
+                                  const KisPaintInformation &pi2,
+                                  KisDistanceInformation *currentDistance)
+{
+    /**
+     * The spacing and timing are guaranteed to be the same for all the
+     * dabs of the line (see supportsBatchedPainting()), so we can register
+     * the dabs in the distance information before actually painting them.
+     * The sequence of the registrations is exactly the same as the one in
+     * KisPaintOpUtils::paintLine().
+     */
+    KisSpacingInformation spacingInfo;
+    KisTimingInformation timingInfo;
+    {
+        KisPaintInformation pi(pi1);
+        KisPaintInformation::DistanceInformationRegistrar r =
+            pi.registerDistanceInformation(currentDistance);
+        spacingInfo = updateSpacingImpl(pi);
+        timingInfo = updateTimingImpl(pi);
+    }
+
+    QVector<KisPaintInformation> &batch = d->dabsBatch;
+    batch.clear();
+
+    const QPointF end = pi2.pos();
+    const qreal endTime = pi2.currentTime();
+
+    KisPaintInformation pi = pi1;
+    qreal t = 0.0;
+
+    while ((t = currentDistance->getNextPointPosition(pi.pos(), end, pi.currentTime(), endTime)) >= 0.0) {
+        pi = KisPaintInformation::mix(t, pi, pi2);
+
+        {
+            KisPaintInformation::DistanceInformationRegistrar r =
+                pi.registerDistanceInformation(currentDistance);
+
+            if (!pi.isHoveringMode()) {
+                currentDistance->lockCurrentDrawingAngle(pi);
+            }
+        }
+
+        currentDistance->registerPaintedDab(pi, spacingInfo, timingInfo);
+        batch.append(pi);
+    }
+
+    if (!batch.isEmpty()) {
+        paintAtBatch(batch);
+        batch.clear();
+    }
+
+    // see a comment in KisPaintOpUtils::paintLine()
+    if (currentDistance->needsSpacingUpdate()) {
+        updateSpacing(pi2, *currentDistance);
+    }
+    if (currentDistance->needsTimingUpdate()) {
+        updateTiming(pi2, *currentDistance);
+    }
+}
+
+void KisPaintOp::paintAtBatch(const QVector<KisPaintInformation> &infos)
+{
+    Q_FOREACH (const KisPaintInformation &info, infos) {
+        paintAt(info);
+    }
+}
+
+bool KisPaintOp::supportsBatchedPainting() const
+{
+    return false;
+}
+
 void KisPaintOp::paintAt(const KisPaintInformation& info, KisDistanceInformation *currentDistance)
 {
     Q_ASSERT(currentDistance);
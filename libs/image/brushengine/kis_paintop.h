@@ -11,6 +11,8 @@
 #ifndef KIS_PAINTOP_H_
 #define KIS_PAINTOP_H_
 
+#include <QVector>
+
 #include <kis_distance_information.h>
 #include "kis_shared.h"
 #include "kis_types.h"
@@ -109,6 +111,13 @@ public:
      */
     virtual std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs);
 
+    /**
+     * Enables or disables painting of lines with paintAtBatch() (enabled
+     * by default). Both ways must produce exactly the same result, so it
+     * is useful only for comparing the two code paths in tests.
+     */
+    void setBatchedPaintingEnabled(bool value);
+
 protected:
     friend class KisPaintInformation;
     /**
@@ -117,6 +126,35 @@ protected:
      */
     virtual KisSpacingInformation paintAt(const KisPaintInformation& info) = 0;
 
+    /**
+     * Paints a batch of dabs interpolated along a line. All the samples
+     * in \p infos have already been registered in the distance information
+     * of the stroke, so the drawing angle, distance and other history-based
+     * sensors return the same values as they would in paintAt().
+     *
+     * The paintop may use the batch to evaluate the sensors of its
+     * options for all the dabs at once. The dabs must still be painted
+     * in the order they are passed, because the random sources and
+     * smudging depend on that.
+     *
+     * The method is called only when supportsBatchedPainting() returns
+     * true. The default implementation calls paintAt() for every sample.
+     */
+    virtual void paintAtBatch(const QVector<KisPaintInformation> &infos);
+
+    /**
+     * Returns true if the dabs of a line can be painted with
+     * paintAtBatch(). It is possible only when the spacing and timing
+     * information returned by paintAt() is the same for every dab of the
+     * line, because otherwise the position of every dab depends on the
+     * previous one. Calculation of the spacing and timing must also not
+     * consume any random values, since updateSpacingImpl() and
+     * updateTimingImpl() are called only once per batch.
+     *
+     * The default implementation returns false.
+     */
+    virtual bool supportsBatchedPainting() const;
+
     /**
      * Implementation of a spacing update
      */
@@ -141,6 +179,11 @@ protected:
      */
     KisPaintDeviceSP source() const;
 
+private:
+    void paintLineBatched(const KisPaintInformation &pi1,
+                          const KisPaintInformation &pi2,
+                          KisDistanceInformation *currentDistance);
+
 private:
     friend class KisRotationOption;
     void setFanCornersInfo(bool fanCornersEnabled, qreal fanCornersStep);
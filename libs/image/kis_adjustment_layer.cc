@@ -21,6 +21,7 @@
 #include "filter/kis_filter.h"
 #include "kis_node_visitor.h"
 #include "kis_processing_visitor.h"
+#include "KisPixelLocalFilterCache.h"
 
 
 KisAdjustmentLayer::KisAdjustmentLayer(KisImageWSP image,
@@ -28,6 +29,7 @@ KisAdjustmentLayer::KisAdjustmentLayer(KisImageWSP image,
                                        KisFilterConfigurationSP kfc,
                                        KisSelectionSP selection)
     : KisSelectionBasedLayer(image.data(), name, selection, kfc)
+    , m_filterCache(new KisPixelLocalFilterCache())
 {
     // by default Adjustment Layers have a copy composition,
     // which is more natural for users
@@ -43,6 +45,7 @@ KisAdjustmentLayer::KisAdjustmentLayer(KisImageWSP image,
 
 KisAdjustmentLayer::KisAdjustmentLayer(const KisAdjustmentLayer& rhs)
         : KisSelectionBasedLayer(rhs)
+        , m_filterCache(new KisPixelLocalFilterCache())
 {
 }
 
@@ -55,6 +58,7 @@ void KisAdjustmentLayer::setFilter(KisFilterConfigurationSP filterConfig, bool c
 {
     filterConfig->setChannelFlags(channelFlags());
     KisSelectionBasedLayer::setFilter(filterConfig, checkCompareConfig);
+    m_filterCache->reset();
 }
 
 QRect KisAdjustmentLayer::incomingChangeRect(const QRect &rect) const
@@ -133,6 +137,21 @@ void KisAdjustmentLayer::setChannelFlags(const QBitArray & channelFlags)
     if (filterConfig) {
         filterConfig->setChannelFlags(channelFlags);
     }
+    m_filterCache->reset();
     KisLayer::setChannelFlags(channelFlags);
 }
 
+void KisAdjustmentLayer::setVisible(bool visible, bool loading)
+{
+    if (visible != this->visible()) {
+        m_filterCache->reset();
+    }
+
+    KisSelectionBasedLayer::setVisible(visible, loading);
+}
+
+KisPixelLocalFilterCache* KisAdjustmentLayer::pixelLocalFilterCache() const
+{
+    return m_filterCache.data();
+}
+
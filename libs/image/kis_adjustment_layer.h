@@ -17,10 +17,12 @@
 #define KIS_ADJUSTMENT_LAYER_H_
 
 #include <QObject>
+#include <QScopedPointer>
 #include <kritaimage_export.h>
 #include "kis_selection_based_layer.h"
 
 class KisFilterConfiguration;
+class KisPixelLocalFilterCache;
 
 class KRITAIMAGE_EXPORT KisAdjustmentLayer : public KisSelectionBasedLayer
 {
@@ -78,6 +80,14 @@ public:
 
     void setChannelFlags(const QBitArray & channelFlags) override;
 
+    void setVisible(bool visible, bool loading = false) override;
+
+    /**
+     * The cache of the filtered tiles used by the merger for
+     * pixel-local filters
+     */
+    KisPixelLocalFilterCache* pixelLocalFilterCache() const;
+
 protected:
     // override from KisLayer
     QRect incomingChangeRect(const QRect &rect) const override;
@@ -93,6 +103,9 @@ public Q_SLOTS:
     KisLayer* layer() {
         return this;
     }
+
+private:
+    QScopedPointer<KisPixelLocalFilterCache> m_filterCache;
 };
 
 #endif // KIS_ADJUSTMENT_LAYER_H_
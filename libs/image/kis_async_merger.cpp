@@ -33,6 +33,10 @@
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "kis_layer_projection_plane.h"
+#include "kis_image_config.h"
+#include "KisPremultipliedProjectionUtils.h"
+#include "KisPixelLocalFilterCache.h"
 
 
 //#define DEBUG_MERGER
@@ -48,10 +52,11 @@
 class KisUpdateOriginalVisitor : public KisNodeVisitor
 {
 public:
-    KisUpdateOriginalVisitor(const QRect &updateRect, KisPaintDeviceSP projection, const QRect &cropRect)
+    KisUpdateOriginalVisitor(const QRect &updateRect, KisPaintDeviceSP projection, const QRect &cropRect, KisNodeSP startNode)
         : m_updateRect(updateRect),
           m_cropRect(cropRect),
-          m_projection(projection)
+          m_projection(projection),
+          m_startNode(startNode)
         {
         }
 
@@ -110,8 +115,19 @@ public:
             KIS_ASSERT_RECOVER_NOOP(layer->busyProgressIndicator());
             layer->busyProgressIndicator()->update();
 
+            /**
+             * When the walker has been started from the layer itself or
+             * from one of its masks, the layers below it are unchanged,
+             * so the filtered tiles can be reused
+             */
+            const bool sourceChanged =
+                !m_startNode ||
+                (m_startNode != layer && m_startNode->parent() != layer);
+
             // We do not create a transaction here, as srcDevice != dstDevice
-            filter->process(m_projection, dstDevice, 0, filterRect, filterConfig.data(), 0);
+            layer->pixelLocalFilterCache()->process(filter, m_projection, dstDevice, filterRect, filterConfig,
+                                                    KisPixelLocalFilterCache::sourceSignature(layer),
+                                                    sourceChanged);
         }
 
         if (selection) {
@@ -196,6 +212,7 @@ private:
     QRect m_updateRect;
     QRect m_cropRect;
     KisPaintDeviceSP m_projection;
+    KisNodeSP m_startNode;
 };
 
 
@@ -203,6 +220,11 @@ private:
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
 
+KisAsyncMerger::KisAsyncMerger()
+    : m_usePremultipliedComposition(KisImageConfig(true).premultipliedGroupComposition())
+{
+}
+
 void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
     KisMergeWalker::LeafStack &leafStack = walker.leafStack();
 
@@ -225,6 +247,18 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         QRect applyRect = item.m_applyRect;
 
+        /**
+         * Everything except compositing of the simple layers may read
+         * the current projection, so it should be converted back into
+         * straight form first.
+         */
+        if (!m_premultipliedRect.isEmpty() &&
+            ((item.m_position & KisMergeWalker::N_EXTRA) ||
+             !canCompositePremultiplied(currentLeaf))) {
+
+            unpremultiplyProjection();
+        }
+
         if (currentLeaf->isRoot()) {
             currentLeaf->projectionPlane()->recalculate(applyRect, walker.startNode());
             continue;
@@ -236,7 +270,8 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
             DEBUG_NODE_ACTION("Updating", "N_EXTRA", currentLeaf, applyRect);
             KisUpdateOriginalVisitor originalVisitor(applyRect,
                                                      m_currentProjection,
-                                                     walker.cropRect());
+                                                     walker.cropRect(),
+                                                     walker.startNode());
             currentLeaf->accept(originalVisitor);
             currentLeaf->projectionPlane()->recalculate(applyRect, currentLeaf->node());
 
@@ -250,7 +285,8 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         KisUpdateOriginalVisitor originalVisitor(applyRect,
                                                  m_currentProjection,
-                                                 walker.cropRect());
+                                                 walker.cropRect(),
+                                                 walker.startNode());
 
         if(item.m_position & KisMergeWalker::N_FILTHY) {
             DEBUG_NODE_ACTION("Updating", "N_FILTHY", currentLeaf, applyRect);
@@ -306,6 +342,7 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 }
 
 void KisAsyncMerger::resetProjection() {
+    unpremultiplyProjection();
     m_currentProjection = 0;
     m_finalProjection = 0;
 }
@@ -343,6 +380,8 @@ void KisAsyncMerger::writeProjection(KisProjectionLeafSP topmostLeaf, bool useTe
     Q_UNUSED(topmostLeaf);
     if (!m_currentProjection) return;
 
+    unpremultiplyProjection();
+
     if(m_currentProjection != m_finalProjection) {
         KisPainter::copyAreaOptimized(rect.topLeft(), m_currentProjection, m_finalProjection, rect);
     }
@@ -354,6 +393,14 @@ bool KisAsyncMerger::compositeWithProjection(KisProjectionLeafSP leaf, const QRe
     if (!m_currentProjection) return true;
     if (!leaf->visible()) return true;
 
+    if (canCompositePremultiplied(leaf)) {
+        compositePremultiplied(leaf, rect);
+        DEBUG_NODE_ACTION("Compositing projection (premultiplied)", "", leaf, rect);
+        return true;
+    }
+
+    unpremultiplyProjection();
+
     KisPainter gc(m_currentProjection);
     leaf->projectionPlane()->apply(&gc, rect);
 
@@ -361,6 +408,50 @@ bool KisAsyncMerger::compositeWithProjection(KisProjectionLeafSP leaf, const QRe
     return true;
 }
 
+bool KisAsyncMerger::canCompositePremultiplied(KisProjectionLeafSP leaf) const {
+    if (!m_usePremultipliedComposition || !m_currentProjection) return false;
+    if (leaf->isRoot() || leaf->dependsOnLowerNodes()) return false;
+    if (leaf->node()->compositeOpId() != COMPOSITE_OVER) return false;
+
+    const QBitArray channelFlags = leaf->channelFlags();
+    if (!channelFlags.isEmpty() &&
+        channelFlags != QBitArray(channelFlags.size(), true)) {
+
+        return false;
+    }
+
+    // layer styles have their own way of composition
+    if (!dynamic_cast<KisLayerProjectionPlane*>(leaf->projectionPlane().data())) {
+        return false;
+    }
+
+    KisPaintDeviceSP device = leaf->projection();
+
+    return device &&
+        *device->colorSpace() == *m_currentProjection->colorSpace() &&
+        KisPremultipliedProjectionUtils::canBePremultiplied(m_currentProjection);
+}
+
+void KisAsyncMerger::compositePremultiplied(KisProjectionLeafSP leaf, const QRect &rect) {
+    if (!m_premultipliedRect.contains(rect)) {
+        unpremultiplyProjection();
+        KisPremultipliedProjectionUtils::premultiply(m_currentProjection, rect);
+        m_premultipliedRect = rect;
+    }
+
+    KisPremultipliedProjectionUtils::compositeOver(m_currentProjection,
+                                                   leaf->projection(),
+                                                   rect,
+                                                   leaf->opacity());
+}
+
+void KisAsyncMerger::unpremultiplyProjection() {
+    if (m_premultipliedRect.isEmpty()) return;
+
+    KisPremultipliedProjectionUtils::unpremultiply(m_currentProjection, m_premultipliedRect);
+    m_premultipliedRect = QRect();
+}
+
 void KisAsyncMerger::doNotifyClones(KisBaseRectsWalker &walker) {
     KisBaseRectsWalker::CloneNotificationsVector &vector =
         walker.cloneNotifications();
@@ -9,12 +9,15 @@
 #include "kritaimage_export.h"
 #include "kis_types.h"
 
-class QRect;
+#include <QRect>
+
 class KisBaseRectsWalker;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
 public:
+    KisAsyncMerger();
+
     void startMerge(KisBaseRectsWalker &walker, bool notifyClones = true);
 
 private:
@@ -24,6 +27,10 @@ private:
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
     inline void doNotifyClones(KisBaseRectsWalker &walker);
 
+    inline bool canCompositePremultiplied(KisProjectionLeafSP leaf) const;
+    inline void compositePremultiplied(KisProjectionLeafSP leaf, const QRect &rect);
+    inline void unpremultiplyProjection();
+
 private:
     /**
      * The place where intermediate results of layer's merge
@@ -49,6 +56,15 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    /**
+     * When enabled, the layers with "normal" blending mode are composited
+     * into RGBA F32 projections in premultiplied form. m_premultipliedRect
+     * is the area of m_currentProjection that is currently premultiplied.
+     * It is converted back before the projection is used by anything else.
+     */
+    bool m_usePremultipliedComposition {false};
+    QRect m_premultipliedRect;
 };
 
 
@@ -39,6 +39,7 @@ struct Q_DECL_HIDDEN KisBaseProcessor::Private {
             , supportsPainting(false)
             , supportsAdjustmentLayers(true)
             , supportsThreading(true)
+            , isPixelLocal(false)
             , showConfigurationWidget(true)
             , colorSpaceIndependence(FULLY_INDEPENDENT) {
     }
@@ -52,6 +53,7 @@ struct Q_DECL_HIDDEN KisBaseProcessor::Private {
     bool supportsPainting;
     bool supportsAdjustmentLayers;
     bool supportsThreading;
+    bool isPixelLocal;
     bool showConfigurationWidget;
     ColorSpaceIndependence colorSpaceIndependence;
 };
@@ -145,6 +147,11 @@ bool KisBaseProcessor::supportsThreading() const
     return d->supportsThreading;
 }
 
+bool KisBaseProcessor::isPixelLocal() const
+{
+    return d->isPixelLocal;
+}
+
 ColorSpaceIndependence KisBaseProcessor::colorSpaceIndependence() const
 {
     return d->colorSpaceIndependence;
@@ -165,6 +172,11 @@ void KisBaseProcessor::setSupportsThreading(bool v)
     d->supportsThreading = v;
 }
 
+void KisBaseProcessor::setPixelLocal(bool v)
+{
+    d->isPixelLocal = v;
+}
+
 void KisBaseProcessor::setColorSpaceIndependence(ColorSpaceIndependence v)
 {
     d->colorSpaceIndependence = v;
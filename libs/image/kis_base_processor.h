@@ -122,6 +122,16 @@ public:
      */
     bool supportsThreading() const;
 
+    /**
+     * A pixel-local filter calculates every output pixel from the
+     * corresponding input pixel only (and, possibly, its position).
+     * The output of such filters can be cached and re-rendered
+     * per-tile, only where the source has actually changed.
+     *
+     * @see KisPixelLocalFilterCache
+     */
+    bool isPixelLocal() const;
+
     /// If true, the filter wants to show a configuration widget
     bool showConfigurationWidget();
 
@@ -142,6 +152,7 @@ protected:
     void setSupportsPainting(bool v);
     void setSupportsAdjustmentLayers(bool v);
     void setSupportsThreading(bool v);
+    void setPixelLocal(bool v);
     void setColorSpaceIndependence(ColorSpaceIndependence v);
     void setShowConfigurationWidget(bool v);
 
@@ -56,6 +56,7 @@ bool KisConvolutionPainter::useFFTImplementation(const KisConvolutionKernelSP ke
 
     result =
         m_enginePreference == FFTW ||
+        m_enginePreference == FFTW_SINGLE_PASS ||
         (m_enginePreference == NONE &&
          (kernel->width() > THRESHOLD_SIZE ||
           kernel->height() > THRESHOLD_SIZE));
@@ -75,7 +76,8 @@ KisConvolutionWorker<factory>* KisConvolutionPainter::createWorker(const KisConv
 
 #ifdef HAVE_FFTW3
     if (useFFTImplementation(kernel)) {
-        worker = new KisConvolutionWorkerFFT<factory>(painter, progress);
+        worker = new KisConvolutionWorkerFFT<factory>(painter, progress,
+                                                      m_enginePreference != FFTW_SINGLE_PASS);
     } else {
         worker = new KisConvolutionWorkerSpatial<factory>(painter, progress);
     }
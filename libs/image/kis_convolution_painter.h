@@ -38,7 +38,8 @@ public:
     enum EnginePreference {
         NONE,
         SPATIAL,
-        FFTW
+        FFTW,
+        FFTW_SINGLE_PASS ///< FFTW without splitting the area into tiles, used for benchmarking
     };
 
 
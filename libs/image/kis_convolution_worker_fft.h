@@ -23,23 +23,21 @@
 
 #include <fftw3.h>
 
-template<class _IteratorFactory_> class KisConvolutionWorkerFFT;
-class KisConvolutionWorkerFFTLock
-{
-private:
-    static QMutex fftwMutex;
-    template<class _IteratorFactory_> friend class KisConvolutionWorkerFFT;
-};
-
-QMutex KisConvolutionWorkerFFTLock::fftwMutex;
+#include "KisFFTWPlanCache.h"
+#include "krita_utils.h"
 
 
 template<class _IteratorFactory_>
 class KisConvolutionWorkerFFT : public KisConvolutionWorker<_IteratorFactory_>
 {
 public:
-    KisConvolutionWorkerFFT(KisPainter *painter, KoUpdater *progress)
-        : KisConvolutionWorker<_IteratorFactory_>(painter, progress)
+    /**
+     * When \p allowTiling is true, big areas are split into tiles, which
+     * are convolved in parallel using the cached FFTW plans
+     */
+    KisConvolutionWorkerFFT(KisPainter *painter, KoUpdater *progress, bool allowTiling = true)
+        : KisConvolutionWorker<_IteratorFactory_>(painter, progress),
+          m_allowTiling(allowTiling)
     {
     }
 
@@ -72,6 +70,17 @@ public:
         const quint32 halfKernelWidth = (kernel->width() - 1) / 2;
         const quint32 halfKernelHeight = (kernel->height() - 1) / 2;
 
+        if (m_allowTiling) {
+            const TileGeometry geometry = calculateTileGeometry(halfKernelWidth, halfKernelHeight);
+
+            if (areaSize.width() > geometry.tileWidth ||
+                areaSize.height() > geometry.tileHeight) {
+
+                executeTiled(kernel, src, srcPos, dstPos, areaSize, dataRect, geometry);
+                return;
+            }
+        }
+
         m_fftWidth = areaSize.width() + 4 * halfKernelWidth;
         m_fftHeight = areaSize.height() + 2 * halfKernelHeight;
 
@@ -110,7 +119,8 @@ public:
                                   m_fftWidth,
                                   m_fftHeight),
                             cacheRowStride,
-                            info, dataRect);
+                            info, dataRect,
+                            channelPointers());
 
         addToProgress(10);
         if (isInterrupted()) return;
@@ -121,10 +131,10 @@ public:
         // perform FFT
         fftw_plan fftwPlanForward, fftwPlanBackward;
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
+        KisFFTWPlanCache::plannerMutex().lock();
         fftwPlanForward = fftw_plan_dft_r2c_2d(m_fftHeight, m_fftWidth, (double*)m_kernelFFT, m_kernelFFT, FFTW_ESTIMATE);
         fftwPlanBackward = fftw_plan_dft_c2r_2d(m_fftHeight, m_fftWidth, m_kernelFFT, (double*)m_kernelFFT, FFTW_ESTIMATE);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+        KisFFTWPlanCache::plannerMutex().unlock();
 
         fftw_execute(fftwPlanForward);
         addToProgress(progressPerFFT);
@@ -143,15 +153,16 @@ public:
             if (isInterrupted()) return;
         }
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
+        KisFFTWPlanCache::plannerMutex().lock();
         fftw_destroy_plan(fftwPlanForward);
         fftw_destroy_plan(fftwPlanBackward);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+        KisFFTWPlanCache::plannerMutex().unlock();
 
 
         writeResultToDevice(QRect(dstPos.x(), dstPos.y(), areaSize.width(), areaSize.height()),
                             cacheRowStride, halfKernelWidth, halfKernelHeight,
-                            info, dataRect);
+                            info, dataRect,
+                            channelPointers());
 
         addToProgress(20);
         cleanUp();
@@ -213,7 +224,8 @@ public:
                              const QRect &rect,
                              const int cacheRowStride,
                              const FFTInfo &info,
-                             const QRect &dataRect) {
+                             const QRect &dataRect,
+                             const QVector<double*> &channels) {
 
         typename _IteratorFactory_::HLineConstIterator hitSrc =
             _IteratorFactory_::createHLineConstIterator(src,
@@ -221,15 +233,10 @@ public:
                                                         dataRect);
 
         const int channelCount = info.numChannels();
-        QVector<double*> channelPtr(channelCount);
+        QVector<double*> channelPtr = channels;
         const auto channelPtrBegin = channelPtr.begin();
         const auto channelPtrEnd = channelPtr.end();
 
-        auto iFFt = m_channelFFT.constBegin();
-        for (auto i = channelPtrBegin; i != channelPtrEnd; ++i, ++iFFt) {
-            *i = (double*)*iFFt;
-        }
-
         // prepare cache, reused in all loops
         QVector<double*> cacheRowStart(channelCount);
         const auto cacheRowStartBegin = cacheRowStart.begin();
@@ -318,7 +325,8 @@ public:
                              const int halfKernelWidth,
                              const int halfKernelHeight,
                              const FFTInfo &info,
-                             const QRect &dataRect) {
+                             const QRect &dataRect,
+                             const QVector<double*> &channels) {
 
         typename _IteratorFactory_::HLineIterator hitDst =
             _IteratorFactory_::createHLineIterator(this->m_painter->device(),
@@ -332,9 +340,9 @@ public:
         const auto channelPtrBegin = channelPtr.begin();
         const auto channelPtrEnd = channelPtr.end();
 
-        auto iFFt = m_channelFFT.constBegin();
-        for (auto i = channelPtrBegin; i != channelPtrEnd; ++i, ++iFFt) {
-            *i = (double*)*iFFt + initialOffset;
+        auto iChannel = channels.constBegin();
+        for (auto i = channelPtrBegin; i != channelPtrEnd; ++i, ++iChannel) {
+            *i = *iChannel + initialOffset;
         }
 
         // prepare cache, reused in all loops
@@ -410,6 +418,222 @@ public:
     }
 
 private:
+    struct TileGeometry {
+        int fftWidth {0};
+        int fftHeight {0};
+        int tileWidth {0};
+        int tileHeight {0};
+    };
+
+    struct Tile {
+        QRect dstRect;
+
+        /// the source area of the tile including the borders needed by the kernel
+        QRect srcRect;
+
+        /// the convolved channels of the tile, stored one after another
+        QVector<double> result;
+    };
+
+    /**
+     * The tiles are aligned to the tiles of the paint device, so
+     * every tile of the device is written by a single thread only
+     */
+    static const int tileAlignment = 64;
+    static const int minimalTileSize = 192;
+
+    static int alignDown(int value)
+    {
+        return value - ((value % tileAlignment) + tileAlignment) % tileAlignment;
+    }
+
+    static int optimalFFTSize(int size)
+    {
+        // FFTW is most efficient when array size is a factor of 2, 3, 5 or 7
+        for (;; size++) {
+            int n = size;
+
+            for (int factor : {2, 3, 5, 7}) {
+                while (n % factor == 0) {
+                    n /= factor;
+                }
+            }
+
+            if (n == 1) return size;
+        }
+    }
+
+    /**
+     * Chooses the size of the FFT so that at least a half of
+     * the transformed area is used for the result of the tile
+     */
+    static TileGeometry calculateTileGeometry(int halfKernelWidth, int halfKernelHeight)
+    {
+        auto calculate = [] (int border, int *fftSize, int *tileSize) {
+            const int size = alignDown(qMax(minimalTileSize, border) + tileAlignment - 1);
+            *fftSize = optimalFFTSize(size + border);
+            *tileSize = alignDown(*fftSize - border);
+        };
+
+        TileGeometry geometry;
+        calculate(2 * halfKernelWidth, &geometry.fftWidth, &geometry.tileWidth);
+        calculate(2 * halfKernelHeight, &geometry.fftHeight, &geometry.tileHeight);
+
+        return geometry;
+    }
+
+    /**
+     * Overlap-save convolution: the area is split into tiles, every tile
+     * is convolved separately with the source borders needed by the kernel
+     * and the borders are discarded from the result. The tiles have the
+     * same size, so the plans and the transformed kernel are shared by all
+     * of them and the tiles are processed in parallel.
+     */
+    void executeTiled(const KisConvolutionKernelSP kernel,
+                      const KisPaintDeviceSP src,
+                      QPoint srcPos,
+                      QPoint dstPos,
+                      QSize areaSize,
+                      const QRect &dataRect,
+                      const TileGeometry &geometry)
+    {
+        const int halfKernelWidth = (kernel->width() - 1) / 2;
+        const int halfKernelHeight = (kernel->height() - 1) / 2;
+
+        m_fftWidth = geometry.fftWidth;
+        m_fftHeight = geometry.fftHeight;
+        m_fftLength = m_fftHeight * (m_fftWidth / 2 + 1);
+        m_extraMem = (m_fftWidth % 2) ? 1 : 2;
+
+        const int cacheRowStride = m_fftWidth + m_extraMem;
+
+        const KisFFTWPlanCache::Plans plans =
+            KisFFTWPlanCache::instance()->plans(m_fftWidth, m_fftHeight);
+
+        // the kernel is transformed once and shared by all the tiles
+        m_kernelFFT = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
+        memset(m_kernelFFT, 0, sizeof(fftw_complex) * m_fftLength);
+        fftFillKernelMatrix(kernel, m_kernelFFT);
+        fftw_execute_dft_r2c(plans.forward, (double*)m_kernelFFT, m_kernelFFT);
+
+        QList<KoChannelInfo*> convChannelList = this->convolvableChannelList(src);
+
+        const double kernelFactor = kernel->factor() ? kernel->factor() : 1;
+        const double fftScale = 1.0 / (m_fftHeight * m_fftWidth) / kernelFactor;
+
+        FFTInfo info (fftScale, convChannelList, kernel, this->m_painter->device()->colorSpace());
+
+        addToProgress(10);
+        if (isInterrupted()) return;
+
+        const QRect dstRect(dstPos, areaSize);
+        const QPoint srcOffset = srcPos - dstPos;
+
+        QVector<Tile> tiles;
+
+        for (int y = alignDown(dstRect.top()); y <= dstRect.bottom(); y += geometry.tileHeight) {
+            for (int x = alignDown(dstRect.left()); x <= dstRect.right(); x += geometry.tileWidth) {
+                Tile tile;
+                tile.dstRect = QRect(x, y, geometry.tileWidth, geometry.tileHeight) & dstRect;
+                tile.srcRect = tile.dstRect.translated(srcOffset)
+                        .adjusted(-halfKernelWidth, -halfKernelHeight,
+                                  halfKernelWidth, halfKernelHeight);
+                tiles << tile;
+            }
+        }
+
+        KoUpdater *progress = this->m_progress;
+
+        /**
+         * All the tiles are read and convolved before writing
+         * anything, because the source and the destination devices
+         * may coincide
+         */
+        KritaUtils::parallelMap(tiles,
+            [&] (Tile &tile) {
+                if (progress && progress->interrupted()) return;
+
+                convolveTile(tile, src, plans, info, cacheRowStride,
+                             halfKernelWidth, halfKernelHeight, dataRect);
+            });
+
+        addToProgress(70);
+        if (isInterrupted()) return;
+
+        KritaUtils::parallelMap(tiles,
+            [&] (Tile &tile) {
+                const int numPixels = tile.dstRect.width() * tile.dstRect.height();
+
+                QVector<double*> channels(info.numChannels());
+                for (int k = 0; k < channels.size(); k++) {
+                    channels[k] = tile.result.data() + k * numPixels;
+                }
+
+                writeResultToDevice(tile.dstRect, tile.dstRect.width(), 0, 0,
+                                    info, dataRect, channels);
+
+                tile.result = QVector<double>();
+            });
+
+        addToProgress(20);
+        cleanUp();
+    }
+
+    void convolveTile(Tile &tile,
+                      const KisPaintDeviceSP src,
+                      const KisFFTWPlanCache::Plans &plans,
+                      const FFTInfo &info,
+                      const int cacheRowStride,
+                      const int halfKernelWidth,
+                      const int halfKernelHeight,
+                      const QRect &dataRect)
+    {
+        const int channelCount = info.numChannels();
+
+        QVector<double*> channels(channelCount);
+        for (auto it = channels.begin(); it != channels.end(); ++it) {
+            *it = (double*)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
+
+            // the edge tiles don't fill the whole array
+            memset(*it, 0, sizeof(fftw_complex) * m_fftLength);
+        }
+
+        fillCacheFromDevice(src, tile.srcRect, cacheRowStride, info, dataRect, channels);
+
+        const int width = tile.dstRect.width();
+        const int height = tile.dstRect.height();
+
+        tile.result.resize(channelCount * width * height);
+        double *dstPtr = tile.result.data();
+
+        Q_FOREACH (double *channel, channels) {
+            fftw_execute_dft_r2c(plans.forward, channel, (fftw_complex*)channel);
+            fftMultiply((fftw_complex*)channel, m_kernelFFT);
+            fftw_execute_dft_c2r(plans.backward, (fftw_complex*)channel, channel);
+
+            const double *srcPtr = channel + halfKernelHeight * cacheRowStride + halfKernelWidth;
+
+            for (int y = 0; y < height; y++) {
+                memcpy(dstPtr, srcPtr, width * sizeof(double));
+                dstPtr += width;
+                srcPtr += cacheRowStride;
+            }
+
+            fftw_free(channel);
+        }
+    }
+
+    QVector<double*> channelPointers() const
+    {
+        QVector<double*> channels;
+
+        Q_FOREACH (fftw_complex *channel, m_channelFFT) {
+            channels << (double*)channel;
+        }
+
+        return channels;
+    }
+
     void fftFillKernelMatrix(const KisConvolutionKernelSP kernel, fftw_complex *m_kernelFFT)
     {
         // find central item
@@ -482,14 +706,14 @@ private:
 
     void fftLogMatrix(double* channel, const QString &f)
     {
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
+        KisFFTWPlanCache::plannerMutex().lock();
         QString filename(QDir::homePath() + "/log_" + f + ".txt");
         dbgKrita << "Log File Name: " << filename;
         QFile file (filename);
         if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
         {
             dbgKrita << "Failed";
-            KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+            KisFFTWPlanCache::plannerMutex().unlock();
             return;
         }
 
@@ -507,7 +731,7 @@ private:
             }
             in << "\n";
         }
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+        KisFFTWPlanCache::plannerMutex().unlock();
     }
 
     void addToProgress(float amount)
@@ -534,6 +758,7 @@ private:
         // free kernel fft data
         if (m_kernelFFT) {
             fftw_free(m_kernelFFT);
+            m_kernelFFT = 0;
         }
 
         Q_FOREACH (fftw_complex *channel, m_channelFFT) {
@@ -542,6 +767,8 @@ private:
         m_channelFFT.clear();
     }
 private:
+    bool m_allowTiling {true};
+
     quint32 m_fftWidth {0};
     quint32 m_fftHeight {0};
     quint32 m_fftLength {0};
@@ -14,6 +14,318 @@
 #include <kis_iterator_ng.h>
 #include <QVector3D>
 
+#include <functional>
+
+#include <QAtomicInt>
+#include <QBitArray>
+#include <QScopedPointer>
+
+#include <KoUpdater.h>
+
+#include "kis_convolution_worker.h"
+#include "kis_default_bounds.h"
+#include "KisDecomposedConvolutionOps.h"
+#include "KisEdgeDetectionOps.h"
+#include "KisPremultipliedChannelsInfo_p.h"
+#include "krita_utils.h"
+
+namespace {
+
+/**
+ * Bigger kernels are processed by KisConvolutionWorkerFFT, so we
+ * replace only the spatial convolution
+ */
+const int maximumFusedKernelSize = 5;
+
+/**
+ * A non-zero weight of the kernel, \p x and \p y are the position
+ * of the source pixel relative to the top-left corner of the source
+ * area of the output pixel
+ */
+struct GradientTap {
+    int x = 0;
+    int y = 0;
+    float weight = 0.0f;
+};
+
+struct GradientKernel {
+    QVector<GradientTap> taps;
+    float kernelFactor = 1.0f;
+    float offset = 0.0f;
+};
+
+/**
+ * Returns true if the gradients can be calculated by
+ * applyFusedGradient(), that is, the result will be the same as
+ * the one of KisConvolutionWorkerSpatial
+ */
+bool canUseFusedGradient(const KoColorSpace *cs,
+                         const QBitArray &channelFlags,
+                         KisConvolutionKernelSP kernelX,
+                         KisConvolutionKernelSP kernelY)
+{
+    const KisConvolutionKernelSP kernels[2] = {kernelX, kernelY};
+
+    for (const KisConvolutionKernelSP &kernel : kernels) {
+        if (kernel->width() > maximumFusedKernelSize ||
+            kernel->height() > maximumFusedKernelSize) {
+
+            return false;
+        }
+    }
+
+    if (!channelFlags.isEmpty() && channelFlags.count(true) != channelFlags.size()) {
+        return false;
+    }
+
+    if (cs->alphaPos() < 0) {
+        return false;
+    }
+
+    Q_FOREACH (const KoChannelInfo *channel, cs->channels()) {
+        if (channel->channelValueType() != KoChannelInfo::UINT8 &&
+            channel->channelValueType() != KoChannelInfo::UINT16) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Receives the gradients of every channel of \p numPixels pixels in
+ * the form of the normalized channel values of the gradient devices
+ * minus 0.5 and writes the result into \p pixels. The pixels initially
+ * contain the original data of the device.
+ */
+using GradientFunction = std::function<void(const QVector<const float*> &dx, const QVector<const float*> &dy,
+                                            quint8 *pixels, int numPixels)>;
+
+/**
+ * Calculates the horizontal and vertical gradients in a single pass
+ * over tile-aligned blocks processed in parallel. The gradients are
+ * the same as the ones written by KisConvolutionPainter::applyMatrix()
+ * into the temporary devices with BORDER_REPEAT, including the
+ * premultiplication by alpha, clamping and rounding of the channel
+ * values, but they are passed to \p func without creating any
+ * temporary devices.
+ */
+void applyFusedGradient(KisPaintDeviceSP device,
+                        const QRect &rect,
+                        KisConvolutionKernelSP kernelX,
+                        KisConvolutionKernelSP kernelY,
+                        KoUpdater *progressUpdater,
+                        GradientFunction func)
+{
+    if (rect.isEmpty()) return;
+
+    /**
+     * The same border handling as KisConvolutionPainter::applyMatrix() does
+     */
+    KisConvolutionBorderOp borderOp = BORDER_REPEAT;
+
+    if (device->defaultBounds()->wrapAroundMode()) {
+        borderOp = BORDER_IGNORE;
+    }
+
+    QRect dataRect;
+
+    if (borderOp == BORDER_REPEAT) {
+        const QRect boundsRect = device->defaultBounds()->bounds();
+        dataRect = rect | boundsRect;
+
+        KIS_SAFE_ASSERT_RECOVER(boundsRect != KisDefaultBounds().bounds()) {
+            dataRect = rect | device->exactBounds();
+        }
+    }
+
+    const KoColorSpace *cs = device->colorSpace();
+    const KisPremultipliedChannelsInfo info(cs, QBitArray());
+    const int numChannels = info.numChannels();
+    const int alphaPos = info.alphaCachePos;
+    const int pixelSize = cs->pixelSize();
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(alphaPos >= 0);
+
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+
+    const KisConvolutionKernelSP sourceKernels[2] = {kernelX, kernelY};
+
+    for (const KisConvolutionKernelSP &kernel : sourceKernels) {
+        const int halfWidth = (kernel->width() - 1) / 2;
+        const int halfHeight = (kernel->height() - 1) / 2;
+
+        left = qMax(left, halfWidth);
+        top = qMax(top, halfHeight);
+        right = qMax(right, int(kernel->width()) - 1 - halfWidth);
+        bottom = qMax(bottom, int(kernel->height()) - 1 - halfHeight);
+    }
+
+    auto prepareKernel = [&] (const KisConvolutionKernelSP kernel) {
+        GradientKernel result;
+
+        const int kw = kernel->width();
+        const int kh = kernel->height();
+        const int halfWidth = (kw - 1) / 2;
+        const int halfHeight = (kh - 1) / 2;
+
+        // KisConvolutionWorkerSpatial applies the kernel flipped
+        for (int row = 0; row < kh; row++) {
+            for (int col = 0; col < kw; col++) {
+                const qreal weight = (*(kernel->data()))(kh - 1 - row, kw - 1 - col);
+                if (weight == 0.0) continue;
+
+                GradientTap tap;
+                tap.x = left + col - halfWidth;
+                tap.y = top + row - halfHeight;
+                tap.weight = weight;
+                result.taps << tap;
+            }
+        }
+
+        result.kernelFactor = kernel->factor() != 0.0 ? 1.0 / kernel->factor() : 1.0;
+        result.offset = kernel->offset();
+
+        return result;
+    };
+
+    const GradientKernel kernels[2] = {prepareKernel(kernelX), prepareKernel(kernelY)};
+
+    QScopedPointer<KisDecomposedConvolutionOpsBase> convolutionOps(KisDecomposedConvolutionOpsFactory::create());
+    QScopedPointer<KisEdgeDetectionOpsBase> ops(KisEdgeDetectionOpsFactory::create());
+
+    KisPaintDeviceSP source = new KisPaintDevice(*device);
+
+    const QVector<QRect> blocks = KritaUtils::splitRectIntoPatches(rect, QSize(256, 64));
+    QAtomicInt numProcessedBlocks;
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(0);
+    }
+
+    KritaUtils::parallelMap(blocks,
+        [&] (const QRect &block) {
+            if (progressUpdater && progressUpdater->interrupted()) return;
+
+            const QRect srcRect = block.adjusted(-left, -top, right, bottom);
+            const int srcWidth = srcRect.width();
+            const int planeSize = srcWidth * srcRect.height();
+
+            // every channel is stored in a separate plane
+            QVector<float> planes(numChannels * planeSize);
+
+            {
+                QVector<float> pixel(numChannels);
+
+                auto readPlanes = [&] (auto it) {
+                    int index = 0;
+
+                    for (int y = 0; y < srcRect.height(); y++) {
+                        for (int x = 0; x < srcWidth; x++) {
+                            info.readPixel(it->oldRawData(), pixel.data());
+
+                            for (int c = 0; c < numChannels; c++) {
+                                planes[c * planeSize + index] = pixel[c];
+                            }
+
+                            index++;
+                            it->nextPixel();
+                        }
+
+                        it->nextRow();
+                    }
+                };
+
+                if (borderOp == BORDER_REPEAT) {
+                    readPlanes(RepeatIteratorFactory::createHLineConstIterator(source, srcRect.x(), srcRect.y(), srcWidth, dataRect));
+                } else {
+                    readPlanes(StandardIteratorFactory::createHLineConstIterator(source, srcRect.x(), srcRect.y(), srcWidth, dataRect));
+                }
+            }
+
+            const int width = block.width();
+
+            QVector<float> convolved(numChannels * width);
+            QVector<float> alpha(width);
+            QVector<float> gradients(2 * numChannels * width);
+
+            QVector<const float*> dx(numChannels);
+            QVector<const float*> dy(numChannels);
+
+            for (int c = 0; c < numChannels; c++) {
+                dx[c] = gradients.constData() + c * width;
+                dy[c] = gradients.constData() + (numChannels + c) * width;
+            }
+
+            QVector<quint8> pixels(width * block.height() * pixelSize);
+            source->readBytes(pixels.data(), block);
+
+            for (int y = 0; y < block.height(); y++) {
+                for (int i = 0; i < 2; i++) {
+                    const GradientKernel &kernel = kernels[i];
+
+                    convolved.fill(0.0f);
+
+                    for (int c = 0; c < numChannels; c++) {
+                        float *dst = convolved.data() + c * width;
+                        const float *plane = planes.constData() + c * planeSize;
+
+                        Q_FOREACH (const GradientTap &tap, kernel.taps) {
+                            convolutionOps->addScaled(dst, plane + (y + tap.y) * srcWidth + tap.x, tap.weight, width);
+                        }
+                    }
+
+                    /**
+                     * The convolved alpha is used for un-premultiplying the
+                     * color channels before it is rounded, the same way as
+                     * KisConvolutionWorkerSpatial does
+                     */
+                    ops->resolveChannel(convolved.constData() + alphaPos * width, 0,
+                                        kernel.kernelFactor,
+                                        (info.maxClamp[alphaPos] - info.minClamp[alphaPos]) * kernel.offset,
+                                        info.minClamp[alphaPos], info.maxClamp[alphaPos],
+                                        false, 1.0f, 0.0f,
+                                        alpha.data(), width);
+
+                    float *gradientRows = gradients.data() + i * numChannels * width;
+
+                    for (int c = 0; c < numChannels; c++) {
+                        const float unitValue = info.maxClamp[c];
+
+                        if (c == alphaPos) {
+                            ops->resolveChannel(alpha.constData(), 0,
+                                                1.0f, 0.0f,
+                                                info.minClamp[c], info.maxClamp[c],
+                                                true, 1.0f / unitValue, -0.5f,
+                                                gradientRows + c * width, width);
+                        } else {
+                            ops->resolveChannel(convolved.constData() + c * width, alpha.constData(),
+                                                kernel.kernelFactor,
+                                                (info.maxClamp[c] - info.minClamp[c]) * kernel.offset,
+                                                info.minClamp[c], info.maxClamp[c],
+                                                true, 1.0f / unitValue, -0.5f,
+                                                gradientRows + c * width, width);
+                        }
+                    }
+                }
+
+                func(dx, dy, pixels.data() + y * width * pixelSize, width);
+            }
+
+            device->writeBytes(pixels.constData(), block);
+
+            if (progressUpdater) {
+                progressUpdater->setProgress(100 * (numProcessedBlocks.fetchAndAddOrdered(1) + 1) / blocks.size());
+            }
+        });
+}
+
+}
+
 KisEdgeDetectionKernel::KisEdgeDetectionKernel()
 {
 
@@ -194,16 +506,69 @@ void KisEdgeDetectionKernel::applyEdgeDetection(KisPaintDeviceSP device,
     finalPainter.setChannelFlags(channelFlags);
     finalPainter.setProgress(progressUpdater);
     if (output == pythagorean || output == radian) {
+        KisConvolutionKernelSP kernelHorizLeftRight = KisEdgeDetectionKernel::createHorizontalKernel(xRadius, type);
+        KisConvolutionKernelSP kernelVerticalTopBottom = KisEdgeDetectionKernel::createVerticalKernel(yRadius, type);
+
+        if (canUseFusedGradient(device->colorSpace(), channelFlags, kernelHorizLeftRight, kernelVerticalTopBottom)) {
+            const KoColorSpace *cs = device->colorSpace();
+            const int pixelSize = cs->pixelSize();
+            const int channels = cs->channelCount();
+            const int alphaPos = cs->alphaPos();
+
+            QScopedPointer<KisEdgeDetectionOpsBase> ops(KisEdgeDetectionOpsFactory::create());
+
+            applyFusedGradient(device, rect, kernelHorizLeftRight, kernelVerticalTopBottom, progressUpdater,
+                [&] (const QVector<const float*> &dx, const QVector<const float*> &dy, quint8 *pixels, int numPixels) {
+                    QVector<float> magnitudes;
+
+                    if (output == pythagorean) {
+                        magnitudes.resize(channels * numPixels);
+
+                        for (int c = 0; c < channels; c++) {
+                            ops->magnitude(dx[c], dy[c], magnitudes.data() + c * numPixels, numPixels);
+                        }
+                    }
+
+                    QVector<float> finalNorm(channels);
+
+                    for (int i = 0; i < numPixels; i++) {
+                        if (output == pythagorean) {
+                            for (int c = 0; c < channels; c++) {
+                                finalNorm[c] = magnitudes[c * numPixels + i];
+                            }
+                        } else { //radian
+                            for (int c = 0; c < channels; c++) {
+                                finalNorm[c] = atan2(dx[c][i], dy[c][i]);
+                            }
+                        }
+
+                        quint8 *pixel = pixels + i * pixelSize;
+
+                        if (writeToAlpha) {
+                            qreal alpha = 0;
+
+                            for (int c = 0; c < (channels - 1); c++) {
+                                alpha = alpha + finalNorm[c];
+                            }
+
+                            alpha = qMin(alpha / (channels - 1), cs->opacityF(pixel));
+                            cs->setOpacity(pixel, alpha, 1);
+                        } else {
+                            finalNorm[alphaPos] = 1.0;
+                            cs->fromNormalisedChannelsValue(pixel, finalNorm);
+                        }
+                    }
+                });
+
+            return;
+        }
+
         KisPaintDeviceSP x_denormalised = new KisPaintDevice(device->colorSpace());
         KisPaintDeviceSP y_denormalised = new KisPaintDevice(device->colorSpace());
 
         x_denormalised->prepareClone(device);
         y_denormalised->prepareClone(device);
 
-
-        KisConvolutionKernelSP kernelHorizLeftRight = KisEdgeDetectionKernel::createHorizontalKernel(xRadius, type);
-        KisConvolutionKernelSP kernelVerticalTopBottom = KisEdgeDetectionKernel::createVerticalKernel(yRadius, type);
-
         KisConvolutionPainter horizPainterLR(x_denormalised);
         horizPainterLR.setChannelFlags(channelFlags);
         horizPainterLR.setProgress(progressUpdater);
@@ -340,6 +705,54 @@ void KisEdgeDetectionKernel::convertToNormalMap(KisPaintDeviceSP device,
 {
     KIS_ASSERT_RECOVER_RETURN(device->colorSpace()->channelCount() > 3);
 
+    KisConvolutionKernelSP kernelHorizLeftRight = KisEdgeDetectionKernel::createHorizontalKernel(yRadius, type, true, !channelFlip[1]);
+    KisConvolutionKernelSP kernelVerticalTopBottom = KisEdgeDetectionKernel::createVerticalKernel(xRadius, type, true, !channelFlip[0]);
+
+    // an explicit request for FFTW engine should still be respected
+    if ((!useFftw || !*useFftw) &&
+        canUseFusedGradient(device->colorSpace(), channelFlags, kernelVerticalTopBottom, kernelHorizLeftRight)) {
+
+        const KoColorSpace *cs = device->colorSpace();
+        const int pixelSize = cs->pixelSize();
+        const int channels = cs->channelCount();
+        const int alphaPos = cs->alphaPos();
+        const float z = channelFlip[2] ? -1.0 : 1.0;
+        const QList<KoChannelInfo *> channelInfo = cs->channels();
+
+        QScopedPointer<KisEdgeDetectionOpsBase> ops(KisEdgeDetectionOpsFactory::create());
+
+        applyFusedGradient(device, rect, kernelVerticalTopBottom, kernelHorizLeftRight, progressUpdater,
+            [&] (const QVector<const float*> &dx, const QVector<const float*> &dy, quint8 *pixels, int numPixels) {
+                QVector<float> normalX(numPixels);
+                QVector<float> normalY(numPixels);
+                QVector<float> normalZ(numPixels);
+
+                for (int i = 0; i < numPixels; i++) {
+                    normalX[i] = dx[channelToConvert][i] * 2;
+                    normalY[i] = dy[channelToConvert][i] * 2;
+                }
+
+                ops->normalize(normalX.data(), normalY.data(), normalZ.data(), z, numPixels);
+
+                QVector<float> finalNorm(channels);
+
+                for (int i = 0; i < numPixels; i++) {
+                    const float normal[3] = {normalX[i], normalY[i], normalZ[i]};
+
+                    finalNorm.fill(1.0);
+                    for (int c = 0; c < 3; c++) {
+                        finalNorm[channelInfo.at(channelOrder[c])->displayPosition()] = (normal[channelOrder[c]]/2)+0.5;
+                    }
+
+                    finalNorm[alphaPos]= 1.0;
+
+                    cs->fromNormalisedChannelsValue(pixels + i * pixelSize, finalNorm);
+                }
+            });
+
+        return;
+    }
+
     QPoint srcTopLeft = rect.topLeft();
     KisPainter finalPainter(device);
     finalPainter.setChannelFlags(channelFlags);
@@ -349,9 +762,6 @@ void KisEdgeDetectionKernel::convertToNormalMap(KisPaintDeviceSP device,
     x_denormalised->prepareClone(device);
     y_denormalised->prepareClone(device);
 
-    KisConvolutionKernelSP kernelHorizLeftRight = KisEdgeDetectionKernel::createHorizontalKernel(yRadius, type, true, !channelFlip[1]);
-    KisConvolutionKernelSP kernelVerticalTopBottom = KisEdgeDetectionKernel::createVerticalKernel(xRadius, type, true, !channelFlip[0]);
-
     KisConvolutionPainter horizPainterLR(y_denormalised);
 
     if (useFftw) {
@@ -7,12 +7,16 @@
 #include <KoIcon.h>
 #include <kis_icon.h>
 #include <KoCompositeOpRegistry.h>
+#include <KoColorTransformation.h>
 
 #include "kis_layer.h"
 #include "kis_filter_mask.h"
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
+#include "filter/kis_color_transformation_filter.h"
+#include "filter/kis_color_transformation_configuration.h"
+#include "kis_pixel_selection.h"
 #include "kis_selection.h"
 #include "kis_processing_information.h"
 #include "kis_node.h"
@@ -21,10 +25,12 @@
 #include "kis_busy_progress_indicator.h"
 #include "kis_transaction.h"
 #include "kis_painter.h"
+#include "KisPixelLocalFilterCache.h"
 
 KisFilterMask::KisFilterMask(KisImageWSP image, const QString &name)
     : KisEffectMask(image, name),
-      KisNodeFilterInterface(0)
+      KisNodeFilterInterface(0),
+      m_filterCache(new KisPixelLocalFilterCache())
 {
     setCompositeOpId(COMPOSITE_COPY);
 }
@@ -36,6 +42,7 @@ KisFilterMask::~KisFilterMask()
 KisFilterMask::KisFilterMask(const KisFilterMask& rhs)
         : KisEffectMask(rhs)
         , KisNodeFilterInterface(rhs)
+        , m_filterCache(new KisPixelLocalFilterCache())
 {
 }
 
@@ -47,6 +54,21 @@ QIcon KisFilterMask::icon() const
 void KisFilterMask::setFilter(KisFilterConfigurationSP  filterConfig, bool checkCompareConfig)
 {
     KisNodeFilterInterface::setFilter(filterConfig, checkCompareConfig);
+    m_filterCache->reset();
+}
+
+void KisFilterMask::setVisible(bool visible, bool loading)
+{
+    if (visible != this->visible()) {
+        m_filterCache->reset();
+    }
+
+    KisEffectMask::setVisible(visible, loading);
+}
+
+KisPixelLocalFilterCache* KisFilterMask::pixelLocalFilterCache() const
+{
+    return m_filterCache.data();
 }
 
 QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
@@ -54,8 +76,6 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
                                   const QRect & rc,
                                   PositionToFilthy maskPos) const
 {
-    Q_UNUSED(maskPos);
-
     KisFilterConfigurationSP filterConfig = filter();
 
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(nodeProgressProxy(), rc);
@@ -81,12 +101,64 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
     KIS_ASSERT_RECOVER_NOOP(this->busyProgressIndicator());
     this->busyProgressIndicator()->update();
 
-    filter->process(src, dst, 0, rc, filterConfig.data(), 0);
+    /**
+     * The source of the mask is changed only when the layer or one of
+     * the masks below has changed. When one of the masks above is dirty,
+     * the filtered tiles can be reused.
+     */
+    m_filterCache->process(filter, src, dst, rc, filterConfig,
+                           KisPixelLocalFilterCache::sourceSignature(this),
+                           maskPos != N_BELOW_FILTHY);
 
     QRect r = filter->changedRect(rc, filterConfig.data(), dst->defaultBounds()->currentLevelOfDetail());
     return r;
 }
 
+QSharedPointer<KoColorTransformation>
+KisFilterMask::fusableColorTransformation(const KoColorSpace *cs, const QRect &rect) const
+{
+    KisFilterConfigurationSP filterConfig = filter();
+    if (!filterConfig) return QSharedPointer<KoColorTransformation>();
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value(filterConfig->name());
+
+    const KisColorTransformationFilter *colorFilter =
+        dynamic_cast<const KisColorTransformationFilter*>(filter.data());
+    if (!colorFilter) return QSharedPointer<KoColorTransformation>();
+
+    /**
+     * The mask is fusable only when its selection covers the
+     * whole rect with the full opacity
+     */
+    KisSelectionSP selection = this->selection();
+    if (selection) {
+        if (temporaryTarget() || selection->hasShapeSelection()) {
+            return QSharedPointer<KoColorTransformation>();
+        }
+
+        KisPixelSelectionSP pixelSelection = selection->pixelSelection();
+
+        if (pixelSelection->defaultPixel().opacityU8() != MAX_SELECTED ||
+            pixelSelection->nonDefaultPixelArea().intersects(rect)) {
+
+            return QSharedPointer<KoColorTransformation>();
+        }
+    }
+
+    // see KisColorTransformationFilter::processImpl()
+    const KisColorTransformationConfiguration *colorConfig =
+        dynamic_cast<const KisColorTransformationConfiguration*>(filterConfig.data());
+
+    if (colorConfig) {
+        // the transformation is owned by the configuration
+        return QSharedPointer<KoColorTransformation>(
+            colorConfig->colorTransformation(cs, colorFilter),
+            [] (KoColorTransformation*) {});
+    }
+
+    return QSharedPointer<KoColorTransformation>(colorFilter->createTransformation(cs, filterConfig));
+}
+
 bool KisFilterMask::accept(KisNodeVisitor &v)
 {
     return v.visit(this);
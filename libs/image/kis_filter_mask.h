@@ -6,12 +6,18 @@
 #ifndef _KIS_FILTER_MASK_
 #define _KIS_FILTER_MASK_
 
+#include <QScopedPointer>
+#include <QSharedPointer>
+
 #include "kis_types.h"
 #include "kis_effect_mask.h"
 
 #include "kis_node_filter_interface.h"
 #include "kis_filter_configuration.h"
 
+class KisPixelLocalFilterCache;
+class KoColorTransformation;
+class KoColorSpace;
 
 /**
    An filter mask is a single channel mask that applies a particular
@@ -46,6 +52,8 @@ public:
 
     void setFilter(KisFilterConfigurationSP filterConfig, bool checkCompareConfig = true) override;
 
+    void setVisible(bool visible, bool loading = false) override;
+
     QRect decorateRect(KisPaintDeviceSP &src,
                        KisPaintDeviceSP &dst,
                        const QRect & rc,
@@ -53,6 +61,27 @@ public:
 
     QRect changeRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
     QRect needRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
+
+    /**
+     * The cache of the filtered tiles used in decorateRect()
+     * for pixel-local filters
+     */
+    KisPixelLocalFilterCache* pixelLocalFilterCache() const;
+
+    /**
+     * Returns the color transformation equivalent to applying the mask
+     * to \p rect of a device in color space \p cs. The transformation
+     * exists only when the mask has a color transformation filter and
+     * its selection doesn't limit the effect inside \p rect, otherwise
+     * a null pointer is returned.
+     *
+     * KisLayer uses these transformations to apply a stack of color
+     * adjustment masks in a single pass.
+     */
+    QSharedPointer<KoColorTransformation> fusableColorTransformation(const KoColorSpace *cs, const QRect &rect) const;
+
+private:
+    QScopedPointer<KisPixelLocalFilterCache> m_filterCache;
 };
 
 #endif //_KIS_FILTER_MASK_
@@ -10,9 +10,63 @@
 #include "kis_convolution_kernel.h"
 #include <kis_convolution_painter.h>
 #include <kis_transaction.h>
+#include "KisRecursiveGaussianBlur.h"
 #include <QRect>
 
 
+namespace {
+
+/**
+ * Blurs the axes with big radii with KisRecursiveGaussianBlur and
+ * the rest of them with the exact convolution
+ */
+void applyApproximatedGaussian(KisPaintDeviceSP device,
+                               const QRect& rect,
+                               qreal xRadius, qreal yRadius,
+                               const QBitArray &channelFlags,
+                               KoUpdater *progressUpdater,
+                               KisConvolutionBorderOp borderOp)
+{
+    const bool approximateX = KisRecursiveGaussianBlur::isApplicable(xRadius);
+    const bool approximateY = KisRecursiveGaussianBlur::isApplicable(yRadius);
+
+    const qreal exactRadius = approximateX ? yRadius : xRadius;
+
+    if ((approximateX && approximateY) || exactRadius <= 0.0) {
+        KisRecursiveGaussianBlur::apply(device, rect,
+                                        xRadius, yRadius,
+                                        channelFlags, progressUpdater,
+                                        borderOp);
+        return;
+    }
+
+    KisConvolutionKernelSP exactKernel = approximateX ?
+        KisGaussianKernel::createVerticalKernel(exactRadius) :
+        KisGaussianKernel::createHorizontalKernel(exactRadius);
+
+    const int halfWidth = exactKernel->width() / 2;
+    const int halfHeight = exactKernel->height() / 2;
+
+    /**
+     * The recursive pass fills the area needed by the exact kernel
+     * in a copy of the device, so the device itself is written only
+     * by the convolution
+     */
+    KisPaintDeviceSP interm = new KisPaintDevice(*device);
+    KisRecursiveGaussianBlur::apply(interm,
+                                    rect.adjusted(-halfWidth, -halfHeight, halfWidth, halfHeight),
+                                    approximateX ? xRadius : 0.0,
+                                    approximateY ? yRadius : 0.0,
+                                    channelFlags, 0, borderOp);
+
+    KisConvolutionPainter painter(device);
+    painter.setChannelFlags(channelFlags);
+    painter.setProgress(progressUpdater);
+    painter.applyMatrix(exactKernel, interm, rect.topLeft(), rect.topLeft(), rect.size(), borderOp);
+}
+
+}
+
 qreal KisGaussianKernel::sigmaFromRadius(qreal radius)
 {
     return 0.3 * radius + 0.3;
@@ -105,12 +159,27 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
                                       const QBitArray &channelFlags,
                                       KoUpdater *progressUpdater,
                                       bool createTransaction,
-                                      KisConvolutionBorderOp borderOp)
+                                      KisConvolutionBorderOp borderOp,
+                                      bool allowApproximation)
 {
     QPoint srcTopLeft = rect.topLeft();
 
+    /**
+     * The cost of the convolution grows with the radius, so, when the
+     * caller allows that, the big blurs are approximated with a recursive
+     * filter. It never writes the pixels it reads, so no transaction is
+     * needed.
+     */
+    if (allowApproximation &&
+        (KisRecursiveGaussianBlur::isApplicable(xRadius) ||
+         KisRecursiveGaussianBlur::isApplicable(yRadius))) {
+
+        applyApproximatedGaussian(device, rect,
+                                  xRadius, yRadius,
+                                  channelFlags, progressUpdater,
+                                  borderOp);
 
-    if (KisConvolutionPainter::supportsFFTW()) {
+    } else if (KisConvolutionPainter::supportsFFTW()) {
         KisConvolutionPainter painter(device, KisConvolutionPainter::FFTW);
         painter.setChannelFlags(channelFlags);
         painter.setProgress(progressUpdater);
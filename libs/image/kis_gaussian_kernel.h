@@ -42,7 +42,8 @@ public:
                               const QBitArray &channelFlags,
                               KoUpdater *updater,
                               bool createTransaction = false,
-                              KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+                              KisConvolutionBorderOp borderOp = BORDER_REPEAT,
+                              bool allowApproximation = false);
 
     static Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> createLoGMatrix(qreal radius, qreal coeff, bool zeroCentered, bool includeWrappedArea);
 
@@ -8,6 +8,7 @@
 #include "kis_histogram.h"
 
 #include <QVector>
+#include <QSharedPointer>
 
 #include "kis_image.h"
 #include "kis_paint_layer.h"
@@ -15,6 +16,34 @@
 #include "KoColorSpace.h"
 #include "kis_debug.h"
 #include "kis_iterator_ng.h"
+#include "krita_utils.h"
+
+namespace {
+
+void addRectToProducer(KisPaintDeviceSP device, const QRect &rect, KoHistogramProducer *producer)
+{
+    KisSequentialConstIterator srcIt(device, rect);
+    const KoColorSpace* cs = device->colorSpace();
+
+    // XXX: the original code depended on their being a selection mask in the iterator
+    //      if the paint device had a selection. When we changed that to passing an
+    //      explicit selection to the createRectIterator call, that broke because
+    //      paint devices didn't know about their selections anymore.
+    //      updateHistogram should get a selection parameter.
+    int numConseqPixels = srcIt.nConseqPixels();
+    while (srcIt.nextPixels(numConseqPixels)) {
+
+        numConseqPixels = srcIt.nConseqPixels();
+        producer->addRegionToBin(srcIt.oldRawData(), 0, numConseqPixels, cs);
+    }
+}
+
+struct HistogramPatch {
+    QRect rect;
+    QSharedPointer<KoHistogramProducer> producer;
+};
+
+}
 
 KisHistogram::KisHistogram(const KisPaintLayerSP layer,
                            KoHistogramProducer *producer,
@@ -73,23 +102,38 @@ void KisHistogram::updateHistogram()
         return;
     }
 
-    KisSequentialConstIterator srcIt(m_paintDevice, m_bounds);
-    const KoColorSpace* cs = m_paintDevice->colorSpace();
-
     // Let the producer do it's work
     m_producer->clear();
 
+    const QVector<QRect> rects =
+        KritaUtils::splitRectIntoPatches(m_bounds, KritaUtils::optimalPatchSize());
+
+    QVector<HistogramPatch> patches;
+    if (rects.size() > 1) {
+        Q_FOREACH (const QRect &rc, rects) {
+            KoHistogramProducer *producer = m_producer->createEmptyCopy();
+            if (!producer) {
+                patches.clear();
+                break;
+            }
+            patches.append({rc, QSharedPointer<KoHistogramProducer>(producer)});
+        }
+    }
 
-    // XXX: the original code depended on their being a selection mask in the iterator
-    //      if the paint device had a selection. When we changed that to passing an
-    //      explicit selection to the createRectIterator call, that broke because
-    //      paint devices didn't know about their selections anymore.
-    //      updateHistogram should get a selection parameter.
-    int numConseqPixels = srcIt.nConseqPixels();
-    while (srcIt.nextPixels(numConseqPixels)) {
-
-        numConseqPixels = srcIt.nConseqPixels();
-        m_producer->addRegionToBin(srcIt.oldRawData(), 0, numConseqPixels, cs);
+    if (!patches.isEmpty()) {
+        // every patch is binned by its own copy of the producer,
+        // then all the bins are merged into the main one
+        KisPaintDeviceSP device = m_paintDevice;
+        KritaUtils::parallelMap(patches,
+            [device] (HistogramPatch &patch) {
+                addRectToProducer(device, patch.rect, patch.producer.data());
+            });
+
+        Q_FOREACH (const HistogramPatch &patch, patches) {
+            m_producer->addBinsFrom(patch.producer.data());
+        }
+    } else {
+        addRectToProducer(m_paintDevice, m_bounds, m_producer);
     }
 
     computeHistogram();
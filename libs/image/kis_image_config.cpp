@@ -80,6 +80,28 @@ void KisImageConfig::setEnablePerfLog(bool value)
     m_config.writeEntry("enablePerfLog", value);
 }
 
+bool KisImageConfig::cacheConvertedLayerProjections(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("cacheConvertedLayerProjections", false) : false;
+}
+
+void KisImageConfig::setCacheConvertedLayerProjections(bool value)
+{
+    m_config.writeEntry("cacheConvertedLayerProjections", value);
+}
+
+bool KisImageConfig::premultipliedGroupComposition(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("premultipliedGroupComposition", false) : false;
+}
+
+void KisImageConfig::setPremultipliedGroupComposition(bool value)
+{
+    m_config.writeEntry("premultipliedGroupComposition", value);
+}
+
 qreal KisImageConfig::transformMaskOffBoundsReadArea() const
 {
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
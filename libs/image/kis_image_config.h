@@ -24,6 +24,12 @@ public:
     bool enablePerfLog(bool requestDefault = false) const;
     void setEnablePerfLog(bool value);
 
+    bool cacheConvertedLayerProjections(bool requestDefault = false) const;
+    void setCacheConvertedLayerProjections(bool value);
+
+    bool premultipliedGroupComposition(bool requestDefault = false) const;
+    void setPremultipliedGroupComposition(bool value);
+
     qreal transformMaskOffBoundsReadArea() const;
 
     int updatePatchHeight() const;
@@ -24,6 +24,7 @@
 #include <KoProperties.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorTransformation.h>
 
 #include "kis_debug.h"
 #include "kis_image.h"
@@ -32,6 +33,8 @@
 #include "kis_mask.h"
 #include "kis_effect_mask.h"
 #include "kis_selection_mask.h"
+#include "kis_filter_mask.h"
+#include "kis_sequential_iterator.h"
 #include "kis_meta_data_store.h"
 #include "kis_selection.h"
 #include "kis_paint_layer.h"
@@ -48,6 +51,7 @@
 #include "kis_layer_utils.h"
 #include "kis_projection_leaf.h"
 #include "KisSafeNodeProjectionStore.h"
+#include "kis_busy_progress_indicator.h"
 
 
 class KisCloneLayersList {
@@ -629,6 +633,64 @@ KisNode::PositionToFilthy calculatePositionToFilthy(KisNodeSP nodeInQuestion,
     return KisNode::N_BELOW_FILTHY;
 }
 
+namespace {
+
+typedef QVector<QSharedPointer<KoColorTransformation>> FusedTransformations;
+
+/**
+ * Collects the color transformations of the consecutive filter masks
+ * starting at \p index. All the masks should apply to the same \p rect,
+ * which is checked by comparing it with the top of \p applyRects.
+ */
+FusedTransformations collectFusableMasks(const QList<KisEffectMaskSP> &masks,
+                                         int index,
+                                         const QStack<QRect> &applyRects,
+                                         const KoColorSpace *cs,
+                                         const QRect &rect)
+{
+    FusedTransformations result;
+
+    for (int i = index; i < masks.size(); i++) {
+        if (i > index) {
+            const int stackIndex = applyRects.size() - (i - index);
+            if (stackIndex < 0 || applyRects[stackIndex] != rect) break;
+        }
+
+        KisFilterMask *mask = dynamic_cast<KisFilterMask*>(masks[i].data());
+        if (!mask) break;
+
+        QSharedPointer<KoColorTransformation> transformation =
+            mask->fusableColorTransformation(cs, rect);
+        if (!transformation) break;
+
+        result.append(transformation);
+    }
+
+    return result;
+}
+
+/**
+ * Applies all the transformations in a single pass over the device
+ * instead of running every mask with its own intermediate device
+ */
+void applyFusedTransformations(KisPaintDeviceSP device,
+                               const QRect &rect,
+                               const FusedTransformations &transformations)
+{
+    KisSequentialIterator it(device, rect);
+
+    int conseq = it.nConseqPixels();
+    while (it.nextPixels(conseq)) {
+        conseq = it.nConseqPixels();
+
+        Q_FOREACH (const QSharedPointer<KoColorTransformation> &transformation, transformations) {
+            transformation->transform(it.rawData(), it.rawData(), conseq);
+        }
+    }
+}
+
+}
+
 QRect KisLayer::applyMasks(const KisPaintDeviceSP source,
                            KisPaintDeviceSP destination,
                            const QRect &requestedRect,
@@ -673,15 +735,52 @@ QRect KisLayer::applyMasks(const KisPaintDeviceSP source,
              */
             Q_ASSERT(needRect == requestedRect);
 
+            /**
+             * Devices with a special composition source color space
+             * (e.g. pixel selections) are processed by the masks one
+             * by one, the fused transformations are created for the
+             * plain color space of the device only
+             */
+            const bool canFuseMasks =
+                *destination->colorSpace() == *destination->compositionSourceColorSpace();
+
             if (source != destination) {
                 copyOriginalToProjection(source, destination, needRect);
             }
 
-            Q_FOREACH (const KisEffectMaskSP& mask, masks) {
+            for (int i = 0; i < masks.size(); i++) {
+                const KisEffectMaskSP &mask = masks[i];
                 const QRect maskApplyRect = applyRects.pop();
+
+                /**
+                 * Consecutive color adjustment masks (levels, curves,
+                 * HSV, etc.) are applied in a single pass
+                 */
+                const FusedTransformations fused = canFuseMasks ?
+                    collectFusableMasks(masks, i, applyRects,
+                                        destination->colorSpace(), maskApplyRect) :
+                    FusedTransformations();
+
+                if (fused.size() > 1) {
+                    for (int j = 0; j < fused.size(); j++) {
+                        KisBusyProgressIndicator *indicator = masks[i + j]->busyProgressIndicator();
+                        if (indicator) {
+                            indicator->update();
+                        }
+                    }
+
+                    applyFusedTransformations(destination, maskApplyRect, fused);
+
+                    for (int j = 1; j < fused.size(); j++) {
+                        applyRects.pop();
+                    }
+                    i += fused.size() - 1;
+                    continue;
+                }
+
                 const QRect maskNeedRect =
                     applyRects.isEmpty() ? needRect : applyRects.top();
-                    
+
                 PositionToFilthy maskPosition = calculatePositionToFilthy(mask, filthyNode, const_cast<KisLayer*>(this));
                 mask->apply(destination, maskApplyRect, maskNeedRect, maskPosition);
             }
@@ -7,6 +7,8 @@
 #include "kis_layer_projection_plane.h"
 
 #include <QBitArray>
+#include <QMutex>
+#include <QRegion>
 #include <KoColorSpace.h>
 #include <KoChannelInfo.h>
 #include <KoCompositeOpRegistry.h>
@@ -14,28 +16,160 @@
 #include "kis_projection_leaf.h"
 #include "kis_cached_paint_device.h"
 #include "kis_sequential_iterator.h"
+#include "kis_image_config.h"
+#include "kis_default_bounds_base.h"
 
 
 struct KisLayerProjectionPlane::Private
 {
     KisLayer *layer;
     KisCachedPaintDevice cachedDevice;
+
+    /**
+     * Optional cache of the layer's projection converted into the color
+     * space of the parent's projection. When enabled, a layer with a color
+     * space different from the image's one is converted only when it
+     * changes itself, not every time something else in the stack changes.
+     */
+    bool useConvertedProjectionCache = false;
+    QMutex convertedProjectionLock;
+    KisPaintDeviceSP convertedProjection;
+    KisPaintDeviceWSP convertedSource;
+    const KoColorSpace *convertedSourceColorSpace = 0;
+    QPoint convertedSourceOffset;
+    QRegion convertedValidRegion;
+
+    void invalidateConvertedProjection(const QRect &rect);
+    void resetConvertedProjection(KisPaintDeviceSP source, const KoColorSpace *dstColorSpace);
+    KisPaintDeviceSP fetchConvertedProjection(KisPaintDeviceSP source, const QRect &rect, const KoColorSpace *dstColorSpace);
 };
 
+namespace {
+
+/**
+ * The maximum number of pixels kept in the converted projection cache.
+ * When the cache grows bigger, it is restarted with the currently
+ * requested rect only. The rects bigger than the limit are not cached
+ * at all.
+ */
+const qint64 maxConvertedProjectionArea = 2048 * 2048;
+
+qint64 regionArea(const QRegion &region)
+{
+    qint64 area = 0;
+    for (auto it = region.begin(); it != region.end(); ++it) {
+        area += qint64(it->width()) * it->height();
+    }
+    return area;
+}
+
+}
+
+void KisLayerProjectionPlane::Private::invalidateConvertedProjection(const QRect &rect)
+{
+    QMutexLocker l(&convertedProjectionLock);
+    convertedValidRegion -= rect;
+}
+
+void KisLayerProjectionPlane::Private::resetConvertedProjection(KisPaintDeviceSP source, const KoColorSpace *dstColorSpace)
+{
+    /**
+     * The walkers that still use the old device keep their own
+     * reference to it, so it is safe to just replace it
+     */
+    convertedProjection = new KisPaintDevice(dstColorSpace);
+    convertedProjection->setDefaultBounds(source->defaultBounds());
+    convertedProjection->setDefaultPixel(source->defaultPixel().convertedTo(dstColorSpace));
+    convertedSource = source;
+    convertedSourceColorSpace = source->colorSpace();
+    convertedSourceOffset = source->offset();
+    convertedValidRegion = QRegion();
+}
+
+KisPaintDeviceSP KisLayerProjectionPlane::Private::fetchConvertedProjection(KisPaintDeviceSP source, const QRect &rect, const KoColorSpace *dstColorSpace)
+{
+    QRegion missingRegion;
+    KisPaintDeviceSP converted;
+
+    {
+        QMutexLocker l(&convertedProjectionLock);
+
+        /**
+         * The projection device of the layer is replaced when the
+         * first mask is added or the last one is removed
+         */
+        if (!convertedProjection ||
+            !convertedSource.isValid() ||
+            convertedSource.data() != source.data() ||
+            *convertedProjection->colorSpace() != *dstColorSpace ||
+            !convertedSourceColorSpace ||
+            *convertedSourceColorSpace != *source->colorSpace() ||
+            convertedSourceOffset != source->offset()) {
+
+            resetConvertedProjection(source, dstColorSpace);
+        }
+
+        missingRegion = QRegion(rect) - convertedValidRegion;
+
+        if (!missingRegion.isEmpty() &&
+            regionArea(convertedValidRegion) + regionArea(missingRegion) > maxConvertedProjectionArea) {
+
+            resetConvertedProjection(source, dstColorSpace);
+            missingRegion = QRegion(rect);
+        }
+
+        converted = convertedProjection;
+    }
+
+    /**
+     * The updates scheduler guarantees that the concurrent walkers never
+     * touch overlapping areas of the same layer, so the conversion itself
+     * can be done without holding the lock.
+     */
+    if (!missingRegion.isEmpty()) {
+        KisPainter gc(converted);
+        gc.setCompositeOpId(COMPOSITE_COPY);
+
+        for (auto it = missingRegion.begin(); it != missingRegion.end(); ++it) {
+            gc.bitBlt(it->topLeft(), source, *it);
+        }
+
+        QMutexLocker l(&convertedProjectionLock);
+        if (converted == convertedProjection) {
+            convertedValidRegion += missingRegion;
+        }
+    }
+
+    return converted;
+}
+
 
 KisLayerProjectionPlane::KisLayerProjectionPlane(KisLayer *layer)
     : m_d(new Private)
 {
     m_d->layer = layer;
+    m_d->useConvertedProjectionCache = KisImageConfig(true).cacheConvertedLayerProjections();
 }
 
 KisLayerProjectionPlane::~KisLayerProjectionPlane()
 {
 }
 
+QRegion KisLayerProjectionPlane::convertedProjectionCacheRegion() const
+{
+    QMutexLocker l(&m_d->convertedProjectionLock);
+    return m_d->convertedProjection ? m_d->convertedValidRegion : QRegion();
+}
+
 QRect KisLayerProjectionPlane::recalculate(const QRect& rect, KisNodeSP filthyNode)
 {
-    return m_d->layer->updateProjection(rect, filthyNode);
+    const QRect changeRect = m_d->layer->updateProjection(rect, filthyNode);
+
+    if (m_d->useConvertedProjectionCache) {
+        m_d->invalidateConvertedProjection(rect | changeRect);
+    }
+
+    return changeRect;
 }
 
 void KisLayerProjectionPlane::applyImpl(KisPainter *painter, const QRect &rect, KritaUtils::ThresholdMode thresholdMode)
@@ -66,6 +200,15 @@ void KisLayerProjectionPlane::applyImpl(KisPainter *painter, const QRect &rect,
         KritaUtils::thresholdOpacity(tmp, needRect, thresholdMode);
 
         device = tmp;
+    } else if (m_d->useConvertedProjectionCache &&
+               channelFlags.isEmpty() &&
+               painter->device() &&
+               *painter->device()->colorSpace() != *device->colorSpace() &&
+               device->defaultBounds()->currentLevelOfDetail() == 0 &&
+               !m_d->layer->isAnimated() &&
+               qint64(needRect.width()) * needRect.height() <= maxConvertedProjectionArea) {
+
+        device = m_d->fetchConvertedProjection(device, needRect, painter->device()->colorSpace());
     }
 
     painter->setChannelFlags(channelFlags);
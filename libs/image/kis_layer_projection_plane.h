@@ -9,14 +9,16 @@
 
 #include "kis_abstract_projection_plane.h"
 
+#include <QRegion>
 #include <QScopedPointer>
+#include "kritaimage_export.h"
 #include "krita_utils.h"
 
 /**
  * An implementation of the KisAbstractProjectionPlane interface for a
  * layer object
  */
-class KisLayerProjectionPlane : public KisAbstractProjectionPlane
+class KRITAIMAGE_EXPORT KisLayerProjectionPlane : public KisAbstractProjectionPlane
 {
 public:
     KisLayerProjectionPlane(KisLayer *layer);
@@ -34,6 +36,14 @@ public:
 
     KisPaintDeviceList getLodCapableDevices() const override;
 
+    /**
+     * The area of the cache of the layer projection converted into
+     * the color space of the parent (see
+     * KisImageConfig::cacheConvertedLayerProjections()). Used for
+     * testing purposes only.
+     */
+    QRegion convertedProjectionCacheRegion() const;
+
 private:
     void applyImpl(KisPainter *painter, const QRect &rect, KritaUtils::ThresholdMode thresholdMode);
 
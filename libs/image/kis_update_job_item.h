@@ -17,6 +17,7 @@
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "KisThreadBudget.h"
 #include <KoAlwaysInline.h>
 
 //#define DEBUG_JOBS_SEQUENCE
@@ -46,7 +47,11 @@ public:
     }
 
     void run() override {
+        // the helpers of KritaUtils::runParallelJobs() share
+        // the thread limit with the updater threads
+        KisThreadBudget::instance()->acquireThread();
         runImpl();
+        KisThreadBudget::instance()->releaseThread();
 
         // notify that the job is exiting and wake everybody
         // waiting on wakeForDone()
@@ -17,6 +17,7 @@
 
 #include "kis_queues_progress_updater.h"
 #include "KisImageConfigNotifier.h"
+#include "KisThreadBudget.h"
 
 #include <QReadWriteLock>
 #include "kis_lazy_wait_condition.h"
@@ -324,6 +325,7 @@ void KisUpdateScheduler::updateSettings()
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
     setThreadsLimit(config.maxNumberOfThreads());
+    KisThreadBudget::instance()->setLimit(config.maxNumberOfThreads());
 }
 
 void KisUpdateScheduler::immediateLockForReadOnly()
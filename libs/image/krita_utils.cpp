@@ -14,6 +14,8 @@
 #include <QPolygonF>
 #include <QPen>
 #include <QPainter>
+#include <QAtomicInt>
+#include <QSemaphore>
 
 #include "kis_algebra_2d.h"
 
@@ -25,10 +27,35 @@
 #include "kis_node.h"
 #include "kis_sequential_iterator.h"
 #include "kis_random_accessor_ng.h"
+#include "KisThreadBudget.h"
 
 #include <KisRenderedDab.h>
 
 
+namespace {
+
+struct ParallelJobs
+{
+    ParallelJobs(int _numJobs, std::function<void(int)> _job)
+        : numJobs(_numJobs), job(_job)
+    {
+    }
+
+    void processJobs() {
+        int index = 0;
+        while ((index = nextJob.fetchAndAddOrdered(1)) < numJobs) {
+            job(index);
+        }
+    }
+
+    const int numJobs;
+    std::function<void(int)> job;
+    QAtomicInt nextJob;
+    QSemaphore finishedHelpers;
+};
+
+}
+
 namespace KritaUtils
 {
 
@@ -68,6 +95,42 @@ namespace KritaUtils
         return patches;
     }
 
+    void runParallelJobs(int numJobs, std::function<void(int)> job)
+    {
+        if (numJobs <= 0) return;
+
+        if (numJobs == 1) {
+            job(0);
+            return;
+        }
+
+        KisThreadBudget *budget = KisThreadBudget::instance();
+
+        ParallelJobs jobs(numJobs, job);
+
+        /**
+         * The calling thread processes the jobs as well, so we never
+         * wait for a helper that has not been started
+         */
+        const int numHelpers = qMin(numJobs, budget->limit()) - 1;
+        int numStartedHelpers = 0;
+
+        for (int i = 0; i < numHelpers; i++) {
+            const bool started = budget->tryStart(
+                [&jobs] () {
+                    jobs.processJobs();
+                    jobs.finishedHelpers.release();
+                });
+
+            if (!started) break;
+
+            numStartedHelpers++;
+        }
+
+        jobs.processJobs();
+        jobs.finishedHelpers.acquire(numStartedHelpers);
+    }
+
     QVector<QRect> splitRectIntoPatchesTight(const QRect &rc, const QSize &patchSize)
     {
         QVector<QRect> patches;
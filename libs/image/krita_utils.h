@@ -23,6 +23,7 @@ class KisRegion;
 #include "kis_types.h"
 #include "krita_container_utils.h"
 #include <functional>
+#include <iterator>
 
 
 namespace KritaUtils
@@ -34,6 +35,37 @@ namespace KritaUtils
     QVector<QRect> KRITAIMAGE_EXPORT splitRegionIntoPatches(const QRegion &region, const QSize &patchSize);
     QVector<QRect> KRITAIMAGE_EXPORT splitRegionIntoPatches(const KisRegion &region, const QSize &patchSize);
 
+    /**
+     * Calls \p job for every index in range [0, \p numJobs) in parallel
+     * and waits until all the jobs are finished.
+     *
+     * The helper threads are taken from KisThreadBudget, which is
+     * shared with the updater threads, and the calling thread processes
+     * the jobs as well. When the budget has no free threads, e.g. when
+     * all the updater threads are busy or when called from a job of
+     * another parallel loop, the jobs are processed by the calling
+     * thread only, so the total number of threads never exceeds
+     * KisImageConfig::maxNumberOfThreads().
+     */
+    void KRITAIMAGE_EXPORT runParallelJobs(int numJobs, std::function<void(int)> job);
+
+    /**
+     * Calls \p function for every element of \p sequence in parallel,
+     * the same way as QtConcurrent::blockingMap() does, but respecting
+     * the limit of the threads. See runParallelJobs().
+     */
+    template <typename Sequence, typename Function>
+    void parallelMap(Sequence &sequence, Function function)
+    {
+        // detach the sequence in the calling thread only
+        auto begin = std::begin(sequence);
+
+        runParallelJobs(sequence.size(),
+            [begin, &function] (int index) {
+                function(*(begin + index));
+            });
+    }
+
     KRITAIMAGE_EXPORT KisRegion splitTriangles(const QPointF &center,
                                              const QVector<QPointF> &points);
     KRITAIMAGE_EXPORT KisRegion splitPath(const QPainterPath &path);
@@ -103,10 +103,15 @@ namespace KisLsUtils
                                       const QRect &applyRect,
                                       qreal radius)
     {
+        /**
+         * The difference between the exact and the approximated blur
+         * is not visible in the soft masks of the layer styles, so
+         * the big blurs are always approximated
+         */
         KisGaussianKernel::applyGaussian(selection, applyRect,
                                          radius, radius,
                                          QBitArray(), 0, true,
-                                         BORDER_IGNORE);
+                                         BORDER_IGNORE, true);
     }
 
     namespace Private {
@@ -0,0 +1,107 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSlidingHistogramTest.h"
+
+#include <algorithm>
+
+#include <QRandomGenerator>
+
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_paint_device.h"
+#include "KisSlidingHistogram.h"
+
+#include <simpletest.h>
+
+void KisSlidingHistogramTest::testMedian_data()
+{
+    QTest::addColumn<QRect>("rect");
+    QTest::addColumn<int>("radius");
+
+    QTest::newRow("aligned") << QRect(0, 0, 256, 128) << 3;
+    QTest::newRow("unaligned") << QRect(-10, -7, 300, 200) << 7;
+    QTest::newRow("radius-0") << QRect(5, 5, 70, 70) << 0;
+}
+
+void KisSlidingHistogramTest::testMedian()
+{
+    QFETCH(QRect, rect);
+    QFETCH(int, radius);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+    const QRect deviceRect = rect.adjusted(-radius / 2, -radius / 2, radius / 2, radius / 2);
+
+    QVector<quint8> data(deviceRect.width() * deviceRect.height());
+    QRandomGenerator random(42);
+    for (quint8 &value : data) {
+        value = random.bounded(256);
+    }
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->writeBytes(data.constData(), deviceRect);
+
+    KisPaintDeviceSP original = new KisPaintDevice(*dev);
+
+    auto binningFunction = [] (const quint8 *pixels, int numPixels, int *bins, float *values) {
+        for (int i = 0; i < numPixels; i++) {
+            bins[i] = pixels[i];
+            values[i] = pixels[i];
+        }
+    };
+
+    auto resultFunction = [] (const KisSlidingHistogram::Window &window,
+                              const quint8 *, quint8 *dst, QVector<float> &) {
+        const int *counts = window.histogramCounts(0);
+        const int half = (window.total(0) + 1) / 2;
+
+        int median = 0;
+        for (int sum = 0; median < window.numBins; median++) {
+            sum += counts[median];
+            if (sum >= half) break;
+        }
+
+        // the sum of the values in the bin should be consistent with the counts
+        KIS_SAFE_ASSERT_RECOVER_NOOP(qFuzzyCompare(1.0f + window.binSums(0, median)[0],
+                                                   1.0f + float(median * counts[median])));
+
+        *dst = median;
+    };
+
+    KisSlidingHistogram histogram(1, 256, 1);
+    histogram.apply(dev, rect, radius, binningFunction, resultFunction, 0);
+
+    const int windowSize = 2 * radius + 1;
+    const QRect srcRect = rect.adjusted(-radius, -radius, radius, radius);
+
+    QVector<quint8> src(srcRect.width() * srcRect.height());
+    original->readBytes(src.data(), srcRect);
+
+    QVector<quint8> result(rect.width() * rect.height());
+    dev->readBytes(result.data(), rect);
+
+    QVector<quint8> window(windowSize * windowSize);
+
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            for (int j = 0; j < windowSize; j++) {
+                for (int i = 0; i < windowSize; i++) {
+                    window[j * windowSize + i] = src[(y + j) * srcRect.width() + x + i];
+                }
+            }
+
+            std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+            const quint8 expected = window[window.size() / 2];
+
+            if (result[y * rect.width() + x] != expected) {
+                QFAIL(QString("Wrong median at %1,%2: %3 instead of %4")
+                      .arg(x).arg(y).arg(result[y * rect.width() + x]).arg(expected).toLatin1());
+            }
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisSlidingHistogramTest)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSLIDINGHISTOGRAMTEST_H
+#define KISSLIDINGHISTOGRAMTEST_H
+
+#include <simpletest.h>
+
+class KisSlidingHistogramTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMedian_data();
+    void testMedian();
+};
+
+#endif // KISSLIDINGHISTOGRAMTEST_H
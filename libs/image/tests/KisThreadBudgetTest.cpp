@@ -0,0 +1,98 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisThreadBudgetTest.h"
+
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThread>
+
+#include "KisThreadBudget.h"
+#include "krita_utils.h"
+
+#include <simpletest.h>
+
+void KisThreadBudgetTest::testLimit()
+{
+    KisThreadBudget budget;
+    budget.setLimit(2);
+
+    QSemaphore started;
+    QSemaphore finish;
+
+    // an updater thread is running
+    budget.acquireThread();
+
+    QVERIFY(budget.tryStart([&] () { started.release(); finish.acquire(); }));
+    started.acquire();
+    QCOMPARE(budget.busyThreads(), 2);
+
+    // the limit is reached, even though the pool might have spare threads
+    QVERIFY(!budget.tryStart([] () {}));
+
+    budget.releaseThread();
+    QVERIFY(budget.tryStart([&] () { started.release(); finish.acquire(); }));
+    started.acquire();
+
+    finish.release(2);
+
+    while (budget.busyThreads() > 0) {
+        QThread::msleep(1);
+    }
+
+    // the limit is updated when the configuration changes
+    budget.setLimit(3);
+    QCOMPARE(budget.limit(), 3);
+}
+
+void KisThreadBudgetTest::testParallelJobs()
+{
+    KisThreadBudget *budget = KisThreadBudget::instance();
+
+    const int limit = budget->limit();
+    QAtomicInt runningJobs;
+    QAtomicInt maxRunningJobs;
+    QAtomicInt finishedJobs;
+
+    auto job = [&] (int) {
+        const int running = runningJobs.fetchAndAddOrdered(1) + 1;
+
+        int max = maxRunningJobs.loadAcquire();
+        while (running > max && !maxRunningJobs.testAndSetOrdered(max, running, max));
+
+        QThread::msleep(5);
+
+        runningJobs.deref();
+        finishedJobs.ref();
+    };
+
+    // the calling thread is an updater thread
+    budget->acquireThread();
+    KritaUtils::runParallelJobs(50, job);
+    budget->releaseThread();
+
+    QCOMPARE(finishedJobs.loadAcquire(), 50);
+    QVERIFY(maxRunningJobs.loadAcquire() <= limit);
+
+    // all the threads are busy with updates, so everything runs in the calling thread
+    for (int i = 1; i < limit; i++) {
+        budget->acquireThread();
+    }
+
+    maxRunningJobs.storeRelease(0);
+    budget->acquireThread();
+    KritaUtils::runParallelJobs(10, job);
+    budget->releaseThread();
+
+    for (int i = 1; i < limit; i++) {
+        budget->releaseThread();
+    }
+
+    QCOMPARE(finishedJobs.loadAcquire(), 60);
+    QCOMPARE(maxRunningJobs.loadAcquire(), 1);
+}
+
+SIMPLE_TEST_MAIN(KisThreadBudgetTest)
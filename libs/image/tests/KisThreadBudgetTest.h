@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTHREADBUDGETTEST_H
+#define KISTHREADBUDGETTEST_H
+
+#include <simpletest.h>
+
+class KisThreadBudgetTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testLimit();
+    void testParallelJobs();
+};
+
+#endif // KISTHREADBUDGETTEST_H
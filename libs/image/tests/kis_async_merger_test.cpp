@@ -13,6 +13,7 @@
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
 #include "kis_image.h"
 #include "kis_paint_layer.h"
 #include "kis_group_layer.h"
@@ -21,6 +22,8 @@
 #include "kis_filter_mask.h"
 #include "kis_selection.h"
 #include "kis_paint_device_debug_utils.h"
+#include "kis_sequential_iterator.h"
+#include "KisPremultipliedProjectionUtils.h"
 #include <KisGlobalResourcesInterface.h>
 
 #include "filter/kis_filter.h"
@@ -497,5 +500,148 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
 }
 
 
+    /*
+      +-----------------+
+      |root             |
+      | group           |
+      |  paint 4        |
+      |  paint 3 (mult) |
+      |  paint 2        |
+      | paint 1         |
+      +-----------------+
+     */
+
+void KisAsyncMergerTest::testPremultipliedComposition()
+{
+    const KoColorSpace *colorSpace =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), 0);
+    KisImageSP image = new KisImage(0, 640, 441, colorSpace, "premultiplied test");
+
+    QImage sourceImage1(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    QImage sourceImage2(QString(FILES_DATA_DIR) + '/' + "inverted_hakonepa.png");
+
+    KisPaintDeviceSP device1 = new KisPaintDevice(colorSpace);
+    KisPaintDeviceSP device2 = new KisPaintDevice(colorSpace);
+    KisPaintDeviceSP device3 = new KisPaintDevice(colorSpace);
+    KisPaintDeviceSP device4 = new KisPaintDevice(colorSpace);
+
+    device1->convertFromQImage(sourceImage1, 0, 0, 0);
+    device2->convertFromQImage(sourceImage2, 0, 0, 0);
+    device2->clear(QRect(100, 100, 200, 200));
+    device3->fill(QRect(50, 50, 300, 200), KoColor(QColor(200, 250, 100, 180), colorSpace));
+    device4->fill(QRect(200, 150, 300, 250), KoColor(QColor(255, 0, 0, 100), colorSpace));
+
+    KisLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8, device1);
+    KisLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", 150, device2);
+    KisLayerSP paintLayer3 = new KisPaintLayer(image, "paint3", OPACITY_OPAQUE_U8, device3);
+    KisLayerSP paintLayer4 = new KisPaintLayer(image, "paint4", 220, device4);
+    KisLayerSP groupLayer = new KisGroupLayer(image, "group", 200);
+
+    paintLayer3->setCompositeOpId(COMPOSITE_MULT);
+
+    image->addNode(paintLayer1, image->rootLayer());
+    image->addNode(groupLayer, image->rootLayer());
+    image->addNode(paintLayer2, groupLayer);
+    image->addNode(paintLayer3, groupLayer);
+    image->addNode(paintLayer4, groupLayer);
+
+    auto renderImage = [image] () {
+        KisFullRefreshWalker walker(image->bounds());
+        KisAsyncMerger merger;
+
+        walker.collectRects(image->rootLayer(), image->bounds());
+        merger.startMerge(walker);
+
+        return image->projection()->convertToQImage(0);
+    };
+
+    KisImageConfig(false).setPremultipliedGroupComposition(false);
+    const QImage referenceImage = renderImage();
+
+    KisImageConfig(false).setPremultipliedGroupComposition(true);
+    const QImage resultImage = renderImage();
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt, resultImage, referenceImage, 1, 1, 0));
+}
+
+void KisAsyncMergerTest::testPremultipliedRoundTrip()
+{
+    const KoColorSpace *colorSpace =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), 0);
+
+    /**
+     * The width is not a multiple of any vector size, so both the
+     * vectorized and the scalar tail code paths are checked
+     */
+    const QRect rc(0, 0, 37, 20);
+
+    KisPaintDeviceSP device = new KisPaintDevice(colorSpace);
+    device->fill(rc, KoColor(Qt::black, colorSpace));
+
+    {
+        int i = 0;
+        KisSequentialIterator it(device, rc);
+        while (it.nextPixel()) {
+            float *pixel = reinterpret_cast<float*>(it.rawData());
+            pixel[0] = 0.1f + 0.013f * (i % 53);
+            pixel[1] = 0.9f - 0.007f * (i % 97);
+            pixel[2] = 0.37f * (i % 3);
+            pixel[3] = i % 4 == 0 ? 0.0f : 0.0031f * (i % 323);
+            i++;
+        }
+    }
+
+    KisPaintDeviceSP original = new KisPaintDevice(*device);
+
+    KisPremultipliedProjectionUtils::premultiply(device, rc);
+
+    // a fully transparent layer should change neither alpha nor color
+    KisPaintDeviceSP transparentLayer = new KisPaintDevice(colorSpace);
+    transparentLayer->fill(rc, KoColor(QColor(255, 0, 0, 0), colorSpace));
+    KisPremultipliedProjectionUtils::compositeOver(device, transparentLayer, rc, OPACITY_OPAQUE_U8);
+
+    KisPremultipliedProjectionUtils::unpremultiply(device, rc);
+
+    KisSequentialConstIterator resultIt(device, rc);
+    KisSequentialConstIterator originalIt(original, rc);
+
+    while (resultIt.nextPixel() && originalIt.nextPixel()) {
+        const float *result = reinterpret_cast<const float*>(resultIt.rawDataConst());
+        const float *expected = reinterpret_cast<const float*>(originalIt.rawDataConst());
+
+        QCOMPARE(result[3], expected[3]);
+
+        for (int ch = 0; ch < 3; ch++) {
+            if (expected[3] == 0.0f) {
+                QCOMPARE(result[ch], expected[ch]);
+            } else {
+                QVERIFY2(qAbs(result[ch] - expected[ch]) <= 1e-6f,
+                         qPrintable(QString("channel %1: %2 != %3")
+                                    .arg(ch).arg(result[ch]).arg(expected[ch])));
+            }
+        }
+    }
+
+    // a fully transparent destination pixel does not leak its color into the result
+    KisPaintDeviceSP dst = new KisPaintDevice(colorSpace);
+    dst->fill(rc, KoColor(QColor(0, 255, 0, 0), colorSpace));
+
+    KisPaintDeviceSP redLayer = new KisPaintDevice(colorSpace);
+    redLayer->fill(rc, KoColor(Qt::red, colorSpace));
+
+    KisPremultipliedProjectionUtils::premultiply(dst, rc);
+    KisPremultipliedProjectionUtils::compositeOver(dst, redLayer, rc, 128);
+    KisPremultipliedProjectionUtils::unpremultiply(dst, rc);
+
+    KisSequentialConstIterator dstIt(dst, rc);
+    while (dstIt.nextPixel()) {
+        const float *result = reinterpret_cast<const float*>(dstIt.rawDataConst());
+        QVERIFY(result[0] > 0.99f);
+        QVERIFY(result[1] < 1e-6f);
+        QVERIFY(result[3] > 0.0f);
+    }
+}
+
 SIMPLE_TEST_MAIN(KisAsyncMergerTest)
 
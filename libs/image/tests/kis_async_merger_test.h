@@ -29,6 +29,9 @@ private Q_SLOTS:
 
     void testFilterMaskOnFilterLayer();
 
+    void testPremultipliedComposition();
+    void testPremultipliedRoundTrip();
+
 };
 
 #endif /* KIS_ASYNC_MERGER_TEST_H */
@@ -8,6 +8,8 @@
 
 #include <simpletest.h>
 
+#include <cmath>
+
 #include <QBitArray>
 #include <QElapsedTimer>
 
@@ -20,6 +22,8 @@
 #include "kis_convolution_painter.h"
 #include "kis_convolution_kernel.h"
 #include <kis_gaussian_kernel.h>
+#include <KisRecursiveGaussianBlur.h>
+#include <KisDecomposedConvolution.h>
 #include <kis_mask_generator.h>
 #include <kistest.h>
 #include "testutil.h"
@@ -46,6 +50,44 @@ KisPaintDeviceSP initAsymTestDevice(QRect &imageRect, int &pixelSize, QByteArray
     return dev;
 }
 
+/**
+ * A device with sharp edges of several colors and a transparent hole.
+ * The engines that replace the spatial convolution are compared with
+ * it on this device.
+ */
+KisPaintDeviceSP initShapesTestDevice(QRect &imageRect, QRect &applyRect)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    imageRect = QRect(0, 0, 400, 300);
+    applyRect = QRect(20, 10, 340, 260);
+
+    dev->fill(imageRect, KoColor(Qt::white, cs));
+    dev->fill(QRect(50, 50, 200, 40), KoColor(Qt::red, cs));
+    dev->fill(QRect(150, 20, 30, 250), KoColor(Qt::blue, cs));
+    dev->clear(QRect(300, 150, 60, 60));
+
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+
+    return dev;
+}
+
+/**
+ * Returns a copy of \p dev with \p applyRect convolved by
+ * the spatial convolution
+ */
+KisPaintDeviceSP spatialReference(KisPaintDeviceSP dev, KisConvolutionKernelSP kernel, const QRect &applyRect)
+{
+    KisPaintDeviceSP reference = new KisPaintDevice(*dev);
+
+    KisConvolutionPainter painter(reference, KisConvolutionPainter::SPATIAL);
+    painter.applyMatrix(kernel, dev, applyRect.topLeft(), applyRect.topLeft(),
+                        applyRect.size(), BORDER_REPEAT);
+
+    return reference;
+}
+
 Eigen::Matrix<qreal, 3, 3> initSymmFilter(qreal &offset, qreal &factor)
 {
     Eigen::Matrix<qreal, 3, 3> filter;
@@ -450,8 +492,172 @@ void KisConvolutionPainterTest::testGaussianDetailsFFTW()
     testGaussianDetails(true);
 }
 
+void KisConvolutionPainterTest::testRecursiveGaussian()
+{
+    QRect imageRect;
+    QRect applyRect;
+    KisPaintDeviceSP dev = initShapesTestDevice(imageRect, applyRect);
+
+    const qreal radius = 60;
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*dev);
+
+    {
+        KisConvolutionKernelSP kernelHoriz = KisGaussianKernel::createHorizontalKernel(radius);
+        KisConvolutionKernelSP kernelVertical = KisGaussianKernel::createVerticalKernel(radius);
+
+        const int verticalCenter = kernelVertical->height() / 2;
+
+        KisPaintDeviceSP interm =
+            spatialReference(dev, kernelHoriz, applyRect.adjusted(0, -verticalCenter, 0, verticalCenter));
+
+        KisConvolutionPainter verticalPainter(reference, KisConvolutionPainter::SPATIAL);
+        verticalPainter.applyMatrix(kernelVertical, interm,
+                                    applyRect.topLeft(), applyRect.topLeft(),
+                                    applyRect.size(), BORDER_REPEAT);
+    }
+
+    KisRecursiveGaussianBlur::apply(dev, applyRect, radius, radius, QBitArray(), 0, BORDER_REPEAT);
+
+    /**
+     * The recursive filter is an approximation of the Gaussian,
+     * its error is about 1.5% on sharp edges
+     */
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     reference->convertToQImage(0, imageRect),
+                                     dev->convertToQImage(0, imageRect),
+                                     6, 6));
+}
+
+void KisConvolutionPainterTest::testRecursiveGaussianSingleAxis()
+{
+    QRect imageRect;
+    QRect applyRect;
+    KisPaintDeviceSP dev = initShapesTestDevice(imageRect, applyRect);
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*dev);
+
+    // only the horizontal axis is big enough for the approximation
+    KisGaussianKernel::applyGaussian(reference, applyRect, 60, 3, QBitArray(), 0,
+                                     false, BORDER_REPEAT, false);
+    KisGaussianKernel::applyGaussian(dev, applyRect, 60, 3, QBitArray(), 0,
+                                     false, BORDER_REPEAT, true);
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     reference->convertToQImage(0, imageRect),
+                                     dev->convertToQImage(0, imageRect),
+                                     6, 6));
+}
+
+void KisConvolutionPainterTest::testTiledFFTW()
+{
+    if (!KisConvolutionPainter::supportsFFTW()) {
+        QSKIP("FFTW is not available");
+    }
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    // the image is split into several tiles of the tiled mode
+    const QRect imageRect(0, 0, 700, 500);
+    dev->fill(imageRect, KoColor(Qt::white, cs));
+    dev->fill(QRect(50, 50, 500, 40), KoColor(Qt::red, cs));
+    dev->fill(QRect(250, 20, 30, 450), KoColor(Qt::blue, cs));
+    dev->clear(QRect(400, 150, 200, 200));
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(imageRect);
+    dev->setDefaultBounds(bounds);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createUniform2DKernel(5, 5);
+
+    KisPaintDeviceSP singlePass = new KisPaintDevice(dev->colorSpace());
+    KisPaintDeviceSP tiled = new KisPaintDevice(dev->colorSpace());
+
+    KisConvolutionPainter singlePassPainter(singlePass, KisConvolutionPainter::FFTW_SINGLE_PASS);
+    singlePassPainter.applyMatrix(kernel, dev, imageRect.topLeft(), imageRect.topLeft(), imageRect.size(), BORDER_REPEAT);
+
+    KisConvolutionPainter tiledPainter(tiled, KisConvolutionPainter::FFTW);
+    tiledPainter.applyMatrix(kernel, dev, imageRect.topLeft(), imageRect.topLeft(), imageRect.size(), BORDER_REPEAT);
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     singlePass->convertToQImage(0, imageRect),
+                                     tiled->convertToQImage(0, imageRect),
+                                     1, 1));
+}
+
 #include "kis_transaction.h"
 
+void KisConvolutionPainterTest::testDecomposedConvolution_data()
+{
+    QTest::addColumn<int>("kernelType");
+
+    QTest::newRow("aperture") << 0;
+    QTest::newRow("motion-line") << 1;
+}
+
+void KisConvolutionPainterTest::testDecomposedConvolution()
+{
+    QFETCH(int, kernelType);
+
+    QRect imageRect;
+    QRect applyRect;
+    KisPaintDeviceSP dev = initShapesTestDevice(imageRect, applyRect);
+
+    /**
+     * An even-sized disk with soft edges or a thin diagonal line,
+     * similar to the kernels of the lens and motion blur filters
+     */
+    Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> matrix;
+
+    if (kernelType == 0) {
+        matrix.resize(18, 21);
+
+        for (int j = 0; j < matrix.rows(); j++) {
+            for (int i = 0; i < matrix.cols(); i++) {
+                const qreal dist = std::hypot(i - 10.0, (j - 8.5) * 1.1);
+                matrix(j, i) = qRound(255.0 * qBound(0.0, 9.0 - dist, 1.0));
+            }
+        }
+    } else {
+        matrix = Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic>::Zero(13, 31);
+
+        for (int i = 0; i < matrix.cols(); i++) {
+            const qreal y = 6.0 + (i - 15.0) * 0.37;
+            const int row = std::floor(y);
+            const qreal frac = y - row;
+
+            matrix(row, i) += qRound(255.0 * (1.0 - frac));
+            if (row + 1 < matrix.rows()) {
+                matrix(row + 1, i) += qRound(255.0 * frac);
+            }
+        }
+    }
+
+    KisPaintDeviceSP reference =
+        spatialReference(dev, KisConvolutionKernel::fromMatrix(matrix, 0, matrix.sum()), applyRect);
+
+    KisDecomposedKernelSP kernel = KisDecomposedKernel::fromMatrix(matrix);
+    QCOMPARE(kernel->width(), int(matrix.cols()));
+    QCOMPARE(kernel->height(), int(matrix.rows()));
+
+    if (kernelType == 0) {
+        // the middle of the disk should be decomposed into runs
+        QVERIFY(!kernel->runs().isEmpty());
+        QVERIFY(kernel->runs().size() + kernel->taps().size() < (matrix.array() != 0.0).count());
+    }
+
+    KisDecomposedConvolution::apply(dev, applyRect, kernel, QBitArray(), 0, BORDER_REPEAT);
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     reference->convertToQImage(0, imageRect),
+                                     dev->convertToQImage(0, imageRect),
+                                     2, 2));
+}
+
 void KisConvolutionPainterTest::testDilate()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
@@ -491,6 +697,7 @@ void KisConvolutionPainterTest::testErode()
 }
 
 #include "kis_edge_detection_kernel.h"
+#include "kis_sequential_iterator.h"
 
 void KisConvolutionPainterTest::testNormalMap(KisPaintDeviceSP dev, bool useFftw, const QString &prefix)
 {
@@ -581,4 +788,77 @@ void KisConvolutionPainterTest::testNormalMapFFTW()
     testNormalMap(true);
 }
 
+void KisConvolutionPainterTest::testEdgeDetectionGradient_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<qreal>("radius");
+
+    QTest::newRow("simple") << int(KisEdgeDetectionKernel::Simple) << 1.0;
+    QTest::newRow("sobel") << int(KisEdgeDetectionKernel::SobelVector) << 1.0;
+    QTest::newRow("prewitt-5x5") << int(KisEdgeDetectionKernel::Prewitt) << 4.0;
+}
+
+void KisConvolutionPainterTest::testEdgeDetectionGradient()
+{
+    QFETCH(int, type);
+    QFETCH(qreal, radius);
+
+    const KisEdgeDetectionKernel::FilterType filterType = KisEdgeDetectionKernel::FilterType(type);
+
+    QRect imageRect;
+    QRect applyRect;
+    KisPaintDeviceSP dev = initShapesTestDevice(imageRect, applyRect);
+    const KoColorSpace *cs = dev->colorSpace();
+
+    for (int i = 0; i < 60; i++) {
+        KoColor c(Qt::magenta, cs);
+        c.setOpacity(static_cast<quint8>(75 + 3 * i));
+        dev->setPixel(200 + i, 20 + i, c);
+    }
+
+    /**
+     * The reference is calculated the way KisEdgeDetectionKernel did it
+     * before the gradients were fused: two spatial convolutions into
+     * temporary devices and the magnitude of the normalized gradients
+     */
+    KisPaintDeviceSP reference = new KisPaintDevice(*dev);
+
+    {
+        KisPaintDeviceSP xGradient =
+            spatialReference(dev, KisEdgeDetectionKernel::createHorizontalKernel(radius, filterType), applyRect);
+        KisPaintDeviceSP yGradient =
+            spatialReference(dev, KisEdgeDetectionKernel::createVerticalKernel(radius, filterType), applyRect);
+
+        const int channels = cs->channelCount();
+        QVector<float> x(channels);
+        QVector<float> y(channels);
+        QVector<float> result(channels);
+
+        KisSequentialIterator xIt(xGradient, applyRect);
+        KisSequentialIterator yIt(yGradient, applyRect);
+        KisSequentialIterator dstIt(reference, applyRect);
+
+        while (xIt.nextPixel() && yIt.nextPixel() && dstIt.nextPixel()) {
+            cs->normalisedChannelsValue(xIt.rawData(), x);
+            cs->normalisedChannelsValue(yIt.rawData(), y);
+
+            for (int c = 0; c < channels; c++) {
+                result[c] = 2 * std::sqrt((x[c] - 0.5) * (x[c] - 0.5) + (y[c] - 0.5) * (y[c] - 0.5));
+            }
+            result[cs->alphaPos()] = 1.0;
+
+            cs->fromNormalisedChannelsValue(dstIt.rawData(), result);
+        }
+    }
+
+    KisEdgeDetectionKernel::applyEdgeDetection(dev, applyRect, radius, radius, filterType,
+                                               QBitArray(), 0, KisEdgeDetectionKernel::pythagorean);
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     reference->convertToQImage(0, imageRect),
+                                     dev->convertToQImage(0, imageRect),
+                                     1, 1));
+}
+
 KISTEST_MAIN(KisConvolutionPainterTest)
@@ -47,11 +47,21 @@ private Q_SLOTS:
     void testGaussianDetailsSpatial();
     void testGaussianDetailsFFTW();
 
+    void testRecursiveGaussian();
+    void testRecursiveGaussianSingleAxis();
+    void testTiledFFTW();
+
+    void testDecomposedConvolution_data();
+    void testDecomposedConvolution();
+
     void testDilate();
     void testErode();
 
     void testNormalMapSpatial();
     void testNormalMapFFTW();
+
+    void testEdgeDetectionGradient_data();
+    void testEdgeDetectionGradient();
 };
 
 #endif
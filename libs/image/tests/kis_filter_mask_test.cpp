@@ -8,6 +8,7 @@
 #include <simpletest.h>
 
 #include <KoColorSpaceRegistry.h>
+#include <KoColor.h>
 
 #include "kis_selection.h"
 #include "filter/kis_filter.h"
@@ -19,6 +20,9 @@
 #include "kis_paint_layer.h"
 #include "kis_types.h"
 #include "kis_image.h"
+#include "kis_painter.h"
+#include "kis_fill_painter.h"
+#include "KisPixelLocalFilterCache.h"
 #include <KisGlobalResourcesInterface.h>
 
 
@@ -98,4 +102,215 @@ void KisFilterMaskTest::testProjectionSelected()
 
 }
 
+void KisFilterMaskTest::testPixelLocalCache()
+{
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    QImage inverted(QString(FILES_DATA_DIR) + '/' + "inverted_hakonepa.png");
+
+    KisPaintDeviceSP source = new KisPaintDevice(layer->colorSpace());
+    source->convertFromQImage(qimage, 0, 0, 0);
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("invert");
+    Q_ASSERT(f);
+    QVERIFY(f->isPixelLocal());
+
+    KisFilterConfigurationSP  kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(kfc);
+
+    KisFilterMaskSP mask = new KisFilterMask(image, "mask");
+    image->addNode(mask, layer);
+
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    mask->createNodeProgressProxy();
+
+    KisPixelLocalFilterCache *cache = mask->pixelLocalFilterCache();
+
+    const QRect rc = qimage.rect();
+    const qint64 fullArea = qint64(rc.width()) * rc.height();
+
+    // only the tiles fully covered by the rect are cached
+    const QRect cachedRect(0, 0, rc.width() / 64 * 64, rc.height() / 64 * 64);
+    const qint64 borderArea = fullArea - qint64(cachedRect.width()) * cachedRect.height();
+
+    KisPaintDeviceSP projection = new KisPaintDevice(*source);
+
+    auto applyMask = [&] (const QRect &applyRect, KisNode::PositionToFilthy pos) {
+        KisPainter::copyAreaOptimized(applyRect.topLeft(), source, projection, applyRect);
+        mask->apply(projection, applyRect, applyRect, pos);
+    };
+
+    auto checkInverted = [&] (const QImage &reference) {
+        QPoint errpoint;
+        if (!TestUtil::compareQImages(errpoint, reference, projection->convertToQImage(0, 0, 0, rc.width(), rc.height()))) {
+            projection->convertToQImage(0, 0, 0, rc.width(), rc.height()).save("filtermasktest_cache.png");
+            qWarning() << "Failed to create inverted image, first different pixel:" << errpoint;
+            return false;
+        }
+        return true;
+    };
+
+    // the layer itself is dirty, the first pass filters everything
+    applyMask(rc, KisNode::N_ABOVE_FILTHY);
+    QVERIFY(checkInverted(inverted));
+    QCOMPARE(cache->filteredArea(), fullArea);
+
+    // a mask above is dirty, the source is unchanged and only the borders are filtered
+    qint64 area = cache->filteredArea();
+    applyMask(rc, KisNode::N_BELOW_FILTHY);
+    QVERIFY(checkInverted(inverted));
+    QCOMPARE(cache->filteredArea() - area, borderArea);
+
+    // the layer is changed inside a single tile, the walker passes only its dirty rect
+    const QRect changedRect(70, 70, 10, 10);
+    {
+        KisFillPainter gc(source);
+        gc.fillRect(changedRect, KoColor(Qt::red, source->colorSpace()));
+    }
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*source);
+    f->process(reference, rc, kfc->cloneWithResourcesSnapshot());
+    const QImage referenceImage = reference->convertToQImage(0, 0, 0, rc.width(), rc.height());
+
+    area = cache->filteredArea();
+    applyMask(changedRect, KisNode::N_ABOVE_FILTHY);
+    QCOMPARE(cache->filteredArea() - area, qint64(changedRect.width()) * changedRect.height());
+    QVERIFY(checkInverted(referenceImage));
+
+    // the tile touched by the dirty rect is dropped, so it is filtered again
+    area = cache->filteredArea();
+    applyMask(rc, KisNode::N_BELOW_FILTHY);
+    QVERIFY(checkInverted(referenceImage));
+    QCOMPARE(cache->filteredArea() - area, borderArea + 64 * 64);
+
+    // the re-render area is much smaller than the full one
+    area = cache->filteredArea();
+    applyMask(rc, KisNode::N_BELOW_FILTHY);
+    QCOMPARE(cache->filteredArea() - area, borderArea);
+    QVERIFY(borderArea < fullArea / 4);
+
+    // a new configuration drops the cache
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    QCOMPARE(cache->filteredArea(), qint64(0));
+
+    applyMask(rc, KisNode::N_BELOW_FILTHY);
+    QVERIFY(checkInverted(referenceImage));
+    QCOMPARE(cache->filteredArea(), fullArea);
+
+    // hiding the mask drops the cache, because the walkers skip hidden masks
+    mask->setVisible(false);
+    QCOMPARE(cache->filteredArea(), qint64(0));
+}
+
+void KisFilterMaskTest::testPixelLocalCacheLimit()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+
+    const QRect rc(0, 0, 256, 256);
+    src->fill(rc, KoColor(Qt::blue, cs));
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("invert");
+    Q_ASSERT(f);
+    KisFilterConfigurationSP  kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(kfc);
+    kfc = kfc->cloneWithResourcesSnapshot();
+
+    // only four of the sixteen tiles fit into the cache
+    const int tileBytes = 64 * 64 * cs->pixelSize();
+    KisPixelLocalFilterCache cache(4 * tileBytes);
+
+    cache.process(f, src, dst, rc, kfc, 0, true);
+    QCOMPARE(cache.filteredArea(), qint64(rc.width()) * rc.height());
+
+    qint64 area = cache.filteredArea();
+    cache.process(f, src, dst, rc, kfc, 0, false);
+    QCOMPARE(cache.filteredArea() - area, qint64(rc.width()) * rc.height() - 4 * 64 * 64);
+
+    // a different source signature drops the cache
+    area = cache.filteredArea();
+    cache.process(f, src, dst, QRect(0, 0, 64, 64), kfc, 1, false);
+    QCOMPARE(cache.filteredArea() - area, qint64(64 * 64));
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*src);
+    f->process(reference, rc, kfc);
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     reference->convertToQImage(0, 0, 0, rc.width(), rc.height()),
+                                     dst->convertToQImage(0, 0, 0, rc.width(), rc.height())));
+}
+
+void KisFilterMaskTest::testFusedMasks()
+{
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    layer->paintDevice()->convertFromQImage(qimage, 0, 0, 0);
+
+    const QRect rc = qimage.rect();
+
+    KisFilterSP invert = KisFilterRegistry::instance()->value("invert");
+    KisFilterSP desaturate = KisFilterRegistry::instance()->value("desaturate");
+    QVERIFY(invert);
+    QVERIFY(desaturate);
+
+    KisFilterConfigurationSP invertConfig =
+        invert->defaultConfiguration(KisGlobalResourcesInterface::instance())->cloneWithResourcesSnapshot();
+    KisFilterConfigurationSP desaturateConfig =
+        desaturate->defaultConfiguration(KisGlobalResourcesInterface::instance())->cloneWithResourcesSnapshot();
+
+    // the masks have no selection, so they are applied as a single pass
+    KisFilterMaskSP mask1 = new KisFilterMask(image, "mask1");
+    image->addNode(mask1, layer);
+    mask1->setFilter(invertConfig);
+    mask1->createNodeProgressProxy();
+
+    KisFilterMaskSP mask2 = new KisFilterMask(image, "mask2");
+    image->addNode(mask2, layer);
+    mask2->setFilter(desaturateConfig);
+    mask2->createNodeProgressProxy();
+
+    QVERIFY(mask1->fusableColorTransformation(layer->colorSpace(), rc));
+    QVERIFY(mask2->fusableColorTransformation(layer->colorSpace(), rc));
+
+    layer->updateProjection(rc, layer);
+
+    // both masks were collected into a single chain and the filters were never called
+    QCOMPARE(mask1->pixelLocalFilterCache()->filteredArea(), qint64(0));
+    QCOMPARE(mask2->pixelLocalFilterCache()->filteredArea(), qint64(0));
+
+    KisPaintDeviceSP reference = new KisPaintDevice(*layer->paintDevice());
+    invert->process(reference, rc, invertConfig);
+    desaturate->process(reference, rc, desaturateConfig);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  reference->convertToQImage(0, 0, 0, rc.width(), rc.height()),
+                                  layer->projection()->convertToQImage(0, 0, 0, rc.width(), rc.height()))) {
+        layer->projection()->convertToQImage(0, 0, 0, rc.width(), rc.height()).save("filtermasktest_fused.png");
+        QFAIL(QString("Failed to create fused image, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+
+    // a partially selected mask breaks the chain
+    mask2->initSelection(layer);
+    mask2->select(QRect(0, 0, 100, 100), MIN_SELECTED);
+
+    QVERIFY(mask1->fusableColorTransformation(layer->colorSpace(), rc));
+    QVERIFY(!mask2->fusableColorTransformation(layer->colorSpace(), rc));
+
+    layer->updateProjection(rc, layer);
+
+    // a single mask is not fused, so both masks are applied one by one
+    QVERIFY(mask1->pixelLocalFilterCache()->filteredArea() > 0);
+    QVERIFY(mask2->pixelLocalFilterCache()->filteredArea() > 0);
+}
+
 SIMPLE_TEST_MAIN(KisFilterMaskTest)
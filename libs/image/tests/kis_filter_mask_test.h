@@ -19,6 +19,9 @@ private Q_SLOTS:
 
     void testProjectionNotSelected();
     void testProjectionSelected();
+    void testPixelLocalCache();
+    void testPixelLocalCacheLimit();
+    void testFusedMasks();
 
 };
 
@@ -10,6 +10,9 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoHistogramProducer.h>
+#include <KoColor.h>
+#include <KoColorModelStandardIds.h>
+#include "kis_sequential_iterator.h"
 #include "kis_paint_device.h"
 #include "kis_histogram.h"
 #include "kis_paint_layer.h"
@@ -34,5 +37,67 @@ void KisHistogramTest::testCreation()
     }
 }
 
+void KisHistogramTest::testParallelMatchesSequential_data()
+{
+    QTest::addColumn<QString>("depthId");
+
+    QTest::newRow("u8") << Integer8BitsColorDepthID.id();
+    QTest::newRow("u16") << Integer16BitsColorDepthID.id();
+    QTest::newRow("f32") << Float32BitsColorDepthID.id();
+}
+
+void KisHistogramTest::testParallelMatchesSequential()
+{
+    QFETCH(QString, depthId);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, 0);
+    QVERIFY(cs);
+
+    // the rect is big enough to be split into several patches
+    const QRect rect(0, 0, 1100, 700);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    for (int y = 0; y < rect.height(); y += 45) {
+        for (int x = 0; x < rect.width(); x += 70) {
+            dev->fill(QRect(x, y, 70, 45),
+                      KoColor(QColor((x * 7) % 256, (y * 3) % 256, (x + y) % 256, (x * y) % 256), cs));
+        }
+    }
+
+    QList<QString> producers = KoHistogramProducerFactoryRegistry::instance()->keysCompatibleWith(cs);
+    Q_FOREACH (const QString &id, producers) {
+        if (id.contains("YCBCR")) {
+            continue;
+        }
+
+        KoHistogramProducerFactory *factory = KoHistogramProducerFactoryRegistry::instance()->get(id);
+
+        KoHistogramProducer *producer = factory->generate();
+        QScopedPointer<KoHistogramProducer> reference(factory->generate());
+        if (!producer) {
+            continue;
+        }
+
+        KisHistogram histogram(dev, rect, producer, LINEAR);
+
+        KisSequentialConstIterator it(dev, rect);
+        int numConseqPixels = it.nConseqPixels();
+        while (it.nextPixels(numConseqPixels)) {
+            numConseqPixels = it.nConseqPixels();
+            reference->addRegionToBin(it.oldRawData(), 0, numConseqPixels, cs);
+        }
+
+        QCOMPARE(producer->count(), reference->count());
+
+        for (int channel = 0; channel < reference->channels().size(); channel++) {
+            for (int bin = 0; bin < reference->numberOfBins(); bin++) {
+                QCOMPARE(producer->getBinAt(channel, bin), reference->getBinAt(channel, bin));
+            }
+            QCOMPARE(producer->outOfViewLeft(channel), reference->outOfViewLeft(channel));
+            QCOMPARE(producer->outOfViewRight(channel), reference->outOfViewRight(channel));
+        }
+    }
+}
 
 KISTEST_MAIN(KisHistogramTest)
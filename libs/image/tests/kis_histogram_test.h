@@ -15,6 +15,8 @@ class KisHistogramTest : public QObject
 private Q_SLOTS:
 
     void testCreation();
+    void testParallelMatchesSequential_data();
+    void testParallelMatchesSequential();
 
 };
 
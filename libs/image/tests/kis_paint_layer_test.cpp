@@ -30,6 +30,9 @@
 #include "filter/kis_filter_registry.h"
 #include "kis_keyframe_channel.h"
 #include "kis_paint_device_debug_utils.h"
+#include "kis_painter.h"
+#include "kis_image_config.h"
+#include "KisMpl.h"
 
 void KisPaintLayerTest::testProjection()
 {
@@ -177,4 +180,176 @@ void KisPaintLayerTest::testLayerStyles()
 }
 
 
+namespace {
+
+struct ConvertedProjectionTester
+{
+    ConvertedProjectionTester(const QRect &imageRect)
+        : rgb8(KoColorSpaceRegistry::instance()->rgb8()),
+          rgb16(KoColorSpaceRegistry::instance()->rgb16())
+    {
+        KisImageConfig cfg(false);
+        const bool oldCacheConverted = cfg.cacheConvertedLayerProjections();
+
+        // restore the user's config even if the test fails
+        auto restoreConfig = kismpl::finally([&] () {
+            cfg.setCacheConvertedLayerProjections(oldCacheConverted);
+        });
+
+        image = new KisImage(0, imageRect.width(), imageRect.height(), rgb8, "converted projection test");
+
+        // the projection plane reads the option on construction
+        cfg.setCacheConvertedLayerProjections(true);
+        cachedLayer = new KisPaintLayer(image, "cached", OPACITY_OPAQUE_U8, rgb16);
+
+        cfg.setCacheConvertedLayerProjections(false);
+        uncachedLayer = new KisPaintLayer(image, "uncached", OPACITY_OPAQUE_U8, rgb16);
+
+        image->addNode(cachedLayer);
+        image->addNode(uncachedLayer);
+    }
+
+    void fill(const QRect &rc, const QColor &color) {
+        for (KisPaintLayerSP layer : {cachedLayer, uncachedLayer}) {
+            layer->paintDevice()->fill(rc, KoColor(color, layer->colorSpace()));
+            layer->projectionPlane()->recalculate(rc, layer);
+        }
+    }
+
+    KisPaintDeviceSP composite(KisPaintLayerSP layer, const QRect &rc) {
+        KisPaintDeviceSP dst = new KisPaintDevice(image->colorSpace());
+        dst->fill(image->bounds(), KoColor(Qt::white, image->colorSpace()));
+
+        KisPainter gc(dst);
+        layer->projectionPlane()->apply(&gc, rc);
+
+        return dst;
+    }
+
+    bool checkComposite(const QRect &rc) {
+        KisPaintDeviceSP cached = composite(cachedLayer, rc);
+        KisPaintDeviceSP uncached = composite(uncachedLayer, rc);
+
+        QPoint errpoint;
+        if (!TestUtil::comparePaintDevices(errpoint, cached, uncached)) {
+            qWarning() << "The cached projection differs from the uncached one, first different pixel:" << errpoint;
+            return false;
+        }
+        return true;
+    }
+
+    QRegion cachedRegion() const {
+        return cachedLayer->internalProjectionPlane()->convertedProjectionCacheRegion();
+    }
+
+    // the plane doesn't process the area outside the extent of the layer
+    QRegion expectedRegion(const QRect &rc) const {
+        return QRegion(rc & cachedLayer->projection()->extent());
+    }
+
+    const KoColorSpace *rgb8;
+    const KoColorSpace *rgb16;
+    KisImageSP image;
+    KisPaintLayerSP cachedLayer;
+    KisPaintLayerSP uncachedLayer;
+};
+
+}
+
+void KisPaintLayerTest::testConvertedProjectionCache()
+{
+    const QRect imageRect(0, 0, 512, 512);
+    ConvertedProjectionTester t(imageRect);
+
+    t.fill(imageRect, QColor(30, 30, 200, 100));
+    t.fill(QRect(50, 50, 300, 300), QColor(200, 30, 40, 180));
+
+    QVERIFY(t.checkComposite(imageRect));
+    QCOMPARE(t.cachedRegion(), QRegion(imageRect));
+
+    // a dirty rect after the cache is filled invalidates only this rect
+    const QRect dirtyRect(100, 100, 50, 50);
+    t.fill(dirtyRect, QColor(10, 200, 100, 120));
+    QCOMPARE(t.cachedRegion(), QRegion(imageRect) - dirtyRect);
+
+    QVERIFY(t.checkComposite(imageRect));
+    QCOMPARE(t.cachedRegion(), QRegion(imageRect));
+
+    // opacity is applied on composition, the cached pixels stay valid
+    t.cachedLayer->setOpacity(100);
+    t.uncachedLayer->setOpacity(100);
+    QVERIFY(t.checkComposite(imageRect));
+    QCOMPARE(t.cachedRegion(), QRegion(imageRect));
+
+    // moving the layer clears the cache
+    const QRect partialRect(0, 0, 200, 200);
+
+    for (KisPaintLayerSP layer : {t.cachedLayer, t.uncachedLayer}) {
+        layer->setX(10);
+    }
+    QVERIFY(t.checkComposite(partialRect));
+    QCOMPARE(t.cachedRegion(), t.expectedRegion(partialRect));
+
+    // adding a mask replaces the projection device and clears the cache
+    QVERIFY(t.checkComposite(imageRect));
+
+    for (KisPaintLayerSP layer : {t.cachedLayer, t.uncachedLayer}) {
+        KisTransparencyMaskSP mask = new KisTransparencyMask(t.image, "tmask");
+        KisSelectionSP selection = new KisSelection();
+        selection->pixelSelection()->select(QRect(120, 120, 100, 100), OPACITY_OPAQUE_U8);
+        mask->setSelection(selection);
+        t.image->addNode(mask, layer);
+
+        layer->projectionPlane()->recalculate(imageRect, layer);
+    }
+    QVERIFY(t.checkComposite(partialRect));
+    QCOMPARE(t.cachedRegion(), t.expectedRegion(partialRect));
+
+    // changing the color space of the layer clears the cache
+    QVERIFY(t.checkComposite(imageRect));
+
+    for (KisPaintLayerSP layer : {t.cachedLayer, t.uncachedLayer}) {
+        layer->paintDevice()->convertTo(KoColorSpaceRegistry::instance()->rgb16(KoColorSpaceRegistry::instance()->p709G10Profile()));
+        layer->projectionPlane()->recalculate(imageRect, layer);
+    }
+    QVERIFY(*t.cachedLayer->projection()->colorSpace() != *t.rgb16);
+    QVERIFY(t.checkComposite(partialRect));
+    QCOMPARE(t.cachedRegion(), t.expectedRegion(partialRect));
+
+    // channel flags bypass the cache
+    QBitArray channelFlags(4, true);
+    channelFlags.setBit(1, false);
+
+    for (KisPaintLayerSP layer : {t.cachedLayer, t.uncachedLayer}) {
+        layer->setChannelFlags(channelFlags);
+    }
+    QVERIFY(t.checkComposite(imageRect));
+    QCOMPARE(t.cachedRegion(), t.expectedRegion(partialRect));
+}
+
+void KisPaintLayerTest::testConvertedProjectionCacheLimit()
+{
+    // bigger than the 2048x2048 limit of the cache
+    const QRect imageRect(0, 0, 2200, 2200);
+    ConvertedProjectionTester t(imageRect);
+
+    t.fill(imageRect, QColor(30, 30, 200, 100));
+    t.fill(QRect(100, 100, 2000, 2000), QColor(200, 30, 40, 180));
+
+    const QRect topHalf(0, 0, 2200, 1100);
+    const QRect bottomHalf(0, 1100, 2200, 1100);
+
+    QVERIFY(t.checkComposite(topHalf));
+    QCOMPARE(t.cachedRegion(), QRegion(topHalf));
+
+    // the cache would grow over the limit, so it is restarted
+    QVERIFY(t.checkComposite(bottomHalf));
+    QCOMPARE(t.cachedRegion(), QRegion(bottomHalf));
+
+    // the rect bigger than the limit is composited without the cache
+    QVERIFY(t.checkComposite(imageRect));
+    QCOMPARE(t.cachedRegion(), QRegion(bottomHalf));
+}
+
+
 SIMPLE_TEST_MAIN(KisPaintLayerTest)
@@ -21,6 +21,10 @@ private Q_SLOTS:
 
     void testLayerStyles();
 
+    void testConvertedProjectionCache();
+
+    void testConvertedProjectionCacheLimit();
+
 };
 
 #endif
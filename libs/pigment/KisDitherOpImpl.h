@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <array>
 #include <type_traits>
 
 #include "DebugPigment.h"
@@ -21,6 +22,7 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceMaths.h>
 #include <KoColorSpaceTraits.h>
+#include <KoOptimizedPixelDepthScalerFactory.h>
 
 #include "KisDitherOp.h"
 #include "KisDitherMaths.h"
@@ -34,6 +36,7 @@ public:
     KisDitherOpImpl(const KoID &srcId, const KoID &dstId)
         : m_srcDepthId(srcId)
         , m_dstDepthId(dstId)
+        , m_scaler(KoOptimizedPixelDepthScalerFactory::create(srcId, dstId, srcCSTraits::channels_nb))
     {
     }
 
@@ -65,6 +68,20 @@ public:
 private:
     const KoID m_srcDepthId, m_dstDepthId;
 
+    /**
+     * Vectorized scaler for the depth pair of the op. It is null when
+     * the source and destination depths are the same.
+     */
+    const QScopedPointer<KoOptimizedPixelDepthScalerBase> m_scaler;
+
+    /**
+     * Number of pixels processed by the vectorized scaler in one go. The value
+     * must be a multiple of the periods of all the dither matrices (8 for
+     * Bayer and 64 for blue noise), so that the thresholds of the first chunk
+     * of a row could be reused for all the other chunks of the same row.
+     */
+    static constexpr int vectorChunkSize = 256;
+
     template<DitherType t = dType, typename std::enable_if<t == DITHER_NONE && std::is_same<srcCSTraits, dstCSTraits>::value, void>::type * = nullptr> inline void ditherImpl(const quint8 *src, quint8 *dst, int, int) const
     {
         memcpy(dst, src, srcCSTraits::pixelSize);
@@ -113,6 +130,11 @@ private:
     template<DitherType t = dType, typename std::enable_if<t == DITHER_NONE && !std::is_same<srcCSTraits, dstCSTraits>::value, void>::type * = nullptr>
     inline void ditherImpl(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int, int, int columns, int rows) const
     {
+        if (m_scaler) {
+            m_scaler->convert(srcRowStart, srcRowStride, dstRowStart, dstRowStride, rows, columns);
+            return;
+        }
+
         const quint8 *nativeSrc = srcRowStart;
         quint8 *nativeDst = dstRowStart;
 
@@ -137,11 +159,21 @@ private:
     template<DitherType t = dType, typename std::enable_if<t != DITHER_NONE, void>::type * = nullptr>
     inline void ditherImpl(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows) const
     {
+        const float s = scale();
+
+        if (m_scaler) {
+            if (s == 0.f) {
+                // floating point destinations are never dithered
+                m_scaler->convert(srcRowStart, srcRowStride, dstRowStart, dstRowStride, rows, columns);
+            } else {
+                ditherRowsVectorized(srcRowStart, srcRowStride, dstRowStart, dstRowStride, x, y, columns, rows, s);
+            }
+            return;
+        }
+
         const quint8 *nativeSrc = srcRowStart;
         quint8 *nativeDst = dstRowStart;
 
-        float s = scale();
-
         for (int a = 0; a < rows; ++a) {
             const srcChannelsType *srcPtr = srcCSTraits::nativeArray(nativeSrc);
             dstChannelsType *dstPtr = dstCSTraits::nativeArray(nativeDst);
@@ -164,6 +196,42 @@ private:
         }
     }
 
+    template<DitherType t = dType, typename std::enable_if<t != DITHER_NONE, void>::type * = nullptr>
+    inline void ditherRowsVectorized(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows, float s) const
+    {
+        const int channelsNb = srcCSTraits::channels_nb;
+        std::array<float, vectorChunkSize * srcCSTraits::channels_nb> factors;
+
+        const int factorColumns = qMin(columns, vectorChunkSize);
+
+        for (int a = 0; a < rows; ++a) {
+            float *factorPtr = factors.data();
+
+            for (int b = 0; b < factorColumns; ++b) {
+                const float f = factor(x + b, y + a);
+
+                for (int channelIndex = 0; channelIndex < channelsNb; ++channelIndex) {
+                    *factorPtr++ = f;
+                }
+            }
+
+            const quint8 *srcPtr = srcRowStart;
+            quint8 *dstPtr = dstRowStart;
+
+            for (int b = 0; b < columns; b += vectorChunkSize) {
+                const int chunkColumns = qMin(columns - b, vectorChunkSize);
+
+                m_scaler->ditherChannels(srcPtr, dstPtr, factors.data(), s, chunkColumns * channelsNb);
+
+                srcPtr += chunkColumns * srcCSTraits::pixelSize;
+                dstPtr += chunkColumns * dstCSTraits::pixelSize;
+            }
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
     template<typename U = typename dstCSTraits::channels_type, typename std::enable_if<!std::numeric_limits<U>::is_integer, void>::type * = nullptr> constexpr float scale() const
     {
         return 0.f; // no dithering for floating point
@@ -7,6 +7,7 @@
 #include "KoBasicHistogramProducers.h"
 
 #include <QString>
+#include <QVarLengthArray>
 #include <klocalizedstring.h>
 
 #include <KoConfig.h>
@@ -17,6 +18,9 @@
 // #include "Ko_global.h"
 #include "KoIntegerMaths.h"
 #include "KoChannelInfo.h"
+#include "KoOptimizedHistogramBinnerFactory.h"
+
+#include <kis_assert.h>
 
 static const KoColorSpace* m_labCs = 0;
 
@@ -55,6 +59,9 @@ KoBasicHistogramProducer::KoBasicHistogramProducer(const KoID& id, int nrOfBins,
     m_width = 1.0;
 }
 
+KoBasicHistogramProducer::~KoBasicHistogramProducer()
+{
+}
 
 void KoBasicHistogramProducer::clear()
 {
@@ -68,6 +75,110 @@ void KoBasicHistogramProducer::clear()
     }
 }
 
+void KoBasicHistogramProducer::addBinsFrom(const KoHistogramProducer *other)
+{
+    const KoBasicHistogramProducer *basic = dynamic_cast<const KoBasicHistogramProducer*>(other);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(basic);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(basic->m_channels == m_channels && basic->m_nrOfBins == m_nrOfBins);
+
+    m_count += basic->m_count;
+    for (int i = 0; i < m_channels; i++) {
+        quint32 *dst = m_bins[i].data();
+        const quint32 *src = basic->m_bins[i].constData();
+
+        for (int j = 0; j < m_nrOfBins; j++) {
+            dst[j] += src[j];
+        }
+        m_outRight[i] += basic->m_outRight[i];
+        m_outLeft[i] += basic->m_outLeft[i];
+    }
+}
+
+KoHistogramProducer *KoBasicHistogramProducer::setupEmptyCopy(KoBasicHistogramProducer *copy) const
+{
+    copy->setView(m_from, m_width);
+    copy->setSkipTransparent(m_skipTransparent);
+    copy->setSkipUnselected(m_skipUnselected);
+    return copy;
+}
+
+const quint8 *KoBasicHistogramProducer::convertToProducerColorSpace(const quint8 *pixels, quint32 nPixels, const KoColorSpace *cs)
+{
+    if (*cs == *m_colorSpace) {
+        return pixels;
+    }
+
+    const int bufferSize = int(nPixels * m_colorSpace->pixelSize());
+    if (m_conversionBuffer.size() < bufferSize) {
+        m_conversionBuffer.resize(bufferSize);
+    }
+
+    cs->convertPixelsTo(pixels, m_conversionBuffer.data(), m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
+    return m_conversionBuffer.constData();
+}
+
+void KoBasicHistogramProducer::addNormalisedRegionToBin(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels,
+                                                        const KoColorSpace *cs,
+                                                        float from, float to, float factor,
+                                                        quint32 integerRange)
+{
+    // the values are collected and binned in chunks to keep the buffer in cache
+    const int chunkSize = 256;
+
+    if (!m_binner) {
+        m_binner.reset(KoOptimizedHistogramBinnerFactory::create(m_channels, m_nrOfBins));
+        m_valuesBuffer.resize(chunkSize * m_channels);
+    }
+
+    QVarLengthArray<quint32*, 5> bins(m_channels);
+    for (int i = 0; i < m_channels; i++) {
+        bins[i] = m_bins[i].data();
+    }
+
+    const quint8 *dst = convertToProducerColorSpace(pixels, nPixels, cs);
+    const quint32 srcPixelSize = cs->pixelSize();
+    const quint32 dstPixelSize = m_colorSpace->pixelSize();
+
+    QVector<float> channels(m_channels);
+
+    while (nPixels > 0) {
+        const int chunkPixels = qMin(nPixels, quint32(chunkSize));
+        float *values = m_valuesBuffer.data();
+        int numValuePixels = 0;
+
+        for (int i = 0; i < chunkPixels; i++) {
+            if (!skipPixel(pixels, selectionMask, cs)) {
+                m_colorSpace->normalisedChannelsValue(dst, channels);
+
+                if (integerRange) {
+                    for (int ch = 0; ch < m_channels; ch++) {
+                        *values++ = static_cast<float>(static_cast<quint32>(qBound(0.0f, channels[ch] * integerRange, float(integerRange))));
+                    }
+                } else {
+                    for (int ch = 0; ch < m_channels; ch++) {
+                        *values++ = channels[ch];
+                    }
+                }
+
+                numValuePixels++;
+            }
+
+            pixels += srcPixelSize;
+            dst += dstPixelSize;
+            if (selectionMask) {
+                selectionMask++;
+            }
+        }
+
+        m_binner->addValues(m_valuesBuffer.constData(), numValuePixels,
+                            from, to, factor,
+                            bins.constData(), m_outLeft.data(), m_outRight.data());
+
+        m_count += numValuePixels;
+        nPixels -= chunkPixels;
+    }
+}
+
 void KoBasicHistogramProducer::makeExternalToInternal()
 {
     // This function assumes that the pixel is has no 'gaps'. That is to say: if we start
@@ -102,40 +213,37 @@ QString KoBasicU8HistogramProducer::positionToString(qreal pos) const
 
 void KoBasicU8HistogramProducer::addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *cs)
 {
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
+    const quint8 *dst = convertToProducerColorSpace(pixels, nPixels, cs);
+    const quint32 srcPixelSize = cs->pixelSize();
+    const quint32 dstPixelSize = m_colorSpace->pixelSize();
 
-    if (selectionMask) {
-        quint8 *dst = dstPixels;
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
+    // for 8-bit channels the value of the channel is the index of the bin itself
+    QVarLengthArray<quint32*, 5> bins(m_channels);
+    for (int i = 0; i < m_channels; i++) {
+        bins[i] = m_bins[i].data();
+    }
 
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
-                }
-                m_count++;
+    while (nPixels > 0) {
+        if (!skipPixel(pixels, selectionMask, cs)) {
+            for (int i = 0; i < m_channels; i++) {
+                bins[i][dst[i]]++;
             }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
+            m_count++;
         }
-    } else {
-        quint8 *dst = dstPixels;
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
+        pixels += srcPixelSize;
+        dst += dstPixelSize;
+        if (selectionMask) {
+            selectionMask++;
         }
+        nPixels--;
     }
 }
 
+KoHistogramProducer *KoBasicU8HistogramProducer::createEmptyCopy() const
+{
+    return setupEmptyCopy(new KoBasicU8HistogramProducer(m_id, m_colorSpace));
+}
+
 // ------------ U16 ---------------------
 
 KoBasicU16HistogramProducer::KoBasicU16HistogramProducer(const KoID& id, const KoColorSpace *cs)
@@ -161,51 +269,12 @@ void KoBasicU16HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
     quint16 to = from + width;
     qreal factor = 255.0 / width;
 
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
+    addNormalisedRegionToBin(pixels, selectionMask, nPixels, cs, from, to, factor, UINT16_MAX);
+}
 
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    quint16 value = channels[i]*UINT16_MAX;
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    quint16 value = channels[i]*UINT16_MAX;
-
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-        }
-    }
+KoHistogramProducer *KoBasicU16HistogramProducer::createEmptyCopy() const
+{
+    return setupEmptyCopy(new KoBasicU16HistogramProducer(m_id, m_colorSpace));
 }
 
 // ------------ Float32 ---------------------
@@ -233,52 +302,12 @@ void KoBasicF32HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
     float to = from + width;
     float factor = 255.0 / width;
 
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
-
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
+    addNormalisedRegionToBin(pixels, selectionMask, nPixels, cs, from, to, factor, 0);
+}
 
-        }
-    }
+KoHistogramProducer *KoBasicF32HistogramProducer::createEmptyCopy() const
+{
+    return setupEmptyCopy(new KoBasicF32HistogramProducer(m_id, m_colorSpace));
 }
 
 #ifdef HAVE_OPENEXR
@@ -308,50 +337,12 @@ void KoBasicF16HalfHistogramProducer::addRegionToBin(const quint8 * pixels, cons
     float to = from + width;
     float factor = 255.0 / width;
 
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
+    addNormalisedRegionToBin(pixels, selectionMask, nPixels, cs, from, to, factor, 0);
+}
 
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected  && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-        }
-    }
+KoHistogramProducer *KoBasicF16HalfHistogramProducer::createEmptyCopy() const
+{
+    return setupEmptyCopy(new KoBasicF16HalfHistogramProducer(m_id, m_colorSpace));
 }
 #endif
 
@@ -423,6 +414,11 @@ void KoGenericRGBHistogramProducer::addRegionToBin(const quint8 * pixels, const
     }
 }
 
+KoHistogramProducer *KoGenericRGBHistogramProducer::createEmptyCopy() const
+{
+    return setupEmptyCopy(new KoGenericRGBHistogramProducer());
+}
+
 KoGenericRGBHistogramProducerFactory::KoGenericRGBHistogramProducerFactory()
     : KoHistogramProducerFactory(KoID("GENRGBHISTO", i18n("Generic RGB Histogram")))
 {
@@ -507,6 +503,11 @@ void KoGenericLabHistogramProducer::addRegionToBin(const quint8 *pixels, const q
     delete[] dstPixels;
 }
 
+KoHistogramProducer *KoGenericLabHistogramProducer::createEmptyCopy() const
+{
+    return setupEmptyCopy(new KoGenericLabHistogramProducer());
+}
+
 KoGenericLabHistogramProducerFactory::KoGenericLabHistogramProducerFactory()
     : KoHistogramProducerFactory(KoID("GENLABHISTO", i18n("Generic L*a*b* Histogram")))
 {
@@ -9,6 +9,7 @@
 
 #include "KoHistogramProducer.h"
 
+#include <QScopedPointer>
 #include <QVector>
 
 #include <KoConfig.h>
@@ -18,15 +19,19 @@
 #include "kritapigment_export.h"
 #include "KoColorSpaceRegistry.h"
 
+class KoOptimizedHistogramBinnerBase;
+
 class KRITAPIGMENT_EXPORT KoBasicHistogramProducer : public KoHistogramProducer
 {
 public:
     explicit KoBasicHistogramProducer(const KoID& id, int channelCount, int nrOfBins);
     explicit KoBasicHistogramProducer(const KoID& id, int nrOfBins, const KoColorSpace *colorSpace);
-    ~KoBasicHistogramProducer() override {}
+    ~KoBasicHistogramProducer() override;
 
     void clear() override;
 
+    void addBinsFrom(const KoHistogramProducer *other) override;
+
     void setView(qreal from, qreal size) override {
         m_from = from; m_width = size;
     }
@@ -78,6 +83,36 @@ protected:
     }
     // not virtual since that is useless: we call it from constructor
     void makeExternalToInternal();
+
+    /**
+     * Copies the view and the skipping settings into \p copy,
+     * used by the implementations of createEmptyCopy()
+     */
+    KoHistogramProducer *setupEmptyCopy(KoBasicHistogramProducer *copy) const;
+
+    /**
+     * Converts \p nPixels pixels from \p colorSpace into m_colorSpace. If the
+     * color spaces are the same, \p pixels are returned as they are, otherwise
+     * the pixels are converted into an internal buffer.
+     */
+    const quint8 *convertToProducerColorSpace(const quint8 *pixels, quint32 nPixels, const KoColorSpace *colorSpace);
+
+    inline bool skipPixel(const quint8 *pixel, const quint8 *selectionMask, const KoColorSpace *colorSpace) const {
+        return (selectionMask && m_skipUnselected && *selectionMask == 0) ||
+            (m_skipTransparent && colorSpace->opacityU8(pixel) == OPACITY_TRANSPARENT_U8);
+    }
+
+    /**
+     * Bins the normalized channel values of the pixels with the vectorized
+     * binner. When \p integerRange is non-zero, the normalized values are
+     * truncated to the integer range [0, integerRange] before binning, and
+     * \p from and \p to should be given in that range.
+     */
+    void addNormalisedRegionToBin(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels,
+                                  const KoColorSpace *colorSpace,
+                                  float from, float to, float factor,
+                                  quint32 integerRange);
+
     typedef QVector<quint32> vBins;
     QVector<vBins> m_bins;
     vBins m_outLeft, m_outRight;
@@ -87,6 +122,11 @@ protected:
     const KoColorSpace *m_colorSpace;
     KoID m_id;
     QVector<qint32> m_external;
+
+private:
+    QScopedPointer<KoOptimizedHistogramBinnerBase> m_binner;
+    QVector<quint8> m_conversionBuffer;
+    QVector<float> m_valuesBuffer;
 };
 
 class KRITAPIGMENT_EXPORT KoBasicU8HistogramProducer : public KoBasicHistogramProducer
@@ -95,6 +135,7 @@ public:
     KoBasicU8HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU8HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer *createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override {
         return 1.0;
@@ -107,6 +148,7 @@ public:
     KoBasicU16HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU16HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer *createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -117,6 +159,7 @@ public:
     KoBasicF32HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF32HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer *createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -129,6 +172,7 @@ public:
     KoBasicF16HalfHistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF16HalfHistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer *createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -182,6 +226,7 @@ public:
     KoGenericRGBHistogramProducer();
     ~KoGenericRGBHistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer *createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
@@ -223,6 +268,7 @@ public:
     KoGenericLabHistogramProducer();
     ~KoGenericLabHistogramProducer() override;
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer *createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
@@ -16,6 +16,7 @@
 #include "KoColorSpace.h"
 #include "KoCopyColorConversionTransformation.h"
 #include "KoMultipleColorConversionTransformation.h"
+#include "KoOptimizedScaleColorConversionTransformation.h"
 
 
 KoColorConversionSystem::KoColorConversionSystem(RegistryInterface *registryInterface)
@@ -224,6 +225,10 @@ KoColorConversionTransformation* KoColorConversionSystem::createColorConverter(c
     if (*srcColorSpace == *dstColorSpace) {
         return new KoCopyColorConversionTransformation(srcColorSpace);
     }
+    if (KoOptimizedScaleColorConversionTransformation::canConvert(srcColorSpace, dstColorSpace)) {
+        // depth-only conversion, no need to go through the color engine
+        return new KoOptimizedScaleColorConversionTransformation(srcColorSpace, dstColorSpace, renderingIntent, conversionFlags);
+    }
     dbgPigmentCCS << srcColorSpace->id() << (srcColorSpace->profile() ? srcColorSpace->profile()->name() : "default");
     dbgPigmentCCS << dstColorSpace->id() << (dstColorSpace->profile() ? dstColorSpace->profile()->name() : "default");
     Path path = findBestPath(
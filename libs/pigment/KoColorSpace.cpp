@@ -497,6 +497,21 @@ bool KoColorSpace::proofPixelsTo(const quint8 *src,
     return true;
 }
 
+namespace {
+
+/**
+ * The number of rows that are converted and composited at once
+ * in the fused conversion path of bitBlt(). The strip should fit
+ * into the L2 cache together with the source and destination rows.
+ */
+qint32 fusedConversionStripRows(quint32 rowStride, qint32 totalRows)
+{
+    const quint32 fusedConversionStripSize = 32 * 1024;
+    return qBound(1, qint32(fusedConversionStripSize / qMax(1u, rowStride)), qMax(1, totalRows));
+}
+
+}
+
 void KoColorSpace::bitBlt(const KoColorSpace* srcSpace, const KoCompositeOp::ParameterInfo& params, const KoCompositeOp* op,
                           KoColorConversionTransformation::Intent renderingIntent,
                           KoColorConversionTransformation::ConversionFlags conversionFlags) const
@@ -511,53 +526,70 @@ void KoColorSpace::bitBlt(const KoColorSpace* srcSpace, const KoCompositeOp::Par
         if (preferCompositionInSourceColorSpace() &&
                 (*op->colorSpace() == *srcSpace || srcSpace->hasCompositeOp(op->id()))) {
 
+            KoCachedColorConversionTransformation toSrcConverter =
+                KoColorSpaceRegistry::instance()->colorConversionCache()->cachedConverter(this, srcSpace, renderingIntent, conversionFlags);
+            KoCachedColorConversionTransformation fromSrcConverter =
+                KoColorSpaceRegistry::instance()->colorConversionCache()->cachedConverter(srcSpace, this, renderingIntent, conversionFlags);
+
             quint32           conversionDstBufferStride = params.cols * srcSpace->pixelSize();
-            QVector<quint8> * conversionDstCache        = d->conversionCache.get(params.rows * conversionDstBufferStride);
+            const qint32      stripRows                 = fusedConversionStripRows(conversionDstBufferStride, params.rows);
+            QVector<quint8> * conversionDstCache        = d->conversionCache.get(stripRows * conversionDstBufferStride);
             quint8*           conversionDstData         = conversionDstCache->data();
 
-            for(qint32 row=0; row<params.rows; row++) {
-                convertPixelsTo(params.dstRowStart + row * params.dstRowStride,
-                                conversionDstData  + row * conversionDstBufferStride, srcSpace, params.cols,
-                                renderingIntent, conversionFlags);
-            }
-
             // TODO: Composite op substitution should eventually be removed here, but it's not urgent.
             //       Code should just provide srcSpace to KoColorSpace::compositeOp() to avoid the lookups.
             const KoCompositeOp *otherOp = (*op->colorSpace() == *srcSpace) ? op : srcSpace->compositeOp(op->id());
 
-            KoCompositeOp::ParameterInfo paramInfo(params);
-            paramInfo.dstRowStart  = conversionDstData;
-            paramInfo.dstRowStride = conversionDstBufferStride;
-            otherOp->composite(paramInfo);
+            /**
+             * Convert the destination in strips, so that the converted
+             * data would still be in cache when we composite it and
+             * convert back.
+             */
+            for (qint32 stripStart = 0; stripStart < params.rows; stripStart += stripRows) {
+                const qint32 numRows = qMin(stripRows, params.rows - stripStart);
+                quint8 *dstStripStart = params.dstRowStart + stripStart * params.dstRowStride;
+
+                for(qint32 row=0; row<numRows; row++) {
+                    toSrcConverter.transformation()->transform(dstStripStart + row * params.dstRowStride,
+                                                               conversionDstData + row * conversionDstBufferStride,
+                                                               params.cols);
+                }
 
-            for(qint32 row=0; row<params.rows; row++) {
-                srcSpace->convertPixelsTo(conversionDstData  + row * conversionDstBufferStride,
-                                          params.dstRowStart + row * params.dstRowStride, this, params.cols,
-                                          renderingIntent, conversionFlags);
+                KoCompositeOp::ParameterInfo paramInfo(params);
+                paramInfo.dstRowStart  = conversionDstData;
+                paramInfo.dstRowStride = conversionDstBufferStride;
+                paramInfo.srcRowStart  = params.srcRowStart + stripStart * params.srcRowStride;
+                paramInfo.maskRowStart = params.maskRowStart ? params.maskRowStart + stripStart * params.maskRowStride : 0;
+                paramInfo.rows         = numRows;
+                otherOp->composite(paramInfo);
+
+                for(qint32 row=0; row<numRows; row++) {
+                    fromSrcConverter.transformation()->transform(conversionDstData + row * conversionDstBufferStride,
+                                                                 dstStripStart + row * params.dstRowStride,
+                                                                 params.cols);
+                }
             }
 
         } else {
-            quint32           conversionBufferStride = params.cols * pixelSize();
-            QVector<quint8> * conversionCache        = d->conversionCache.get(params.rows * conversionBufferStride);
-            quint8*           conversionData         = conversionCache->data();
-
-
             const bool noChannelFlags = params.channelFlags.isEmpty() ||
                     params.channelFlags == srcSpace->channelFlags(true, true);
 
             if (noChannelFlags) {
-                for(qint32 row=0; row<params.rows; row++) {
-                    srcSpace->convertPixelsTo(params.srcRowStart + row * params.srcRowStride,
-                                              conversionData     + row * conversionBufferStride, this, params.cols,
-                                              renderingIntent, conversionFlags);
-                }
+                KoCachedColorConversionTransformation converter =
+                    KoColorSpaceRegistry::instance()->colorConversionCache()->cachedConverter(srcSpace, this, renderingIntent, conversionFlags);
+
+                quint32           conversionBufferStride = params.cols * pixelSize();
+                const qint32      stripRows              = fusedConversionStripRows(conversionBufferStride, params.rows);
+                QVector<quint8> * conversionCache        = d->conversionCache.get(stripRows * conversionBufferStride);
 
                 KoCompositeOp::ParameterInfo paramInfo(params);
-                paramInfo.srcRowStart  = conversionData;
-                paramInfo.srcRowStride = conversionBufferStride;
                 paramInfo.channelFlags = QBitArray();
-                op->composite(paramInfo);
+                op->compositeWithConversion(paramInfo, converter.transformation(), conversionCache->data(), stripRows);
             } else {
+                quint32           conversionBufferStride = params.cols * pixelSize();
+                QVector<quint8> * conversionCache        = d->conversionCache.get(params.rows * conversionBufferStride);
+                quint8*           conversionData         = conversionCache->data();
+
                 quint32           homogenizationBufferStride = params.cols * srcSpace->pixelSize();
                 QVector<quint8> * homogenizationCache        = d->channelFlagsApplicationCache.get(homogenizationBufferStride);
                 quint8*           homogenizationData         = homogenizationCache->data();
@@ -29,7 +29,7 @@ struct Q_DECL_HIDDEN KoColorSpace::Private {
                 m_cache.setLocalData(ba);
             } else {
                 ba = m_cache.localData();
-                if ((quint8)ba->size() < size)
+                if (quint32(ba->size()) < size)
                     ba->resize(size);
             }
             return ba;
@@ -11,6 +11,7 @@
 #include <QList>
 
 #include "KoColorSpace.h"
+#include "KoColorConversionTransformation.h"
 #include "KoColorSpaceMaths.h"
 #include "KoCompositeOpRegistry.h"
 
@@ -168,6 +169,33 @@ void KoCompositeOp::composite(const KoCompositeOp::ParameterInfo& params) const
               scale<quint8>(params.opacity), params.channelFlags );
 }
 
+void KoCompositeOp::compositeWithConversion(const ParameterInfo &params,
+                                            const KoColorConversionTransformation *srcToDstConverter,
+                                            quint8 *stripBuffer, int stripRows) const
+{
+    const qint32 stripBufferStride = params.cols * d->colorSpace->pixelSize();
+
+    KoCompositeOp::ParameterInfo stripParams(params);
+    stripParams.srcRowStart  = stripBuffer;
+    stripParams.srcRowStride = stripBufferStride;
+
+    for (qint32 row = 0; row < params.rows; row += stripRows) {
+        const qint32 numRows = qMin(stripRows, params.rows - row);
+
+        for (qint32 i = 0; i < numRows; i++) {
+            srcToDstConverter->transform(params.srcRowStart + (row + i) * params.srcRowStride,
+                                         stripBuffer + i * stripBufferStride,
+                                         params.cols);
+        }
+
+        stripParams.dstRowStart = params.dstRowStart + row * params.dstRowStride;
+        stripParams.maskRowStart = params.maskRowStart ?
+            params.maskRowStart + row * params.maskRowStride : 0;
+        stripParams.rows = numRows;
+
+        composite(stripParams);
+    }
+}
 
 QString KoCompositeOp::category() const
 {
@@ -17,8 +17,7 @@
 #include "kritapigment_export.h"
 
 class KoColorSpace;
-
-class KoColorSpace;
+class KoColorConversionTransformation;
 
 /**
  * Base for colorspace-specific blending modes.
@@ -126,6 +125,26 @@ public:
     */
     virtual void composite(const ParameterInfo& params) const;
 
+    /**
+     * Composite the source pixels that are stored in a different color
+     * space. The source pixels are converted with \p srcToDstConverter
+     * into the color space of the operation in strips of \p stripRows
+     * rows and every strip is composited right after the conversion,
+     * while it is still hot in cache. It avoids a separate conversion
+     * pass and a full-size temporary buffer for the whole rect.
+     *
+     * @param params the composition parameters, the source pixels are
+     *        in the source color space of \p srcToDstConverter
+     * @param srcToDstConverter the conversion from the source color
+     *        space into colorSpace()
+     * @param stripBuffer the temporary buffer of at least
+     *        stripRows * params.cols * colorSpace()->pixelSize() bytes
+     * @param stripRows the number of rows converted at once
+     */
+    virtual void compositeWithConversion(const ParameterInfo& params,
+                                         const KoColorConversionTransformation *srcToDstConverter,
+                                         quint8 *stripBuffer, int stripRows) const;
+
 private:
     KoCompositeOp();
     struct Private;
@@ -81,6 +81,30 @@ public:
     virtual qint32 getBinAt(qint32 channel, qint32 position) = 0;
     virtual qint32 outOfViewLeft(qint32 channel) = 0;
     virtual qint32 outOfViewRight(qint32 channel) = 0;
+
+    // Methods for accumulating the bins in parallel
+
+    /**
+     * Creates an empty producer with the same settings (view, skipping of
+     * transparent and unselected pixels) as this one. The copy can be filled
+     * independently, e.g. in a different thread, and then merged back with
+     * addBinsFrom().
+     *
+     * @return the new producer or null if the producer doesn't support
+     *         parallel accumulation
+     */
+    virtual KoHistogramProducer *createEmptyCopy() const {
+        return nullptr;
+    }
+
+    /**
+     * Adds the bins and counters of \p other to the bins of this producer.
+     * \p other must be created with createEmptyCopy() of this producer.
+     */
+    virtual void addBinsFrom(const KoHistogramProducer *other) {
+        Q_UNUSED(other);
+    }
+
 protected:
     bool m_skipTransparent;
     bool m_skipUnselected;
@@ -0,0 +1,156 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramBinner_H
+#define KoOptimizedHistogramBinner_H
+
+#include "KoOptimizedHistogramBinnerBase.h"
+
+#include <type_traits>
+
+#include "KoAlwaysInline.h"
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+/**
+ * Generic scalar implementation of the binner. It is used for the
+ * `xsimd::generic` architecture and as a tail-processor for the
+ * vectorized version.
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KoOptimizedHistogramBinner : public KoOptimizedHistogramBinnerBase
+{
+public:
+    KoOptimizedHistogramBinner(int channelsPerPixel, int numberOfBins)
+        : KoOptimizedHistogramBinnerBase(channelsPerPixel, numberOfBins)
+    {
+    }
+
+    void addValues(const float *values, int numPixels,
+                   float from, float to, float factor,
+                   quint32 *const *bins,
+                   quint32 *outLeft, quint32 *outRight) const override
+    {
+        addValuesScalar(values, numPixels * m_channelsPerPixel, 0,
+                        from, to, factor, bins, outLeft, outRight);
+    }
+
+protected:
+    /**
+     * Add \p numValues channel values, the first of which belongs to channel
+     * \p channel. Returns the channel of the value that would follow.
+     */
+    int addValuesScalar(const float *values, int numValues, int channel,
+                        float from, float to, float factor,
+                        quint32 *const *bins,
+                        quint32 *outLeft, quint32 *outRight) const
+    {
+        for (int i = 0; i < numValues; i++) {
+            const float value = values[i];
+
+            if (value > to) {
+                outRight[channel]++;
+            } else if (value < from) {
+                outLeft[channel]++;
+            } else {
+                bins[channel][clampBin(static_cast<int>((value - from) * factor))]++;
+            }
+
+            if (++channel == m_channelsPerPixel) {
+                channel = 0;
+            }
+        }
+
+        return channel;
+    }
+
+    ALWAYS_INLINE int clampBin(int index) const
+    {
+        return qBound(0, index, m_numberOfBins - 1);
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the binner. The bin indexes are calculated
+ * for the whole batch of values at once, only the increment of the
+ * bins is done in a scalar way.
+ */
+template<typename _impl>
+class KoOptimizedHistogramBinner<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KoOptimizedHistogramBinner<xsimd::generic>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+
+public:
+    KoOptimizedHistogramBinner(int channelsPerPixel, int numberOfBins)
+        : KoOptimizedHistogramBinner<xsimd::generic>(channelsPerPixel, numberOfBins)
+    {
+    }
+
+    void addValues(const float *values, int numPixels,
+                   float from, float to, float factor,
+                   quint32 *const *bins,
+                   quint32 *outLeft, quint32 *outRight) const override
+    {
+        const int numValues = numPixels * m_channelsPerPixel;
+        const int vectorBlock = numValues / static_cast<int>(float_v::size);
+        const int scalarBlock = numValues % static_cast<int>(float_v::size);
+
+        const float_v from_v(from);
+        const float_v to_v(to);
+        const float_v factor_v(factor);
+        const float_v zero_v(0.0f);
+        const float_v maxBin_v(static_cast<float>(m_numberOfBins - 1));
+
+        // out-of-range values are marked with indexes outside [0, numberOfBins)
+        const float_v leftIndex_v(-1.0f);
+        const float_v rightIndex_v(static_cast<float>(m_numberOfBins));
+
+        int indexes[int_v::size];
+        int channel = 0;
+
+        for (int i = 0; i < vectorBlock; i++) {
+            const float_v value = float_v::load_unaligned(values);
+
+            float_v index = xsimd::min(xsimd::max((value - from_v) * factor_v, zero_v), maxBin_v);
+            index = xsimd::select(value < from_v, leftIndex_v, index);
+            index = xsimd::select(value > to_v, rightIndex_v, index);
+
+            xsimd::batch_cast<int>(index).store_unaligned(indexes);
+
+            for (size_t k = 0; k < int_v::size; k++) {
+                const int binIndex = indexes[k];
+
+                if (binIndex < 0) {
+                    outLeft[channel]++;
+                } else if (binIndex >= m_numberOfBins) {
+                    outRight[channel]++;
+                } else {
+                    bins[channel][binIndex]++;
+                }
+
+                if (++channel == m_channelsPerPixel) {
+                    channel = 0;
+                }
+            }
+
+            values += float_v::size;
+        }
+
+        this->addValuesScalar(values, scalarBlock, channel,
+                              from, to, factor, bins, outLeft, outRight);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KoOptimizedHistogramBinner_H
@@ -0,0 +1,27 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedHistogramBinnerBase.h"
+
+KoOptimizedHistogramBinnerBase::KoOptimizedHistogramBinnerBase(int channelsPerPixel, int numberOfBins)
+    : m_channelsPerPixel(channelsPerPixel),
+      m_numberOfBins(numberOfBins)
+{
+}
+
+KoOptimizedHistogramBinnerBase::~KoOptimizedHistogramBinnerBase()
+{
+}
+
+int KoOptimizedHistogramBinnerBase::channelsPerPixel() const
+{
+    return m_channelsPerPixel;
+}
+
+int KoOptimizedHistogramBinnerBase::numberOfBins() const
+{
+    return m_numberOfBins;
+}
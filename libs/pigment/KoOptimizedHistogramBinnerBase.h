@@ -0,0 +1,56 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramBinnerBase_H
+#define KoOptimizedHistogramBinnerBase_H
+
+#include <QtGlobal>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Puts normalized channel values into the bins of a histogram
+ *
+ * The binner is used by the basic histogram producers. The producers
+ * collect the normalized values of the pixels into a continuous buffer
+ * and the binner calculates the bin indexes for the whole buffer in
+ * a vectorized way.
+ *
+ * The actual implementation is placed in class `KoOptimizedHistogramBinner`,
+ * which is compiled for every supported CPU architecture. Use
+ * `KoOptimizedHistogramBinnerFactory` to create an instance of it.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedHistogramBinnerBase
+{
+public:
+    KoOptimizedHistogramBinnerBase(int channelsPerPixel, int numberOfBins);
+
+    virtual ~KoOptimizedHistogramBinnerBase();
+
+    /**
+     * Add \p numPixels pixels of interleaved channel \p values to the bins.
+     *
+     * The value goes to the bin `(value - from) * factor` if it lies in
+     * range [from, to], otherwise it is counted in \p outLeft or \p outRight
+     * of the corresponding channel.
+     *
+     * \p bins must point to channelsPerPixel() arrays of numberOfBins()
+     * elements, \p outLeft and \p outRight to arrays of channelsPerPixel()
+     * elements.
+     */
+    virtual void addValues(const float *values, int numPixels,
+                           float from, float to, float factor,
+                           quint32 *const *bins,
+                           quint32 *outLeft, quint32 *outRight) const = 0;
+
+    int channelsPerPixel() const;
+    int numberOfBins() const;
+
+protected:
+    int m_channelsPerPixel;
+    int m_numberOfBins;
+};
+
+#endif // KoOptimizedHistogramBinnerBase_H
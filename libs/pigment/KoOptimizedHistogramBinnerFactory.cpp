@@ -0,0 +1,15 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedHistogramBinnerFactory.h"
+
+#include "KoOptimizedHistogramBinnerFactoryImpl.h"
+
+KoOptimizedHistogramBinnerBase *KoOptimizedHistogramBinnerFactory::create(int channelsPerPixel, int numberOfBins)
+{
+    return createOptimizedClass<
+            KoOptimizedHistogramBinnerFactoryImpl>(channelsPerPixel, numberOfBins);
+}
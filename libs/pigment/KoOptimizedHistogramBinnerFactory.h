@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramBinnerFACTORY_H
+#define KoOptimizedHistogramBinnerFACTORY_H
+
+#include "KoOptimizedHistogramBinnerBase.h"
+
+class KRITAPIGMENT_EXPORT KoOptimizedHistogramBinnerFactory
+{
+public:
+    static KoOptimizedHistogramBinnerBase* create(int channelsPerPixel, int numberOfBins);
+};
+
+#endif // KoOptimizedHistogramBinnerFACTORY_H
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedHistogramBinnerFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedHistogramBinner.h"
+
+template<>
+KoOptimizedHistogramBinnerBase *
+KoOptimizedHistogramBinnerFactoryImpl::create<xsimd::current_arch>(
+    int channelsPerPixel, int numberOfBins)
+{
+    return new KoOptimizedHistogramBinner<xsimd::current_arch>(
+        channelsPerPixel, numberOfBins);
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
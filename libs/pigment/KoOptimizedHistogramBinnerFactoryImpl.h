@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramBinnerFACTORYIMPL_H
+#define KoOptimizedHistogramBinnerFACTORYIMPL_H
+
+#include <KoOptimizedHistogramBinnerBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoOptimizedHistogramBinnerFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoOptimizedHistogramBinnerBase* create(int, int);
+};
+
+#endif // KoOptimizedHistogramBinnerFACTORYIMPL_H
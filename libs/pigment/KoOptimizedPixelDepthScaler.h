@@ -0,0 +1,343 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedPixelDepthScaler_H
+#define KoOptimizedPixelDepthScaler_H
+
+#include "KoOptimizedPixelDepthScalerBase.h"
+#include "KoOptimizedPixelDataScalerU8ToU16.h"
+
+#include <type_traits>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+#include "KoAlwaysInline.h"
+#include "KoColorSpaceMaths.h"
+#include "KisDitherMaths.h"
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+
+template <typename src_channel_type, typename dst_channel_type>
+struct KoIsIntegerDepthScalingPair
+    : std::integral_constant<bool,
+                             (std::is_same<src_channel_type, quint8>::value &&
+                              std::is_same<dst_channel_type, quint16>::value) ||
+                             (std::is_same<src_channel_type, quint16>::value &&
+                              std::is_same<dst_channel_type, quint8>::value)>
+{
+};
+
+/**
+ * Scalar implementation of the dithering conversion. A vectorized
+ * version is defined below for all non-generic architectures.
+ */
+template<typename _impl,
+         typename src_channel_type,
+         typename dst_channel_type,
+         typename EnableDummyType = void>
+struct KoDepthScalerDither
+{
+    static inline void ditherChannels(const src_channel_type *src, dst_channel_type *dst,
+                                      const float *factors, float scale, int numChannels)
+    {
+        for (int i = 0; i < numChannels; i++) {
+            const float c = KoColorSpaceMaths<src_channel_type, float>::scaleToA(src[i]);
+            dst[i] = KoColorSpaceMaths<float, dst_channel_type>::scaleToA(KisDitherMaths::apply_dither(c, factors[i], scale));
+        }
+    }
+};
+
+/**
+ * Generic scalar implementation of the depth scaler. It is used for the
+ * `xsimd::generic` architecture and as a tail-processor for the
+ * vectorized versions.
+ */
+template<typename _impl,
+         typename src_channel_type,
+         typename dst_channel_type,
+         typename EnableDummyType = void>
+class KoOptimizedPixelDepthScaler : public KoOptimizedPixelDepthScalerBase
+{
+public:
+    KoOptimizedPixelDepthScaler(int channelsPerPixel)
+        : KoOptimizedPixelDepthScalerBase(channelsPerPixel)
+    {
+    }
+
+    void convert(const quint8 *src, int srcRowStride, quint8 *dst, int dstRowStride, int numRows, int numColumns) const override
+    {
+        const int numColorChannels = m_channelsPerPixel * numColumns;
+
+        for (int row = 0; row < numRows; row++) {
+            scaleChannels(reinterpret_cast<const src_channel_type*>(src),
+                          reinterpret_cast<dst_channel_type*>(dst),
+                          numColorChannels);
+
+            src += srcRowStride;
+            dst += dstRowStride;
+        }
+    }
+
+    void ditherChannels(const quint8 *src, quint8 *dst, const float *factors, float scale, int numChannels) const override
+    {
+        KoDepthScalerDither<_impl, src_channel_type, dst_channel_type>::ditherChannels(
+            reinterpret_cast<const src_channel_type*>(src), reinterpret_cast<dst_channel_type*>(dst),
+            factors, scale, numChannels);
+    }
+
+    static inline void scaleChannels(const src_channel_type *src, dst_channel_type *dst, int numChannels)
+    {
+        for (int i = 0; i < numChannels; i++) {
+            dst[i] = KoColorSpaceMaths<src_channel_type, dst_channel_type>::scaleToA(src[i]);
+        }
+    }
+};
+
+/**
+ * U8 -> U16 conversion reuses the specially tuned integer kernels
+ */
+template<typename _impl>
+class KoOptimizedPixelDepthScaler<_impl, quint8, quint16, void> : public KoOptimizedPixelDepthScalerBase
+{
+public:
+    KoOptimizedPixelDepthScaler(int channelsPerPixel)
+        : KoOptimizedPixelDepthScalerBase(channelsPerPixel),
+          m_scaler(channelsPerPixel)
+    {
+    }
+
+    void convert(const quint8 *src, int srcRowStride, quint8 *dst, int dstRowStride, int numRows, int numColumns) const override
+    {
+        m_scaler.convertU8ToU16(src, srcRowStride, dst, dstRowStride, numRows, numColumns);
+    }
+
+    void ditherChannels(const quint8 *src, quint8 *dst, const float *factors, float scale, int numChannels) const override
+    {
+        KoDepthScalerDither<_impl, quint8, quint16>::ditherChannels(
+            reinterpret_cast<const quint8*>(src), reinterpret_cast<quint16*>(dst),
+            factors, scale, numChannels);
+    }
+
+private:
+    KoOptimizedPixelDataScalerU8ToU16<_impl> m_scaler;
+};
+
+/**
+ * U16 -> U8 conversion reuses the specially tuned integer kernels
+ */
+template<typename _impl>
+class KoOptimizedPixelDepthScaler<_impl, quint16, quint8, void> : public KoOptimizedPixelDepthScalerBase
+{
+public:
+    KoOptimizedPixelDepthScaler(int channelsPerPixel)
+        : KoOptimizedPixelDepthScalerBase(channelsPerPixel),
+          m_scaler(channelsPerPixel)
+    {
+    }
+
+    void convert(const quint8 *src, int srcRowStride, quint8 *dst, int dstRowStride, int numRows, int numColumns) const override
+    {
+        m_scaler.convertU16ToU8(src, srcRowStride, dst, dstRowStride, numRows, numColumns);
+    }
+
+    void ditherChannels(const quint8 *src, quint8 *dst, const float *factors, float scale, int numChannels) const override
+    {
+        KoDepthScalerDither<_impl, quint16, quint8>::ditherChannels(
+            reinterpret_cast<const quint16*>(src), reinterpret_cast<quint8*>(dst),
+            factors, scale, numChannels);
+    }
+
+private:
+    KoOptimizedPixelDataScalerU8ToU16<_impl> m_scaler;
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Loads and stores a batch of channels of type \p channel_type
+ * converting them into normalized floating point values
+ */
+template<typename _impl, typename channel_type>
+struct KoDepthScalerChannelIO
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+
+    static_assert(std::is_integral<channel_type>::value, "the generic version is used for integer types only");
+
+    static ALWAYS_INLINE float_v load(const channel_type *ptr)
+    {
+        return xsimd::batch_cast<float>(xsimd::load_and_extend<int_v>(ptr)) *
+            float_v(1.0f / KoColorSpaceMathsTraits<channel_type>::unitValue);
+    }
+
+    static ALWAYS_INLINE void store(const float_v &value, channel_type *ptr)
+    {
+        const float_v unit(KoColorSpaceMathsTraits<channel_type>::unitValue);
+        const float_v scaled = xsimd::min(xsimd::max(value * unit, float_v(0.0f)), unit);
+
+        int buf[int_v::size];
+        xsimd::nearbyint_as_int(scaled).store_unaligned(buf);
+
+        for (size_t i = 0; i < int_v::size; i++) {
+            ptr[i] = static_cast<channel_type>(buf[i]);
+        }
+    }
+};
+
+template<typename _impl>
+struct KoDepthScalerChannelIO<_impl, float>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    static ALWAYS_INLINE float_v load(const float *ptr)
+    {
+        return float_v::load_unaligned(ptr);
+    }
+
+    static ALWAYS_INLINE void store(const float_v &value, float *ptr)
+    {
+        value.store_unaligned(ptr);
+    }
+};
+
+#ifdef HAVE_OPENEXR
+
+/**
+ * There is no portable vectorized half-float conversion, so we just
+ * convert the values with the lookup table of Imath and then let the
+ * remaining arithmetic be vectorized.
+ */
+template<typename _impl>
+struct KoDepthScalerChannelIO<_impl, half>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    static ALWAYS_INLINE float_v load(const half *ptr)
+    {
+        float buf[float_v::size];
+
+        for (size_t i = 0; i < float_v::size; i++) {
+            buf[i] = ptr[i];
+        }
+
+        return float_v::load_unaligned(buf);
+    }
+
+    static ALWAYS_INLINE void store(const float_v &value, half *ptr)
+    {
+        float buf[float_v::size];
+        value.store_unaligned(buf);
+
+        for (size_t i = 0; i < float_v::size; i++) {
+            ptr[i] = half(buf[i]);
+        }
+    }
+};
+
+#endif /* HAVE_OPENEXR */
+
+/**
+ * Vectorized version of the dithering conversion. The channels are
+ * converted into normalized float batches, mixed with the thresholds
+ * and stored into the destination type.
+ */
+template<typename _impl, typename src_channel_type, typename dst_channel_type>
+struct KoDepthScalerDither<
+        _impl, src_channel_type, dst_channel_type,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using SrcIO = KoDepthScalerChannelIO<_impl, src_channel_type>;
+    using DstIO = KoDepthScalerChannelIO<_impl, dst_channel_type>;
+    using ScalarImpl = KoDepthScalerDither<xsimd::generic, src_channel_type, dst_channel_type>;
+
+    static inline void ditherChannels(const src_channel_type *src, dst_channel_type *dst,
+                                      const float *factors, float scale, int numChannels)
+    {
+        const int vectorBlock = numChannels / static_cast<int>(float_v::size);
+        const int scalarBlock = numChannels % static_cast<int>(float_v::size);
+
+        const float_v s(scale);
+
+        for (int i = 0; i < vectorBlock; i++) {
+            const float_v c = SrcIO::load(src);
+            const float_v d = float_v::load_unaligned(factors);
+
+            // keep the order of operations of KisDitherMaths::apply_dither()
+            DstIO::store(c + (d - c) * s, dst);
+
+            src += float_v::size;
+            dst += float_v::size;
+            factors += float_v::size;
+        }
+
+        ScalarImpl::ditherChannels(src, dst, factors, scale, scalarBlock);
+    }
+};
+
+/**
+ * Vectorized version of the scaler. All the values are converted into
+ * normalized float batches and then stored into the destination type.
+ */
+template<typename _impl, typename src_channel_type, typename dst_channel_type>
+class KoOptimizedPixelDepthScaler<
+        _impl, src_channel_type, dst_channel_type,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value &&
+                                !KoIsIntegerDepthScalingPair<src_channel_type, dst_channel_type>::value>::type>
+    : public KoOptimizedPixelDepthScalerBase
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using SrcIO = KoDepthScalerChannelIO<_impl, src_channel_type>;
+    using DstIO = KoDepthScalerChannelIO<_impl, dst_channel_type>;
+    using ScalarImpl = KoOptimizedPixelDepthScaler<xsimd::generic, src_channel_type, dst_channel_type>;
+
+public:
+    KoOptimizedPixelDepthScaler(int channelsPerPixel)
+        : KoOptimizedPixelDepthScalerBase(channelsPerPixel)
+    {
+    }
+
+    void convert(const quint8 *src, int srcRowStride, quint8 *dst, int dstRowStride, int numRows, int numColumns) const override
+    {
+        const int numColorChannels = m_channelsPerPixel * numColumns;
+        const int vectorBlock = numColorChannels / static_cast<int>(float_v::size);
+        const int scalarBlock = numColorChannels % static_cast<int>(float_v::size);
+
+        for (int row = 0; row < numRows; row++) {
+            const src_channel_type *srcPtr = reinterpret_cast<const src_channel_type*>(src);
+            dst_channel_type *dstPtr = reinterpret_cast<dst_channel_type*>(dst);
+
+            for (int i = 0; i < vectorBlock; i++) {
+                DstIO::store(SrcIO::load(srcPtr), dstPtr);
+
+                srcPtr += float_v::size;
+                dstPtr += float_v::size;
+            }
+
+            ScalarImpl::scaleChannels(srcPtr, dstPtr, scalarBlock);
+
+            src += srcRowStride;
+            dst += dstRowStride;
+        }
+    }
+
+    void ditherChannels(const quint8 *src, quint8 *dst, const float *factors, float scale, int numChannels) const override
+    {
+        KoDepthScalerDither<_impl, src_channel_type, dst_channel_type>::ditherChannels(
+            reinterpret_cast<const src_channel_type*>(src), reinterpret_cast<dst_channel_type*>(dst),
+            factors, scale, numChannels);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KoOptimizedPixelDepthScaler_H
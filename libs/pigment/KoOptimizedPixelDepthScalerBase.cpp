@@ -0,0 +1,26 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedPixelDepthScalerBase.h"
+
+KoOptimizedPixelDepthScalerBase::KoOptimizedPixelDepthScalerBase(int channelsPerPixel)
+    : m_channelsPerPixel(channelsPerPixel)
+{
+}
+
+KoOptimizedPixelDepthScalerBase::~KoOptimizedPixelDepthScalerBase()
+{
+}
+
+void KoOptimizedPixelDepthScalerBase::convertPixels(const quint8 *src, quint8 *dst, int numPixels) const
+{
+    convert(src, 0, dst, 0, 1, numPixels);
+}
+
+int KoOptimizedPixelDepthScalerBase::channelsPerPixel() const
+{
+    return m_channelsPerPixel;
+}
@@ -0,0 +1,72 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedPixelDepthScalerBase_H
+#define KoOptimizedPixelDepthScalerBase_H
+
+#include <QtGlobal>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Converts pixel data between two channel depths of the same color model
+ *
+ * This is a generalization of `KoOptimizedPixelDataScalerU8ToU16Base`
+ * for all the depth pairs supported by Krita: U8, U16, F16 and F32.
+ * The scaler does nothing except rescaling the values of every channel
+ * (including alpha), so it can be used only when both color spaces have
+ * the same color model, the same profile and the same order of channels.
+ *
+ * The actual implementation is placed in class `KoOptimizedPixelDepthScaler`,
+ * which is compiled for every supported CPU architecture. The integer-to-integer
+ * pairs reuse the kernels of `KoOptimizedPixelDataScalerU8ToU16`.
+ *
+ * To create a scaler, just call a factory. It will create a version
+ * of the scaler optimized for your CPU architecture.
+ *
+ * \code{.cpp}
+ * QScopedPointer<KoOptimizedPixelDepthScalerBase> scaler(
+ *     KoOptimizedPixelDepthScalerFactory::create(Integer8BitsColorDepthID,
+ *                                                Float32BitsColorDepthID,
+ *                                                4));
+ *
+ * scaler->convert(src, srcRowStride,
+ *                 dst, dstRowStride,
+ *                 numRows, numColumns);
+ * \endcode
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedPixelDepthScalerBase
+{
+public:
+    KoOptimizedPixelDepthScalerBase(int channelsPerPixel);
+
+    virtual ~KoOptimizedPixelDepthScalerBase();
+
+    virtual void convert(const quint8 *src, int srcRowStride,
+                         quint8 *dst, int dstRowStride,
+                         int numRows, int numColumns) const = 0;
+
+    /**
+     * Convert a continuous array of \p numPixels pixels
+     */
+    void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const;
+
+    /**
+     * Convert a continuous array of \p numChannels channels, mixing every
+     * channel with the corresponding value of \p factors with the ratio
+     * \p scale before storing it (see `KisDitherMaths::apply_dither()`).
+     * \p factors should contain one value per channel.
+     */
+    virtual void ditherChannels(const quint8 *src, quint8 *dst,
+                                const float *factors, float scale,
+                                int numChannels) const = 0;
+
+    int channelsPerPixel() const;
+
+protected:
+    int m_channelsPerPixel;
+};
+
+#endif // KoOptimizedPixelDepthScalerBase_H
@@ -0,0 +1,73 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedPixelDepthScalerFactory.h"
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorModelStandardIdsUtils.h>
+
+#include "KoOptimizedPixelDepthScalerFactoryImpl.h"
+
+#include <type_traits>
+
+namespace {
+
+bool isSupportedDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID ||
+#ifdef HAVE_OPENEXR
+        depthId == Float16BitsColorDepthID ||
+#endif
+        depthId == Float32BitsColorDepthID;
+}
+
+template <typename src_channel_type, typename dst_channel_type>
+KoOptimizedPixelDepthScalerBase* createScaler(int channelsPerPixel, std::false_type)
+{
+    return createOptimizedClass<
+        KoOptimizedPixelDepthScalerFactoryImpl<src_channel_type, dst_channel_type>>(channelsPerPixel);
+}
+
+template <typename src_channel_type, typename dst_channel_type>
+KoOptimizedPixelDepthScalerBase* createScaler(int, std::true_type)
+{
+    // same-depth "conversion" is just a memcpy, no scaler is instantiated for it
+    return nullptr;
+}
+
+template <typename src_channel_type>
+struct CreateScalerForSource
+{
+    template <typename dst_channel_type>
+    struct CreateScaler
+    {
+        KoOptimizedPixelDepthScalerBase* operator() (int channelsPerPixel) {
+            return createScaler<src_channel_type, dst_channel_type>(
+                channelsPerPixel, std::is_same<src_channel_type, dst_channel_type>());
+        }
+    };
+
+    KoOptimizedPixelDepthScalerBase* operator() (const KoID &dstDepthId, int channelsPerPixel) {
+        return channelTypeForColorDepthId<CreateScaler>(dstDepthId, channelsPerPixel);
+    }
+};
+
+}
+
+bool KoOptimizedPixelDepthScalerFactory::isSupported(const KoID &srcDepthId, const KoID &dstDepthId)
+{
+    return srcDepthId != dstDepthId &&
+        isSupportedDepth(srcDepthId) &&
+        isSupportedDepth(dstDepthId);
+}
+
+KoOptimizedPixelDepthScalerBase *KoOptimizedPixelDepthScalerFactory::create(const KoID &srcDepthId, const KoID &dstDepthId, int channelsPerPixel)
+{
+    if (!isSupported(srcDepthId, dstDepthId)) return nullptr;
+
+    return channelTypeForColorDepthId<CreateScalerForSource>(srcDepthId, dstDepthId, channelsPerPixel);
+}
@@ -0,0 +1,36 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedPixelDepthScalerFACTORY_H
+#define KoOptimizedPixelDepthScalerFACTORY_H
+
+#include "KoOptimizedPixelDepthScalerBase.h"
+
+#include <KoID.h>
+
+/**
+ * \see KoOptimizedPixelDepthScalerBase
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedPixelDepthScalerFactory
+{
+public:
+    /**
+     * \return true if there is an optimized scaler for
+     * the pair of depths \p srcDepthId and \p dstDepthId
+     */
+    static bool isSupported(const KoID &srcDepthId, const KoID &dstDepthId);
+
+    /**
+     * Create a scaler that converts pixels with \p channelsPerPixel
+     * channels from \p srcDepthId into \p dstDepthId. Returns null
+     * if the pair is not supported.
+     */
+    static KoOptimizedPixelDepthScalerBase* create(const KoID &srcDepthId,
+                                                   const KoID &dstDepthId,
+                                                   int channelsPerPixel);
+};
+
+#endif // KoOptimizedPixelDepthScalerFACTORY_H
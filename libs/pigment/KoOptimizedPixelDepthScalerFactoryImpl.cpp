@@ -0,0 +1,41 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedPixelDepthScalerFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedPixelDepthScaler.h"
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+template<typename src_channel_type, typename dst_channel_type>
+template<typename _impl>
+KoOptimizedPixelDepthScalerBase *
+KoOptimizedPixelDepthScalerFactoryImpl<src_channel_type, dst_channel_type>::create(int channelsPerPixel)
+{
+    return new KoOptimizedPixelDepthScaler<_impl, src_channel_type, dst_channel_type>(channelsPerPixel);
+}
+
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<quint8,  quint16>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<quint8,  float>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<quint16, quint8>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<quint16, float>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<float,   quint8>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<float,   quint16>::create<xsimd::current_arch>(int);
+
+#ifdef HAVE_OPENEXR
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<quint8,  half>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<quint16, half>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<half,    quint8>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<half,    quint16>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<half,    float>::create<xsimd::current_arch>(int);
+template KoOptimizedPixelDepthScalerBase* KoOptimizedPixelDepthScalerFactoryImpl<float,   half>::create<xsimd::current_arch>(int);
+#endif
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedPixelDepthScalerFACTORYIMPL_H
+#define KoOptimizedPixelDepthScalerFACTORYIMPL_H
+
+#include <KoOptimizedPixelDepthScalerBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+template<typename src_channel_type, typename dst_channel_type>
+class KRITAPIGMENT_EXPORT KoOptimizedPixelDepthScalerFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoOptimizedPixelDepthScalerBase* create(int);
+};
+
+#endif // KoOptimizedPixelDepthScalerFACTORYIMPL_H
@@ -0,0 +1,293 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedPremultipliedAlphaOps_H
+#define KoOptimizedPremultipliedAlphaOps_H
+
+#include "KoOptimizedPremultipliedAlphaOpsBase.h"
+
+#include <type_traits>
+
+#include "KoAlwaysInline.h"
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+namespace KoPremultipliedAlphaMath {
+
+struct Pixel {
+    float red;
+    float green;
+    float blue;
+    float alpha;
+};
+
+/**
+ * Fully transparent pixels are left untouched, so that their color
+ * survives the round trip through the premultiplied form
+ */
+ALWAYS_INLINE void premultiplyPixel(quint8 *pixel)
+{
+    Pixel *p = reinterpret_cast<Pixel*>(pixel);
+
+    if (p->alpha > 0.0f) {
+        p->red *= p->alpha;
+        p->green *= p->alpha;
+        p->blue *= p->alpha;
+    }
+}
+
+ALWAYS_INLINE void unpremultiplyPixel(quint8 *pixel)
+{
+    Pixel *p = reinterpret_cast<Pixel*>(pixel);
+
+    if (p->alpha > 0.0f) {
+        p->red /= p->alpha;
+        p->green /= p->alpha;
+        p->blue /= p->alpha;
+    }
+}
+
+/**
+ * Composes a straight \p src pixel over a premultiplied \p dst one,
+ * \p srcAlphaScale is the product of opacity and mask values. The color
+ * of a fully transparent \p dst pixel is ignored, because it is kept
+ * in straight form by premultiplyPixel()
+ */
+ALWAYS_INLINE void compositeOverPixel(const quint8 *src, quint8 *dst, float srcAlphaScale)
+{
+    const Pixel *s = reinterpret_cast<const Pixel*>(src);
+    Pixel *d = reinterpret_cast<Pixel*>(dst);
+
+    const float srcAlpha = s->alpha * srcAlphaScale;
+    if (srcAlpha == 0.0f) return;
+
+    const float dstFactor = 1.0f - srcAlpha;
+    const float dstColorFactor = d->alpha > 0.0f ? dstFactor : 0.0f;
+
+    d->red = s->red * srcAlpha + d->red * dstColorFactor;
+    d->green = s->green * srcAlpha + d->green * dstColorFactor;
+    d->blue = s->blue * srcAlpha + d->blue * dstColorFactor;
+    d->alpha = srcAlpha + d->alpha * dstFactor;
+}
+
+}
+
+/**
+ * Generic scalar implementation of the premultiplied ops. It is used
+ * for the `xsimd::generic` architecture and as a tail-processor for
+ * the vectorized version.
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KoOptimizedPremultipliedAlphaOps : public KoOptimizedPremultipliedAlphaOpsBase
+{
+public:
+    static constexpr int pixelSize = sizeof(KoPremultipliedAlphaMath::Pixel);
+
+    void premultiply(quint8 *pixels, int numPixels) const override
+    {
+        for (int i = 0; i < numPixels; i++) {
+            KoPremultipliedAlphaMath::premultiplyPixel(pixels);
+            pixels += pixelSize;
+        }
+    }
+
+    void unpremultiply(quint8 *pixels, int numPixels) const override
+    {
+        for (int i = 0; i < numPixels; i++) {
+            KoPremultipliedAlphaMath::unpremultiplyPixel(pixels);
+            pixels += pixelSize;
+        }
+    }
+
+    void compositeOver(const KoCompositeOp::ParameterInfo &params) const override
+    {
+        const qint32 srcInc = params.srcRowStride ? pixelSize : 0;
+        const float uint8Rec1 = 1.0f / 255.0f;
+
+        const quint8 *srcRowStart = params.srcRowStart;
+        const quint8 *maskRowStart = params.maskRowStart;
+        quint8 *dstRowStart = params.dstRowStart;
+
+        for (qint32 r = 0; r < params.rows; r++) {
+            const quint8 *src = srcRowStart;
+            const quint8 *mask = maskRowStart;
+            quint8 *dst = dstRowStart;
+
+            for (qint32 c = 0; c < params.cols; c++) {
+                const float srcAlphaScale =
+                    mask ? params.opacity * float(*mask++) * uint8Rec1 : params.opacity;
+
+                KoPremultipliedAlphaMath::compositeOverPixel(src, dst, srcAlphaScale);
+
+                src += srcInc;
+                dst += pixelSize;
+            }
+
+            srcRowStart += params.srcRowStride;
+            dstRowStart += params.dstRowStride;
+            if (maskRowStart) {
+                maskRowStart += params.maskRowStride;
+            }
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+#include "KoStreamedMath.h"
+
+/**
+ * The compositor for KoStreamedMath::genericComposite128(). In contrast
+ * to OverCompositor128 it has no branches and no divisions, because
+ * the destination is kept premultiplied. Fully transparent destination
+ * pixels keep their straight color, so it is masked out unless the source
+ * pixel is transparent as well.
+ */
+struct OverPremultipliedCompositor128 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+        {
+            Q_UNUSED(params);
+        }
+    };
+
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+        float_v src_alpha;
+
+        PixelWrapper<float, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        if (xsimd::all(src_alpha == float_v(0.0f))) {
+            return;
+        }
+
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+        float_v dst_alpha;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        const float_v zeroValue(0.0f);
+        const float_v dst_factor = float_v(1.0f) - src_alpha;
+        const float_m dst_transparent = (dst_alpha <= zeroValue) & (src_alpha != zeroValue);
+        const float_v dst_color_factor = xsimd::set_zero(dst_factor, dst_transparent);
+
+        dst_c1 = src_c1 * src_alpha + dst_c1 * dst_color_factor;
+        dst_c2 = src_c2 * src_alpha + dst_c2 * dst_color_factor;
+        dst_c3 = src_c3 * src_alpha + dst_c3 * dst_color_factor;
+        dst_alpha = src_alpha + dst_alpha * dst_factor;
+
+        dataWrapper.write(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src,
+                                                      quint8 *dst,
+                                                      const quint8 *mask,
+                                                      float opacity,
+                                                      const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        if (haveMask) {
+            opacity *= float(*mask) * (1.0f / 255.0f);
+        }
+
+        KoPremultipliedAlphaMath::compositeOverPixel(src, dst, opacity);
+    }
+};
+
+template<typename _impl>
+class KoOptimizedPremultipliedAlphaOps<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KoOptimizedPremultipliedAlphaOps<xsimd::generic>
+{
+    using float_v = typename KoStreamedMath<_impl>::float_v;
+
+public:
+    void premultiply(quint8 *pixels, int numPixels) const override
+    {
+        const int block1 = numPixels / static_cast<int>(float_v::size);
+        const int block2 = numPixels % static_cast<int>(float_v::size);
+        const int vectorPixelStride = pixelSize * static_cast<int>(float_v::size);
+
+        PixelWrapper<float, _impl> dataWrapper;
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        for (int i = 0; i < block1; i++) {
+            float_v c1, c2, c3, alpha;
+            dataWrapper.read(pixels, c1, c2, c3, alpha);
+
+            const float_v factor = xsimd::select(alpha <= zeroValue, oneValue, alpha);
+
+            dataWrapper.write(pixels, c1 * factor, c2 * factor, c3 * factor, alpha);
+            pixels += vectorPixelStride;
+        }
+
+        KoOptimizedPremultipliedAlphaOps<xsimd::generic>::premultiply(pixels, block2);
+    }
+
+    void unpremultiply(quint8 *pixels, int numPixels) const override
+    {
+        const int block1 = numPixels / static_cast<int>(float_v::size);
+        const int block2 = numPixels % static_cast<int>(float_v::size);
+        const int vectorPixelStride = pixelSize * static_cast<int>(float_v::size);
+
+        PixelWrapper<float, _impl> dataWrapper;
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        for (int i = 0; i < block1; i++) {
+            float_v c1, c2, c3, alpha;
+            dataWrapper.read(pixels, c1, c2, c3, alpha);
+
+            /**
+             * A real division instead of multiplication by the reciprocal,
+             * so that a premultiply/unpremultiply round trip gives back
+             * the original color
+             */
+            const float_v divisor = xsimd::select(alpha <= zeroValue, oneValue, alpha);
+
+            dataWrapper.write(pixels, c1 / divisor, c2 / divisor, c3 / divisor, alpha);
+            pixels += vectorPixelStride;
+        }
+
+        KoOptimizedPremultipliedAlphaOps<xsimd::generic>::unpremultiply(pixels, block2);
+    }
+
+    void compositeOver(const KoCompositeOp::ParameterInfo &params) const override
+    {
+        if (params.maskRowStart) {
+            KoStreamedMath<_impl>::template genericComposite128<true, false, OverPremultipliedCompositor128>(params);
+        } else {
+            KoStreamedMath<_impl>::template genericComposite128<false, false, OverPremultipliedCompositor128>(params);
+        }
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KoOptimizedPremultipliedAlphaOps_H
@@ -0,0 +1,15 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedPremultipliedAlphaOpsBase.h"
+
+KoOptimizedPremultipliedAlphaOpsBase::KoOptimizedPremultipliedAlphaOpsBase()
+{
+}
+
+KoOptimizedPremultipliedAlphaOpsBase::~KoOptimizedPremultipliedAlphaOpsBase()
+{
+}
@@ -0,0 +1,63 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedPremultipliedAlphaOpsBase_H
+#define KoOptimizedPremultipliedAlphaOpsBase_H
+
+#include <QtGlobal>
+#include "kritapigment_export.h"
+
+#include "KoCompositeOp.h"
+
+/**
+ * @brief Kernels for keeping RGBA F32 pixels in premultiplied form
+ *
+ * Every normal composite op works with straight (non-premultiplied)
+ * alpha, therefore it has to divide the resulting color by the
+ * resulting alpha on every pixel. When many layers are composited
+ * onto the same destination, it is cheaper to premultiply the
+ * destination once, composite all the layers with a division-free
+ * kernel and convert the result back only when compositing is finished.
+ *
+ * The pixels are expected to be in RGBA F32 format, with alpha placed
+ * in the last channel (16 bytes per pixel).
+ *
+ * The actual implementation is placed in class `KoOptimizedPremultipliedAlphaOps`,
+ * which is compiled for every supported CPU architecture. Use
+ * `KoOptimizedPremultipliedAlphaOpsFactory` to create an instance of it.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedPremultipliedAlphaOpsBase
+{
+public:
+    KoOptimizedPremultipliedAlphaOpsBase();
+
+    virtual ~KoOptimizedPremultipliedAlphaOpsBase();
+
+    /**
+     * Convert a continuous array of \p numPixels straight pixels
+     * into premultiplied form in-place. Fully transparent pixels
+     * are left unchanged.
+     */
+    virtual void premultiply(quint8 *pixels, int numPixels) const = 0;
+
+    /**
+     * Convert a continuous array of \p numPixels premultiplied pixels
+     * back into straight form in-place. Fully transparent pixels
+     * are left unchanged, so they keep the color they had before
+     * premultiply() was called.
+     */
+    virtual void unpremultiply(quint8 *pixels, int numPixels) const = 0;
+
+    /**
+     * Composite straight source pixels over premultiplied destination
+     * pixels with the "normal" blending mode. The destination stays
+     * premultiplied. The color of fully transparent destination pixels
+     * is treated as zero. Channel flags and flow of \p params are ignored.
+     */
+    virtual void compositeOver(const KoCompositeOp::ParameterInfo &params) const = 0;
+};
+
+#endif // KoOptimizedPremultipliedAlphaOpsBase_H
@@ -0,0 +1,15 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedPremultipliedAlphaOpsFactory.h"
+
+#include "KoOptimizedPremultipliedAlphaOpsFactoryImpl.h"
+
+KoOptimizedPremultipliedAlphaOpsBase *KoOptimizedPremultipliedAlphaOpsFactory::create()
+{
+    return createOptimizedClass<
+            KoOptimizedPremultipliedAlphaOpsFactoryImpl>();
+}
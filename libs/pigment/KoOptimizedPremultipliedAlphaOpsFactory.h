@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedPremultipliedAlphaOpsFACTORY_H
+#define KoOptimizedPremultipliedAlphaOpsFACTORY_H
+
+#include "KoOptimizedPremultipliedAlphaOpsBase.h"
+
+class KRITAPIGMENT_EXPORT KoOptimizedPremultipliedAlphaOpsFactory
+{
+public:
+    static KoOptimizedPremultipliedAlphaOpsBase* create();
+};
+
+#endif // KoOptimizedPremultipliedAlphaOpsFACTORY_H
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedPremultipliedAlphaOpsFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedPremultipliedAlphaOps.h"
+
+template<>
+KoOptimizedPremultipliedAlphaOpsBase *
+KoOptimizedPremultipliedAlphaOpsFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KoOptimizedPremultipliedAlphaOps<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
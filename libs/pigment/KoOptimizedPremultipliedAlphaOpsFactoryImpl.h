@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedPremultipliedAlphaOpsFACTORYIMPL_H
+#define KoOptimizedPremultipliedAlphaOpsFACTORYIMPL_H
+
+#include <KoOptimizedPremultipliedAlphaOpsBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoOptimizedPremultipliedAlphaOpsFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoOptimizedPremultipliedAlphaOpsBase* create();
+};
+
+#endif // KoOptimizedPremultipliedAlphaOpsFACTORYIMPL_H
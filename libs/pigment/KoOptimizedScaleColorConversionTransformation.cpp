@@ -0,0 +1,128 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedScaleColorConversionTransformation.h"
+
+#include <KoColorSpace.h>
+#include <KoColorProfile.h>
+#include <KoChannelInfo.h>
+#include <KoColorModelStandardIds.h>
+#include <kis_assert.h>
+
+#include "KoOptimizedPixelDepthScalerFactory.h"
+
+namespace {
+
+/**
+ * Build a mapping "pixel-order index of the source channel" ->
+ * "byte offset of the same channel in the destination pixel". Returns
+ * an empty vector when the order of the channels is the same.
+ */
+QVector<int> calculateDstChannelOffsets(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    const QList<KoChannelInfo*> srcChannels = srcCs->channels();
+    const QList<KoChannelInfo*> dstChannels = dstCs->channels();
+
+    QVector<int> offsets;
+    bool needsReordering = false;
+
+    for (int i = 0; i < srcChannels.size(); i++) {
+        const int dstIndex = KoChannelInfo::displayPositionToChannelIndex(srcChannels[i]->displayPosition(), dstChannels);
+        KIS_SAFE_ASSERT_RECOVER(dstIndex >= 0) { return QVector<int>(); }
+
+        offsets << dstChannels[dstIndex]->pos();
+        needsReordering |= dstIndex != i;
+    }
+
+    return needsReordering ? offsets : QVector<int>();
+}
+
+}
+
+KoOptimizedScaleColorConversionTransformation::KoOptimizedScaleColorConversionTransformation(const KoColorSpace *srcCs,
+                                                                                             const KoColorSpace *dstCs,
+                                                                                             Intent renderingIntent,
+                                                                                             ConversionFlags conversionFlags)
+    : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags),
+      m_scaler(KoOptimizedPixelDepthScalerFactory::create(srcCs->colorDepthId(),
+                                                          dstCs->colorDepthId(),
+                                                          srcCs->channelCount())),
+      m_dstChannelOffsets(calculateDstChannelOffsets(srcCs, dstCs))
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_scaler);
+}
+
+KoOptimizedScaleColorConversionTransformation::~KoOptimizedScaleColorConversionTransformation()
+{
+}
+
+bool KoOptimizedScaleColorConversionTransformation::canConvert(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    /**
+     * Only the models, where all the channels have the same [0; unit]
+     * range in every depth, can be converted with pure scaling. CMYK and
+     * Lab have special ranges in floating point version.
+     */
+    if (srcCs->colorModelId() != dstCs->colorModelId() ||
+        (srcCs->colorModelId() != RGBAColorModelID &&
+         srcCs->colorModelId() != GrayAColorModelID)) {
+
+        return false;
+    }
+
+    if (!srcCs->profile() || !dstCs->profile() ||
+        !(*srcCs->profile() == *dstCs->profile())) {
+
+        return false;
+    }
+
+    return srcCs->channelCount() == dstCs->channelCount() &&
+        KoOptimizedPixelDepthScalerFactory::isSupported(srcCs->colorDepthId(),
+                                                        dstCs->colorDepthId());
+}
+
+void KoOptimizedScaleColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_scaler);
+
+    if (m_dstChannelOffsets.isEmpty()) {
+        m_scaler->convertPixels(src, dst, nPixels);
+        return;
+    }
+
+    const int srcPixelSize = srcColorSpace()->pixelSize();
+    const int dstPixelSize = dstColorSpace()->pixelSize();
+    const int channelSize = dstPixelSize / m_dstChannelOffsets.size();
+    const int numChannels = m_dstChannelOffsets.size();
+
+    /**
+     * Reorder the channels in small chunks, so that the data
+     * would still be in cache when we swizzle it.
+     */
+    const int chunkSize = 256;
+    quint8 pixel[64];
+    KIS_SAFE_ASSERT_RECOVER_RETURN(dstPixelSize <= int(sizeof(pixel)));
+
+    for (int chunkStart = 0; chunkStart < nPixels; chunkStart += chunkSize) {
+        const int numChunkPixels = qMin(chunkSize, nPixels - chunkStart);
+
+        m_scaler->convertPixels(src, dst, numChunkPixels);
+
+        quint8 *dstPtr = dst;
+        for (int i = 0; i < numChunkPixels; i++) {
+            memcpy(pixel, dstPtr, dstPixelSize);
+
+            for (int ch = 0; ch < numChannels; ch++) {
+                memcpy(dstPtr + m_dstChannelOffsets[ch], pixel + ch * channelSize, channelSize);
+            }
+
+            dstPtr += dstPixelSize;
+        }
+
+        src += numChunkPixels * srcPixelSize;
+        dst += numChunkPixels * dstPixelSize;
+    }
+}
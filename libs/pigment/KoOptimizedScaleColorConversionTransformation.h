@@ -0,0 +1,51 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDSCALECOLORCONVERSIONTRANSFORMATION_H
+#define KOOPTIMIZEDSCALECOLORCONVERSIONTRANSFORMATION_H
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include "KoColorConversionTransformation.h"
+
+class KoOptimizedPixelDepthScalerBase;
+
+/**
+ * A fast-path transformation for converting between two color spaces
+ * that differ in the channel depth only, e.g. "sRGB U8" -> "sRGB F32".
+ * Such conversion is a pure rescaling of the channel values, so it is
+ * done with a vectorized KoOptimizedPixelDepthScalerBase instead of
+ * a generic color management pipeline.
+ *
+ * If the two color spaces have a different in-memory order of the
+ * channels (e.g. BGRA for integer RGB and RGBA for float RGB), the
+ * channels are reordered right after the scaling in small cache-friendly
+ * chunks.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedScaleColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    KoOptimizedScaleColorConversionTransformation(const KoColorSpace* srcCs,
+                                                  const KoColorSpace* dstCs,
+                                                  Intent renderingIntent,
+                                                  ConversionFlags conversionFlags);
+    ~KoOptimizedScaleColorConversionTransformation() override;
+
+    /**
+     * \return true if conversion from \p srcCs into \p dstCs can be done
+     * by this transformation
+     */
+    static bool canConvert(const KoColorSpace *srcCs, const KoColorSpace *dstCs);
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
+
+private:
+    QScopedPointer<KoOptimizedPixelDepthScalerBase> m_scaler;
+    QVector<int> m_dstChannelOffsets;
+};
+
+#endif // KOOPTIMIZEDSCALECOLORCONVERSIONTRANSFORMATION_H
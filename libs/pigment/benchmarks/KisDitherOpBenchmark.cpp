@@ -0,0 +1,109 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KisDitherOpBenchmark.h"
+
+#include <simpletest.h>
+
+#include <QColor>
+
+#include <KisDitherOp.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+// a single tile
+#define NB_COLUMNS 64
+#define NB_ROWS 64
+#define NB_ITERATIONS 256
+
+namespace {
+
+void createRows()
+{
+    QTest::addColumn<QString>("modelID");
+    QTest::addColumn<QString>("srcDepthID");
+    QTest::addColumn<QString>("dstDepthID");
+    QTest::addColumn<int>("ditherType");
+
+    const QList<KoID> models({RGBAColorModelID, GrayAColorModelID, CMYKAColorModelID});
+    const QList<KoID> srcDepths({Float32BitsColorDepthID, Integer16BitsColorDepthID});
+
+    Q_FOREACH (const KoID &model, models) {
+        Q_FOREACH (const KoID &src, srcDepths) {
+            Q_FOREACH (int type, QList<int>({DITHER_NONE, DITHER_BAYER, DITHER_BLUE_NOISE})) {
+                const QString name = QString("%1 %2->%3 (%4)").arg(model.id()).arg(src.id()).arg(Integer8BitsColorDepthID.id()).arg(type);
+                QTest::newRow(name.toLatin1()) << model.id() << src.id() << Integer8BitsColorDepthID.id() << type;
+            }
+        }
+    }
+}
+
+}
+
+#define START_BENCHMARK \
+    QFETCH(QString, modelID); \
+    QFETCH(QString, srcDepthID); \
+    QFETCH(QString, dstDepthID); \
+    QFETCH(int, ditherType); \
+    \
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->colorSpace(modelID, srcDepthID, 0); \
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(modelID, dstDepthID, 0); \
+    QVERIFY(srcCs && dstCs); \
+    const KisDitherOp *op = srcCs->ditherOp(dstDepthID, DitherType(ditherType)); \
+    QVERIFY(op); \
+    \
+    const int srcPixelSize = srcCs->pixelSize(); \
+    const int dstPixelSize = dstCs->pixelSize(); \
+    QVector<quint8> src(NB_COLUMNS * NB_ROWS * srcPixelSize); \
+    QVector<quint8> dst(NB_COLUMNS * NB_ROWS * dstPixelSize); \
+    srcCs->fromQColor(QColor(100, 150, 200, 220), src.data()); \
+    for (int i = 1; i < NB_COLUMNS * NB_ROWS; i++) { \
+        memcpy(src.data() + i * srcPixelSize, src.data(), srcPixelSize); \
+    }
+
+void KisDitherOpBenchmark::benchmarkDitherRows_data()
+{
+    createRows();
+}
+
+void KisDitherOpBenchmark::benchmarkDitherRows()
+{
+    START_BENCHMARK
+
+    QBENCHMARK {
+        for (int i = 0; i < NB_ITERATIONS; i++) {
+            op->dither(src.constData(), NB_COLUMNS * srcPixelSize,
+                       dst.data(), NB_COLUMNS * dstPixelSize,
+                       i * NB_COLUMNS, 0, NB_COLUMNS, NB_ROWS);
+        }
+    }
+}
+
+void KisDitherOpBenchmark::benchmarkDitherPixels_data()
+{
+    createRows();
+}
+
+void KisDitherOpBenchmark::benchmarkDitherPixels()
+{
+    START_BENCHMARK
+
+    QBENCHMARK {
+        for (int i = 0; i < NB_ITERATIONS; i++) {
+            for (int y = 0; y < NB_ROWS; y++) {
+                for (int x = 0; x < NB_COLUMNS; x++) {
+                    const int index = y * NB_COLUMNS + x;
+                    op->dither(src.constData() + index * srcPixelSize,
+                               dst.data() + index * dstPixelSize,
+                               i * NB_COLUMNS + x, y);
+                }
+            }
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisDitherOpBenchmark)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KIS_DITHER_OP_BENCHMARK_H_
+#define KIS_DITHER_OP_BENCHMARK_H_
+
+#include <QObject>
+
+class KisDitherOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkDitherRows_data();
+    void benchmarkDitherRows();
+
+    void benchmarkDitherPixels_data();
+    void benchmarkDitherPixels();
+};
+
+#endif
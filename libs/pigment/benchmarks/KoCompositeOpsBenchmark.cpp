@@ -9,10 +9,15 @@
 #include "../compositeops/KoCompositeOpAlphaDarken.h"
 #include "../compositeops/KoCompositeOpOver.h"
 #include <KoOptimizedCompositeOpFactory.h>
+#include <KoOptimizedPremultipliedAlphaOpsFactory.h>
+#include <KoColorModelStandardIds.h>
 
 #include <KoColorSpaceTraits.h>
 #include <KoColorSpaceRegistry.h>
 
+#include <QScopedPointer>
+#include <QVector>
+
 #include <simpletest.h>
 
 const int TILE_WIDTH = 64;
@@ -96,5 +101,79 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamy()
     }
 }
 
+/**
+ * The layer stack benchmarks composite a stack of layers over the same
+ * RGBA F32 destination, like the merger does for a group layer. The
+ * premultiplied version pays for the conversion of the destination only
+ * once per stack.
+ */
+const int STACK_SIZE = 8;
+const int STACK_IMG_WIDTH = 1024;
+const int STACK_IMG_HEIGHT = 1024;
+
+namespace {
+
+QVector<float> randomFloatPixels(int numPixels)
+{
+    QVector<float> result(numPixels * 4);
+    for (int i = 0; i < result.size(); i++) {
+        result[i] = float(qrand() % 1001) / 1000.0f;
+    }
+    return result;
+}
+
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverLayerStackF32()
+{
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), 0);
+    QScopedPointer<KoCompositeOp> compositeOp(KoOptimizedCompositeOpFactory::createOverOp128(cs));
+
+    const int numPixels = STACK_IMG_WIDTH * STACK_IMG_HEIGHT;
+    const int rowStride = STACK_IMG_WIDTH * 4 * sizeof(float);
+    QVector<float> dst = randomFloatPixels(numPixels);
+    const QVector<float> src = randomFloatPixels(numPixels);
+
+    QBENCHMARK {
+        for (int i = 0; i < STACK_SIZE; i++) {
+            compositeOp->composite(reinterpret_cast<quint8*>(dst.data()), rowStride,
+                                   reinterpret_cast<const quint8*>(src.constData()), rowStride,
+                                   0, 0,
+                                   STACK_IMG_HEIGHT, STACK_IMG_WIDTH,
+                                   OPACITY_HALF);
+        }
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOverLayerStackPremultipliedF32()
+{
+    QScopedPointer<KoOptimizedPremultipliedAlphaOpsBase> ops(KoOptimizedPremultipliedAlphaOpsFactory::create());
+
+    const int numPixels = STACK_IMG_WIDTH * STACK_IMG_HEIGHT;
+    const int rowStride = STACK_IMG_WIDTH * 4 * sizeof(float);
+    QVector<float> dst = randomFloatPixels(numPixels);
+    const QVector<float> src = randomFloatPixels(numPixels);
+
+    KoCompositeOp::ParameterInfo params;
+    params.dstRowStart = reinterpret_cast<quint8*>(dst.data());
+    params.dstRowStride = rowStride;
+    params.srcRowStart = reinterpret_cast<const quint8*>(src.constData());
+    params.srcRowStride = rowStride;
+    params.rows = STACK_IMG_HEIGHT;
+    params.cols = STACK_IMG_WIDTH;
+    params.opacity = float(OPACITY_HALF) / 255.0f;
+    params.flow = 1.0f;
+
+    QBENCHMARK {
+        ops->premultiply(params.dstRowStart, numPixels);
+
+        for (int i = 0; i < STACK_SIZE; i++) {
+            ops->compositeOver(params);
+        }
+
+        ops->unpremultiply(params.dstRowStart, numPixels);
+    }
+}
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
@@ -22,6 +22,9 @@ private Q_SLOTS:
     void benchmarkCompositeAlphaDarkenHard();
     void benchmarkCompositeAlphaDarkenCreamy();
 
+    void benchmarkCompositeOverLayerStackF32();
+    void benchmarkCompositeOverLayerStackPremultipliedF32();
+
 private:
     quint8 * m_dstBuffer;
     quint8 * m_srcBuffer;
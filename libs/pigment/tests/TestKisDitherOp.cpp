@@ -0,0 +1,171 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKisDitherOp.h"
+
+#include <simpletest.h>
+
+#include <KoConfig.h>
+#include <KisDitherOp.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_debug.h>
+
+namespace {
+
+const KoColorSpace *colorSpace(const KoID &model, const KoID &depth)
+{
+    return KoColorSpaceRegistry::instance()->colorSpace(model.id(), depth.id(), nullptr);
+}
+
+/**
+ * Fill \p numPixels pixels of \p cs with a smooth gradient, so that
+ * all the values between the levels of the destination are present
+ */
+QByteArray fillGradient(const KoColorSpace *cs, int numPixels)
+{
+    QByteArray buffer(numPixels * int(cs->pixelSize()), '\0');
+    QVector<float> channels(int(cs->channelCount()));
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < channels.size(); ch++) {
+            channels[ch] = float((i * (ch + 1)) % 1021) / 1020.0f;
+        }
+        cs->fromNormalisedChannelsValue(reinterpret_cast<quint8*>(buffer.data()) + i * cs->pixelSize(), channels);
+    }
+
+    return buffer;
+}
+
+}
+
+void TestKisDitherOp::testRowsMatchPixels_data()
+{
+    QTest::addColumn<QString>("modelId");
+    QTest::addColumn<QString>("srcDepthId");
+    QTest::addColumn<QString>("dstDepthId");
+    QTest::addColumn<int>("ditherType");
+
+    QList<KoID> srcDepths;
+    srcDepths << Integer16BitsColorDepthID << Float32BitsColorDepthID;
+#ifdef HAVE_OPENEXR
+    srcDepths << Float16BitsColorDepthID;
+#endif
+
+    const QList<KoID> dstDepths({Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID});
+    const QList<KoID> models({RGBAColorModelID, GrayAColorModelID, CMYKAColorModelID});
+    const QList<int> types({DITHER_NONE, DITHER_BAYER, DITHER_BLUE_NOISE});
+
+    Q_FOREACH (const KoID &model, models) {
+        Q_FOREACH (const KoID &src, srcDepths) {
+            Q_FOREACH (const KoID &dst, dstDepths) {
+                if (!colorSpace(model, src) || !colorSpace(model, dst)) continue;
+
+                Q_FOREACH (int type, types) {
+                    const QString name = QString("%1 %2->%3 (%4)").arg(model.id()).arg(src.id()).arg(dst.id()).arg(type);
+                    QTest::newRow(name.toLatin1()) << model.id() << src.id() << dst.id() << type;
+                }
+            }
+        }
+    }
+}
+
+void TestKisDitherOp::testRowsMatchPixels()
+{
+    QFETCH(QString, modelId);
+    QFETCH(QString, srcDepthId);
+    QFETCH(QString, dstDepthId);
+    QFETCH(int, ditherType);
+
+    const KoColorSpace *srcCs = colorSpace(KoID(modelId), KoID(srcDepthId));
+    const KoColorSpace *dstCs = colorSpace(KoID(modelId), KoID(dstDepthId));
+
+    const KisDitherOp *op = srcCs->ditherOp(dstDepthId, DitherType(ditherType));
+    QVERIFY(op);
+
+    // more columns than a single chunk of the vectorized path
+    const int columns = 301;
+    const int rows = 5;
+    const int x = 13;
+    const int y = 7;
+
+    const int srcPixelSize = int(srcCs->pixelSize());
+    const int dstPixelSize = int(dstCs->pixelSize());
+    const int srcRowStride = (columns + 3) * srcPixelSize;
+    const int dstRowStride = (columns + 5) * dstPixelSize;
+
+    const QByteArray src = fillGradient(srcCs, srcRowStride / srcPixelSize * rows);
+    QByteArray dstRows(dstRowStride * rows, '\0');
+    QByteArray dstPixels(dstRowStride * rows, '\0');
+
+    op->dither(reinterpret_cast<const quint8*>(src.constData()), srcRowStride,
+               reinterpret_cast<quint8*>(dstRows.data()), dstRowStride,
+               x, y, columns, rows);
+
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            op->dither(reinterpret_cast<const quint8*>(src.constData()) + row * srcRowStride + column * srcPixelSize,
+                       reinterpret_cast<quint8*>(dstPixels.data()) + row * dstRowStride + column * dstPixelSize,
+                       x + column, y + row);
+        }
+    }
+
+    QVector<float> rowValues(int(dstCs->channelCount()));
+    QVector<float> pixelChannels(rowValues.size());
+
+    /**
+     * The vectorized path uses a different conversion into float for integer
+     * sources, so the result may differ for the values lying exactly on the
+     * rounding border.
+     */
+    const float tolerance = 1.0f / 255.0f + 1e-5f;
+
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            const int offset = row * dstRowStride + column * dstPixelSize;
+            dstCs->normalisedChannelsValue(reinterpret_cast<const quint8*>(dstRows.constData()) + offset, rowValues);
+            dstCs->normalisedChannelsValue(reinterpret_cast<const quint8*>(dstPixels.constData()) + offset, pixelChannels);
+
+            for (int ch = 0; ch < rowValues.size(); ch++) {
+                if (qAbs(rowValues[ch] - pixelChannels[ch]) > tolerance) {
+                    qDebug() << "Failed pixel" << ppVar(row) << ppVar(column) << ppVar(ch)
+                             << ppVar(rowValues[ch]) << ppVar(pixelChannels[ch]);
+                    QFAIL("row dithering differs from per-pixel dithering");
+                }
+            }
+        }
+    }
+}
+
+void TestKisDitherOp::testExactValuesAreKept()
+{
+    const KoColorSpace *srcCs = colorSpace(RGBAColorModelID, Float32BitsColorDepthID);
+    const KoColorSpace *dstCs = colorSpace(RGBAColorModelID, Integer8BitsColorDepthID);
+
+    const int columns = 600;
+    const int channelsPerPixel = int(srcCs->channelCount());
+
+    QVector<float> src(columns * channelsPerPixel);
+    for (int i = 0; i < src.size(); i++) {
+        src[i] = float(i % 256) / 255.0f;
+    }
+
+    Q_FOREACH (DitherType type, QList<DitherType>({DITHER_BAYER, DITHER_BLUE_NOISE})) {
+        const KisDitherOp *op = srcCs->ditherOp(dstCs->colorDepthId().id(), type);
+        QVERIFY(op);
+
+        QVector<quint8> dst(columns * channelsPerPixel);
+        op->dither(reinterpret_cast<const quint8*>(src.constData()), src.size() * int(sizeof(float)),
+                   dst.data(), dst.size(), 0, 0, columns, 1);
+
+        for (int i = 0; i < dst.size(); i++) {
+            QCOMPARE(int(dst[i]), i % 256);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKisDitherOp)
@@ -598,5 +598,70 @@ void TestKoColorSpaceAbstract::testBitBltCrossColorSpaceWithChannelFlags()
     }
 }
 
+void TestKoColorSpaceAbstract::testBitBltCrossColorSpaceFusedStrips()
+{
+    const KoColorSpace *srcSpace = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *dstSpace = KoColorSpaceRegistry::instance()->rgb8();
+
+    // the rect is big enough to be split into several conversion strips
+    const int numColumns = 67;
+    const int numRows = 1023;
+    const int numPixels = numColumns * numRows;
+    const int srcPixelSize = srcSpace->pixelSize();
+    const int dstPixelSize = dstSpace->pixelSize();
+
+    QByteArray srcData(numPixels * srcPixelSize, Qt::Uninitialized);
+    QByteArray dstData(numPixels * dstPixelSize, Qt::Uninitialized);
+    QByteArray maskData(numPixels, Qt::Uninitialized);
+
+    quint16 *srcPtr = reinterpret_cast<quint16*>(srcData.data());
+    quint8 *dstPtr = reinterpret_cast<quint8*>(dstData.data());
+    quint8 *maskPtr = reinterpret_cast<quint8*>(maskData.data());
+
+    for (int i = 0; i < numPixels * 4; i++) {
+        srcPtr[i] = quint16((i * 7919) & 0xffff);
+        dstPtr[i] = quint8((i * 31) & 0xff);
+    }
+
+    for (int i = 0; i < numPixels; i++) {
+        maskPtr[i] = quint8((i * 13) & 0xff);
+    }
+
+    // reference: convert the whole source first and composite afterwards
+    QByteArray convertedData(numPixels * dstPixelSize, Qt::Uninitialized);
+    QByteArray expectedData(dstData);
+
+    srcSpace->convertPixelsTo(reinterpret_cast<const quint8*>(srcData.constData()),
+                              reinterpret_cast<quint8*>(convertedData.data()),
+                              dstSpace, numPixels,
+                              KoColorConversionTransformation::internalRenderingIntent(),
+                              KoColorConversionTransformation::internalConversionFlags());
+
+    const KoCompositeOp *op = dstSpace->compositeOp(COMPOSITE_OVER);
+
+    KoCompositeOp::ParameterInfo params;
+    params.rows = numRows;
+    params.cols = numColumns;
+    params.srcRowStart = reinterpret_cast<const quint8*>(convertedData.constData());
+    params.srcRowStride = numColumns * dstPixelSize;
+    params.dstRowStart = reinterpret_cast<quint8*>(expectedData.data());
+    params.dstRowStride = numColumns * dstPixelSize;
+    params.maskRowStart = maskPtr;
+    params.maskRowStride = numColumns;
+    params.opacity = 0.7f;
+    params.flow = 1.0f;
+    op->composite(params);
+
+    params.srcRowStart = reinterpret_cast<const quint8*>(srcData.constData());
+    params.srcRowStride = numColumns * srcPixelSize;
+    params.dstRowStart = dstPtr;
+
+    dstSpace->bitBlt(srcSpace, params, op,
+                     KoColorConversionTransformation::internalRenderingIntent(),
+                     KoColorConversionTransformation::internalConversionFlags());
+
+    QCOMPARE(dstData, expectedData);
+}
+
 
 SIMPLE_TEST_MAIN(TestKoColorSpaceAbstract)
@@ -17,6 +17,7 @@ private Q_SLOTS:
     void testMixColorsOpU8NoAlphaLinear();
     void testBitBltCrossColorSpaceWithChannelFlags_data();
     void testBitBltCrossColorSpaceWithChannelFlags();
+    void testBitBltCrossColorSpaceFusedStrips();
 
 };
 
@@ -0,0 +1,187 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKoOptimizedPixelDepthScaler.h"
+
+#include <simpletest.h>
+#include <functional>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorModelStandardIdsUtils.h>
+#include <KoColorSpaceMaths.h>
+#include <KoOptimizedPixelDepthScalerFactory.h>
+#include <kis_debug.h>
+
+namespace {
+
+/**
+ * Fill the buffer with values that cover the whole range of the channel,
+ * including the borders, and convert them into normalized floats
+ */
+template <typename channel_type>
+struct FillChannels
+{
+    QVector<float> operator() (QByteArray &buffer, int numChannels) {
+        buffer.resize(numChannels * int(sizeof(channel_type)));
+        channel_type *ptr = reinterpret_cast<channel_type*>(buffer.data());
+
+        QVector<float> normalized(numChannels);
+
+        for (int i = 0; i < numChannels; i++) {
+            const float value = float(i % 257) / 256.0f;
+            ptr[i] = KoColorSpaceMaths<float, channel_type>::scaleToA(value);
+            normalized[i] = KoColorSpaceMaths<channel_type, float>::scaleToA(ptr[i]);
+        }
+
+        return normalized;
+    }
+};
+
+template <typename channel_type>
+struct ReadChannels
+{
+    QVector<float> operator() (const QByteArray &buffer, int numChannels) {
+        const channel_type *ptr = reinterpret_cast<const channel_type*>(buffer.constData());
+        QVector<float> normalized(numChannels);
+
+        for (int i = 0; i < numChannels; i++) {
+            normalized[i] = KoColorSpaceMaths<channel_type, float>::scaleToA(ptr[i]);
+        }
+
+        return normalized;
+    }
+};
+
+template <typename channel_type>
+struct ChannelSize
+{
+    int operator() () {
+        return int(sizeof(channel_type));
+    }
+};
+
+float toleranceForDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ? 1.0f / 255.0f :
+           depthId == Integer16BitsColorDepthID ? 1.0f / 65535.0f :
+           depthId == Float16BitsColorDepthID ? 1e-3f : 1e-6f;
+}
+
+QList<KoID> supportedDepths()
+{
+    QList<KoID> depths;
+    depths << Integer8BitsColorDepthID << Integer16BitsColorDepthID;
+#ifdef HAVE_OPENEXR
+    depths << Float16BitsColorDepthID;
+#endif
+    depths << Float32BitsColorDepthID;
+    return depths;
+}
+
+}
+
+void TestKoOptimizedPixelDepthScaler::testSupportedPairs()
+{
+    QVERIFY(!KoOptimizedPixelDepthScalerFactory::isSupported(Integer8BitsColorDepthID, Integer8BitsColorDepthID));
+    QVERIFY(!KoOptimizedPixelDepthScalerFactory::isSupported(Integer8BitsColorDepthID, Float64BitsColorDepthID));
+    QVERIFY(!KoOptimizedPixelDepthScalerFactory::create(Float32BitsColorDepthID, Float32BitsColorDepthID, 4));
+
+    Q_FOREACH (const KoID &src, supportedDepths()) {
+        Q_FOREACH (const KoID &dst, supportedDepths()) {
+            QCOMPARE(KoOptimizedPixelDepthScalerFactory::isSupported(src, dst), src != dst);
+        }
+    }
+}
+
+void TestKoOptimizedPixelDepthScaler::testConversion_data()
+{
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<int>("channelsPerPixel");
+
+    Q_FOREACH (const KoID &src, supportedDepths()) {
+        Q_FOREACH (const KoID &dst, supportedDepths()) {
+            if (src == dst) continue;
+
+            Q_FOREACH (int channels, QList<int>({2, 4, 5})) {
+                const QString name = QString("%1->%2 (%3ch)").arg(src.id()).arg(dst.id()).arg(channels);
+                QTest::newRow(name.toLatin1()) << src.id() << dst.id() << channels;
+            }
+        }
+    }
+}
+
+void TestKoOptimizedPixelDepthScaler::testConversion()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, dstDepth);
+    QFETCH(int, channelsPerPixel);
+
+    const KoID srcId(srcDepth);
+    const KoID dstId(dstDepth);
+
+    // odd number of pixels to make sure the scalar tail is also tested
+    const int numPixels = 1031;
+    const int numChannels = numPixels * channelsPerPixel;
+
+    QByteArray src;
+    const QVector<float> srcValues = channelTypeForColorDepthId<FillChannels>(srcId, std::ref(src), numChannels);
+
+    QByteArray dst(numChannels * channelTypeForColorDepthId<ChannelSize>(dstId), '\0');
+
+    QScopedPointer<KoOptimizedPixelDepthScalerBase> scaler(
+        KoOptimizedPixelDepthScalerFactory::create(srcId, dstId, channelsPerPixel));
+    QVERIFY(scaler);
+    QCOMPARE(scaler->channelsPerPixel(), channelsPerPixel);
+
+    scaler->convertPixels(reinterpret_cast<const quint8*>(src.constData()),
+                          reinterpret_cast<quint8*>(dst.data()),
+                          numPixels);
+
+    const QVector<float> dstValues = channelTypeForColorDepthId<ReadChannels>(dstId, dst, numChannels);
+    const float tolerance = toleranceForDepth(dstId) + toleranceForDepth(srcId);
+
+    for (int i = 0; i < numChannels; i++) {
+        if (qAbs(srcValues[i] - dstValues[i]) > tolerance) {
+            qDebug() << "Failed channel" << i << ppVar(srcValues[i]) << ppVar(dstValues[i]);
+            QFAIL("conversion error is too high");
+        }
+    }
+}
+
+void TestKoOptimizedPixelDepthScaler::testRowStrides()
+{
+    const int channelsPerPixel = 4;
+    const int numColumns = 13;
+    const int numRows = 3;
+    const int srcRowStride = (numColumns + 3) * channelsPerPixel * int(sizeof(float));
+    const int dstRowStride = (numColumns + 5) * channelsPerPixel;
+
+    QVector<float> src(srcRowStride * numRows / int(sizeof(float)), 1.0f);
+    QVector<quint8> dst(dstRowStride * numRows, 0x11);
+
+    QScopedPointer<KoOptimizedPixelDepthScalerBase> scaler(
+        KoOptimizedPixelDepthScalerFactory::create(Float32BitsColorDepthID, Integer8BitsColorDepthID, channelsPerPixel));
+    QVERIFY(scaler);
+
+    scaler->convert(reinterpret_cast<const quint8*>(src.constData()), srcRowStride,
+                    dst.data(), dstRowStride,
+                    numRows, numColumns);
+
+    for (int row = 0; row < numRows; row++) {
+        for (int i = 0; i < dstRowStride; i++) {
+            const quint8 expected = i < numColumns * channelsPerPixel ? 255 : 0x11;
+            QCOMPARE(dst[row * dstRowStride + i], expected);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKoOptimizedPixelDepthScaler)
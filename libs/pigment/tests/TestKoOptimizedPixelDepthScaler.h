@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKOOPTIMIZEDPIXELDEPTHSCALER_H
+#define TESTKOOPTIMIZEDPIXELDEPTHSCALER_H
+
+#include <QObject>
+
+class TestKoOptimizedPixelDepthScaler : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testSupportedPairs();
+    void testConversion_data();
+    void testConversion();
+    void testRowStrides();
+};
+
+#endif // TESTKOOPTIMIZEDPIXELDEPTHSCALER_H
@@ -33,6 +33,7 @@
 // krita/ui
 #include "KisViewManager.h"
 #include "kis_canvas2.h"
+#include "kis_coordinates_converter.h"
 #include <kis_bookmarked_configuration_manager.h>
 
 #include "kis_action.h"
@@ -309,9 +310,19 @@ void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
     d->currentStrokeId =
         image->startStroke(strategy);
 
+    /**
+     * The visible part of the canvas is filtered and shown first, so
+     * that the preview of a slow filter is refined where the user is
+     * looking, while the rest of the image is still being processed
+     */
+    QRect priorityRect;
+    if (d->view->canvasBase()) {
+        priorityRect = d->view->canvasBase()->coordinatesConverter()->widgetRectInImagePixels().toAlignedRect();
+    }
+
     // Apply filter preview to active, visible frame only.
     KisImageConfig imgConf(true);
-    image->addJob(d->currentStrokeId, new KisFilterStrokeStrategy::FilterJobData());
+    image->addJob(d->currentStrokeId, new KisFilterStrokeStrategy::FilterJobData(-1, priorityRect));
 
     {
         KisFilterStrokeStrategy::IdleBarrierData *data =
@@ -0,0 +1,401 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "FreehandStrokeReplayBenchmark.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThread>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+
+#include "KisAsynchronousStrokeUpdateHelper.h"
+#include "KisFreehandStrokeRecorder.h"
+#include "kis_distance_information.h"
+#include "kis_image.h"
+#include "kis_resources_snapshot.h"
+#include "kis_timing_information.h"
+#include "stroke_testing_utils.h"
+#include "strokes/KisFreehandStrokeInfo.h"
+#include "strokes/freehand_stroke.h"
+#include <brushengine/kis_paint_information.h>
+#include <testui.h>
+
+#include "testutil.h"
+#include "KisResourceModel.h"
+#include <KisSupportedArchitectures.h>
+
+namespace {
+
+/**
+ * The same as KisToolFreehandHelper uses for the spacing and timing
+ * updates of the stroke
+ */
+const qreal SPACING_UPDATE_INTERVAL = 50.0;
+const qreal TIMING_UPDATE_INTERVAL = 50.0;
+
+struct ReplayStatistics
+{
+    /// the time spent on every painting job, in nanoseconds
+    QVector<qint64> eventLatencies;
+
+    /// the time spent on every dab, in nanoseconds
+    QVector<qint64> dabLatencies;
+
+    void clear() {
+        eventLatencies.clear();
+        dabLatencies.clear();
+    }
+};
+
+/**
+ * A freehand stroke that measures the time spent on every painting job.
+ * The time of the job is evenly split between the dabs it has painted.
+ *
+ * The painting jobs of the stroke are executed sequentially, so no
+ * locking is needed for the statistics.
+ */
+class TimedFreehandStrokeStrategy : public FreehandStrokeStrategy
+{
+public:
+    TimedFreehandStrokeStrategy(KisResourcesSnapshotSP resources,
+                                QVector<KisFreehandStrokeInfo*> strokeInfos,
+                                ReplayStatistics *statistics)
+        : FreehandStrokeStrategy(resources, strokeInfos, kundo2_noi18n("Replayed Stroke")),
+          m_strokeInfos(strokeInfos),
+          m_statistics(statistics)
+    {
+    }
+
+    void doStrokeCallback(KisStrokeJobData *data) override {
+        FreehandStrokeStrategy::Data *d = dynamic_cast<FreehandStrokeStrategy::Data*>(data);
+
+        if (!d || d->strokeInfoId < 0 || d->strokeInfoId >= m_strokeInfos.size()) {
+            FreehandStrokeStrategy::doStrokeCallback(data);
+            return;
+        }
+
+        KisDistanceInformation *distance = m_strokeInfos[d->strokeInfoId]->dragDistance;
+        const int dabsBefore = distance->currentDabSeqNo();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        FreehandStrokeStrategy::doStrokeCallback(data);
+
+        const qint64 elapsed = timer.nsecsElapsed();
+        const int numDabs = distance->currentDabSeqNo() - dabsBefore;
+
+        m_statistics->eventLatencies.append(elapsed);
+        for (int i = 0; i < numDabs; i++) {
+            m_statistics->dabLatencies.append(elapsed / numDabs);
+        }
+    }
+
+private:
+    QVector<KisFreehandStrokeInfo*> m_strokeInfos;
+    ReplayStatistics *m_statistics;
+};
+
+class FreehandStrokeReplayTester : public utils::StrokeTester
+{
+public:
+    FreehandStrokeReplayTester(const KisFreehandStrokeRecorder &recording,
+                               const QSize &imageSize,
+                               const QString &presetFilename)
+        : StrokeTester("freehand_replay", imageSize, presetFilename),
+          m_recording(recording)
+    {
+        Q_FOREACH (const KisFreehandStrokeRecorder::Event &event, m_recording.events()) {
+            m_numStrokeInfos = qMax(m_numStrokeInfos, event.strokeInfoId + 1);
+        }
+    }
+
+    void setCpuCoresLimit(int value) {
+        m_cpuCoresLimit = value;
+    }
+
+    const ReplayStatistics& statistics() const {
+        return m_statistics;
+    }
+
+protected:
+    using utils::StrokeTester::initImage;
+    void initImage(KisImageWSP image, KisNodeSP activeNode) override {
+        Q_UNUSED(activeNode);
+
+        if (m_cpuCoresLimit > 0) {
+            image->setWorkingThreadsLimit(m_cpuCoresLimit);
+        }
+    }
+
+    KisStrokeStrategy* createStroke(KisResourcesSnapshotSP resources,
+                                    KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisDistanceInitInfo startDistInfo(m_recording.startPos(),
+                                          m_recording.startAngle(),
+                                          resources->needsSpacingUpdates() ? SPACING_UPDATE_INTERVAL : LONG_TIME,
+                                          resources->needsAirbrushing() ? TIMING_UPDATE_INTERVAL : LONG_TIME,
+                                          0);
+        const KisDistanceInformation startDist = startDistInfo.makeDistInfo();
+
+        QVector<KisFreehandStrokeInfo*> strokeInfos;
+        for (int i = 0; i < m_numStrokeInfos; i++) {
+            strokeInfos << new KisFreehandStrokeInfo(startDist);
+        }
+
+        m_statistics.clear();
+
+        return new TimedFreehandStrokeStrategy(resources, strokeInfos, &m_statistics);
+    }
+
+    using utils::StrokeTester::addPaintingJobs;
+    void addPaintingJobs(KisImageWSP image, KisResourcesSnapshotSP resources) override {
+        Q_UNUSED(resources);
+
+        Q_FOREACH (const KisFreehandStrokeRecorder::Event &event, m_recording.events()) {
+            FreehandStrokeStrategy::Data *data = 0;
+
+            switch (event.type) {
+            case KisFreehandStrokeRecorder::Point:
+                data = new FreehandStrokeStrategy::Data(event.strokeInfoId, event.pi1);
+                break;
+            case KisFreehandStrokeRecorder::Line:
+                data = new FreehandStrokeStrategy::Data(event.strokeInfoId, event.pi1, event.pi2);
+                break;
+            case KisFreehandStrokeRecorder::Curve:
+                data = new FreehandStrokeStrategy::Data(event.strokeInfoId,
+                                                        event.pi1, event.control1,
+                                                        event.control2, event.pi2);
+                break;
+            }
+
+            image->addJob(strokeId(), data);
+        }
+
+        image->addJob(strokeId(), new KisAsynchronousStrokeUpdateHelper::UpdateData(true));
+    }
+
+private:
+    const KisFreehandStrokeRecorder &m_recording;
+    ReplayStatistics m_statistics;
+    int m_numStrokeInfos = 1;
+    int m_cpuCoresLimit = -1;
+};
+
+/**
+ * Generates a stroke similar to what a tablet at 200 Hz reports for a few
+ * wavy strokes with a pressure ramp and a varying tilt
+ */
+KisFreehandStrokeRecorder generateSyntheticStroke(const QSize &imageSize)
+{
+    const qreal eventInterval = 5.0; // ms
+    const int numEvents = 2000;
+
+    const QRectF area = QRectF(QPointF(), imageSize).adjusted(100, 100, -100, -100);
+
+    auto paintInfo = [&] (int i) {
+        const qreal t = qreal(i) / numEvents;
+        const qreal x = area.left() + area.width() * std::fmod(t * 4.0, 1.0);
+        const qreal y = area.top() + area.height() * (0.125 + 0.25 * std::floor(t * 4.0)) +
+            0.1 * area.height() * std::sin(t * 16.0 * M_PI);
+
+        const qreal pressure = 0.2 + 0.8 * std::abs(std::sin(t * 8.0 * M_PI));
+        const qreal xTilt = 40.0 * std::sin(t * 2.0 * M_PI);
+        const qreal yTilt = 20.0 * std::cos(t * 2.0 * M_PI);
+
+        KisPaintInformation pi(QPointF(x, y), pressure, xTilt, yTilt,
+                               0.0, 0.0, 1.0, i * eventInterval, 1.0);
+        return pi;
+    };
+
+    KisFreehandStrokeRecorder recording(paintInfo(0).pos(), 0.0);
+
+    recording.recordPoint(0, paintInfo(0));
+    for (int i = 1; i < numEvents; i++) {
+        recording.recordLine(0, paintInfo(i - 1), paintInfo(i));
+    }
+
+    return recording;
+}
+
+QSize parseImageSize(const QString &value, const QSize &defaultSize)
+{
+    const QStringList parts = value.split('x');
+    if (parts.size() != 2) return defaultSize;
+
+    bool okWidth = false;
+    bool okHeight = false;
+    const QSize size(parts[0].toInt(&okWidth), parts[1].toInt(&okHeight));
+
+    return okWidth && okHeight && !size.isEmpty() ? size : defaultSize;
+}
+
+QVector<int> parseThreadCounts(const QString &value)
+{
+    QVector<int> result;
+
+    Q_FOREACH (const QString &part, value.split(',')) {
+        bool ok = false;
+        const int threads = part.toInt(&ok);
+        if (ok && threads > 0) {
+            result << threads;
+        }
+    }
+
+    if (result.isEmpty()) {
+        result << 1 << QThread::idealThreadCount();
+    }
+
+    return result;
+}
+
+qreal percentileUs(const QVector<qint64> &sortedValues, qreal percentile)
+{
+    if (sortedValues.isEmpty()) return 0.0;
+
+    const int index = qBound(0, qCeil(percentile * sortedValues.size()) - 1, sortedValues.size() - 1);
+    return sortedValues[index] / 1000.0;
+}
+
+QString formatLatencies(QVector<qint64> values)
+{
+    std::sort(values.begin(), values.end());
+
+    return QString("n: %1 p50: %2 p90: %3 p99: %4 max: %5 (us)")
+        .arg(values.size())
+        .arg(percentileUs(values, 0.50), 0, 'f', 1)
+        .arg(percentileUs(values, 0.90), 0, 'f', 1)
+        .arg(percentileUs(values, 0.99), 0, 'f', 1)
+        .arg(percentileUs(values, 1.00), 0, 'f', 1);
+}
+
+}
+
+void FreehandStrokeReplayBenchmark::initTestCase()
+{
+    {
+        QString fullFileName = TestUtil::fetchDataFileLazy("3_texture.png");
+        KIS_ASSERT(!fullFileName.isEmpty());
+        KIS_ASSERT(QFileInfo(fullFileName).exists());
+
+        KisResourceModel model(ResourceType::Brushes);
+        model.importResourceFile(fullFileName, true);
+    }
+
+    qDebug() << "Optimized code uses set:" << KisSupportedArchitectures::bestArchName();
+}
+
+void FreehandStrokeReplayBenchmark::testRecordingRoundTrip()
+{
+    const KisFreehandStrokeRecorder recording = generateSyntheticStroke(QSize(1000, 1000));
+
+    KisFreehandStrokeRecorder curveRecording = recording;
+    curveRecording.recordCurve(1,
+                               recording.events()[1].pi1,
+                               QPointF(10, 20), QPointF(30, 40),
+                               recording.events()[1].pi2);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(curveRecording.write(&buffer));
+    buffer.close();
+
+    buffer.open(QIODevice::ReadOnly);
+    KisFreehandStrokeRecorder loaded;
+    QVERIFY(loaded.read(&buffer));
+
+    QCOMPARE(loaded.events().size(), curveRecording.events().size());
+    QCOMPARE(loaded.startPos(), curveRecording.startPos());
+
+    // the values are stored in single precision
+    auto fuzzyEqual = [] (const KisPaintInformation &lhs, const KisPaintInformation &rhs) {
+        const qreal eps = 1e-3;
+        return qAbs(lhs.pos().x() - rhs.pos().x()) < eps &&
+            qAbs(lhs.pos().y() - rhs.pos().y()) < eps &&
+            qAbs(lhs.pressure() - rhs.pressure()) < eps &&
+            qAbs(lhs.xTilt() - rhs.xTilt()) < eps &&
+            qAbs(lhs.yTilt() - rhs.yTilt()) < eps &&
+            qAbs(lhs.currentTime() - rhs.currentTime()) < eps &&
+            qAbs(lhs.drawingSpeed() - rhs.drawingSpeed()) < eps;
+    };
+
+    for (int i = 0; i < loaded.events().size(); i++) {
+        const KisFreehandStrokeRecorder::Event &lhs = loaded.events()[i];
+        const KisFreehandStrokeRecorder::Event &rhs = curveRecording.events()[i];
+
+        QCOMPARE(lhs.type, rhs.type);
+        QCOMPARE(lhs.strokeInfoId, rhs.strokeInfoId);
+        QVERIFY(fuzzyEqual(lhs.pi1, rhs.pi1));
+
+        if (lhs.type != KisFreehandStrokeRecorder::Point) {
+            QVERIFY(fuzzyEqual(lhs.pi2, rhs.pi2));
+        }
+
+        if (lhs.type == KisFreehandStrokeRecorder::Curve) {
+            QCOMPARE(lhs.control1, rhs.control1);
+            QCOMPARE(lhs.control2, rhs.control2);
+        }
+    }
+
+    // truncated files are rejected
+    QByteArray truncated = buffer.data();
+    truncated.chop(10);
+
+    QBuffer truncatedBuffer(&truncated);
+    truncatedBuffer.open(QIODevice::ReadOnly);
+    KisFreehandStrokeRecorder broken;
+    QVERIFY(!broken.read(&truncatedBuffer));
+}
+
+void FreehandStrokeReplayBenchmark::testReplay()
+{
+    const QString strokeFile = qEnvironmentVariable("KRITA_REPLAY_STROKE");
+    const QString preset = qEnvironmentVariable("KRITA_REPLAY_PRESET", "testing_1000px_auto_default.kpp");
+
+    KisFreehandStrokeRecorder recording;
+    QSize defaultSize(4000, 4000);
+
+    if (!strokeFile.isEmpty()) {
+        QVERIFY(recording.load(strokeFile));
+
+        QRectF bounds(recording.startPos(), QSizeF(1, 1));
+        Q_FOREACH (const KisFreehandStrokeRecorder::Event &event, recording.events()) {
+            bounds |= QRectF(event.pi1.pos(), QSizeF(1, 1));
+            bounds |= QRectF(event.pi2.pos(), QSizeF(1, 1));
+        }
+        defaultSize = QSize(qCeil(bounds.right()) + 100, qCeil(bounds.bottom()) + 100);
+    } else {
+        recording = generateSyntheticStroke(defaultSize);
+    }
+
+    const QSize imageSize = parseImageSize(qEnvironmentVariable("KRITA_REPLAY_IMAGE_SIZE"), defaultSize);
+    const QVector<int> threadCounts = parseThreadCounts(qEnvironmentVariable("KRITA_REPLAY_THREADS"));
+
+    qDebug() << qPrintable(QString("Replaying %1 events (%2) with %3 on %4x%5 image")
+                           .arg(recording.events().size())
+                           .arg(strokeFile.isEmpty() ? "synthetic" : strokeFile)
+                           .arg(preset)
+                           .arg(imageSize.width())
+                           .arg(imageSize.height()));
+
+    FreehandStrokeReplayTester tester(recording, imageSize, preset);
+
+    Q_FOREACH (int threads, threadCounts) {
+        tester.setCpuCoresLimit(threads);
+        tester.benchmark();
+
+        qDebug() << qPrintable(QString("Threads: %1 Total stroke time: %2 (ms)").arg(threads).arg(tester.lastStrokeTime()));
+        qDebug() << qPrintable(QString("    per-dab latency:   %1").arg(formatLatencies(tester.statistics().dabLatencies)));
+        qDebug() << qPrintable(QString("    per-event latency: %1").arg(formatLatencies(tester.statistics().eventLatencies)));
+    }
+}
+
+KISTEST_MAIN(FreehandStrokeReplayBenchmark)
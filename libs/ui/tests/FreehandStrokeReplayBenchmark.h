@@ -0,0 +1,35 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef FREEHANDSTROKEREPLAYBENCHMARK_H
+#define FREEHANDSTROKEREPLAYBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Replays a stroke recorded by KisFreehandStrokeRecorder headlessly and
+ * reports per-dab latency percentiles and the total stroke time.
+ *
+ * The benchmark is configured with the environment variables:
+ *
+ * KRITA_REPLAY_STROKE      --- the *.kisstroke file to replay; if not set,
+ *                              a synthetic tablet stroke is generated
+ * KRITA_REPLAY_PRESET      --- the preset to paint with (a file name in the
+ *                              test data directory or an absolute path)
+ * KRITA_REPLAY_IMAGE_SIZE  --- the image size, e.g. "4000x3000"
+ * KRITA_REPLAY_THREADS     --- comma-separated list of thread counts
+ */
+class FreehandStrokeReplayBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void testRecordingRoundTrip();
+    void testReplay();
+};
+
+#endif // FREEHANDSTROKEREPLAYBENCHMARK_H
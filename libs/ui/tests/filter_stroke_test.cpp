@@ -14,14 +14,17 @@
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_registry.h"
 #include "filter/kis_filter_configuration.h"
+#include "kis_image_config.h"
+#include "KisMpl.h"
 #include <KisGlobalResourcesInterface.h>
 
 class FilterStrokeTester : public utils::StrokeTester
 {
 public:
-    FilterStrokeTester(const QString &filterName)
+    FilterStrokeTester(const QString &filterName, const QRect &priorityRect = QRect())
         : StrokeTester(QString("filter_") + filterName, QSize(500, 500), ""),
-          m_filterName(filterName)
+          m_filterName(filterName),
+          m_priorityRect(priorityRect)
     {
         setBaseFuzziness(5);
     }
@@ -54,17 +57,18 @@ protected:
         Q_UNUSED(resources);
 
         image->addJob(strokeId(),
-                      new KisFilterStrokeStrategy::FilterJobData());
+                      new KisFilterStrokeStrategy::FilterJobData(-1, m_priorityRect));
 
         image->addJob(strokeId(),
-                      new KisFilterStrokeStrategy::FilterJobData());
+                      new KisFilterStrokeStrategy::FilterJobData(-1, m_priorityRect));
 
         image->addJob(strokeId(),
-                      new KisFilterStrokeStrategy::FilterJobData());
+                      new KisFilterStrokeStrategy::FilterJobData(-1, m_priorityRect));
     }
 
 private:
     QString m_filterName;
+    QRect m_priorityRect;
 };
 
 void FilterStrokeTest::testBlurFilter()
@@ -73,4 +77,25 @@ void FilterStrokeTest::testBlurFilter()
     tester.test();
 }
 
+void FilterStrokeTest::testBlurFilterWithPriorityRect()
+{
+    KisImageConfig cfg(false);
+    const int oldPatchWidth = cfg.updatePatchWidth();
+    const int oldPatchHeight = cfg.updatePatchHeight();
+
+    // restore the user's config even if the test fails
+    auto restoreConfig = kismpl::finally([&] () {
+        cfg.setUpdatePatchWidth(oldPatchWidth);
+        cfg.setUpdatePatchHeight(oldPatchHeight);
+    });
+
+    // make sure the image is split into several patches
+    cfg.setUpdatePatchWidth(128);
+    cfg.setUpdatePatchHeight(128);
+
+    // the result should be the same as the one of the ordinary stroke
+    FilterStrokeTester tester("blur", QRect(100, 100, 200, 150));
+    tester.test();
+}
+
 SIMPLE_TEST_MAIN(FilterStrokeTest)
@@ -16,6 +16,7 @@ class FilterStrokeTest : public QObject
 
 private Q_SLOTS:
     void testBlurFilter();
+    void testBlurFilterWithPriorityRect();
 };
 
 #endif /* __FILTER_STROKE_TEST_H */
@@ -0,0 +1,319 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFreehandStrokeRecorder.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGlobalStatic>
+#include <QScopedPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <kis_debug.h>
+
+namespace {
+
+const quint32 MAGIC = 0x4B535452; // "KSTR"
+const quint16 VERSION = 1;
+
+enum PaintInfoFlag {
+    CanvasMirroredH = 0x1,
+    CanvasMirroredV = 0x2
+};
+
+void writePaintInfo(QDataStream &stream, const KisPaintInformation &pi)
+{
+    quint8 flags = 0;
+    if (pi.canvasMirroredH()) flags |= CanvasMirroredH;
+    if (pi.canvasMirroredV()) flags |= CanvasMirroredV;
+
+    stream << pi.pos()
+           << pi.pressure()
+           << pi.xTilt()
+           << pi.yTilt()
+           << pi.rotation()
+           << pi.tangentialPressure()
+           << pi.perspective()
+           << pi.currentTime()
+           << pi.drawingSpeed()
+           << pi.canvasRotation()
+           << flags;
+}
+
+KisPaintInformation readPaintInfo(QDataStream &stream)
+{
+    QPointF pos;
+    qreal pressure = 0.0;
+    qreal xTilt = 0.0;
+    qreal yTilt = 0.0;
+    qreal rotation = 0.0;
+    qreal tangentialPressure = 0.0;
+    qreal perspective = 1.0;
+    qreal time = 0.0;
+    qreal speed = 0.0;
+    qreal canvasRotation = 0.0;
+    quint8 flags = 0;
+
+    stream >> pos
+           >> pressure
+           >> xTilt
+           >> yTilt
+           >> rotation
+           >> tangentialPressure
+           >> perspective
+           >> time
+           >> speed
+           >> canvasRotation
+           >> flags;
+
+    KisPaintInformation pi(pos, pressure, xTilt, yTilt, rotation,
+                           tangentialPressure, perspective, time, speed);
+    pi.setCanvasRotation(canvasRotation);
+    pi.setCanvasMirroredH(flags & CanvasMirroredH);
+    pi.setCanvasMirroredV(flags & CanvasMirroredV);
+
+    return pi;
+}
+
+struct WriterThreadPool : public QThreadPool
+{
+    WriterThreadPool() {
+        setMaxThreadCount(1);
+    }
+
+    ~WriterThreadPool() {
+        waitForDone();
+    }
+};
+
+Q_GLOBAL_STATIC(WriterThreadPool, s_writerThreadPool)
+
+void initStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+}
+
+}
+
+KisFreehandStrokeRecorder::KisFreehandStrokeRecorder(const QPointF &startPos, qreal startAngle)
+    : m_startPos(startPos),
+      m_startAngle(startAngle)
+{
+}
+
+void KisFreehandStrokeRecorder::recordPoint(int strokeInfoId, const KisPaintInformation &pi)
+{
+    Event event;
+    event.type = Point;
+    event.strokeInfoId = strokeInfoId;
+    event.pi1 = pi;
+
+    m_events.append(event);
+}
+
+void KisFreehandStrokeRecorder::recordLine(int strokeInfoId,
+                                           const KisPaintInformation &pi1,
+                                           const KisPaintInformation &pi2)
+{
+    Event event;
+    event.type = Line;
+    event.strokeInfoId = strokeInfoId;
+    event.pi1 = pi1;
+    event.pi2 = pi2;
+
+    m_events.append(event);
+}
+
+void KisFreehandStrokeRecorder::recordCurve(int strokeInfoId,
+                                            const KisPaintInformation &pi1,
+                                            const QPointF &control1,
+                                            const QPointF &control2,
+                                            const KisPaintInformation &pi2)
+{
+    Event event;
+    event.type = Curve;
+    event.strokeInfoId = strokeInfoId;
+    event.pi1 = pi1;
+    event.pi2 = pi2;
+    event.control1 = control1;
+    event.control2 = control2;
+
+    m_events.append(event);
+}
+
+QPointF KisFreehandStrokeRecorder::startPos() const
+{
+    return m_startPos;
+}
+
+qreal KisFreehandStrokeRecorder::startAngle() const
+{
+    return m_startAngle;
+}
+
+const QVector<KisFreehandStrokeRecorder::Event> &KisFreehandStrokeRecorder::events() const
+{
+    return m_events;
+}
+
+void KisFreehandStrokeRecorder::clear()
+{
+    m_events.clear();
+}
+
+bool KisFreehandStrokeRecorder::write(QIODevice *device) const
+{
+    QDataStream stream(device);
+    initStream(stream);
+
+    stream << MAGIC << VERSION;
+    stream << m_startPos << m_startAngle;
+    stream << quint32(m_events.size());
+
+    Q_FOREACH (const Event &event, m_events) {
+        stream << quint8(event.type) << qint32(event.strokeInfoId);
+
+        writePaintInfo(stream, event.pi1);
+
+        if (event.type == Line || event.type == Curve) {
+            writePaintInfo(stream, event.pi2);
+        }
+
+        if (event.type == Curve) {
+            stream << event.control1 << event.control2;
+        }
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool KisFreehandStrokeRecorder::read(QIODevice *device)
+{
+    QDataStream stream(device);
+    initStream(stream);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+
+    stream >> magic >> version;
+
+    if (magic != MAGIC || version != VERSION) {
+        warnUI << "KisFreehandStrokeRecorder: unsupported stroke recording format";
+        return false;
+    }
+
+    QPointF startPos;
+    qreal startAngle = 0.0;
+    quint32 numEvents = 0;
+
+    stream >> startPos >> startAngle >> numEvents;
+
+    QVector<Event> events;
+
+    for (quint32 i = 0; i < numEvents && stream.status() == QDataStream::Ok; i++) {
+        quint8 type = 0;
+        qint32 strokeInfoId = 0;
+
+        stream >> type >> strokeInfoId;
+
+        if (type > Curve) {
+            warnUI << "KisFreehandStrokeRecorder: unknown event type" << type;
+            return false;
+        }
+
+        Event event;
+        event.type = EventType(type);
+        event.strokeInfoId = strokeInfoId;
+        event.pi1 = readPaintInfo(stream);
+
+        if (event.type == Line || event.type == Curve) {
+            event.pi2 = readPaintInfo(stream);
+        }
+
+        if (event.type == Curve) {
+            stream >> event.control1 >> event.control2;
+        }
+
+        events.append(event);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        warnUI << "KisFreehandStrokeRecorder: stroke recording is truncated";
+        return false;
+    }
+
+    m_startPos = startPos;
+    m_startAngle = startAngle;
+    m_events = events;
+
+    return true;
+}
+
+bool KisFreehandStrokeRecorder::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        warnUI << "KisFreehandStrokeRecorder: failed to open" << fileName << "for writing";
+        return false;
+    }
+
+    return write(&file);
+}
+
+bool KisFreehandStrokeRecorder::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        warnUI << "KisFreehandStrokeRecorder: failed to open" << fileName;
+        return false;
+    }
+
+    return read(&file);
+}
+
+QString KisFreehandStrokeRecorder::saveToRecordingDirectory() const
+{
+    QDir dir(recordingDirectory());
+    if (!dir.exists() && !dir.mkpath(".")) {
+        warnUI << "KisFreehandStrokeRecorder: failed to create" << dir.path();
+        return QString();
+    }
+
+    const QString baseName =
+        QString("stroke-%1").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz"));
+
+    QString fileName = dir.filePath(baseName + ".kisstroke");
+    for (int i = 1; QFileInfo::exists(fileName); i++) {
+        fileName = dir.filePath(QString("%1-%2.kisstroke").arg(baseName).arg(i));
+    }
+
+    return save(fileName) ? fileName : QString();
+}
+
+void KisFreehandStrokeRecorder::saveToRecordingDirectoryAsync(KisFreehandStrokeRecorder *recorder)
+{
+    QtConcurrent::run(s_writerThreadPool,
+        [recorder] () {
+            QScopedPointer<KisFreehandStrokeRecorder> guard(recorder);
+            guard->saveToRecordingDirectory();
+        });
+}
+
+QString KisFreehandStrokeRecorder::recordingDirectory()
+{
+    return qEnvironmentVariable("KRITA_RECORD_STROKES");
+}
+
+bool KisFreehandStrokeRecorder::isRecordingEnabled()
+{
+    return !recordingDirectory().isEmpty();
+}
@@ -0,0 +1,109 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFREEHANDSTROKERECORDER_H
+#define KISFREEHANDSTROKERECORDER_H
+
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include <brushengine/kis_paint_information.h>
+#include "kritaui_export.h"
+
+class QIODevice;
+
+/**
+ * @brief Records the stream of painting jobs generated by
+ * KisToolFreehandHelper
+ *
+ * The recorder captures the paint information passed to the
+ * low-level paintAt(), paintLine() and paintBezierCurve() calls of the
+ * helper, that is, the data after smoothing and stabilization. Such
+ * recordings can be replayed headlessly against any preset, image size
+ * and thread count by FreehandStrokeReplayBenchmark.
+ *
+ * The recording is enabled by setting KRITA_RECORD_STROKES environment
+ * variable to a directory path. Every finished stroke is saved into that
+ * directory as a separate `*.kisstroke` file.
+ *
+ * The file format is a compact binary QDataStream with all the
+ * floating-point values stored in single precision.
+ */
+class KRITAUI_EXPORT KisFreehandStrokeRecorder
+{
+public:
+    enum EventType {
+        Point = 0,
+        Line,
+        Curve
+    };
+
+    struct Event {
+        EventType type = Point;
+        int strokeInfoId = 0;
+        KisPaintInformation pi1;
+        KisPaintInformation pi2;
+        QPointF control1;
+        QPointF control2;
+    };
+
+public:
+    KisFreehandStrokeRecorder(const QPointF &startPos = QPointF(), qreal startAngle = 0.0);
+
+    void recordPoint(int strokeInfoId, const KisPaintInformation &pi);
+    void recordLine(int strokeInfoId, const KisPaintInformation &pi1, const KisPaintInformation &pi2);
+    void recordCurve(int strokeInfoId,
+                     const KisPaintInformation &pi1,
+                     const QPointF &control1,
+                     const QPointF &control2,
+                     const KisPaintInformation &pi2);
+
+    /// position of the first event of the stroke
+    QPointF startPos() const;
+
+    /// the drawing angle the stroke has been started with
+    qreal startAngle() const;
+
+    const QVector<Event>& events() const;
+    void clear();
+
+    bool write(QIODevice *device) const;
+    bool read(QIODevice *device);
+
+    bool save(const QString &fileName) const;
+    bool load(const QString &fileName);
+
+    /**
+     * Saves the recording into recordingDirectory() under
+     * a unique name
+     *
+     * \return the name of the written file or an empty string
+     *         if saving failed
+     */
+    QString saveToRecordingDirectory() const;
+
+    /**
+     * Saves \p recorder into recordingDirectory() in a background
+     * writer thread and deletes it afterwards. The writes are serialized,
+     * so the unique file names don't clash.
+     *
+     * The ownership of \p recorder is transferred to the writer.
+     */
+    static void saveToRecordingDirectoryAsync(KisFreehandStrokeRecorder *recorder);
+
+    /// the directory set by KRITA_RECORD_STROKES environment variable
+    static QString recordingDirectory();
+
+    static bool isRecordingEnabled();
+
+private:
+    QPointF m_startPos;
+    qreal m_startAngle = 0.0;
+    QVector<Event> m_events;
+};
+
+#endif // KISFREEHANDSTROKERECORDER_H
@@ -34,6 +34,7 @@
 #include "strokes/freehand_stroke.h"
 #include "strokes/KisFreehandStrokeInfo.h"
 #include "KisAsynchronousStrokeUpdateHelper.h"
+#include "KisFreehandStrokeRecorder.h"
 #include "kis_canvas_resource_provider.h"
 #include <KisOptimizedBrushOutline.h>
 
@@ -103,6 +104,10 @@ struct KisToolFreehandHelper::Private
     KisStabilizedEventsSampler stabilizedSampler;
     KisStabilizerDelayedPaintHelper stabilizerDelayedPaintHelper;
 
+    // Captures the painting jobs for replaying them in benchmarks,
+    // see KisFreehandStrokeRecorder
+    QScopedPointer<KisFreehandStrokeRecorder> recorder;
+
     qreal effectiveSmoothnessDistance() const;
 };
 
@@ -305,6 +310,9 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
 
     m_d->strokeId = m_d->strokesFacade->startStroke(stroke);
 
+    m_d->recorder.reset(KisFreehandStrokeRecorder::isRecordingEnabled() ?
+                        new KisFreehandStrokeRecorder(pi.pos(), startAngle) : nullptr);
+
     m_d->history.clear();
     m_d->distanceHistory.clear();
 
@@ -647,6 +655,11 @@ void KisToolFreehandHelper::endPaint()
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
     m_d->infoBuilder->reset();
+
+    if (m_d->recorder) {
+        // writing the file on the GUI thread would stall the next stroke
+        KisFreehandStrokeRecorder::saveToRecordingDirectoryAsync(m_d->recorder.take());
+    }
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -677,6 +690,7 @@ void KisToolFreehandHelper::cancelPaint()
     m_d->strokesFacade->cancelStroke(m_d->strokeId);
     m_d->strokeId.clear();
 
+    m_d->recorder.reset();
 }
 
 int KisToolFreehandHelper::elapsedStrokeTime() const
@@ -919,6 +933,9 @@ void KisToolFreehandHelper::paintAt(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi));
 
+    if (m_d->recorder) {
+        m_d->recorder->recordPoint(strokeInfoId, pi);
+    }
 }
 
 void KisToolFreehandHelper::paintLine(int strokeInfoId,
@@ -929,6 +946,9 @@ void KisToolFreehandHelper::paintLine(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
 
+    if (m_d->recorder) {
+        m_d->recorder->recordLine(strokeInfoId, pi1, pi2);
+    }
 }
 
 void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
@@ -966,6 +986,9 @@ void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
                                new FreehandStrokeStrategy::Data(strokeInfoId,
                                                                 pi1, control1, control2, pi2));
 
+    if (m_d->recorder) {
+        m_d->recorder->recordCurve(strokeInfoId, pi1, control1, control2, pi2);
+    }
 }
 
 void KisToolFreehandHelper::createPainters(QVector<KisFreehandStrokeInfo*> &strokeInfos,
@@ -22,6 +22,9 @@
 #include "KisAnimAutoKey.h"
 #include <commands_new/KisDisableDirtyRequestsCommand.h>
 
+#include <QMutex>
+#include <QMutexLocker>
+
 
 struct KisFilterStrokeStrategy::Private {
     Private()
@@ -57,6 +60,29 @@ struct KisFilterStrokeStrategy::Private {
     ExternalCancelUpdatesStorageSP cancelledUpdates;
     QRect nextExternalUpdateRect;
     bool hasBeenLodCloned = false;
+
+    /**
+     * The progress helpers of the running filter jobs. They are used
+     * to interrupt the filters when the stroke is cancelled, e.g. when
+     * the user changes the parameters of the filter in the dialog.
+     */
+    QMutex progressHelpersLock;
+    QVector<QWeakPointer<KisProcessingVisitor::ProgressHelper>> progressHelpers;
+    QAtomicInt isCancelling;
+
+    void registerProgressHelper(QSharedPointer<KisProcessingVisitor::ProgressHelper> helper) {
+        QMutexLocker l(&progressHelpersLock);
+
+        for (auto it = progressHelpers.begin(); it != progressHelpers.end();) {
+            if (it->isNull()) {
+                it = progressHelpers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        progressHelpers.append(helper);
+    }
 };
 
 struct SubTaskSharedData {
@@ -74,6 +100,7 @@ struct SubTaskSharedData {
         , m_storage(new KisLayerUtils::SwitchFrameCommand::SharedStorage()){
 
         m_frameTime = filterFrameData->frameTime;
+        m_priorityRect = filterFrameData->priorityRect;
         m_shouldSwitchTime = filterFrameData->frameTime != -1;
 
         m_shouldRedraw = !m_shouldSwitchTime || filterFrameData->frameTime == KisLayerUtils::fetchLayerActiveRasterFrameTime(m_node);
@@ -100,6 +127,13 @@ struct SubTaskSharedData {
         return m_frameTime;
     }
 
+    QRect priorityRect() { return m_priorityRect; }
+
+    bool hasChangedPixels() {
+        return filterDeviceBounds.intersects(
+            m_filter->neededRect(processRect, m_filterConfig.data(), m_levelOfDetail));
+    }
+
     bool shouldSwitchTime() { return m_shouldSwitchTime; }
 
     bool shouldRedraw() { return m_shouldRedraw; }
@@ -112,6 +146,12 @@ public:
     QSharedPointer<KisTransaction> filterDeviceTransaction;
     QRect processRect;
 
+    /**
+     * When the priority rect has already been written into the target
+     * device, contains the patches that are still to be written
+     */
+    QVector<QRect> pendingPatches;
+
 private:
     KisImageSP m_image;
     KisNodeSP m_node;
@@ -123,6 +163,7 @@ private:
     bool m_shouldSwitchTime;
     bool m_shouldRedraw;
     int m_frameTime;
+    QRect m_priorityRect;
     KisLayerUtils::SwitchFrameCommand::SharedStorageSP m_storage;
 
 };
@@ -205,6 +246,8 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
         QSharedPointer<SubTaskSharedData> shared( new SubTaskSharedData(m_d->image, m_d->node, m_d->levelOfDetail,
                                                                         m_d->activeSelection, m_d->filter, m_d->filterConfig, filterFrameData) );
         QSharedPointer<KisProcessingVisitor::ProgressHelper> progress( new KisProcessingVisitor::ProgressHelper(m_d->node) );
+        m_d->registerProgressHelper(progress);
+
         addJobSequential(jobs, [this, shared, progress](){
             // Switch time if necessary..
             if (shared->shouldSwitchTime()) {
@@ -251,14 +294,73 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
                 QSize size = KritaUtils::optimalPatchSize();
                 QVector<QRect> patches = KritaUtils::splitRectIntoPatches(shared->processRect, size);
 
+                QVector<QRect> priorityPatches;
+                QVector<QRect> otherPatches;
+
                 Q_FOREACH (const QRect &patch, patches) {
-                    if (!patch.isEmpty()) {
-                        addJobConcurrent(processJobs, [patch, shared, progress](){
+                    if (patch.isEmpty()) continue;
+
+                    if (patch.intersects(shared->priorityRect())) {
+                        priorityPatches << patch;
+                    } else {
+                        otherPatches << patch;
+                    }
+                }
+
+                auto addPatchJobs = [this, shared, progress, &processJobs] (const QVector<QRect> &rects) {
+                    Q_FOREACH (const QRect &patch, rects) {
+                        addJobConcurrent(processJobs, [this, patch, shared, progress](){
+                            if (m_d->isCancelling) return;
+
                             shared->filter()->processImpl(shared->filterDevice, patch,
                                                           shared->filterConfig().data(),
                                                           progress->updater());
                         });
                     }
+                };
+
+                if (!priorityPatches.isEmpty() && !otherPatches.isEmpty()) {
+                    /**
+                     * Filter the visible part of the image first and show it
+                     * to the user right away, the rest of the image will be
+                     * written into the target device by the final job
+                     */
+                    addPatchJobs(priorityPatches);
+
+                    addJobSequential(processJobs, [this, shared, priorityPatches](){
+                        if (m_d->isCancelling || !shared->hasChangedPixels()) return;
+
+                        QScopedPointer<KisTransaction> workingTransaction( new KisTransaction(shared->targetDevice()) );
+                        Q_FOREACH (const QRect &patch, priorityPatches) {
+                            KisPainter::copyAreaOptimized(patch.topLeft(), shared->filterDevice, shared->targetDevice(), patch, shared->selection());
+                        }
+                        runAndSaveCommand( toQShared(workingTransaction->endAndTake()), KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE );
+
+                        if (shared->shouldRedraw()) {
+                            QRect extraUpdateRect;
+                            qSwap(extraUpdateRect, m_d->nextExternalUpdateRect);
+
+                            QVector<QRect> dirtyRects = priorityPatches;
+                            if (!extraUpdateRect.isEmpty()) {
+                                dirtyRects << extraUpdateRect;
+                            }
+
+                            shared->node()->setDirty(dirtyRects);
+
+                            QRect priorityBounds;
+                            Q_FOREACH (const QRect &patch, priorityPatches) {
+                                priorityBounds |= patch;
+                            }
+
+                            // the cancellation should restore the visible area as well
+                            m_d->nextExternalUpdateRect = priorityBounds;
+                        }
+                    });
+
+                    shared->pendingPatches = otherPatches;
+                    addPatchJobs(otherPatches);
+                } else {
+                    addPatchJobs(priorityPatches + otherPatches);
                 }
             } else {
                 if (!shared->processRect.isEmpty()) {
@@ -279,22 +381,35 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
             runAndSaveCommand(toQShared(shared->filterDeviceTransaction->endAndTake()), KisStrokeJobData::BARRIER, KisStrokeJobData::NORMAL);
             shared->filterDeviceTransaction.reset();
 
-            if (!shared->filterDeviceBounds.intersects(
-                    shared->filter()->neededRect(shared->processRect, shared->filterConfig().data(), shared->levelOfDetail()))) {
+            if (!shared->hasChangedPixels()) {
                 return;
             }
 
+            // the priority patches might have already been written into the target device
+            const QVector<QRect> updateRects =
+                !shared->pendingPatches.isEmpty() ? shared->pendingPatches : QVector<QRect>({shared->processRect});
+
             // Make a transaction, change the target device, and "end" transaction.
             // Should be useful for undoing later.
             QScopedPointer<KisTransaction> workingTransaction( new KisTransaction(shared->targetDevice()) );
-            KisPainter::copyAreaOptimized(shared->processRect.topLeft(), shared->filterDevice, shared->targetDevice(), shared->processRect, shared->selection());
+            Q_FOREACH (const QRect &rc, updateRects) {
+                KisPainter::copyAreaOptimized(rc.topLeft(), shared->filterDevice, shared->targetDevice(), rc, shared->selection());
+            }
             runAndSaveCommand( toQShared(workingTransaction->endAndTake()), KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE );
 
             if (shared->shouldRedraw()) {
                 QRect extraUpdateRect;
                 qSwap(extraUpdateRect, m_d->nextExternalUpdateRect);
 
-                shared->node()->setDirty(shared->processRect | extraUpdateRect);
+                QVector<QRect> dirtyRects = updateRects;
+
+                // if the priority patches have been written, the extra rect
+                // contains only them and they are already up-to-date
+                if (!extraUpdateRect.isEmpty() && shared->pendingPatches.isEmpty()) {
+                    dirtyRects << extraUpdateRect;
+                }
+
+                shared->node()->setDirty(dirtyRects);
 
                /**
                 * Save the last update to be able to restore the
@@ -368,6 +483,21 @@ void KisFilterStrokeStrategy::finishStrokeCallback()
     KisStrokeStrategyUndoCommandBased::finishStrokeCallback();
 }
 
+void KisFilterStrokeStrategy::tryCancelCurrentStrokeJobAsync()
+{
+    // NOTE: this method may be called by the GUI thread asynchronously!
+    m_d->isCancelling.ref();
+
+    QMutexLocker l(&m_d->progressHelpersLock);
+
+    Q_FOREACH (const QWeakPointer<KisProcessingVisitor::ProgressHelper> &weakHelper, m_d->progressHelpers) {
+        QSharedPointer<KisProcessingVisitor::ProgressHelper> helper = weakHelper.toStrongRef();
+        if (helper) {
+            helper->cancel();
+        }
+    }
+}
+
 KisStrokeStrategy* KisFilterStrokeStrategy::createLodClone(int levelOfDetail)
 {
     if (!m_d->filter->supportsLevelOfDetail(m_d->filterConfig.data(), levelOfDetail)) return 0;
@@ -17,9 +17,10 @@ class KRITAUI_EXPORT KisFilterStrokeStrategy : public KisStrokeStrategyUndoComma
 public:
     class FilterJobData : public KisStrokeJobData {
     public:
-        FilterJobData(int frameTime = -1)
+        FilterJobData(int frameTime = -1, const QRect &priorityRect = QRect())
             : KisStrokeJobData(CONCURRENT),
-              frameTime(frameTime)
+              frameTime(frameTime),
+              priorityRect(priorityRect)
         {}
 
         KisStrokeJobData* createLodClone(int levelOfDetail) override {
@@ -28,12 +29,21 @@ public:
 
         int frameTime;
 
+        /**
+         * The area of the image the user is looking at, e.g. the visible
+         * part of the canvas. It is filtered and shown on screen before
+         * the rest of the image, so that the preview of a slow filter is
+         * refined where it is visible first. Empty rect means no priority.
+         */
+        QRect priorityRect;
+
     private:
         FilterJobData(const FilterJobData &rhs, int levelOfDetail)
             : KisStrokeJobData(rhs)
             , frameTime(rhs.frameTime)
          {
              KisLodTransform t(levelOfDetail);
+             priorityRect = t.map(rhs.priorityRect);
          }
     };
 
@@ -95,6 +105,8 @@ public:
     void cancelStrokeCallback() override;
     void finishStrokeCallback() override;
 
+    void tryCancelCurrentStrokeJobAsync() override;
+
     KisStrokeStrategy* createLodClone(int levelOfDetail) override;
 
 private:
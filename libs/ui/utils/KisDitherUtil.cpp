@@ -15,6 +15,8 @@
 KisDitherUtil::KisDitherUtil()
     : m_thresholdMode(ThresholdMode::Pattern), m_patternValueMode(PatternValueMode::Auto)
     , m_noiseSeed(0), m_patternUseAlpha(false), m_spread(1.0)
+    , m_patternWidth(0), m_patternHeight(0)
+    , m_noiseGenerator(new KisRandomGenerator(0))
 {
 }
 
@@ -49,11 +51,32 @@ void KisDitherUtil::setPattern(const QString &md5sum, const QString &patternName
     else {
         m_patternUseAlpha = (m_patternValueMode == PatternValueMode::Alpha);
     }
+
+    m_patternThresholds.clear();
+    m_patternWidth = 0;
+    m_patternHeight = 0;
+
+    if (m_pattern) {
+        // QImage::pixelColor() is way too slow to be called per pixel
+        const QImage &image = m_pattern->pattern();
+        m_patternWidth = image.width();
+        m_patternHeight = image.height();
+        m_patternThresholds.resize(m_patternWidth * m_patternHeight);
+
+        qreal *dstPtr = m_patternThresholds.data();
+        for (int y = 0; y < m_patternHeight; ++y) {
+            for (int x = 0; x < m_patternWidth; ++x) {
+                const QColor pixel = image.pixelColor(x, y);
+                *dstPtr++ = m_patternUseAlpha ? pixel.alphaF() : pixel.lightnessF();
+            }
+        }
+    }
 }
 
 void KisDitherUtil::setNoiseSeed(const quint64 &noiseSeed)
 {
     m_noiseSeed = noiseSeed;
+    m_noiseGenerator.reset(new KisRandomGenerator(m_noiseSeed));
 }
 
 void KisDitherUtil::setSpread(const qreal &spread)
@@ -61,17 +84,18 @@ void KisDitherUtil::setSpread(const qreal &spread)
     m_spread = spread;
 }
 
-qreal KisDitherUtil::threshold(const QPoint &pos)
+qreal KisDitherUtil::threshold(const QPoint &pos) const
 {
     qreal threshold;
-    if (m_thresholdMode == ThresholdMode::Pattern && m_pattern) {
-        const QImage &image = m_pattern->pattern();
-        const QColor color = image.pixelColor(pos.x() % image.width(), pos.y() % image.height());
-        threshold = (m_patternUseAlpha ? color.alphaF() : color.lightnessF());
+    if (m_thresholdMode == ThresholdMode::Pattern && !m_patternThresholds.isEmpty()) {
+        int x = pos.x() % m_patternWidth;
+        int y = pos.y() % m_patternHeight;
+        if (x < 0) x += m_patternWidth;
+        if (y < 0) y += m_patternHeight;
+        threshold = m_patternThresholds[y * m_patternWidth + x];
     }
     else if (m_thresholdMode == ThresholdMode::Noise) {
-        KisRandomGenerator random(m_noiseSeed);
-        threshold = random.doubleRandomAt(pos.x(), pos.y());
+        threshold = m_noiseGenerator->doubleRandomAt(pos.x(), pos.y());
     }
     else threshold = 0.5;
 
@@ -13,10 +13,20 @@
 
 #include <kis_types.h>
 
+#include <QSharedPointer>
+#include <QVector>
+
 #include <KoPattern.h>
 
 class KisPropertiesConfiguration;
+class KisRandomGenerator;
 
+/**
+ * The thresholds of the pattern are precomputed in setConfiguration(), so
+ * threshold() is cheap and safe to be called from several threads at once.
+ * That lets the users of the class (e.g. filters) process their tiles in
+ * parallel with the same instance.
+ */
 class KRITAUI_EXPORT KisDitherUtil
 {
 public:
@@ -32,7 +42,7 @@ public:
 
     KisDitherUtil();
     void setConfiguration(const KisFilterConfiguration &config, const QString &prefix = "");
-    qreal threshold(const QPoint &pos);
+    qreal threshold(const QPoint &pos) const;
 
 private:
 
@@ -49,6 +59,11 @@ private:
     quint64 m_noiseSeed;
     bool m_patternUseAlpha;
     qreal m_spread;
+
+    QVector<qreal> m_patternThresholds;
+    int m_patternWidth;
+    int m_patternHeight;
+    QSharedPointer<KisRandomGenerator> m_noiseGenerator;
 };
 
 #endif
@@ -6,12 +6,38 @@
  */
 #include "HistogramComputationStrokeStrategy.h"
 
+#include <QMutexLocker>
+
 #include "KoColorSpace.h"
 
 #include "krita_utils.h"
 #include "kis_image.h"
 #include "kis_sequential_iterator.h"
 
+void HistogramComputationCache::addDirtyRect(const QRect &rect)
+{
+    QMutexLocker l(&mutex);
+
+    if (!isValid) return;
+
+    for (int i = 0; i < patches.size(); i++) {
+        if (patches[i].intersects(rect)) {
+            dirtyPatches[i] = true;
+        }
+    }
+}
+
+void HistogramComputationCache::invalidate()
+{
+    QMutexLocker l(&mutex);
+
+    isValid = false;
+    generation++;
+    patches.clear();
+    dirtyPatches.clear();
+    results.clear();
+}
+
 struct HistogramComputationStrokeStrategy::Private
 {
 
@@ -29,15 +55,21 @@ struct HistogramComputationStrokeStrategy::Private
     };
 
     KisImageSP image;
+    HistogramComputationCacheSP cache;
+
+    int cacheGeneration {0};
+    int nSkip {1};
+    QVector<int> recalculatedPatches; // ids of the patches in the cache
     std::vector<HistVector> results;
 };
 
 
-HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageSP image)
+HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageSP image, HistogramComputationCacheSP cache)
     : KisIdleTaskStrokeStrategy(QLatin1String("ComputeHistogram"), kundo2_i18n("Update histogram"))
     , m_d(new Private)
 {
     m_d->image = image;
+    m_d->cache = cache;
 }
 
 HistogramComputationStrokeStrategy::~HistogramComputationStrokeStrategy()
@@ -48,15 +80,45 @@ void HistogramComputationStrokeStrategy::initStrokeCallback()
 {
     KisIdleTaskStrokeStrategy::initStrokeCallback();
 
+    const QRect imageBounds = m_d->image->bounds();
+    const KoColorSpace *cs = m_d->image->projection()->colorSpace();
+
+    const int imageSize = imageBounds.width() * imageBounds.height();
+    m_d->nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+
+    HistogramComputationCache *cache = m_d->cache.data();
+    QMutexLocker l(&cache->mutex);
+
+    if (!cache->isValid ||
+        cache->imageBounds != imageBounds ||
+        !(*cache->colorSpace == *cs)) {
+
+        cache->isValid = true;
+        cache->generation++;
+        cache->imageBounds = imageBounds;
+        cache->colorSpace = cs;
+        cache->patches = KritaUtils::splitRectIntoPatches(imageBounds, KritaUtils::optimalPatchSize());
+        cache->dirtyPatches.assign(cache->patches.size(), true);
+        cache->results.assign(cache->patches.size(), HistVector());
+    }
+
+    m_d->cacheGeneration = cache->generation;
+
     QVector<KisStrokeJobData*> jobsData;
-    int i = 0;
-    QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(m_d->image->bounds(), KritaUtils::optimalPatchSize());
-    m_d->results.resize(tileRects.size());
 
-    Q_FOREACH (const QRect &tileRectangle, tileRects) {
-        jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(tileRectangle, i);
-        i++;
+    for (int i = 0; i < cache->patches.size(); i++) {
+        if (!cache->dirtyPatches[i]) continue;
+
+        // the patch is marked clean right now, so that the updates
+        // that come during the computation would mark it dirty again
+        cache->dirtyPatches[i] = false;
+
+        jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(cache->patches[i], m_d->recalculatedPatches.size());
+        m_d->recalculatedPatches << i;
     }
+
+    m_d->results.resize(m_d->recalculatedPatches.size());
+
     addMutatedJobs(jobsData);
 }
 
@@ -72,20 +134,18 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
     QRect calculate = d_pd->rectToCalculate;
 
     KisPaintDeviceSP m_dev = m_d->image->projection();
-    QRect imageBounds = m_d->image->bounds();
 
     const KoColorSpace *cs = m_dev->colorSpace();
     quint32 channelCount = m_dev->channelCount();
     quint32 pixelSize = m_dev->pixelSize();
 
-    int imageSize = imageBounds.width() * imageBounds.height();
-    int nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+    HistVector &result = m_d->results[d_pd->jobId];
+    initiateVector(result, cs);
 
     if (calculate.isEmpty())
         return;
 
-    initiateVector(m_d->results[d_pd->jobId], cs);
-
+    const int nSkip = m_d->nSkip;
     quint32 toSkip = nSkip;
 
     KisSequentialConstIterator it(m_dev, calculate);
@@ -98,7 +158,7 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
         for (int k = 0; k < numConseqPixels; ++k) {
             if (--toSkip == 0) {
                 for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    m_d->results[d_pd->jobId][chan][cs->scaleToU8(pixel, chan)]++;
+                    result[chan][cs->scaleToU8(pixel, chan)]++;
                 }
                 toSkip = nSkip;
             }
@@ -109,35 +169,63 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
 
 void HistogramComputationStrokeStrategy::finishStrokeCallback()
 {
+    HistogramComputationCache *cache = m_d->cache.data();
+
     HistogramData hisData;
     hisData.colorSpace = m_d->image->projection()->colorSpace();
+    initiateVector(hisData.bins, hisData.colorSpace);
+
+    {
+        QMutexLocker l(&cache->mutex);
+
+        // the cache has been invalidated while we were working,
+        // the next run will recalculate the histogram from scratch
+        if (!cache->isValid || cache->generation != m_d->cacheGeneration) {
+            KisIdleTaskStrokeStrategy::finishStrokeCallback();
+            return;
+        }
 
-    if (m_d->results.size() == 1) {
-        hisData.bins = m_d->results[0];
-        emit computationResultReady(hisData);
-    } else {
+        for (int i = 0; i < m_d->recalculatedPatches.size(); i++) {
+            std::swap(cache->results[m_d->recalculatedPatches[i]], m_d->results[i]);
+        }
 
-        quint32 channelCount = m_d->image->projection()->channelCount();
+        const int channelCount = hisData.bins.size();
 
-        initiateVector(hisData.bins, hisData.colorSpace);
+        for (const HistVector &patchResult : cache->results) {
+            if (patchResult.empty()) continue;
 
-        for (int chan = 0; chan < (int)channelCount; chan++) {
-            int bsize = hisData.bins[chan].size();
+            for (int chan = 0; chan < channelCount; chan++) {
+                const int bsize = hisData.bins[chan].size();
+                quint32 *dst = hisData.bins[chan].data();
+                const quint32 *src = patchResult[chan].data();
 
-            for (int bi = 0; bi < bsize; bi++) {
-                hisData.bins[chan][bi] = 0;
-                for (int i = 0; i < (int)m_d->results.size(); i++) {
-                    hisData.bins[chan][bi] += m_d->results[i][chan][bi];
+                for (int bi = 0; bi < bsize; bi++) {
+                    dst[bi] += src[bi];
                 }
             }
         }
-
-        emit computationResultReady(hisData);
     }
 
+    emit computationResultReady(hisData);
+
     KisIdleTaskStrokeStrategy::finishStrokeCallback();
 }
 
+void HistogramComputationStrokeStrategy::cancelStrokeCallback()
+{
+    HistogramComputationCache *cache = m_d->cache.data();
+    QMutexLocker l(&cache->mutex);
+
+    // the patches we have taken should be recalculated in the next run
+    if (cache->isValid && cache->generation == m_d->cacheGeneration) {
+        Q_FOREACH (int patchId, m_d->recalculatedPatches) {
+            cache->dirtyPatches[patchId] = true;
+        }
+    }
+
+    KisIdleTaskStrokeStrategy::cancelStrokeCallback();
+}
+
 void HistogramComputationStrokeStrategy::initiateVector(HistVector &vec, const KoColorSpace *colorSpace)
 {
     vec.resize(colorSpace->channelCount());
@@ -8,6 +8,10 @@
 #define HISTOGRAMCOMPUTATIONSTROKESTRATEGY_H
 
 #include <KisIdleTaskStrokeStrategy.h>
+#include <QMutex>
+#include <QRect>
+#include <QSharedPointer>
+#include <QVector>
 #include <vector>
 
 class KoColorSpace;
@@ -22,18 +26,47 @@ struct HistogramData
 };
 Q_DECLARE_METATYPE(HistogramData)
 
+/**
+ * Keeps the histograms of the image patches between the runs of
+ * HistogramComputationStrokeStrategy, so that only the patches touched
+ * by the image updates since the last run are re-binned. The cache is
+ * thread-safe: the dirty rects are added directly from the image's
+ * update signal.
+ */
+class HistogramComputationCache
+{
+public:
+    void addDirtyRect(const QRect &rect);
+    void invalidate();
+
+private:
+    friend class HistogramComputationStrokeStrategy;
+
+    QMutex mutex;
+    int generation {0};
+    bool isValid {false};
+    QRect imageBounds;
+    const KoColorSpace *colorSpace {0};
+    QVector<QRect> patches;
+    std::vector<bool> dirtyPatches;
+    std::vector<HistVector> results;
+};
+
+using HistogramComputationCacheSP = QSharedPointer<HistogramComputationCache>;
+
 
 class HistogramComputationStrokeStrategy : public KisIdleTaskStrokeStrategy
 {
     Q_OBJECT
 public:
-    HistogramComputationStrokeStrategy(KisImageSP image);
+    HistogramComputationStrokeStrategy(KisImageSP image, HistogramComputationCacheSP cache);
     ~HistogramComputationStrokeStrategy() override;
 
 private:
     void initStrokeCallback() override;
     void doStrokeCallback(KisStrokeJobData *data) override;
     void finishStrokeCallback() override;
+    void cancelStrokeCallback() override;
 
     void initiateVector(HistVector &vec, const KoColorSpace* colorSpace);
 
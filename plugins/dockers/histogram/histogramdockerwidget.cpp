@@ -18,11 +18,13 @@
 #include "KoChannelInfo.h"
 #include "KisViewManager.h"
 #include "kis_canvas2.h"
+#include "kis_image.h"
 
 
 
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
     : KisWidgetWithIdleTask<QLabel>(parent, f)
+    , m_computationCache(new HistogramComputationCache())
 {
     setObjectName(name);
     qRegisterMetaType<HistogramData>();
@@ -43,11 +45,28 @@ KisIdleTasksManager::TaskGuard HistogramDockerWidget::registerIdleTask(KisCanvas
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(canvas, KisIdleTasksManager::TaskGuard());
 
+    disconnect(m_imageUpdatedConnection);
+    m_computationCache->invalidate();
+
+    HistogramComputationCacheSP cache = m_computationCache;
+
+    KisImageSP image = canvas->image();
+    if (image) {
+        // the updates are delivered from the updater threads, so the cache
+        // is marked dirty directly, without going through the event loop
+        m_imageUpdatedConnection =
+            connect(image.data(), &KisImage::sigImageUpdated, this,
+                    [cache] (const QRect &rect) {
+                        cache->addDirtyRect(rect);
+                    },
+                    Qt::DirectConnection);
+    }
+
     return
         canvas->viewManager()->idleTasksManager()->
-        addIdleTaskWithGuard([this](KisImageSP image) {
+        addIdleTaskWithGuard([this, cache](KisImageSP image) {
             HistogramComputationStrokeStrategy* strategy =
-                new HistogramComputationStrokeStrategy(image);
+                new HistogramComputationStrokeStrategy(image, cache);
 
             connect(strategy, SIGNAL(computationResultReady(HistogramData)), this, SLOT(receiveNewHistogram(HistogramData)));
 
@@ -59,6 +78,7 @@ void HistogramDockerWidget::clearCachedState()
 {
     m_colorSpace = 0;
     m_histogramData.clear();
+    m_computationCache->invalidate();
 }
 
 void HistogramDockerWidget::paintEvent(QPaintEvent *event)
@@ -34,6 +34,8 @@ private:
     void clearCachedState() override;
 
 private:
+    HistogramComputationCacheSP m_computationCache;
+    QMetaObject::Connection m_imageUpdatedConnection;
     HistVector m_histogramData;
     const KoColorSpace* m_colorSpace {0};
     bool m_smoothHistogram {false};
@@ -48,6 +48,7 @@ KisFilterConfigurationSP KisGaussianBlurFilter::defaultConfiguration(KisResource
     config->setProperty("horizRadius", 5);
     config->setProperty("vertRadius", 5);
     config->setProperty("lockAspect", true);
+    config->setProperty("fastApproximation", true);
 
     return config;
 }
@@ -77,7 +78,9 @@ void KisGaussianBlurFilter::processImpl(KisPaintDeviceSP device,
 
     KisGaussianKernel::applyGaussian(device, rect,
                                      horizontalRadius, verticalRadius,
-                                     channelFlags, progressUpdater);
+                                     channelFlags, progressUpdater,
+                                     false, BORDER_REPEAT,
+                                     config->getBool("fastApproximation", false));
 }
 
 QRect KisGaussianBlurFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
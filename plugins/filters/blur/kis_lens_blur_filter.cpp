@@ -12,7 +12,6 @@
 
 #include <KoCompositeOp.h>
 
-#include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
 
 #include "ui_wdg_lens_blur.h"
@@ -113,14 +112,59 @@ QPolygonF KisLensBlurFilter::getIrisPolygon(const KisFilterConfigurationSP confi
     return transformedIris;
 }
 
+KisDecomposedKernelSP KisLensBlurFilter::createKernel(const KisFilterConfigurationSP config, int lod) const
+{
+    QPolygonF transformedIris = getIrisPolygon(config, lod);
+    if (transformedIris.isEmpty()) return 0;
+
+    const QString key = QString("%1 %2 %3 %4")
+        .arg(config->getString("irisShape"))
+        .arg(config->getInt("irisRadius"))
+        .arg(config->getInt("irisRotation"))
+        .arg(lod);
+
+    return m_kernelCache.fetch(key, [transformedIris] () {
+        QRectF boundingRect = transformedIris.boundingRect();
+
+        int kernelWidth = boundingRect.toAlignedRect().width();
+        int kernelHeight = boundingRect.toAlignedRect().height();
+
+        QImage kernelRepresentation(kernelWidth, kernelHeight, QImage::Format_RGB32);
+        kernelRepresentation.fill(0);
+
+        QPainter imagePainter(&kernelRepresentation);
+        imagePainter.setRenderHint(QPainter::Antialiasing);
+        imagePainter.setBrush(QColor::fromRgb(255, 255, 255));
+
+        QTransform offsetTransform;
+        offsetTransform.translate(-boundingRect.x(), -boundingRect.y());
+        imagePainter.setTransform(offsetTransform);
+        imagePainter.drawPolygon(transformedIris, Qt::WindingFill);
+        imagePainter.end();
+
+        // construct kernel from image
+        Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> irisKernel(kernelHeight, kernelWidth);
+        for (int j = 0; j < kernelHeight; ++j) {
+            for (int i = 0; i < kernelWidth; ++i) {
+                irisKernel(j, i) = qRed(kernelRepresentation.pixel(i, j));
+            }
+        }
+
+        /**
+         * Every row of a convex polygon is a single run of full weights
+         * with a few antialiased pixels on its ends, so the cost of the
+         * convolution grows linearly with the radius of the iris
+         */
+        return KisDecomposedKernel::fromMatrix(irisKernel);
+    });
+}
+
 void KisLensBlurFilter::processImpl(KisPaintDeviceSP device,
                                     const QRect& rect,
                                     const KisFilterConfigurationSP config,
                                     KoUpdater* progressUpdater
                                     ) const
 {
-    QPoint srcTopLeft = rect.topLeft();
-
     Q_ASSERT(device != 0);
     KIS_SAFE_ASSERT_RECOVER_RETURN(config);
 
@@ -130,41 +174,10 @@ void KisLensBlurFilter::processImpl(KisPaintDeviceSP device,
     }
 
     const int lod = device->defaultBounds()->currentLevelOfDetail();
-    QPolygonF transformedIris = getIrisPolygon(config, lod);
-    if (transformedIris.isEmpty()) return;
-
-    QRectF boundingRect = transformedIris.boundingRect();
-
-    int kernelWidth = boundingRect.toAlignedRect().width();
-    int kernelHeight = boundingRect.toAlignedRect().height();
-
-    QImage kernelRepresentation(kernelWidth, kernelHeight, QImage::Format_RGB32);
-    kernelRepresentation.fill(0);
-
-    QPainter imagePainter(&kernelRepresentation);
-    imagePainter.setRenderHint(QPainter::Antialiasing);
-    imagePainter.setBrush(QColor::fromRgb(255, 255, 255));
-
-    QTransform offsetTransform;
-    offsetTransform.translate(-boundingRect.x(), -boundingRect.y());
-    imagePainter.setTransform(offsetTransform);
-    imagePainter.drawPolygon(transformedIris, Qt::WindingFill);
-
-    // construct kernel from image
-    Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> irisKernel(kernelHeight, kernelWidth);
-    for (int j = 0; j < kernelHeight; ++j) {
-        for (int i = 0; i < kernelWidth; ++i) {
-            irisKernel(j, i) = qRed(kernelRepresentation.pixel(i, j));
-        }
-    }
-
-    // apply convolution
-    KisConvolutionPainter painter(device);
-    painter.setChannelFlags(channelFlags);
-    painter.setProgress(progressUpdater);
+    KisDecomposedKernelSP kernel = createKernel(config, lod);
+    if (!kernel) return;
 
-    KisConvolutionKernelSP kernel = KisConvolutionKernel::fromMatrix(irisKernel, 0, irisKernel.sum());
-    painter.applyMatrix(kernel, device, srcTopLeft, srcTopLeft, rect.size(), BORDER_REPEAT);
+    KisDecomposedConvolution::apply(device, rect, kernel, channelFlags, progressUpdater, BORDER_REPEAT);
 }
 
 QRect KisLensBlurFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
@@ -11,6 +11,7 @@
 #define KIS_LENS_BLUR_FILTER_H
 
 #include "filter/kis_filter.h"
+#include "KisDecomposedConvolution.h"
 #include "ui_wdg_lens_blur.h"
 
 #include <Eigen/Core>
@@ -42,6 +43,11 @@ public:
 
 private:
     static QPolygonF getIrisPolygon(const KisFilterConfigurationSP config, int lod);
+
+    KisDecomposedKernelSP createKernel(const KisFilterConfigurationSP config, int lod) const;
+
+private:
+    mutable KisDecomposedKernelCache m_kernelCache;
 };
 
 #endif
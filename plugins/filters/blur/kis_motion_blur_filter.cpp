@@ -12,8 +12,8 @@
 
 #include <KoCompositeOp.h>
 
-#include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
+#include <kis_default_bounds_base.h>
 
 #include "ui_wdg_motion_blur.h"
 
@@ -91,51 +91,56 @@ void KisMotionBlurFilter::processImpl(KisPaintDeviceSP device,
                                       KoUpdater* progressUpdater
                                       ) const
 {
-    QPoint srcTopLeft = rect.topLeft();
-
     Q_ASSERT(device);
     KIS_SAFE_ASSERT_RECOVER_RETURN(config);
 
-    KisLodTransformScalar t(device);
+    const int lod = device->defaultBounds()->currentLevelOfDetail();
+    KisLodTransformScalar t(lod);
     MotionBlurProperties props(config, t);
 
     if (props.blurLength == 0) {
         return;
     }
 
-    QBitArray channelFlags;
+    QBitArray channelFlags = config->channelFlags();
 
-    if (config) {
-        channelFlags = config->channelFlags();
-    }
-
-    if (channelFlags.isEmpty() || !config) {
+    if (channelFlags.isEmpty()) {
         channelFlags = QBitArray(device->colorSpace()->channelCount(), true);
     }
 
-    QImage kernelRepresentation(props.kernelSize, QImage::Format_RGB32);
-    kernelRepresentation.fill(0);
-
-    QPainter imagePainter(&kernelRepresentation);
-    imagePainter.setRenderHint(QPainter::Antialiasing);
-    imagePainter.setPen(QPen(QColor::fromRgb(255, 255, 255), 1.0));
-    imagePainter.drawLine(props.motionLine);
-
-    // construct kernel from image
-    Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> motionBlurKernel(props.kernelSize.height(), props.kernelSize.width());
-    for (int j = 0; j < props.kernelSize.height(); ++j) {
-        for (int i = 0; i < props.kernelSize.width(); ++i) {
-            motionBlurKernel(j, i) = qRed(kernelRepresentation.pixel(i, j));
-        }
-    }
-
-    // apply convolution
-    KisConvolutionPainter painter(device);
-    painter.setChannelFlags(channelFlags);
-    painter.setProgress(progressUpdater);
-
-    KisConvolutionKernelSP kernel = KisConvolutionKernel::fromMatrix(motionBlurKernel, 0, motionBlurKernel.sum());
-    painter.applyMatrix(kernel, device, srcTopLeft, srcTopLeft, rect.size(), BORDER_REPEAT);
+    const QString key = QString("%1 %2 %3")
+        .arg(config->getInt("blurAngle", 0))
+        .arg(props.blurLength)
+        .arg(lod);
+
+    KisDecomposedKernelSP kernel =
+        m_kernelCache.fetch(key, [props] () {
+            QImage kernelRepresentation(props.kernelSize, QImage::Format_RGB32);
+            kernelRepresentation.fill(0);
+
+            QPainter imagePainter(&kernelRepresentation);
+            imagePainter.setRenderHint(QPainter::Antialiasing);
+            imagePainter.setPen(QPen(QColor::fromRgb(255, 255, 255), 1.0));
+            imagePainter.drawLine(props.motionLine);
+            imagePainter.end();
+
+            // construct kernel from image
+            Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> motionBlurKernel(props.kernelSize.height(), props.kernelSize.width());
+            for (int j = 0; j < props.kernelSize.height(); ++j) {
+                for (int i = 0; i < props.kernelSize.width(); ++i) {
+                    motionBlurKernel(j, i) = qRed(kernelRepresentation.pixel(i, j));
+                }
+            }
+
+            return KisDecomposedKernel::fromMatrix(motionBlurKernel);
+        });
+
+    /**
+     * The line is only one pixel wide, so the kernel decomposes into
+     * a couple of taps per row: the cost of the convolution grows
+     * linearly with the length of the blur instead of quadratically
+     */
+    KisDecomposedConvolution::apply(device, rect, kernel, channelFlags, progressUpdater, BORDER_REPEAT);
 }
 
 QRect KisMotionBlurFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
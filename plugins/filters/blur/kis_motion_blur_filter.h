@@ -11,6 +11,7 @@
 #define KIS_MOTION_BLUR_FILTER_H
 
 #include "filter/kis_filter.h"
+#include "KisDecomposedConvolution.h"
 #include "ui_wdg_motion_blur.h"
 
 #include <Eigen/Core>
@@ -35,6 +36,9 @@ public:
     KisConfigWidget * createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool useForMasks) const override;
     QRect neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const override;
     QRect changedRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const override;
+
+private:
+    mutable KisDecomposedKernelCache m_kernelCache;
 };
 
 #endif
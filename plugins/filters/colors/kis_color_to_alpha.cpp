@@ -32,6 +32,7 @@ KisFilterColorToAlpha::KisFilterColorToAlpha()
     setSupportsPainting(true);
     setSupportsAdjustmentLayers(true);
     setSupportsLevelOfDetail(true);
+    setPixelLocal(true);
     setColorSpaceIndependence(FULLY_INDEPENDENT);
 }
 
@@ -59,6 +59,7 @@ KisFilterMax::KisFilterMax() : KisFilter(id(), FiltersCategoryColorId, i18n("M&a
 {
     setSupportsPainting(true);
     setSupportsLevelOfDetail(true);
+    setPixelLocal(true);
     setColorSpaceIndependence(FULLY_INDEPENDENT);
     setShowConfigurationWidget(false);
 }
@@ -96,6 +97,7 @@ void KisFilterMax::processImpl(KisPaintDeviceSP device,
 KisFilterMin::KisFilterMin() : KisFilter(id(), FiltersCategoryColorId, i18n("M&inimize Channel"))
 {
     setSupportsPainting(true);
+    setPixelLocal(true);
     setColorSpaceIndependence(FULLY_INDEPENDENT);
     setShowConfigurationWidget(false);
 }
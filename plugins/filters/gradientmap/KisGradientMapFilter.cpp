@@ -32,6 +32,7 @@ KisGradientMapFilter::KisGradientMapFilter()
     : KisFilter(id(), FiltersCategoryMapId, i18n("&Gradient Map..."))
 {
     setSupportsPainting(true);
+    setPixelLocal(true);
 }
 
 class BlendColorModePolicy
@@ -83,16 +84,16 @@ const quint8* NearestColorModePolicy::colorAt(qreal t, int x, int y) const
 class DitherColorModePolicy
 {
 public:
-    DitherColorModePolicy(const KisGradientMapFilterDitherCachedGradient *cachedGradient, KisDitherUtil *ditherUtil);
+    DitherColorModePolicy(const KisGradientMapFilterDitherCachedGradient *cachedGradient, const KisDitherUtil *ditherUtil);
 
     const quint8* colorAt(qreal t, int x, int y) const;
 
 private:
     const KisGradientMapFilterDitherCachedGradient *m_cachedGradient;
-    KisDitherUtil *m_ditherUtil;
+    const KisDitherUtil *m_ditherUtil;
 };
 
-DitherColorModePolicy::DitherColorModePolicy(const KisGradientMapFilterDitherCachedGradient *cachedGradient, KisDitherUtil *ditherUtil)
+DitherColorModePolicy::DitherColorModePolicy(const KisGradientMapFilterDitherCachedGradient *cachedGradient, const KisDitherUtil *ditherUtil)
     : m_cachedGradient(cachedGradient)
     , m_ditherUtil(ditherUtil)
 {}
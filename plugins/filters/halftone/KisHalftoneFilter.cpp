@@ -19,17 +19,79 @@
 #include <KisSequentialIteratorProgress.h>
 #include <kis_processing_information.h>
 #include <kis_selection.h>
+#include <kis_pixel_selection.h>
 #include <kis_painter.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoColorModelStandardIds.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorProfile.h>
+#include <KoColor.h>
+#include <krita_utils.h>
 
 #include "KisHalftoneFilter.h"
 #include "KisHalftoneConfigWidget.h"
 
 K_PLUGIN_FACTORY_WITH_JSON(KritaHalftoneFactory, "KritaHalftone.json", registerPlugin<KritaHalftone>();)
 
+namespace {
+
+/**
+ * Combines the value of the processed pixel with the value of the
+ * generator (the screen) and applies the hardness. The combination for
+ * opaque generator pixels, which is the usual case, is precomputed into
+ * a single table, so the inner loops need only one lookup per pixel.
+ */
+class ThresholdFunction
+{
+public:
+    ThresholdFunction(const QVector<quint8> &hardnessLut, const QVector<quint8> &noiseWeightLut)
+        : m_hardnessLut(hardnessLut)
+        , m_noiseWeightLut(noiseWeightLut)
+        , m_opaqueLut(256 * 256)
+    {
+        for (int value = 0; value < 256; ++value) {
+            for (int generatorValue = 0; generatorValue < 256; ++generatorValue) {
+                m_opaqueLut[(value << 8) | generatorValue] = combine(value, generatorValue, 255);
+            }
+        }
+    }
+
+    inline quint8 operator()(int value, int generatorValue, int generatorAlpha = 255) const
+    {
+        if (generatorAlpha == 255) {
+            return m_opaqueLut[(value << 8) | generatorValue];
+        }
+        return combine(value, generatorValue, generatorAlpha);
+    }
+
+private:
+    inline quint8 combine(int value, int generatorValue, int generatorAlpha) const
+    {
+        // Combine pixels
+        const int result =
+            qBound(0, value + (generatorValue - 128) * m_noiseWeightLut[value] * generatorAlpha / 0xFE01, 255);
+        // Apply hardness
+        return m_hardnessLut[result];
+    }
+
+    const QVector<quint8> m_hardnessLut;
+    const QVector<quint8> m_noiseWeightLut;
+    QVector<quint8> m_opaqueLut;
+};
+
+/**
+ * The rect is processed in tile-aligned patches in parallel,
+ * so every tile of the devices is written by a single thread only
+ */
+template <typename Function>
+void processInParallel(const QRect &applyRect, Function function)
+{
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(applyRect, QSize(256, 256));
+    KritaUtils::parallelMap(patches, function);
+}
+
+}
+
 KritaHalftone::KritaHalftone(QObject *parent, const QVariantList &)
     : QObject(parent)
 {
@@ -208,48 +270,29 @@ void KisHalftoneFilter::processIntensity(KisPaintDeviceSP device,
 
     // Make the hardness and the noise weight LUT
     const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
+    const ThresholdFunction threshold(makeHardnessLut(hardness), makeNoiseWeightLut(hardness));
 
     // Fill the mask device
     KisSelectionSP maskDevice = m_selectionsCache.getSelection();
 
     {
         const bool invert = config->invert(prefix);
+        const KoColorSpace *colorSpace = device->colorSpace();
+        KisPixelSelectionSP maskPixelSelection = maskDevice->pixelSelection();
 
-        KisSequentialIterator maskIterator(maskDevice->pixelSelection(), applyRect);
-        KisSequentialIterator dstIterator(device, applyRect);
-        KisSequentialIterator srcIterator(generatorDevice, applyRect);
+        processInParallel(applyRect, [&] (const QRect &rect) {
+            KisSequentialIterator maskIterator(maskPixelSelection, rect);
+            KisSequentialConstIterator dstIterator(device, rect);
+            KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
-        if (!invert) {
             while (maskIterator.nextPixel() && dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dstGray = device->colorSpace()->intensity8(dstIterator.rawData());
-                int srcGray = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-
-                // Combine pixels
-                int result = qBound(0, dstGray + (srcGray - 128) * noiseWeightLut[dstGray] * srcAlpha / 0xFE01, 255);
+                const int dstGray = colorSpace->intensity8(dstIterator.rawDataConst());
+                const quint8 result = threshold(dstGray, srcIterator.rawDataConst()[0], srcIterator.rawDataConst()[1]);
 
-                // Apply hardness
-                result = hardnessLut[result];
-
-                *maskIterator.rawData() = 255 - result;
+                *maskIterator.rawData() = invert ? result : 255 - result;
             }
-        } else {
-            while (maskIterator.nextPixel() && dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dstGray = device->colorSpace()->intensity8(dstIterator.rawData());
-                int srcGray = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-
-                // Combine pixels
-                int result = qBound(0, dstGray + (srcGray - 128) * noiseWeightLut[dstGray] * srcAlpha / 0xFE01, 255);
+        });
 
-                // Apply hardness
-                result = hardnessLut[result];
-
-                *maskIterator.rawData() = result;
-            }
-        }
         m_grayDevicesCache.putDevice(generatorDevice);
     }
     if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 50)) {
@@ -319,95 +362,54 @@ void KisHalftoneFilter::processChannel(KisPaintDeviceSP device,
     const int channelPos = channelInfo->pos() / sizeof(ChannelType);
     // Make the hardness and the noise weight LUT
     const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
-
-    // Fill the device
-    const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
+    const ThresholdFunction threshold(makeHardnessLut(hardness), makeNoiseWeightLut(hardness));
 
     const KoColorSpace *colorSpace = device->colorSpace();
 
+    // The generator values converted to the color space of the device
+    QVector<quint8> generatorValueLut(256);
+    QVector<quint8> generatorAlphaLut(256);
+
     if (colorSpace->profile()->isLinear()) {
-        if (!invert) {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = 255 - device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-                KoColor c(QColor(src, src, src, srcAlpha), device->colorSpace());
-                src = device->colorSpace()->scaleToU8(c.data(), 0);
-                srcAlpha = device->colorSpace()->scaleToU8(c.data(), device->colorSpace()->alphaPos());
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(255 - result, channelMin, channelMax));
-            }
-        } else {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-                KoColor c(QColor(src, src, src, srcAlpha), device->colorSpace());
-                src = device->colorSpace()->scaleToU8(c.data(), 0);
-                srcAlpha = device->colorSpace()->scaleToU8(c.data(), device->colorSpace()->alphaPos());
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(result, channelMin, channelMax));
-            }
+        for (int i = 0; i < 256; ++i) {
+            KoColor value(QColor(i, i, i, 255), colorSpace);
+            KoColor alpha(QColor(0, 0, 0, i), colorSpace);
+            generatorValueLut[i] = colorSpace->scaleToU8(value.data(), 0);
+            generatorAlphaLut[i] = colorSpace->scaleToU8(alpha.data(), colorSpace->alphaPos());
         }
     } else {
-        if (!invert) {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = 255 - device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
-
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
-
-                // Apply hardness
-                result = hardnessLut[result];
-
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(255 - result, channelMin, channelMax));
-            }
-        } else {
-            while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-                int dst = device->colorSpace()->scaleToU8(dstIterator.rawData(), channelPos);
-                int src = srcIterator.rawData()[0];
-                int srcAlpha = srcIterator.rawData()[1];
+        for (int i = 0; i < 256; ++i) {
+            generatorValueLut[i] = i;
+            generatorAlphaLut[i] = i;
+        }
+    }
+
+    // The results mapped to the range of the channel
+    const ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
+    const ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
+    QVector<ChannelType> channelValueLut(256);
+    for (int i = 0; i < 256; ++i) {
+        channelValueLut[i] = static_cast<ChannelType>(mapU8ToRange(static_cast<quint8>(i), channelMin, channelMax));
+    }
 
-                // Combine pixels
-                int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+    // Fill the device
+    const bool invert = config->invert(prefix);
 
-                // Apply hardness
-                result = hardnessLut[result];
+    processInParallel(applyRect, [&] (const QRect &rect) {
+        KisSequentialIterator dstIterator(device, rect);
+        KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
-                ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
-                ChannelType channelMin = static_cast<ChannelType>(channelInfo->getUIMin());
-                ChannelType channelMax = static_cast<ChannelType>(channelInfo->getUIMax());
-                dstPixel[channelPos] = static_cast<ChannelType>(mapU8ToRange(result, channelMin, channelMax));
-            }
+        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
+            const int dst = colorSpace->scaleToU8(dstIterator.rawData(), channelPos);
+            const int src = generatorValueLut[srcIterator.rawDataConst()[0]];
+            const int srcAlpha = generatorAlphaLut[srcIterator.rawDataConst()[1]];
+
+            const quint8 result = threshold(invert ? dst : 255 - dst, src, srcAlpha);
+
+            ChannelType *dstPixel = reinterpret_cast<ChannelType*>(dstIterator.rawData());
+            dstPixel[channelPos] = channelValueLut[invert ? result : 255 - result];
         }
-    }
+    });
 }
 
 void KisHalftoneFilter::processChannels(KisPaintDeviceSP device,
@@ -417,6 +419,7 @@ void KisHalftoneFilter::processChannels(KisPaintDeviceSP device,
 {
     const QList<KoChannelInfo *> channels = device->colorSpace()->channels();
     const int progressStep = 100 / (channels.count() * 2);
+    int progress = 0;
 
     if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 0)) {
         return;
@@ -437,7 +440,8 @@ void KisHalftoneFilter::processChannels(KisPaintDeviceSP device,
                 generatorDevices[i] = nullptr;
             }
         }
-        if (checkUpdaterInterruptedAndSetPercent(progressUpdater, progressUpdater->progress() + progressStep)) {
+        progress += progressStep;
+        if (checkUpdaterInterruptedAndSetPercent(progressUpdater, progress)) {
             return;
         }
     }
@@ -445,7 +449,8 @@ void KisHalftoneFilter::processChannels(KisPaintDeviceSP device,
     // process channels
     for (int i = 0; i < channels.count(); ++i) {
         if (!generatorDevices[i]) {
-            progressUpdater->setProgress(progressUpdater->progress() + progressStep);
+            progress += progressStep;
+            checkUpdaterInterruptedAndSetPercent(progressUpdater, progress);
             continue;
         }
 
@@ -485,7 +490,8 @@ void KisHalftoneFilter::processChannels(KisPaintDeviceSP device,
 
         m_grayDevicesCache.putDevice(generatorDevices[i]);
 
-        if (checkUpdaterInterruptedAndSetPercent(progressUpdater, progressUpdater->progress() + progressStep)) {
+        progress += progressStep;
+        if (checkUpdaterInterruptedAndSetPercent(progressUpdater, progress)) {
             return;
         }
     }
@@ -517,43 +523,25 @@ void KisHalftoneFilter::processAlpha(KisPaintDeviceSP device,
 
     // Make the hardness and the noise weight LUT
     const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
+    const ThresholdFunction threshold(makeHardnessLut(hardness), makeNoiseWeightLut(hardness));
 
     // Fill the device
     const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
-
-    if (!invert) {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = 255 - device->colorSpace()->opacityU8(dstIterator.rawData());
-            int src = srcIterator.rawData()[0];
-            int srcAlpha = srcIterator.rawData()[1];
-
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+    const KoColorSpace *colorSpace = device->colorSpace();
 
-            // Apply hardness
-            result = hardnessLut[result];
+    processInParallel(applyRect, [&] (const QRect &rect) {
+        KisSequentialIterator dstIterator(device, rect);
+        KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
-            device->colorSpace()->setOpacity(dstIterator.rawData(), static_cast<quint8>(255 - result), 1);
-        }
-    } else {
         while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = device->colorSpace()->opacityU8(dstIterator.rawData());
-            int src = srcIterator.rawData()[0];
-            int srcAlpha = srcIterator.rawData()[1];
-
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] * srcAlpha / 0xFE01, 255);
+            const int dst = colorSpace->opacityU8(dstIterator.rawData());
+            const quint8 result = threshold(invert ? dst : 255 - dst,
+                                            srcIterator.rawDataConst()[0],
+                                            srcIterator.rawDataConst()[1]);
 
-            // Apply hardness
-            result = hardnessLut[result];
-
-            device->colorSpace()->setOpacity(dstIterator.rawData(), static_cast<quint8>(result), 1);
+            colorSpace->setOpacity(dstIterator.rawData(), invert ? result : static_cast<quint8>(255 - result), 1);
         }
-    }
+    });
     m_grayDevicesCache.putDevice(generatorDevice);
 
     if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 100)) {
@@ -583,41 +571,22 @@ void KisHalftoneFilter::processMask(KisPaintDeviceSP device,
 
     // Make the hardness and the noise weight LUT
     const qreal hardness = config->hardness(prefix) / 100.0;
-    const QVector<quint8> hardnessLut = makeHardnessLut(hardness);
-    const QVector<quint8> noiseWeightLut = makeNoiseWeightLut(hardness);
+    const ThresholdFunction threshold(makeHardnessLut(hardness), makeNoiseWeightLut(hardness));
 
     // Fill the device
     const bool invert = config->invert(prefix);
-    KisSequentialIterator dstIterator(device, applyRect);
-    KisSequentialIterator srcIterator(generatorDevice, applyRect);
 
-    if (!invert) {
-        while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = 255 - *dstIterator.rawData();
-            int src = *srcIterator.rawData();
-
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] / 0xFF, 255);
+    processInParallel(applyRect, [&] (const QRect &rect) {
+        KisSequentialIterator dstIterator(device, rect);
+        KisSequentialConstIterator srcIterator(generatorDevice, rect);
 
-            // Apply hardness
-            result = hardnessLut[result];
-
-            *dstIterator.rawData() = static_cast<quint8>(255 - result);
-        }
-    } else {
         while (dstIterator.nextPixel() && srcIterator.nextPixel()) {
-            int dst = *dstIterator.rawData();
-            int src = *srcIterator.rawData();
-
-            // Combine pixels
-            int result = qBound(0, dst + (src - 128) * noiseWeightLut[dst] / 0xFF, 255);
+            const int dst = *dstIterator.rawData();
+            const quint8 result = threshold(invert ? dst : 255 - dst, *srcIterator.rawDataConst());
 
-            // Apply hardness
-            result = hardnessLut[result];
-
-            *dstIterator.rawData() =  static_cast<quint8>(result);
+            *dstIterator.rawData() = invert ? result : static_cast<quint8>(255 - result);
         }
-    }
+    });
     m_grayDevicesCache.putDevice(generatorDevice);
 
     if (checkUpdaterInterruptedAndSetPercent(progressUpdater, 100)) {
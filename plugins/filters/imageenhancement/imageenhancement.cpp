@@ -23,6 +23,7 @@
 #include <kis_global.h>
 #include <kis_types.h>
 #include "kis_simple_noise_reducer.h"
+#include "kis_median_noise_reducer.h"
 #include "kis_wavelet_noise_reduction.h"
 
 K_PLUGIN_FACTORY_WITH_JSON(KritaImageEnhancementFactory, "kritaimageenhancement.json", registerPlugin<KritaImageEnhancement>();)
@@ -31,6 +32,7 @@ KritaImageEnhancement::KritaImageEnhancement(QObject *parent, const QVariantList
         : QObject(parent)
 {
     KisFilterRegistry::instance()->add(new KisSimpleNoiseReducer());
+    KisFilterRegistry::instance()->add(new KisMedianNoiseReducer());
     KisFilterRegistry::instance()->add(new KisWaveletNoiseReduction());
 }
 
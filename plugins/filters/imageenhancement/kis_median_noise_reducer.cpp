@@ -0,0 +1,261 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_median_noise_reducer.h"
+
+#include <KoChannelInfo.h>
+#include <KoColorSpace.h>
+#include <KoUpdater.h>
+
+#include <kis_global.h>
+#include <widgets/kis_multi_integer_filter_widget.h>
+#include <filter/kis_filter_category_ids.h>
+#include <filter/kis_filter_configuration.h>
+#include <kis_paint_device.h>
+#include <KisSlidingHistogram.h>
+#include "kis_lod_transform.h"
+#include "krita_utils.h"
+
+#include <algorithm>
+
+namespace {
+
+const int numLevels = 256;
+
+int findAlphaPos(const KoColorSpace *cs)
+{
+    int alphaPos = -1;
+    const QList<KoChannelInfo*> channels = cs->channels();
+    for (int i = 0; i < channels.size(); i++) {
+        if (channels[i]->channelType() == KoChannelInfo::ALPHA) {
+            alphaPos = i;
+        }
+    }
+    return alphaPos;
+}
+
+bool isEightBitColorSpace(const KoColorSpace *cs)
+{
+    Q_FOREACH (const KoChannelInfo *channel, cs->channels()) {
+        if (channel->channelValueType() != KoChannelInfo::UINT8) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * For 8-bit color spaces every value of a channel has its own bin,
+ * so the median is taken from the histograms of the sliding window
+ * without any loss of precision
+ */
+void applyHistogramMedian(KisPaintDeviceSP device, const QRect &applyRect, int radius, KoUpdater *progressUpdater)
+{
+    const KoColorSpace* cs = device->colorSpace();
+    const int pixelSize = cs->pixelSize();
+    const int numChannels = cs->channelCount();
+    const int alphaPos = findAlphaPos(cs);
+
+    QVector<int> channelPos;
+    Q_FOREACH (const KoChannelInfo *channel, cs->channels()) {
+        channelPos << channel->pos();
+    }
+
+    /**
+     * Every channel has its own histogram. The color of transparent
+     * pixels is meaningless, so they are counted in the alpha
+     * histogram only.
+     */
+    auto binningFunction =
+        [cs, pixelSize, numChannels, alphaPos, channelPos] (const quint8 *pixels, int numPixels, int *bins, float *) {
+            for (int i = 0; i < numPixels; i++) {
+                const bool isTransparent = cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8;
+
+                for (int c = 0; c < numChannels; c++) {
+                    bins[c] = isTransparent && c != alphaPos ? -1 : pixels[channelPos[c]];
+                }
+
+                pixels += pixelSize;
+                bins += numChannels;
+            }
+        };
+
+    auto resultFunction =
+        [numChannels, channelPos] (const KisSlidingHistogram::Window &window,
+                                   const quint8 *src, quint8 *dst,
+                                   QVector<float> &) {
+            Q_UNUSED(src);
+
+            for (int c = 0; c < numChannels; c++) {
+                const int *counts = window.histogramCounts(c);
+                const int half = (window.total(c) + 1) / 2;
+
+                int median = 0;
+                int sum = 0;
+
+                if (half > 0) {
+                    for (; median < numLevels; median++) {
+                        sum += counts[median];
+                        if (sum >= half) break;
+                    }
+                }
+
+                dst[channelPos[c]] = quint8(median);
+            }
+        };
+
+    KisSlidingHistogram histogram(numChannels, numLevels, 0);
+    histogram.apply(device, applyRect, radius, binningFunction, resultFunction, progressUpdater);
+}
+
+/**
+ * The deeper color spaces cannot be binned without posterizing the
+ * result (or clipping the float values), so the median is selected
+ * from the source values of the window directly. It is much slower
+ * than the histogram, but it is exact.
+ */
+void applyExactMedian(KisPaintDeviceSP device, const QRect &applyRect, int radius, KoUpdater *progressUpdater)
+{
+    const KoColorSpace* cs = device->colorSpace();
+    const int pixelSize = cs->pixelSize();
+    const int numChannels = cs->channelCount();
+    const int alphaPos = findAlphaPos(cs);
+    const int windowSize = 2 * radius + 1;
+
+    KisPaintDeviceSP source = new KisPaintDevice(*device);
+
+    const QVector<QRect> patches = KritaUtils::splitRectIntoPatches(applyRect, QSize(256, 64));
+
+    QVector<float> window;
+    window.reserve(windowSize * windowSize);
+
+    QVector<float> channel(numChannels);
+
+    for (int i = 0; i < patches.size(); i++) {
+        if (progressUpdater) {
+            if (progressUpdater->interrupted()) return;
+            progressUpdater->setProgress(100 * i / patches.size());
+        }
+
+        const QRect &patch = patches[i];
+        const QRect srcRect = kisGrowRect(patch, radius);
+        const int numSrcPixels = srcRect.width() * srcRect.height();
+
+        QVector<quint8> pixels(numSrcPixels * pixelSize);
+        source->readBytes(pixels.data(), srcRect);
+
+        QVector<float> values(numSrcPixels * numChannels);
+        QVector<bool> isTransparent(numSrcPixels);
+
+        for (int j = 0; j < numSrcPixels; j++) {
+            const quint8 *pixel = pixels.constData() + j * pixelSize;
+
+            cs->normalisedChannelsValue(pixel, channel);
+            std::copy(channel.begin(), channel.end(), values.begin() + j * numChannels);
+            isTransparent[j] = cs->opacityU8(pixel) == OPACITY_TRANSPARENT_U8;
+        }
+
+        QVector<quint8> result(patch.width() * patch.height() * pixelSize);
+        quint8 *dstPixel = result.data();
+
+        for (int y = 0; y < patch.height(); y++) {
+            for (int x = 0; x < patch.width(); x++) {
+                for (int c = 0; c < numChannels; c++) {
+                    window.clear();
+
+                    for (int wy = 0; wy < windowSize; wy++) {
+                        int index = (y + wy) * srcRect.width() + x;
+
+                        for (int wx = 0; wx < windowSize; wx++, index++) {
+                            if (c != alphaPos && isTransparent[index]) continue;
+                            window.append(values[index * numChannels + c]);
+                        }
+                    }
+
+                    // the same (lower) median as the histogram picks
+                    if (window.isEmpty()) {
+                        channel[c] = 0.0f;
+                    } else {
+                        auto median = window.begin() + (window.size() - 1) / 2;
+                        std::nth_element(window.begin(), median, window.end());
+                        channel[c] = *median;
+                    }
+                }
+
+                cs->fromNormalisedChannelsValue(dstPixel, channel);
+                dstPixel += pixelSize;
+            }
+        }
+
+        device->writeBytes(result.constData(), patch);
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
+    }
+}
+
+}
+
+KisMedianNoiseReducer::KisMedianNoiseReducer()
+    : KisFilter(id(), FiltersCategoryEnhanceId, i18n("&Median Noise Reduction..."))
+{
+    setSupportsPainting(false);
+    setSupportsLevelOfDetail(true);
+}
+
+KisMedianNoiseReducer::~KisMedianNoiseReducer()
+{
+}
+
+KisConfigWidget * KisMedianNoiseReducer::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool) const
+{
+    Q_UNUSED(dev);
+    vKisIntegerWidgetParam param;
+    param.push_back(KisIntegerWidgetParam(1, 100, 2, i18n("Radius"), "radius"));
+    return new KisMultiIntegerFilterWidget(id().id(), parent, id().id(), param);
+}
+
+KisFilterConfigurationSP KisMedianNoiseReducer::defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const
+{
+    KisFilterConfigurationSP config = factoryConfiguration(resourcesInterface);
+    config->setProperty("radius", 2);
+    return config;
+}
+
+void KisMedianNoiseReducer::processImpl(KisPaintDeviceSP device,
+                                        const QRect& applyRect,
+                                        const KisFilterConfigurationSP config,
+                                        KoUpdater* progressUpdater
+                                        ) const
+{
+    Q_ASSERT(device);
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(config);
+
+    KisLodTransformScalar t(device);
+    const int radius = qMax(1, qCeil(t.scale(qreal(config->getInt("radius", 2)))));
+
+    if (isEightBitColorSpace(device->colorSpace())) {
+        applyHistogramMedian(device, applyRect, radius, progressUpdater);
+    } else {
+        applyExactMedian(device, applyRect, radius, progressUpdater);
+    }
+}
+
+QRect KisMedianNoiseReducer::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
+{
+    KisLodTransformScalar t(lod);
+
+    const int radius = _config->getInt("radius", 2);
+    const int margin = qCeil(t.scale(qreal(radius)));
+    return kisGrowRect(rect, margin);
+}
+
+QRect KisMedianNoiseReducer::changedRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
+{
+    return neededRect(rect, _config, lod);
+}
@@ -0,0 +1,47 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISMEDIANNOISEREDUCER_H
+#define KISMEDIANNOISEREDUCER_H
+
+#include <filter/kis_filter.h>
+#include "kis_config_widget.h"
+
+/**
+ * Replaces every channel of a pixel with the median of this channel
+ * in the square window around the pixel.
+ *
+ * The medians are found in the histograms of the window maintained by
+ * KisSlidingHistogram, so the cost per pixel doesn't depend on the
+ * radius. The channels are quantized into 256 levels, so the result is
+ * exact for 8-bit color spaces only.
+ */
+class KisMedianNoiseReducer : public KisFilter
+{
+public:
+    KisMedianNoiseReducer();
+    ~KisMedianNoiseReducer() override;
+public:
+
+    void processImpl(KisPaintDeviceSP device,
+                     const QRect& applyRect,
+                     const KisFilterConfigurationSP config,
+                     KoUpdater* progressUpdater
+                     ) const override;
+    KisConfigWidget * createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool useForMasks) const override;
+
+    static inline KoID id() {
+        return KoID("mediannoisereducer", i18n("Median Noise Reducer"));
+    }
+
+    QRect changedRect(const QRect &rect, const KisFilterConfigurationSP _config, int lod) const override;
+    QRect neededRect(const QRect &rect, const KisFilterConfigurationSP _config, int lod) const override;
+
+protected:
+    KisFilterConfigurationSP  defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const override;
+};
+
+#endif
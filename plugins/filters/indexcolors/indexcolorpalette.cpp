@@ -8,6 +8,9 @@
 
 #include <qmath.h>
 
+#include <algorithm>
+#include <limits>
+
 #include <KoColorSpaceMaths.h>
 #include <KoColorSpaceRegistry.h>
 #include <filter/kis_filter_configuration.h>
@@ -197,3 +200,114 @@ void IndexColorPalette::mergeMostRedundantColors()
         //insertShades(clrB, clrC, 1);
     }
 }
+
+IndexColorSearchTree::IndexColorSearchTree()
+{
+    m_scale[0] = m_scale[1] = m_scale[2] = 1.0f;
+}
+
+IndexColorSearchTree::IndexColorSearchTree(const IndexColorPalette &palette)
+{
+    static const qreal max = KoColorSpaceMathsTraits<quint16>::max;
+    m_scale[0] = palette.similarityFactors.L / max;
+    m_scale[1] = palette.similarityFactors.a / max;
+    m_scale[2] = palette.similarityFactors.b / max;
+
+    m_nodes.resize(palette.numColors());
+    for(int i = 0; i < palette.numColors(); ++i)
+    {
+        scale(palette.colors[i], m_nodes[i].pos);
+        m_nodes[i].index = i;
+        m_nodes[i].axis = 0;
+    }
+
+    build(0, m_nodes.size());
+}
+
+void IndexColorSearchTree::scale(LabColor clr, float *pos) const
+{
+    pos[0] = clr.L * m_scale[0];
+    pos[1] = clr.a * m_scale[1];
+    pos[2] = clr.b * m_scale[2];
+}
+
+void IndexColorSearchTree::build(int begin, int end)
+{
+    if(end - begin <= 1) return;
+
+    // Split the colors along the axis with the largest spread
+    float minPos[3] = {m_nodes[begin].pos[0], m_nodes[begin].pos[1], m_nodes[begin].pos[2]};
+    float maxPos[3] = {minPos[0], minPos[1], minPos[2]};
+    for(int i = begin + 1; i < end; ++i)
+        for(int c = 0; c < 3; ++c)
+        {
+            minPos[c] = qMin(minPos[c], m_nodes[i].pos[c]);
+            maxPos[c] = qMax(maxPos[c], m_nodes[i].pos[c]);
+        }
+
+    int axis = 0;
+    for(int c = 1; c < 3; ++c)
+        if(maxPos[c] - minPos[c] > maxPos[axis] - minPos[axis])
+            axis = c;
+
+    const int middle = begin + (end - begin) / 2;
+    std::nth_element(m_nodes.begin() + begin, m_nodes.begin() + middle, m_nodes.begin() + end,
+                     [axis] (const Node &lhs, const Node &rhs) {
+                         return lhs.pos[axis] < rhs.pos[axis];
+                     });
+    m_nodes[middle].axis = axis;
+
+    build(begin, middle);
+    build(middle + 1, end);
+}
+
+void IndexColorSearchTree::search(int begin, int end, const float *pos, int &bestIndex, float &bestDistance) const
+{
+    if(begin >= end) return;
+
+    const int middle = begin + (end - begin) / 2;
+    const Node &node = m_nodes[middle];
+
+    float distance = 0.f;
+    for(int c = 0; c < 3; ++c)
+    {
+        const float diff = pos[c] - node.pos[c];
+        distance += diff * diff;
+    }
+
+    if(distance < bestDistance || (distance == bestDistance && node.index < bestIndex))
+    {
+        bestDistance = distance;
+        bestIndex = node.index;
+    }
+
+    if(end - begin == 1) return;
+
+    // Visit the half containing the color first, the other one only
+    // if it may contain a color not farther than the best one
+    const float diff = pos[node.axis] - node.pos[node.axis];
+    if(diff < 0)
+    {
+        search(begin, middle, pos, bestIndex, bestDistance);
+        if(diff * diff <= bestDistance)
+            search(middle + 1, end, pos, bestIndex, bestDistance);
+    }
+    else
+    {
+        search(middle + 1, end, pos, bestIndex, bestDistance);
+        if(diff * diff <= bestDistance)
+            search(begin, middle, pos, bestIndex, bestDistance);
+    }
+}
+
+int IndexColorSearchTree::nearestIndex(LabColor clr) const
+{
+    int bestIndex = -1;
+    float bestDistance = std::numeric_limits<float>::infinity();
+
+    float pos[3];
+    scale(clr, pos);
+    search(0, m_nodes.size(), pos, bestIndex, bestDistance);
+
+    return bestIndex;
+}
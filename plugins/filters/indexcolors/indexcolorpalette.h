@@ -47,4 +47,39 @@ struct IndexColorPalette
     QPair< int, int > getNeighbours(int mainClr) const;
 };
 
+/**
+ * A k-d tree over the colors of a palette. The colors are placed in
+ * the space scaled by the similarity factors of the palette, so the
+ * nearest color in the tree is the most similar color of the palette.
+ */
+class IndexColorSearchTree
+{
+public:
+    IndexColorSearchTree();
+    explicit IndexColorSearchTree(const IndexColorPalette &palette);
+
+    /**
+     * Returns the index of the color most similar to \p clr or -1 if
+     * the palette is empty. Of several equally similar colors the
+     * first one is returned, the same as in getNearestIndex().
+     */
+    int nearestIndex(LabColor clr) const;
+
+private:
+    struct Node
+    {
+        float pos[3];
+        int index;
+        int axis;
+    };
+
+    void scale(LabColor clr, float *pos) const;
+    void build(int begin, int end);
+    void search(int begin, int end, const float *pos, int &bestIndex, float &bestDistance) const;
+
+private:
+    QVector<Node> m_nodes;
+    float m_scale[3];
+};
+
 #endif // INDEXCOLORPALETTE_H
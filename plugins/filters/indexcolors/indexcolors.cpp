@@ -6,9 +6,12 @@
 
 #include "indexcolors.h"
 
+#include <limits>
+
 #include <kpluginfactory.h>
 #include <filter/kis_filter_registry.h>
 #include <kis_global.h>
+#include <kis_assert.h>
 #include <KoColorSpaceMaths.h>
 #include <KoColorSpaceRegistry.h>
 #include <filter/kis_filter_category_ids.h>
@@ -90,6 +93,7 @@ KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palet
       m_psize(cs->pixelSize())
 {
     m_palette = palette;
+    m_searchTree = IndexColorSearchTree(m_palette);
 
     static const qreal max = KoColorSpaceMathsTraits<quint16>::max;
     if(alphaSteps > 0)
@@ -111,24 +115,56 @@ void KisIndexColorTransformation::transform(const quint8* src, quint8* dst, qint
         return;
     }
 
-    union
+    union LabAColor
     {
         quint16 laba[4];
         LabColor lab;
-    } clr;
-    while (nPixels--)
+    };
+
+    // The whole run of pixels is converted to and from Lab at once
+    QVector<LabAColor> pixels(nPixels);
+    m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(pixels.data()), nPixels);
+
+    // Neighbouring pixels often have the same color, reuse the result then
+    LabColor lastColor = {0, 0, 0};
+    LabColor lastNearest = {0, 0, 0};
+    bool hasLastColor = false;
+
+    for (LabAColor &clr : pixels)
     {
-        m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(clr.laba), 1);
-        clr.lab = m_palette.getNearestIndex(clr.lab);
+        if(!hasLastColor || clr.lab.L != lastColor.L || clr.lab.a != lastColor.a || clr.lab.b != lastColor.b)
+        {
+            hasLastColor = true;
+            lastColor = clr.lab;
+            lastNearest = nearestColor(clr.lab);
+        }
+        clr.lab = lastNearest;
         if(m_alphaStep)
         {
             quint16 amod = clr.laba[3] % m_alphaStep;
             clr.laba[3] = clr.laba[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
         }
-        m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(clr.laba), dst, 1);
-        src += m_psize;
-        dst += m_psize;
     }
+
+    m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(pixels.data()), dst, nPixels);
+}
+
+LabColor KisIndexColorTransformation::nearestColor(LabColor clr) const
+{
+    const int index = m_searchTree.nearestIndex(clr);
+
+    // The same rules as in IndexColorPalette::getNearestIndex()
+    KIS_SAFE_ASSERT_RECOVER (index >= 0 &&
+                             m_palette.similarity(m_palette.colors[index], clr) > std::numeric_limits<float>::min()) {
+        LabColor color;
+        color.L = 0;
+        color.a = 0;
+        color.b = 0;
+
+        return color;
+    }
+
+    return m_palette.colors[index];
 }
 
 #include "indexcolors.moc"
@@ -42,10 +42,14 @@ class KisIndexColorTransformation : public KoColorTransformation
 public:
     KisIndexColorTransformation(IndexColorPalette palette, const KoColorSpace* cs, int alphaSteps);
     void transform(const quint8* src, quint8* dst, qint32 nPixels) const override;
+private:
+    LabColor nearestColor(LabColor clr) const;
+
 private:
     const KoColorSpace* m_colorSpace;
     quint32 m_psize;
     IndexColorPalette m_palette;
+    IndexColorSearchTree m_searchTree;
     quint16 m_alphaStep;
     quint16 m_alphaHalfStep;
 };
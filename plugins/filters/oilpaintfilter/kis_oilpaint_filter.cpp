@@ -15,6 +15,7 @@
 
 #include <stdlib.h>
 #include <vector>
+#include <algorithm>
 
 #include <QPoint>
 #include <QSpinBox>
@@ -37,6 +38,7 @@
 #include <filter/kis_filter_configuration.h>
 #include <kis_processing_information.h>
 #include <kis_paint_device.h>
+#include <KisSlidingHistogram.h>
 #include "widgets/kis_multi_integer_filter_widget.h"
 #include <KisGlobalResourcesInterface.h>
 
@@ -60,129 +62,99 @@ void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
     const quint32 brushSize = config ? config->getInt("brushSize", 1) : 1;
     const quint32 smooth = config ? config->getInt("smooth", 30) : 30;
 
-    OilPaint(device, device, applyRect, brushSize, smooth, progressUpdater);
+    OilPaint(device, applyRect, brushSize, smooth, progressUpdater);
 }
 
 // This method have been ported from Pieter Z. Voloshyn algorithm code.
 
 /* Function to apply the OilPaint effect.
  *
- * data             => The image data in RGBA mode.
- * w                => Width of image.
- * h                => Height of image.
  * BrushSize        => Brush size.
  * Smoothness       => Smooth value.
  *
- * Theory           => Using MostFrequentColor function we take the main color in
- *                     a matrix and simply write at the original position.
- */
-
-void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
-                                 int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
-{
-    KisSequentialConstIteratorProgress it(src, applyRect, progressUpdater);
-    KisSequentialIterator dstIt(dst, applyRect);
-
-    while (it.nextPixel() && dstIt.nextPixel()) {
-        MostFrequentColor(src, dstIt.rawData(), applyRect, it.x(), it.y(), BrushSize, Smoothness);
-    }
-}
-
-// This method has been ported from Pieter Z. Voloshyn's algorithm code in Digikam.
-
-/* Function to determine the most frequent color in a matrix
- *
- * Bits             => Bits array
- * Width            => Image width
- * Height           => Image height
- * X                => Position horizontal
- * Y                => Position vertical
- * Radius           => Is the radius of the matrix to be analyzed
- * Intensity        => Intensity to calculate
+ * Theory           => Using the most frequent color in a matrix around
+ *                     every pixel we simply write it at the original position.
  *
- * Theory           => This function creates a matrix with the analyzed pixel in
- *                     the center of this matrix and find the most frequent color
+ * The original algorithm rebuilt the intensity histogram of the whole
+ * matrix for every pixel. Now the histograms are updated incrementally by
+ * KisSlidingHistogram, so the cost per pixel doesn't depend on the brush size.
  */
 
-void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, const QRect& /*bounds*/, int X, int Y, int Radius, int Intensity) const
+void KisOilPaintFilter::OilPaint(KisPaintDeviceSP device, const QRect &applyRect,
+                                 int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
 {
-    uint I;
-
-    double Scale = Intensity / 255.0;
-
-    // Alloc some arrays to be used
-    uchar *IntensityCount = new uchar[(Intensity + 1)];
-
-    const KoColorSpace* cs = src->colorSpace();
-
-    QVector<float> channel(cs->channelCount());
-    QVector<float>* AverageChannels = new QVector<float>[(Intensity + 1)];
-
-    // Erase the array
-    memset(IntensityCount, 0, (Intensity + 1) * sizeof(uchar));
-
-    int startx = X - Radius;
-    int starty = Y - Radius;
-    int width = (2 * Radius) + 1;
-    int height = (2 * Radius) + 1;
-
-    qreal middlePointAlpha = 1;
-    {
-        // if the current pixel is transparent, the result must be transparent, too.
-        KisSequentialConstIterator middlePointIt(src, QRect(X, Y, 1, 1));
-        middlePointIt.nextPixel();
-        middlePointAlpha = cs->opacityF(middlePointIt.oldRawData());
-    }
-
-
-    KisSequentialConstIterator srcIt(src, QRect(startx, starty, width, height));
-    while (middlePointAlpha > 0 && srcIt.nextPixel()) {
-
-        cs->normalisedChannelsValue(srcIt.oldRawData(), channel);
+    const KoColorSpace* cs = device->colorSpace();
+    const int pixelSize = cs->pixelSize();
+    const int numChannels = cs->channelCount();
+    const double Scale = Smoothness / 255.0;
+
+    /**
+     * Every non-transparent pixel falls into the bin of its intensity
+     * and accumulates its normalized channels in the bin
+     */
+    auto binningFunction =
+        [cs, pixelSize, numChannels, Scale] (const quint8 *pixels, int numPixels, int *bins, float *values) {
+            QVector<float> channel(numChannels);
+
+            for (int i = 0; i < numPixels; i++) {
+                if (cs->opacityU8(pixels) == 0) {
+                    // if the pixel is transparent, it's not going to provide any useful information
+                    *bins = -1;
+                } else {
+                    *bins = (uint)(cs->intensity8(pixels) * Scale);
+
+                    cs->normalisedChannelsValue(pixels, channel);
+                    std::copy(channel.constBegin(), channel.constEnd(), values);
+                }
+
+                pixels += pixelSize;
+                bins++;
+                values += numChannels;
+            }
+        };
+
+    /**
+     * The result is the average color of the most frequent intensity
+     */
+    auto resultFunction =
+        [cs, pixelSize, numChannels] (const KisSlidingHistogram::Window &window,
+                                      const quint8 *src, quint8 *dst,
+                                      QVector<float> &channel) {
+
+            // if the current pixel is transparent, the result must be transparent, too.
+            const qreal middlePointAlpha = cs->opacityF(src);
+
+            const int *counts = window.histogramCounts(0);
+
+            int I = 0;
+            int MaxInstance = 0;
+
+            if (middlePointAlpha > 0) {
+                for (int i = 0; i < window.numBins; ++i) {
+                    if (counts[i] > MaxInstance) {
+                        I = i;
+                        MaxInstance = counts[i];
+                    }
+                }
+            }
 
-        if (cs->opacityU8(srcIt.oldRawData()) == 0) {
-            // if the pixel is transparent, it's not going to provide any useful information
-            continue;
-        }
+            if (MaxInstance != 0) {
+                const float *sums = window.binSums(0, I);
 
-        I = (uint)(cs->intensity8(srcIt.oldRawData()) * Scale);
+                channel.resize(numChannels);
+                for (int i = 0; i < numChannels; i++) {
+                    channel[i] = sums[i] / MaxInstance;
+                }
+                cs->fromNormalisedChannelsValue(dst, channel);
+            } else {
+                memset(dst, 0, pixelSize);
+            }
 
-        IntensityCount[I]++;
+            cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
+        };
 
-        if (IntensityCount[I] == 1) {
-            AverageChannels[I] = channel;
-        } else {
-            for (int i = 0; i < channel.size(); i++) {
-                AverageChannels[I][i] += channel[i];
-            }
-        }
-    }
-
-    I = 0;
-    int MaxInstance = 0;
-
-    for (int i = 0 ; i <= Intensity ; ++i) {
-        if (IntensityCount[i] > MaxInstance) {
-            I = i;
-            MaxInstance = IntensityCount[i];
-        }
-    }
-
-    if (MaxInstance != 0) {
-        channel = AverageChannels[I];
-        for (int i = 0; i < channel.size(); i++) {
-            channel[i] /= MaxInstance;
-        }
-        cs->fromNormalisedChannelsValue(dst, channel);
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    } else {
-        memset(dst, 0, cs->pixelSize());
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    }
-
-
-    delete [] IntensityCount;        // free all the arrays
-    delete [] AverageChannels;
+    KisSlidingHistogram histogram(1, Smoothness + 1, numChannels);
+    histogram.apply(device, applyRect, BrushSize, binningFunction, resultFunction, progressUpdater);
 }
 
 QRect KisOilPaintFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int /*lod*/) const
@@ -24,6 +24,8 @@
 #include <KisGlobalResourcesInterface.h>
 #include <KoResourceLoadResult.h>
 
+#include <QHash>
+
 K_PLUGIN_FACTORY_WITH_JSON(PalettizeFactory, "kritapalettize.json", registerPlugin<Palettize>();)
 
 Palettize::Palettize(QObject *parent, const QVariantList &)
@@ -278,70 +280,118 @@ void KisFilterPalettize::processImpl(KisPaintDeviceSP device, const QRect& apply
         KisDitherUtil alphaDitherUtil;
         if (alphaMode == AlphaMode::Dither) alphaDitherUtil.setConfiguration(*config, "alphaDither/");
 
-        KisSequentialIteratorProgress pixel(device, applyRect, progressUpdater);
-        while (pixel.nextPixel()) {
-            KoColor workColor(pixel.oldRawData(), colorspace);
-            workColor.convertTo(workColorspace);
-
-            // Find dither threshold
-            double threshold = 0.5;
-            if (ditherEnabled) {
-                threshold = ditherUtil.threshold(QPoint(pixel.x(), pixel.y()));
-
-                // Traditional per-channel ordered dithering
-                if (colorMode == ColorMode::PerChannelOffset) {
-                    QVector<float> normalized(int(workColorspace->channelCount()));
-                    workColorspace->normalisedChannelsValue(workColor.data(), normalized);
-                    for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
-                        normalized[channel] += (threshold - 0.5) * offsetScale;
-                    }
-                    workColorspace->fromNormalisedChannelsValue(workColor.data(), normalized);
-                }
+        if (rtree.empty()) return;
+
+        /**
+         * Pixel art and sprite sheets consist of a few distinct colors,
+         * so the candidates found for a search color are cached. The
+         * cache is limited to keep the memory usage of photos sane.
+         */
+        struct CachedCandidates {
+            ColorCandidate candidates[2];
+            int size = 0;
+            double distanceSum = 0.0;
+        };
+        const int maxCachedColors = 1 << 16;
+        QHash<quint64, CachedCandidates> candidatesCache;
+
+        auto findCandidates = [&] (const SearchColor &searchColor) -> const CachedCandidates & {
+            const quint64 key =
+                quint64(searchColor.get<0>()) << 32 |
+                quint64(searchColor.get<1>()) << 16 |
+                quint64(searchColor.get<2>());
+
+            auto cached = candidatesCache.constFind(key);
+            if (cached != candidatesCache.constEnd()) return *cached;
+
+            if (candidatesCache.size() >= maxCachedColors) {
+                candidatesCache.clear();
             }
 
             // Get candidate colors and their distances
-            SearchColor searchColor;
-            memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor.data(), sizeof(SearchColor));
-            std::vector<ColorCandidate> candidateColors;
-            candidateColors.reserve(size_t(colorCount));
-            double distanceSum = 0.0;
-            for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && candidateColors.size() < colorCount; ++it) {
-                ColorCandidate candidate = it->second;
+            CachedCandidates result;
+            for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && result.size < colorCount; ++it) {
+                ColorCandidate &candidate = result.candidates[result.size++];
+                candidate = it->second;
                 candidate.distance = boost::geometry::distance(searchColor, it->first);
-                candidateColors.push_back(candidate);
-                distanceSum += candidate.distance;
+                result.distanceSum += candidate.distance;
             }
 
-            // Select color candidate
-            quint16 selected;
-            if (ditherEnabled && colorMode == ColorMode::NearestColors) {
-                // Sort candidates by palette order for stable dither color ordering
-                const bool swap = candidateColors[0].index > candidateColors[1].index;
-                selected = swap ^ (candidateColors[swap].distance / distanceSum > threshold);
-            }
-            else {
-                selected = 0;
-            }
-            ColorCandidate &candidate = candidateColors[selected];
-
-            // Set alpha
-            const double oldAlpha = colorspace->opacityF(pixel.oldRawData());
-            double newAlpha = oldAlpha;
-            if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
-                if (alphaMode == AlphaMode::Clip) {
-                    newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+            return *candidatesCache.insert(key, result);
+        };
+
+        const int pixelSize = colorspace->pixelSize();
+        const int workPixelSize = workColorspace->pixelSize();
+        QVector<quint8> workPixels;
+
+        // the pixels are converted into the search colorspace in batches
+        KisSequentialIteratorProgress pixel(device, applyRect, progressUpdater);
+        int numConseqPixels = pixel.nConseqPixels();
+        while (pixel.nextPixels(numConseqPixels)) {
+            numConseqPixels = pixel.nConseqPixels();
+
+            workPixels.resize(numConseqPixels * workPixelSize);
+            colorspace->convertPixelsTo(pixel.oldRawData(), workPixels.data(), workColorspace, numConseqPixels,
+                                        KoColorConversionTransformation::internalRenderingIntent(),
+                                        KoColorConversionTransformation::internalConversionFlags());
+
+            for (int i = 0; i < numConseqPixels; i++) {
+                const QPoint pt(pixel.x() + i, pixel.y());
+                const quint8 *oldPixel = pixel.oldRawData() + i * pixelSize;
+                quint8 *dstPixel = pixel.rawData() + i * pixelSize;
+                quint8 *workColor = workPixels.data() + i * workPixelSize;
+
+                // Find dither threshold
+                double threshold = 0.5;
+                if (ditherEnabled) {
+                    threshold = ditherUtil.threshold(pt);
+
+                    // Traditional per-channel ordered dithering
+                    if (colorMode == ColorMode::PerChannelOffset) {
+                        QVector<float> normalized(int(workColorspace->channelCount()));
+                        workColorspace->normalisedChannelsValue(workColor, normalized);
+                        for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
+                            normalized[channel] += (threshold - 0.5) * offsetScale;
+                        }
+                        workColorspace->fromNormalisedChannelsValue(workColor, normalized);
+                    }
+                }
+
+                SearchColor searchColor;
+                memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor, sizeof(SearchColor));
+                const CachedCandidates &candidateColors = findCandidates(searchColor);
+
+                // Select color candidate
+                quint16 selected;
+                if (ditherEnabled && colorMode == ColorMode::NearestColors && candidateColors.size > 1) {
+                    // Sort candidates by palette order for stable dither color ordering
+                    const bool swap = candidateColors.candidates[0].index > candidateColors.candidates[1].index;
+                    selected = swap ^ (candidateColors.candidates[swap].distance / candidateColors.distanceSum > threshold);
                 }
-                else if (alphaMode == AlphaMode::Index) {
-                    newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+                else {
+                    selected = 0;
                 }
-                else if (alphaMode == AlphaMode::Dither) {
-                    newAlpha = oldAlpha < alphaDitherUtil.threshold(QPoint(pixel.x(), pixel.y())) ? 0.0 : 1.0;
+                const ColorCandidate &candidate = candidateColors.candidates[selected];
+
+                // Set alpha
+                const double oldAlpha = colorspace->opacityF(oldPixel);
+                double newAlpha = oldAlpha;
+                if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
+                    if (alphaMode == AlphaMode::Clip) {
+                        newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+                    }
+                    else if (alphaMode == AlphaMode::Index) {
+                        newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+                    }
+                    else if (alphaMode == AlphaMode::Dither) {
+                        newAlpha = oldAlpha < alphaDitherUtil.threshold(pt) ? 0.0 : 1.0;
+                    }
                 }
-            }
-            colorspace->setOpacity(candidate.color.data(), newAlpha, 1);
 
-            // Copy color to pixel
-            memcpy(pixel.rawData(), candidate.color.data(), colorspace->pixelSize());
+                // Copy color to pixel
+                memcpy(dstPixel, candidate.color.data(), pixelSize);
+                colorspace->setOpacity(dstPixel, newAlpha, 1);
+            }
         }
     }
 }
@@ -20,6 +20,13 @@
 #include "kis_iterator_ng.h"
 #include "kundo2command.h"
 #include "kis_painter.h"
+#include "KisDecomposedConvolutionOps.h"
+#include "KisEdgeDetectionOps.h"
+#include "krita_utils.h"
+
+#include <numeric>
+
+#include <QScopedPointer>
 
 KisFilterPhongBumpmap::KisFilterPhongBumpmap()
                       : KisFilter(KoID("phongbumpmap", i18n("Phong Bumpmap")),
@@ -68,10 +75,6 @@ void KisFilterPhongBumpmap::processImpl(KisPaintDeviceSP device,
         inputArea.adjust(-1, -1, 1, 1);
     }
 
-    quint32 posup;
-    quint32 posdown;
-    quint32 posleft;
-    quint32 posright;
     QColor I; //Reflected light
 
     if (progressUpdater) progressUpdater->setProgress(1);
@@ -88,7 +91,8 @@ void KisFilterPhongBumpmap::processImpl(KisPaintDeviceSP device,
     QVector<quint8> bumpmap(bytesToFillBumpmapArea);
     quint8         *bumpmapDataPointer       = bumpmap.data();
     quint32         ki                       = KoChannelInfo::displayPositionToChannelIndex(m_heightChannel->displayPosition(), channels);
-    PhongPixelProcessor tileRenderer(pixelsOfInputArea, config);
+    // the heightmap is kept in a separate buffer of floats, see below
+    PhongPixelProcessor tileRenderer(m_usenormalmap ? pixelsOfInputArea : 0, config);
 
 
     if (progressUpdater) progressUpdater->setProgress(2);
@@ -109,10 +113,16 @@ void KisFilterPhongBumpmap::processImpl(KisPaintDeviceSP device,
                                              );
 
     if (m_usenormalmap==false) {
+        /**
+         * The channel values are integers, so the differences of the
+         * heights are exact in floats as well
+         */
+        QVector<float> heightmap(pixelsOfInputArea);
+
         for (qint32 srcRow = 0; srcRow < inputArea.height(); ++srcRow) {
             do {
                 const quint8 *data = iterator->oldRawData();
-                tileRenderer.realheightmap[curPixel] = toDoubleFuncPtr[ki](data, channels[ki]->pos());
+                heightmap[curPixel] = toDoubleFuncPtr[ki](data, channels[ki]->pos());
                 curPixel++;
             }
             while (iterator->nextPixel());
@@ -120,25 +130,44 @@ void KisFilterPhongBumpmap::processImpl(KisPaintDeviceSP device,
         }
         if (progressUpdater) progressUpdater->setProgress(50);
 
-        const int tileHeightMinus1 = inputArea.height() - 1;
-        const int tileWidthMinus1 = inputArea.width() - 1;
+        const int inputWidth = inputArea.width();
+        const int outputWidth = outputArea.width();
 
-        // Foreach INNER pixel in tile
-        for (int y = 1; y < tileHeightMinus1; ++y) {
-            for (int x = 1; x < tileWidthMinus1; ++x) {
-                posup   = (y + 1) * inputArea.width() + x;
-                posdown = (y - 1) * inputArea.width() + x;
-                posleft  = y * inputArea.width() + x - 1;
-                posright = y * inputArea.width() + x + 1;
+        QScopedPointer<KisDecomposedConvolutionOpsBase> convolutionOps(KisDecomposedConvolutionOpsFactory::create());
+        QScopedPointer<KisEdgeDetectionOpsBase> edgeDetectionOps(KisEdgeDetectionOpsFactory::create());
 
+        QVector<int> rows(outputArea.height());
+        std::iota(rows.begin(), rows.end(), 0);
 
-               memcpy(bumpmapDataPointer,
-                      tileRenderer.IlluminatePixelFromHeightmap(posup, posdown, posleft, posright).data(),
-                      pixelSize);
+        /**
+         * Foreach INNER pixel in tile. The normals of a whole row are
+         * calculated at once, the rows are illuminated in parallel.
+         * Same as in IlluminatePixelFromHeightmap(), the normal is
+         * (left - right, down - up, 8), where "up" is the next row.
+         */
+        KritaUtils::parallelMap(rows,
+            [&] (int y) {
+                if (progressUpdater && progressUpdater->interrupted()) return;
 
-               bumpmapDataPointer += pixelSize;
-            }
-        }
+                const float *row = heightmap.constData() + (y + 1) * inputWidth;
+                const float *rowUp = row + inputWidth;
+                const float *rowDown = row - inputWidth;
+
+                QVector<float> normalX(outputWidth, 0.0f);
+                QVector<float> normalY(outputWidth, 0.0f);
+                QVector<float> normalZ(outputWidth);
+
+                convolutionOps->addScaledDifference(normalX.data(), row, row + 2, 1.0f, outputWidth);
+                convolutionOps->addScaledDifference(normalY.data(), rowDown + 1, rowUp + 1, 1.0f, outputWidth);
+                edgeDetectionOps->normalize(normalX.data(), normalY.data(), normalZ.data(), 8.0f, outputWidth);
+
+                quint16 *dstPixel = reinterpret_cast<quint16*>(bumpmapDataPointer + y * outputWidth * pixelSize);
+
+                for (int x = 0; x < outputWidth; ++x) {
+                    tileRenderer.IlluminatePixel(QVector3D(normalX[x], normalY[x], normalZ[x]), dstPixel);
+                    dstPixel += CHANNEL_COUNT_OF_BUMPMAP;
+                }
+            });
     } else {
         for (qint32 srcRow = 0; srcRow < inputArea.height(); ++srcRow) {
             do {
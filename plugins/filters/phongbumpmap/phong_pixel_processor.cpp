@@ -113,43 +113,45 @@ QVector<quint16> PhongPixelProcessor::IlluminatePixelFromHeightmap(quint32 posup
 }
 
 QVector<quint16> PhongPixelProcessor::IlluminatePixel()
+{
+    QVector<quint16> finalPixel(4, 0xFFFF);
+    IlluminatePixel(normal_vector, finalPixel.data());
+    return finalPixel;
+}
+
+void PhongPixelProcessor::IlluminatePixel(const QVector3D &normal, quint16 *finalPixel) const
 {
     qreal temp;
     quint8 channel = 0;
     const quint8 totalChannels = 3; // The 4th is alpha and we'll fill it with a nice 0xFFFF
     qreal computation[] = {0, 0, 0};
-    QVector<quint16> finalPixel(4, 0xFFFF);
+
+    finalPixel[0] = finalPixel[1] = finalPixel[2] = finalPixel[3] = 0xFFFF;
 
     if (lightSources.size() == 0)
-        return finalPixel;
+        return;
 
     // PREPARE ALGORITHM HERE
 
     for (int i = 0; i < size; i++) {
-        light_vector = lightSources.at(i).lightVector;
+        const Illuminant &light = lightSources.at(i);
+        const QVector3D &lightVector = light.lightVector;
 
         for (channel = 0; channel < totalChannels; channel++) {
-            Ia = lightSources.at(i).RGBvalue.at(channel) * Ka;
-            computation[channel] += Ia;
+            computation[channel] += light.RGBvalue.at(channel) * Ka;
         }
         if (diffuseLightIsEnabled) {
-            temp = Kd * QVector3D::dotProduct(normal_vector, light_vector);
+            temp = Kd * QVector3D::dotProduct(normal, lightVector);
             for (channel = 0; channel < totalChannels; channel++) {
-                Id = lightSources.at(i).RGBvalue.at(channel) * temp;
-                if (Id < 0)     Id = 0;
-                if (Id > 1)     Id = 1;
-                computation[channel] += Id;
+                computation[channel] += qBound(0.0, light.RGBvalue.at(channel) * temp, 1.0);
             }
         }
 
         if (specularLightIsEnabled) {
-            reflection_vector = (2 * pow(QVector3D::dotProduct(normal_vector, light_vector), shiny_exp)) * normal_vector - light_vector;
-            temp = Ks * QVector3D::dotProduct(vision_vector, reflection_vector);
+            const QVector3D reflectionVector = (2 * pow(QVector3D::dotProduct(normal, lightVector), shiny_exp)) * normal - lightVector;
+            temp = Ks * QVector3D::dotProduct(vision_vector, reflectionVector);
             for (channel = 0; channel < totalChannels; channel++) {
-                Is = lightSources.at(i).RGBvalue.at(channel) * temp;
-                if (Is < 0)     Is = 0;
-                if (Is > 1)     Is = 1;
-                computation[channel] += Is;
+                computation[channel] += qBound(0.0, light.RGBvalue.at(channel) * temp, 1.0);
             }
         }
     }
@@ -165,8 +167,6 @@ QVector<quint16> PhongPixelProcessor::IlluminatePixel()
     finalPixel[2] = quint16(computation[0] * 0xFFFF);
     finalPixel[1] = quint16(computation[1] * 0xFFFF);
     finalPixel[0] = quint16(computation[2] * 0xFFFF);
-
-    return finalPixel;
 }
 
 QVector<quint16> PhongPixelProcessor::IlluminatePixelFromNormalmap(qreal r, qreal g, qreal b)
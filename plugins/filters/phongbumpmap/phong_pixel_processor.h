@@ -66,6 +66,14 @@ public:
 
     QVector<quint16> IlluminatePixelFromHeightmap(quint32 posup, quint32 posdown, quint32 posleft, quint32 posright);
     QVector<quint16> IlluminatePixel();
+
+    /**
+     * Illuminates a pixel with the normal \p normal and writes the
+     * result into \p finalPixel (BGRA, 16 bits per channel). Unlike
+     * IlluminatePixel() it doesn't change the state of the processor,
+     * so it can be called from multiple threads at once.
+     */
+    void IlluminatePixel(const QVector3D &normal, quint16 *finalPixel) const;
     QVector<quint16> IlluminatePixelFromNormalmap(qreal r, qreal g, qreal b);
 
     void setLightVector(QVector3D light_vector);
@@ -61,6 +61,7 @@ KisFilterThreshold::KisFilterThreshold()
     setSupportsLevelOfDetail(true);
     setSupportsAdjustmentLayers(true);
     setSupportsThreading(true);
+    setPixelLocal(true);
 }
 
 void KisFilterThreshold::processImpl(KisPaintDeviceSP device,
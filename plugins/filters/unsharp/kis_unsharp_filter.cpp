@@ -91,10 +91,14 @@ void KisUnsharpFilter::processImpl(KisPaintDeviceSP device,
     const uint lightnessOnly = (config->getProperty("lightnessOnly", value)) ? value.toBool() : true;
 
     QBitArray channelFlags = config->channelFlags();
+
+    // the big radii are used for local contrast enhancement,
+    // where the approximated blur is good enough
     KisGaussianKernel::applyGaussian(device, applyRect,
                                      halfSize, halfSize,
                                      channelFlags,
-                                     convolutionUpdater);
+                                     convolutionUpdater,
+                                     false, BORDER_REPEAT, true);
 
     qreal weights[2];
     qreal factor = 128;
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+
 #include <kpluginfactory.h>
 #include <KoUpdater.h>
 #include <kis_processing_information.h>
@@ -14,6 +15,8 @@
 #include <generator/kis_generator_registry.h>
 #include <KoCompositeOpRegistry.h>
 #include <kis_selection.h>
+#include <kis_pixel_selection.h>
+#include <krita_utils.h>
 #include <kis_painter.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorProfile.h>
@@ -329,21 +332,28 @@ void KisScreentoneGenerator::generate(KisProcessingInformation dst,
     checkUpdaterInterruptedAndSetPercent(progressUpdater, 50);
 
     KisSelectionSP selection = new KisSelection(device->defaultBounds(), KisImageResolutionProxy::identity());
-    KisSequentialIterator it(selection->pixelSelection(), bounds);
+    KisPixelSelectionSP pixelSelection = selection->pixelSelection();
+    const bool invert = config->invert();
 
-    if (!config->invert()) {
-        while (it.nextPixel()) {
-            qreal v = std::round(sampler(it.x(), it.y()) * 10000.0) / 10000.0;
-            v = qBound(0.0, postprocessingFunction(v), 1.0);
-            *it.rawData() = 255 - static_cast<quint8>(qRound(v * 255.0));
-        }
-    } else {
-        while (it.nextPixel()) {
-            qreal v = std::round(sampler(it.x(), it.y()) * 10000.0) / 10000.0;
-            v = qBound(0.0, postprocessingFunction(v), 1.0);
-            *it.rawData() = static_cast<quint8>(qRound(v * 255.0));
-        }
-    }
+    /**
+     * The screen is sampled in tile-aligned patches in parallel, so every
+     * tile of the selection is written by a single thread only. The
+     * samplers and the postprocessing functions are immutable, so they
+     * can be shared between the threads.
+     */
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(bounds, QSize(256, 256));
+
+    KritaUtils::parallelMap(patches,
+        [&] (const QRect &patch) {
+            KisSequentialIterator it(pixelSelection, patch);
+
+            while (it.nextPixel()) {
+                qreal v = std::round(sampler(it.x(), it.y()) * 10000.0) / 10000.0;
+                v = qBound(0.0, postprocessingFunction(v), 1.0);
+                const quint8 value = static_cast<quint8>(qRound(v * 255.0));
+                *it.rawData() = invert ? value : 255 - value;
+            }
+        });
     checkUpdaterInterruptedAndSetPercent(progressUpdater, 25);
 
     {
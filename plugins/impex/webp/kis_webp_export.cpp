@@ -35,10 +35,51 @@
 #include <kis_random_accessor_ng.h>
 #include <kis_raster_keyframe_channel.h>
 #include <kis_time_span.h>
+#include <krita_utils.h>
 
 #include "kis_wdg_options_webp.h"
 #include "kis_webp_export.h"
 
+namespace
+{
+/**
+ * Dither \p src into \p dst with \p op. The work is split into
+ * the update patches of the image, which are processed in parallel.
+ */
+void ditherDeviceInParallel(KisPaintDeviceSP src, KisPaintDeviceSP dst, const KisDitherOp *op, const QRect &bounds)
+{
+    const QVector<QRect> patches = KritaUtils::splitRectIntoPatches(bounds, KritaUtils::optimalPatchSize());
+
+    KritaUtils::parallelMap(patches, [src, dst, op](const QRect &patch) {
+        KisRandomConstAccessorSP srcIt = src->createRandomConstAccessorNG();
+        KisRandomAccessorSP dstIt = dst->createRandomAccessorNG();
+
+        int rows = 1;
+        int columns = 1;
+
+        for (int y = patch.y(); y <= patch.bottom(); y += rows) {
+            rows = qMin(srcIt->numContiguousRows(y),
+                        qMin(dstIt->numContiguousRows(y), patch.bottom() - y + 1));
+
+            for (int x = patch.x(); x <= patch.right(); x += columns) {
+                columns = qMin(srcIt->numContiguousColumns(x),
+                               qMin(dstIt->numContiguousColumns(x), patch.right() - x + 1));
+
+                srcIt->moveTo(x, y);
+                dstIt->moveTo(x, y);
+
+                const qint32 srcRowStride = srcIt->rowStride(x, y);
+                const qint32 dstRowStride = dstIt->rowStride(x, y);
+                const quint8 *srcPtr = srcIt->rawDataConst();
+                quint8 *dstPtr = dstIt->rawData();
+
+                op->dither(srcPtr, srcRowStride, dstPtr, dstRowStride, x, y, columns, rows);
+            }
+        }
+    });
+}
+} // namespace
+
 K_PLUGIN_FACTORY_WITH_JSON(KisWebPExportFactory, "krita_webp_export.json", registerPlugin<KisWebPExport>();)
 
 KisWebPExport::KisWebPExport(QObject *parent, const QVariantList &)
@@ -302,31 +343,7 @@ KisImportExportErrorCode KisWebPExport::convert(KisDocument *document, QIODevice
                         const KisDitherOp *op =
                             mixCs->ditherOp(destCs->colorDepthId().id(), enableDithering ? DITHER_BEST : DITHER_NONE);
 
-                        KisRandomConstAccessorSP srcIt = tmp->createRandomConstAccessorNG();
-                        KisRandomAccessorSP dstIt = dst->createRandomAccessorNG();
-
-                        int rows = 1;
-                        int columns = 1;
-
-                        for (int y = bounds.y(); y <= bounds.bottom(); y += rows) {
-                            rows = qMin(srcIt->numContiguousRows(y),
-                                        qMin(dstIt->numContiguousRows(y), bounds.bottom() - y + 1));
-
-                            for (int x = bounds.x(); x <= bounds.right(); x += columns) {
-                                columns = qMin(srcIt->numContiguousColumns(x),
-                                               qMin(dstIt->numContiguousColumns(x), bounds.right() - x + 1));
-
-                                srcIt->moveTo(x, y);
-                                dstIt->moveTo(x, y);
-
-                                const qint32 srcRowStride = srcIt->rowStride(x, y);
-                                const qint32 dstRowStride = dstIt->rowStride(x, y);
-                                const quint8 *srcPtr = srcIt->rawDataConst();
-                                quint8 *dstPtr = dstIt->rawData();
-
-                                op->dither(srcPtr, srcRowStride, dstPtr, dstRowStride, x, y, columns, rows);
-                            }
-                        }
+                        ditherDeviceInParallel(tmp, dst, op, bounds);
                     }
 
                     const QImage imageOut = dst->convertToQImage(nullptr, 0, 0, bounds.width(), bounds.height())
@@ -413,31 +430,7 @@ KisImportExportErrorCode KisWebPExport::convert(KisDocument *document, QIODevice
                     const KisDitherOp *op =
                         mixCs->ditherOp(destCs->colorDepthId().id(), enableDithering ? DITHER_BEST : DITHER_NONE);
 
-                    KisRandomConstAccessorSP srcIt = tmp->createRandomConstAccessorNG();
-                    KisRandomAccessorSP dstIt = dst->createRandomAccessorNG();
-
-                    int rows = 1;
-                    int columns = 1;
-
-                    for (int y = bounds.y(); y <= bounds.bottom(); y += rows) {
-                        rows = qMin(srcIt->numContiguousRows(y),
-                                    qMin(dstIt->numContiguousRows(y), bounds.bottom() - y + 1));
-
-                        for (int x = bounds.x(); x <= bounds.right(); x += columns) {
-                            columns = qMin(srcIt->numContiguousColumns(x),
-                                           qMin(dstIt->numContiguousColumns(x), bounds.right() - x + 1));
-
-                            srcIt->moveTo(x, y);
-                            dstIt->moveTo(x, y);
-
-                            const qint32 srcRowStride = srcIt->rowStride(x, y);
-                            const qint32 dstRowStride = dstIt->rowStride(x, y);
-                            const quint8 *srcPtr = srcIt->rawDataConst();
-                            quint8 *dstPtr = dstIt->rawData();
-
-                            op->dither(srcPtr, srcRowStride, dstPtr, dstRowStride, x, y, columns, rows);
-                        }
-                    }
+                    ditherDeviceInParallel(tmp, dst, op, bounds);
                 }
 
                 const QImage imageOut = dst->convertToQImage(nullptr, 0, 0, bounds.width(), bounds.height())
@@ -0,0 +1,210 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisColorSmudgeDabPipeline.h"
+
+#include <numeric>
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_brush.h"
+#include "kis_fixed_paint_device.h"
+#include "krita_utils.h"
+
+
+struct KisColorSmudgeDabPipeline::Private
+{
+    Private(KisDabCacheUtils::ResourcesFactory _resourcesFactory)
+        : resourcesFactory(_resourcesFactory),
+          maskColorSpace(KoColorSpaceRegistry::instance()->alpha8()),
+          maskColor(Qt::black, maskColorSpace)
+    {
+    }
+
+    ~Private() {
+        qDeleteAll(cachedResources);
+    }
+
+    KisDabCacheUtils::DabRenderingResources* fetchResources() {
+        {
+            QMutexLocker l(&resourcesMutex);
+            if (!cachedResources.isEmpty()) {
+                return cachedResources.takeLast();
+            }
+        }
+
+        return resourcesFactory();
+    }
+
+    void putResources(KisDabCacheUtils::DabRenderingResources *resources) {
+        QMutexLocker l(&resourcesMutex);
+        cachedResources.append(resources);
+    }
+
+    KisDabCacheUtils::ResourcesFactory resourcesFactory;
+
+    /**
+     * The resources used for calculation of the dab positions,
+     * they are never used in the worker threads
+     */
+    QScopedPointer<KisDabCacheUtils::DabRenderingResources> mainResources;
+
+    QMutex resourcesMutex;
+    QList<KisDabCacheUtils::DabRenderingResources*> cachedResources;
+
+    const KoColorSpace *maskColorSpace;
+    KoColor maskColor;
+
+    KisFixedPaintDeviceSP lastOriginalMask;
+    int seqNo = 0;
+};
+
+KisColorSmudgeDabPipeline::KisColorSmudgeDabPipeline(KisDabCacheUtils::ResourcesFactory resourcesFactory)
+    : m_d(new Private(resourcesFactory))
+{
+}
+
+KisColorSmudgeDabPipeline::~KisColorSmudgeDabPipeline()
+{
+}
+
+QVector<KisColorSmudgeDabPipeline::PreparedMask>
+KisColorSmudgeDabPipeline::prepareMasks(const QVector<Request> &requests)
+{
+    using namespace KisDabCacheUtils;
+
+    struct Job {
+        DabGenerationInfo di;
+        int seqNo = 0;
+
+        /// the index of the job that generates the mask for this dab,
+        /// -1 means that the last mask of the previous batch is reused
+        int sourceIndex = -1;
+
+        KisFixedPaintDeviceSP original;
+    };
+
+    if (requests.isEmpty()) return {};
+
+    if (!m_d->mainResources) {
+        m_d->mainResources.reset(m_d->resourcesFactory());
+    }
+
+    QVector<Job> jobs(requests.size());
+    Job *jobsData = jobs.data();
+
+    QVector<int> generatedJobs;
+
+    /**
+     * 1) Calculate positions of the dabs and check whether they can reuse
+     *    the previously generated masks. The check depends on the internal
+     *    state of KisDabCacheBase, so it must be done sequentially.
+     */
+    for (int i = 0; i < requests.size(); i++) {
+        const Request &request = requests[i];
+        Job &job = jobsData[i];
+
+        job.seqNo = m_d->seqNo++;
+        m_d->mainResources->syncResourcesToSeqNo(job.seqNo, request.info);
+
+        const bool hasMaskInCache = i > 0 || m_d->lastOriginalMask;
+        bool shouldUseCache = false;
+
+        fetchDabGenerationInfo(hasMaskInCache,
+                               m_d->mainResources.data(),
+                               DabRequestInfo(m_d->maskColor,
+                                              request.cursorPoint,
+                                              request.shape,
+                                              request.info,
+                                              1.0,
+                                              request.lightnessStrength),
+                               &job.di,
+                               &shouldUseCache);
+
+        if (shouldUseCache) {
+            job.sourceIndex = i > 0 ? jobsData[i - 1].sourceIndex : -1;
+        } else {
+            job.sourceIndex = i;
+            generatedJobs << i;
+        }
+    }
+
+    /**
+     * 2) Generate all the masks that cannot be reused
+     */
+    auto generateMask = [this, jobsData] (int index) {
+        Job &job = jobsData[index];
+
+        DabRenderingResources *resources = m_d->fetchResources();
+        resources->syncResourcesToSeqNo(job.seqNo, job.di.info);
+
+        job.original = new KisFixedPaintDevice(m_d->maskColorSpace);
+        generateDab(job.di, resources, &job.original);
+
+        m_d->putResources(resources);
+    };
+
+    if (generatedJobs.size() > 1) {
+        KritaUtils::parallelMap(generatedJobs, generateMask);
+    } else if (!generatedJobs.isEmpty()) {
+        generateMask(generatedJobs.first());
+    }
+
+    /**
+     * 3) Fetch the final masks and apply postprocessing (texturing) to them.
+     *    The postprocessing depends on the position of the dab, so it should
+     *    be done for every dab separately, even when the mask is reused.
+     */
+    QVector<PreparedMask> result(jobs.size());
+    PreparedMask *resultData = result.data();
+
+    auto finalizeMask = [this, jobsData, resultData] (int index) {
+        const Job &job = jobsData[index];
+
+        KisFixedPaintDeviceSP original =
+            job.sourceIndex >= 0 ? jobsData[job.sourceIndex].original : m_d->lastOriginalMask;
+
+        PreparedMask &mask = resultData[index];
+        mask.dstDabRect = job.di.dstDabRect;
+
+        if (job.sourceIndex != index) {
+            mask.dstDabRect = correctDabRectWhenFetchedFromCache(mask.dstDabRect, original->bounds().size());
+        }
+
+        if (job.di.needsPostprocessing) {
+            mask.mask = new KisFixedPaintDevice(*original);
+
+            DabRenderingResources *resources = m_d->fetchResources();
+            resources->syncResourcesToSeqNo(job.seqNo, job.di.info);
+            postProcessDab(mask.mask, mask.dstDabRect.topLeft(), job.di.info, resources);
+            m_d->putResources(resources);
+        } else {
+            mask.mask = original;
+        }
+    };
+
+    if (jobs.first().di.needsPostprocessing && jobs.size() > 1) {
+        QVector<int> allJobs(jobs.size());
+        std::iota(allJobs.begin(), allJobs.end(), 0);
+
+        KritaUtils::parallelMap(allJobs, finalizeMask);
+    } else {
+        for (int i = 0; i < jobs.size(); i++) {
+            finalizeMask(i);
+        }
+    }
+
+    const Job &lastJob = jobs.last();
+    if (lastJob.sourceIndex >= 0) {
+        m_d->lastOriginalMask = jobsData[lastJob.sourceIndex].original;
+    }
+
+    return result;
+}
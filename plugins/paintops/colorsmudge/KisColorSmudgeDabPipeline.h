@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KRITA_KISCOLORSMUDGEDABPIPELINE_H
+#define KRITA_KISCOLORSMUDGEDABPIPELINE_H
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include <kis_dab_cache_base.h>
+#include <KisDabCacheUtils.h>
+
+
+/**
+ * @brief Generates masks of the color smudge dabs ahead of painting
+ *
+ * Sampling and blending of the smudge dabs must happen strictly in order,
+ * because every dab reads the result of the previous one. Generation of
+ * the dab masks (including texturing) doesn't depend on the canvas though,
+ * so the paintop collects all the dabs of a line segment and generates
+ * their masks in parallel using a set of rendering resources, one per
+ * worker thread, the same way as KisDabRenderingQueue does for the brush op.
+ *
+ * The masks are cached in the same way as KisDabCache does: if a dab has
+ * the same parameters as the previous one, the previous mask is reused.
+ */
+class KisColorSmudgeDabPipeline : public KisDabCacheBase
+{
+public:
+    struct Request {
+        KisPaintInformation info;
+        KisDabShape shape;
+        QPointF cursorPoint;
+        qreal lightnessStrength = 1.0;
+    };
+
+    struct PreparedMask {
+        QRect dstDabRect;
+        KisFixedPaintDeviceSP mask;
+    };
+
+public:
+    KisColorSmudgeDabPipeline(KisDabCacheUtils::ResourcesFactory resourcesFactory);
+    ~KisColorSmudgeDabPipeline();
+
+    /**
+     * Generates masks for all the \p requests. The results are
+     * returned in the same order as the requests.
+     */
+    QVector<PreparedMask> prepareMasks(const QVector<Request> &requests);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif //KRITA_KISCOLORSMUDGEDABPIPELINE_H
@@ -6,7 +6,20 @@
 
 #include "KisColorSmudgeStrategy.h"
 
+#include <kis_assert.h>
+
 KisColorSmudgeStrategy::KisColorSmudgeStrategy()
         : m_memoryAllocator(new KisOptimizedByteArray::PooledMemoryAllocator())
 {
 }
+
+bool KisColorSmudgeStrategy::supportsPreparedMasks() const
+{
+    return false;
+}
+
+void KisColorSmudgeStrategy::setPreparedMask(KisFixedPaintDeviceSP maskDab)
+{
+    Q_UNUSED(maskDab);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "the strategy doesn't support prepared masks");
+}
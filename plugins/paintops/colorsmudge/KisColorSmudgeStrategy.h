@@ -26,6 +26,20 @@ public:
                             QRect *dstDabRect,
                             qreal lightnessStrength) = 0;
 
+    /**
+     * Returns true if the strategy can paint a dab with a mask generated
+     * in advance by KisColorSmudgeDabPipeline, instead of the one it
+     * generates itself in updateMask()
+     */
+    virtual bool supportsPreparedMasks() const;
+
+    /**
+     * Sets the mask for the next paintDab() call. Should be called
+     * instead of updateMask() and only when supportsPreparedMasks()
+     * returns true
+     */
+    virtual void setPreparedMask(KisFixedPaintDeviceSP maskDab);
+
     virtual QVector<QRect> paintDab(const QRect &srcRect, const QRect &dstRect,
                                     const KoColor &currentPaintColor,
                                     qreal opacity,
@@ -11,6 +11,23 @@
 #include "kis_fixed_paint_device.h"
 #include "kis_paint_device.h"
 #include "KisColorSmudgeSampleUtils.h"
+#include "kis_image_config.h"
+#include "krita_utils.h"
+
+
+namespace {
+
+/**
+ * Returns the pointer to the first pixel of the \p stripeRect
+ * in a buffer that has \p dstRect layout
+ */
+inline quint8* stripePointer(quint8 *data, int pixelSize, const QRect &dstRect, const QRect &stripeRect)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(stripeRect.width() == dstRect.width());
+    return data + (stripeRect.y() - dstRect.y()) * dstRect.width() * pixelSize;
+}
+
+}
 
 /**********************************************************************************/
 /*                 DabColoringStrategyMask                                        */
@@ -22,7 +39,7 @@ bool KisColorSmudgeStrategyBase::DabColoringStrategyMask::supportsFusedDullingBl
 }
 
 void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInFusedBackgroundAndColorRateWithDulling(
-        KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &dstRect,
+        KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &dstRect, const QRect &stripeRect,
         const KoColor &preparedDullingColor, const KoCompositeOp *smearOp, const quint8 smudgeRateOpacity,
         const KoColor &paintColor, const KoCompositeOp *colorRateOp, const quint8 colorRateOpacity) const
 {
@@ -32,13 +49,15 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInFusedBackground
     colorRateOp->composite(dullingFillColor.data(), 1, paintColor.data(), 1, 0, 0, 1, 1, colorRateOpacity);
 
     if (smearOp->id() == COMPOSITE_COPY && smudgeRateOpacity == OPACITY_OPAQUE_U8) {
-        dst->fill(dst->bounds(), dullingFillColor);
+        dst->fill(stripeRect, dullingFillColor);
     } else {
-        src->readBytes(dst->data(), dstRect);
-        smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
+        quint8 *dstPtr = stripePointer(dst->data(), dst->pixelSize(), dstRect, stripeRect);
+
+        src->readBytes(dstPtr, stripeRect);
+        smearOp->composite(dstPtr, stripeRect.width() * dst->pixelSize(),
                            dullingFillColor.data(), 0,
                            0, 0,
-                           1, dstRect.width() * dstRect.height(),
+                           1, stripeRect.width() * stripeRect.height(),
                            smudgeRateOpacity);
     }
 }
@@ -47,14 +66,16 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInColorRate(const
                                                                            const KoCompositeOp *colorRateOp,
                                                                            quint8 colorRateOpacity,
                                                                            KisFixedPaintDeviceSP dstDevice,
-                                                                           const QRect &dstRect) const
+                                                                           const QRect &dstRect,
+                                                                           const QRect &stripeRect) const
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(*paintColor.colorSpace() == *colorRateOp->colorSpace());
 
-    colorRateOp->composite(dstDevice->data(), dstRect.width() * dstDevice->pixelSize(),
+    colorRateOp->composite(stripePointer(dstDevice->data(), dstDevice->pixelSize(), dstRect, stripeRect),
+                           stripeRect.width() * dstDevice->pixelSize(),
                            paintColor.data(), 0,
                            0, 0,
-                           dstRect.height(), dstRect.width(),
+                           stripeRect.height(), stripeRect.width(),
                            colorRateOpacity);
 }
 
@@ -71,17 +92,20 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyStamp::blendInColorRate(cons
                                                                             const KoCompositeOp *colorRateOp,
                                                                             quint8 colorRateOpacity,
                                                                             KisFixedPaintDeviceSP dstDevice,
-                                                                            const QRect &dstRect) const
+                                                                            const QRect &dstRect,
+                                                                            const QRect &stripeRect) const
 {
     Q_UNUSED(paintColor);
 
     // TODO: check correctness for composition source device (transparency masks)
     KIS_ASSERT_RECOVER_RETURN(*dstDevice->colorSpace() == *m_origDab->colorSpace());
 
-    colorRateOp->composite(dstDevice->data(), dstRect.width() * dstDevice->pixelSize(),
-                           m_origDab->data(), dstRect.width() * m_origDab->pixelSize(),
+    colorRateOp->composite(stripePointer(dstDevice->data(), dstDevice->pixelSize(), dstRect, stripeRect),
+                           stripeRect.width() * dstDevice->pixelSize(),
+                           stripePointer(m_origDab->data(), m_origDab->pixelSize(), dstRect, stripeRect),
+                           stripeRect.width() * m_origDab->pixelSize(),
                            0, 0,
-                           dstRect.height(), dstRect.width(),
+                           stripeRect.height(), stripeRect.width(),
                            colorRateOpacity);
 }
 
@@ -91,13 +115,14 @@ bool KisColorSmudgeStrategyBase::DabColoringStrategyStamp::supportsFusedDullingB
 }
 
 void KisColorSmudgeStrategyBase::DabColoringStrategyStamp::blendInFusedBackgroundAndColorRateWithDulling(
-        KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &dstRect,
+        KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &dstRect, const QRect &stripeRect,
         const KoColor &preparedDullingColor, const KoCompositeOp *smearOp, const quint8 smudgeRateOpacity,
         const KoColor &paintColor, const KoCompositeOp *colorRateOp, const quint8 colorRateOpacity) const
 {
     Q_UNUSED(dst);
     Q_UNUSED(src);
     Q_UNUSED(dstRect);
+    Q_UNUSED(stripeRect);
     Q_UNUSED(preparedDullingColor);
     Q_UNUSED(smearOp);
     Q_UNUSED(smudgeRateOpacity);
@@ -206,44 +231,62 @@ KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters,
     DabColoringStrategy &coloringStrategy = this->coloringStrategy();
 
     const quint8 dullingRateOpacity = this->dullingRateOpacity(opacity, smudgeRateValue);
+    const quint8 smudgeRateOpacity = this->smearRateOpacity(opacity, smudgeRateValue);
+    const KoColor preparedPaintColor = currentPaintColor.convertedTo(m_preparedDullingColor.colorSpace());
 
-    if (colorRateOpacity > 0 &&
+    const bool useFusedBlending =
+        colorRateOpacity > 0 &&
         m_useDullingMode &&
         coloringStrategy.supportsFusedDullingBlending() &&
         ((m_smearOp->id() == COMPOSITE_OVER &&
           m_colorRateOp->id() == COMPOSITE_OVER) ||
          (m_smearOp->id() == COMPOSITE_COPY &&
-          dullingRateOpacity == OPACITY_OPAQUE_U8))) {
-
-        coloringStrategy.blendInFusedBackgroundAndColorRateWithDulling(m_blendDevice,
-                                                                       srcSampleDevice,
-                                                                       dstRect,
-                                                                       m_preparedDullingColor,
-                                                                       m_smearOp,
-                                                                       dullingRateOpacity,
-                                                                       currentPaintColor.convertedTo(
-                                                                               m_preparedDullingColor.colorSpace()),
-                                                                       m_colorRateOp,
-                                                                       colorRateOpacity);
-
-    } else {
-        if (!m_useDullingMode) {
-            const quint8 smudgeRateOpacity = this->smearRateOpacity(opacity, smudgeRateValue);
-            blendInBackgroundWithSmearing(m_blendDevice, srcSampleDevice,
-                                          srcRect, dstRect, smudgeRateOpacity);
+          dullingRateOpacity == OPACITY_OPAQUE_U8));
+
+    /**
+     * All the blending steps below are pixel-local, so big dabs can be
+     * processed in stripes in parallel. Writing the result into the
+     * final painters stays sequential.
+     */
+    auto blendStripe = [&] (const QRect &stripeRect) {
+        if (useFusedBlending) {
+            coloringStrategy.blendInFusedBackgroundAndColorRateWithDulling(m_blendDevice,
+                                                                           srcSampleDevice,
+                                                                           dstRect,
+                                                                           stripeRect,
+                                                                           m_preparedDullingColor,
+                                                                           m_smearOp,
+                                                                           dullingRateOpacity,
+                                                                           preparedPaintColor,
+                                                                           m_colorRateOp,
+                                                                           colorRateOpacity);
         } else {
-            blendInBackgroundWithDulling(m_blendDevice, srcSampleDevice,
-                                         dstRect,
-                                         m_preparedDullingColor, dullingRateOpacity);
+            if (!m_useDullingMode) {
+                blendInBackgroundWithSmearing(m_blendDevice, srcSampleDevice,
+                                              srcRect, dstRect, stripeRect,
+                                              smudgeRateOpacity);
+            } else {
+                blendInBackgroundWithDulling(m_blendDevice, srcSampleDevice,
+                                             dstRect, stripeRect,
+                                             m_preparedDullingColor, dullingRateOpacity);
+            }
+
+            if (colorRateOpacity > 0) {
+                coloringStrategy.blendInColorRate(
+                        preparedPaintColor,
+                        m_colorRateOp,
+                        colorRateOpacity,
+                        m_blendDevice, dstRect, stripeRect);
+            }
         }
+    };
 
-        if (colorRateOpacity > 0) {
-            coloringStrategy.blendInColorRate(
-                    currentPaintColor.convertedTo(m_preparedDullingColor.colorSpace()),
-                    m_colorRateOp,
-                    colorRateOpacity,
-                    m_blendDevice, dstRect);
-        }
+    QVector<QRect> stripes = splitDabIntoStripes(dstRect);
+
+    if (stripes.size() > 1) {
+        KritaUtils::parallelMap(stripes, blendStripe);
+    } else {
+        blendStripe(dstRect);
     }
 
     const bool preserveDab = preserveMaskDab && dstPainters.size() > 1;
@@ -263,40 +306,69 @@ KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters,
 
 void KisColorSmudgeStrategyBase::blendInBackgroundWithSmearing(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src,
                                                                const QRect &srcRect, const QRect &dstRect,
+                                                               const QRect &stripeRect,
                                                                const quint8 smudgeRateOpacity)
 {
+    const QRect srcStripeRect = stripeRect.translated(srcRect.topLeft() - dstRect.topLeft());
+    quint8 *dstPtr = stripePointer(dst->data(), dst->pixelSize(), dstRect, stripeRect);
+
     if (m_smearOp->id() == COMPOSITE_COPY && smudgeRateOpacity == OPACITY_OPAQUE_U8) {
-        src->readBytes(dst->data(), srcRect);
+        src->readBytes(dstPtr, srcStripeRect);
     } else {
-        src->readBytes(dst->data(), dstRect);
+        src->readBytes(dstPtr, stripeRect);
 
         KisFixedPaintDevice tempDevice(src->colorSpace(), m_memoryAllocator);
-        tempDevice.setRect(srcRect);
+        tempDevice.setRect(srcStripeRect);
         tempDevice.lazyGrowBufferWithoutInitialization();
 
-        src->readBytes(tempDevice.data(), srcRect);
-        m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
-                             tempDevice.data(), dstRect.width() * tempDevice.pixelSize(), // stride should be random non-zero
+        src->readBytes(tempDevice.data(), srcStripeRect);
+        m_smearOp->composite(dstPtr, stripeRect.width() * dst->pixelSize(),
+                             tempDevice.data(), stripeRect.width() * tempDevice.pixelSize(), // stride should be random non-zero
                              0, 0,
-                             1, dstRect.width() * dstRect.height(),
+                             1, stripeRect.width() * stripeRect.height(),
                              smudgeRateOpacity);
     }
 }
 
 void KisColorSmudgeStrategyBase::blendInBackgroundWithDulling(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src,
-                                                              const QRect &dstRect, const KoColor &preparedDullingColor,
+                                                              const QRect &dstRect, const QRect &stripeRect,
+                                                              const KoColor &preparedDullingColor,
                                                               const quint8 smudgeRateOpacity)
 {
     Q_UNUSED(preparedDullingColor);
 
     if (m_smearOp->id() == COMPOSITE_COPY && smudgeRateOpacity == OPACITY_OPAQUE_U8) {
-        dst->fill(dst->bounds(), m_preparedDullingColor);
+        dst->fill(stripeRect, m_preparedDullingColor);
     } else {
-        src->readBytes(dst->data(), dstRect);
-        m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
+        quint8 *dstPtr = stripePointer(dst->data(), dst->pixelSize(), dstRect, stripeRect);
+
+        src->readBytes(dstPtr, stripeRect);
+        m_smearOp->composite(dstPtr, stripeRect.width() * dst->pixelSize(),
                              m_preparedDullingColor.data(), 0,
                              0, 0,
-                             1, dstRect.width() * dstRect.height(),
+                             1, stripeRect.width() * stripeRect.height(),
                              smudgeRateOpacity);
     }
 }
+
+QVector<QRect> KisColorSmudgeStrategyBase::splitDabIntoStripes(const QRect &dstRect)
+{
+    const int minParallelDabArea = 128 * 128;
+    const int minStripeHeight = 16;
+
+    const int numThreads = KisImageConfig(true).maxNumberOfThreads();
+
+    if (numThreads <= 1 || dstRect.width() * dstRect.height() < minParallelDabArea) {
+        return {dstRect};
+    }
+
+    const int stripeHeight = qMax(minStripeHeight, (dstRect.height() + numThreads - 1) / numThreads);
+
+    QVector<QRect> stripes;
+    for (int y = dstRect.top(); y <= dstRect.bottom(); y += stripeHeight) {
+        stripes << QRect(dstRect.left(), y,
+                         dstRect.width(), qMin(stripeHeight, dstRect.bottom() - y + 1));
+    }
+
+    return stripes;
+}
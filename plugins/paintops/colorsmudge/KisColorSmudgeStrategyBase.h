@@ -23,9 +23,11 @@ public:
         virtual ~DabColoringStrategy() = default;
         virtual bool supportsFusedDullingBlending() const = 0;
         virtual void blendInColorRate(const KoColor &paintColor, const KoCompositeOp *colorRateOp, quint8 colorRateOpacity,
-                                      KisFixedPaintDeviceSP dstDevice, const QRect &dstRect) const = 0;
+                                      KisFixedPaintDeviceSP dstDevice, const QRect &dstRect,
+                                      const QRect &stripeRect) const = 0;
         virtual void blendInFusedBackgroundAndColorRateWithDulling(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src,
                                                                    const QRect &dstRect,
+                                                                   const QRect &stripeRect,
                                                                    const KoColor &preparedDullingColor,
                                                                    const KoCompositeOp *smearOp,
                                                                    const quint8 smudgeRateOpacity,
@@ -39,11 +41,13 @@ public:
         bool supportsFusedDullingBlending() const override;
 
         void blendInColorRate(const KoColor &paintColor, const KoCompositeOp *colorRateOp, quint8 colorRateOpacity,
-                              KisFixedPaintDeviceSP dstDevice, const QRect &dstRect) const override;
+                              KisFixedPaintDeviceSP dstDevice, const QRect &dstRect,
+                              const QRect &stripeRect) const override;
 
         void blendInFusedBackgroundAndColorRateWithDulling(KisFixedPaintDeviceSP dst,
                                                            KisColorSmudgeSourceSP src,
                                                            const QRect &dstRect,
+                                                           const QRect &stripeRect,
                                                            const KoColor &preparedDullingColor,
                                                            const KoCompositeOp *smearOp,
                                                            const quint8 smudgeRateOpacity,
@@ -57,13 +61,15 @@ public:
         void setStampDab(KisFixedPaintDeviceSP device);
 
         void blendInColorRate(const KoColor &paintColor, const KoCompositeOp *colorRateOp, quint8 colorRateOpacity,
-                              KisFixedPaintDeviceSP dstDevice, const QRect &dstRect) const override;
+                              KisFixedPaintDeviceSP dstDevice, const QRect &dstRect,
+                              const QRect &stripeRect) const override;
 
         bool supportsFusedDullingBlending() const override;
 
         void blendInFusedBackgroundAndColorRateWithDulling(KisFixedPaintDeviceSP dst,
                                                            KisColorSmudgeSourceSP src,
                                                            const QRect &dstRect,
+                                                           const QRect &stripeRect,
                                                            const KoColor &preparedDullingColor,
                                                            const KoCompositeOp *smearOp,
                                                            const quint8 smudgeRateOpacity,
@@ -109,10 +115,18 @@ public:
                     qreal maxPossibleSmudgeRateValue, qreal colorRateValue, qreal smudgeRadiusValue);
 
     void blendInBackgroundWithSmearing(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &srcRect,
-                                       const QRect &dstRect, const quint8 smudgeRateOpacity);
+                                       const QRect &dstRect, const QRect &stripeRect, const quint8 smudgeRateOpacity);
 
     void blendInBackgroundWithDulling(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &dstRect,
-                                      const KoColor &preparedDullingColor, const quint8 smudgeRateOpacity);
+                                      const QRect &stripeRect, const KoColor &preparedDullingColor,
+                                      const quint8 smudgeRateOpacity);
+
+    /**
+     * Splits \p dstRect into full-width horizontal stripes that can be
+     * blended independently. Small dabs are never split, because the
+     * threading overhead would eat all the benefit.
+     */
+    static QVector<QRect> splitDabIntoStripes(const QRect &dstRect);
 
 protected:
     const KoCompositeOp * m_colorRateOp {nullptr};
@@ -37,3 +37,19 @@ void KisColorSmudgeStrategyMask::updateMask(KisDabCache *dabCache, const KisPain
 
     m_shouldPreserveMaskDab = !dabCache->needSeparateOriginal();
 }
+
+bool KisColorSmudgeStrategyMask::supportsPreparedMasks() const
+{
+    return true;
+}
+
+void KisColorSmudgeStrategyMask::setPreparedMask(KisFixedPaintDeviceSP maskDab)
+{
+    m_maskDab = maskDab;
+
+    /**
+     * Prepared masks may be shared between several dabs, so
+     * they should never be modified in-place
+     */
+    m_shouldPreserveMaskDab = true;
+}
@@ -27,6 +27,9 @@ public:
                     QRect *dstDabRect, 
                     qreal lightnessStrength) override;
 
+    bool supportsPreparedMasks() const override;
+    void setPreparedMask(KisFixedPaintDeviceSP maskDab) override;
+
 private:
     DabColoringStrategyMask m_coloringStrategy;
 };
@@ -22,6 +22,7 @@
 #include "KisInterstrokeDataFactory.h"
 
 #include "kis_brush_option.h"
+#include "kis_texture_option.h"
 
 #include "KisColorSmudgeInterstrokeData.h"
 #include "KisColorSmudgeStrategyLightness.h"
@@ -29,6 +30,7 @@
 #include "KisColorSmudgeStrategyMask.h"
 #include "KisColorSmudgeStrategyStamp.h"
 #include "KisColorSmudgeStrategyMaskLegacy.h"
+#include "KisColorSmudgeDabPipeline.h"
 
 struct ColorSmudgeInterstrokeDataFactory : public KisInterstrokeDataFactory
 {
@@ -113,6 +115,35 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
     m_strategy->initializePainting();
     m_paintColor = painter->paintColor().convertedTo(m_strategy->preciseColorSpace());
 
+    /**
+     * Pipe brushes change their state with every dab, so their masks
+     * cannot be generated out of order
+     */
+    if (m_strategy->supportsPreparedMasks() &&
+        (m_brush->brushType() == MASK || m_brush->brushType() == IMAGE)) {
+
+        m_brush->notifyBrushIsGoingToBeClonedForStroke();
+
+        KisBrushSP baseBrush = m_brush;
+        auto resourcesFactory =
+            [baseBrush, settings, painter] () {
+                KisDabCacheUtils::DabRenderingResources *resources =
+                    new KisDabCacheUtils::DabRenderingResources();
+                resources->brush = baseBrush->clone().dynamicCast<KisBrush>();
+                resources->textureOption.reset(
+                    new KisTextureOption(settings.data(),
+                                         settings->resourcesInterface(),
+                                         settings->canvasResourcesInterface(),
+                                         painter->device()->defaultBounds()->currentLevelOfDetail()));
+
+                return resources;
+            };
+
+        m_dabPipeline.reset(new KisColorSmudgeDabPipeline(resourcesFactory));
+        m_dabPipeline->setPrecisionOption(&m_precisionOption);
+        m_dabPipeline->setMirrorPostprocessing(&m_mirrorOption);
+    }
+
     m_hsvOptions.append(KisHSVOption::createHueOption(settings.data()));
     m_hsvOptions.append(KisHSVOption::createSaturationOption(settings.data()));
     m_hsvOptions.append(KisHSVOption::createValueOption(settings.data()));
@@ -124,6 +155,27 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
             m_hsvTransform = m_paintColor.colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>());
         }
     }
+
+    /**
+     * The line can be painted in batches only when the spacing and timing
+     * are the same for all the dabs of the line and their calculation
+     * doesn't consume random values (updateSpacingImpl() evaluates the
+     * rotation)
+     */
+    using KisPaintOpPluginUtils::isStaticOption;
+
+    m_supportsBatchedPainting =
+        isStaticOption(m_sizeOption) &&
+        isStaticOption(m_spacingOption) &&
+        isStaticOption(m_rateOption) &&
+        (m_spacingOption.isotropicSpacing() ||
+         (isStaticOption(m_rotationOption) && isStaticOption(m_mirrorOption))) &&
+        !m_mirrorOption.isRandom() &&
+        !m_rotationOption.isRandom() &&
+        m_brush->brushType() != PIPE_MASK &&
+        m_brush->brushType() != PIPE_IMAGE &&
+        !checkSizeTooSmall(m_sizeOption.apply(KisPaintInformation()) *
+                           KisLodTransform::lodToScale(painter->device()));
 }
 
 KisColorSmudgeOp::~KisColorSmudgeOp()
@@ -152,6 +204,10 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
         * and you only notice the lack of subpixel precision in the dulling methods.
         */
         m_dabCache->disableSubpixelPrecision();
+
+        if (m_dabPipeline) {
+            m_dabPipeline->disableSubpixelPrecision();
+        }
     }
 
     // get the scaling factor calculated by the size option
@@ -177,10 +233,155 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_strategy, spacingInfo);
 
+    DabRequest request;
+    request.info = info;
+    request.shape = shape;
+    request.cursorPoint = scatteredPos;
+    request.smudgeRadiusPortion = smudgeRadiusPortion;
+    request.paintThickness = m_paintThicknessOption.apply(info);
+
+    // the first dab is not painted, see processDabRequest()
+    if (!m_firstRun) {
+        request.colorRate = m_colorRateOption.isChecked() ? m_colorRateOption.computeSizeLikeValue(info) : 0.0;
+        request.smudgeRate = m_smudgeRateOption.isChecked() ? m_smudgeRateOption.computeSizeLikeValue(info) : 1.0;
+        request.maxSmudgeRate = m_smudgeRateOption.strengthValue();
+        request.opacity = m_opacityOption.apply(info);
+    }
+
+    processDabRequest(request);
+
+    return spacingInfo;
+}
+
+void KisColorSmudgeOp::processDabRequest(DabRequest &request)
+{
+    /**
+     * The first dab of the stroke only defines the position the next
+     * dab will smudge from, so the options of the paint are neither
+     * evaluated nor consume any random values for it
+     */
+    request.isFirstDab = m_firstRun;
+    m_firstRun = false;
+
+    if (!request.isFirstDab) {
+        request.paintColor = m_paintColor;
+
+        m_gradientOption.apply(request.paintColor, m_gradient, request.info);
+        if (m_hsvTransform) {
+            Q_FOREACH (KisHSVOption *option, m_hsvOptions) {
+                option->apply(m_hsvTransform, request.info);
+            }
+            m_hsvTransform->transform(request.paintColor.data(), request.paintColor.data(), 1);
+        }
+    }
+
+    if (m_collectDabs) {
+        m_pendingDabs.append(request);
+    } else {
+        m_strategy->updateMask(m_dabCache, request.info, request.shape, request.cursorPoint, &m_dstDabRect, request.paintThickness);
+        paintDab(request);
+    }
+}
+
+void KisColorSmudgeOp::paintAtBatch(const QVector<KisPaintInformation> &infos)
+{
+    KisBrushSP brush = m_brush;
+
+    if (!painter()->device() || !brush) return;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_strategy);
+
+    if (m_smudgeRateOption.mode() == KisSmudgeLengthOptionData::SMEARING_MODE) {
+        // see a comment in paintAt()
+        m_dabCache->disableSubpixelPrecision();
+
+        if (m_dabPipeline) {
+            m_dabPipeline->disableSubpixelPrecision();
+        }
+    }
+
+    const int numDabs = infos.size();
+
+    // the size is static, see m_supportsBatchedPainting
+    const qreal scale =
+        m_sizeOption.apply(infos.first()) * KisLodTransform::lodToScale(painter()->device());
+
+    /**
+     * The options that use random sources are still calculated dab-by-dab
+     * to keep the sequence of the random values the same as in paintAt()
+     */
+    auto computeBatch = [&infos, numDabs] (const KisCurveOption &option, qreal defaultValue, std::vector<qreal> &values) {
+        values.resize(numDabs);
+
+        if (!option.isChecked()) {
+            std::fill(values.begin(), values.end(), defaultValue);
+        } else if (!option.isRandom()) {
+            option.computeSizeLikeValues(infos, values.data());
+        } else {
+            return false;
+        }
+        return true;
+    };
+
+    std::vector<qreal> rotations(numDabs);
+    std::vector<qreal> ratios;
+    std::vector<qreal> paintThicknesses;
+    std::vector<qreal> smudgeRadiuses;
+    std::vector<qreal> colorRates;
+    std::vector<qreal> smudgeRates;
+    std::vector<qreal> opacities;
+
+    const bool batchedRotation = !m_rotationOption.isRandom();
+    if (batchedRotation) {
+        m_rotationOption.apply(infos, rotations.data());
+    }
+
+    const bool batchedRatio = computeBatch(m_ratioOption, 1.0, ratios);
+    const bool batchedPaintThickness = computeBatch(m_paintThicknessOption, 1.0, paintThicknesses);
+    const bool batchedSmudgeRadius = computeBatch(m_smudgeRadiusOption, 0.0, smudgeRadiuses);
+    const bool batchedColorRate = computeBatch(m_colorRateOption, 0.0, colorRates);
+    const bool batchedSmudgeRate = computeBatch(m_smudgeRateOption, 1.0, smudgeRates);
+    const bool batchedOpacity = computeBatch(m_opacityOption, 1.0, opacities);
+
+    for (int i = 0; i < numDabs; i++) {
+        const KisPaintInformation &info = infos[i];
 
-    const qreal paintThickness = m_paintThicknessOption.apply(info);
-    m_strategy->updateMask(m_dabCache, info, shape, scatteredPos, &m_dstDabRect, paintThickness);
+        if (!brush->canPaintFor(info)) continue;
 
+        const qreal rotation = batchedRotation ? rotations[i] : m_rotationOption.apply(info);
+        const qreal ratio = batchedRatio ? ratios[i] : m_ratioOption.apply(info);
+
+        KisDabShape shape(scale, ratio, rotation);
+
+        DabRequest request;
+        request.info = info;
+        request.shape = shape;
+        request.cursorPoint =
+            m_scatterOption.apply(info,
+                                  brush->maskWidth(shape, 0, 0, info),
+                                  brush->maskHeight(shape, 0, 0, info));
+        request.smudgeRadiusPortion = batchedSmudgeRadius ? smudgeRadiuses[i] : m_smudgeRadiusOption.computeSizeLikeValue(info);
+
+        request.paintThickness = batchedPaintThickness ? paintThicknesses[i] : m_paintThicknessOption.apply(info);
+
+        // the first dab is not painted, see processDabRequest()
+        if (!m_firstRun) {
+            request.colorRate = batchedColorRate ? colorRates[i] : m_colorRateOption.computeSizeLikeValue(info);
+            request.smudgeRate = batchedSmudgeRate ? smudgeRates[i] : m_smudgeRateOption.computeSizeLikeValue(info);
+            request.maxSmudgeRate = m_smudgeRateOption.strengthValue();
+            request.opacity = batchedOpacity ? opacities[i] : m_opacityOption.apply(info);
+        }
+
+        processDabRequest(request);
+    }
+}
+
+bool KisColorSmudgeOp::supportsBatchedPainting() const
+{
+    return m_supportsBatchedPainting;
+}
+
+void KisColorSmudgeOp::paintDab(const DabRequest &request)
+{
     QPointF newCenterPos = QRectF(m_dstDabRect).center();
     /**
      * Save the center of the current dab to know where to read the
@@ -193,38 +394,70 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     m_lastPaintPos = newCenterPos;
 
-    if (m_firstRun) {
-        m_firstRun = false;
-        return spacingInfo;
+    if (request.isFirstDab) return;
+
+    const QVector<QRect> dirtyRects =
+            m_strategy->paintDab(srcDabRect, m_dstDabRect,
+                                 request.paintColor,
+                                 request.opacity, request.colorRate,
+                                 request.smudgeRate,
+                                 request.maxSmudgeRate,
+                                 request.paintThickness,
+                                 request.smudgeRadiusPortion);
+
+    painter()->addDirtyRects(dirtyRects);
+}
+
+void KisColorSmudgeOp::paintPendingDabs()
+{
+    if (m_pendingDabs.isEmpty()) return;
+
+    QVector<KisColorSmudgeDabPipeline::Request> maskRequests;
+    maskRequests.reserve(m_pendingDabs.size());
+
+    Q_FOREACH (const DabRequest &dab, m_pendingDabs) {
+        KisColorSmudgeDabPipeline::Request request;
+        request.info = dab.info;
+        request.shape = dab.shape;
+        request.cursorPoint = dab.cursorPoint;
+        request.lightnessStrength = dab.paintThickness;
+        maskRequests << request;
     }
 
-    const qreal colorRate = m_colorRateOption.isChecked() ? m_colorRateOption.computeSizeLikeValue(info) : 0.0;
-    const qreal smudgeRate = m_smudgeRateOption.isChecked() ? m_smudgeRateOption.computeSizeLikeValue(info) : 1.0;
-    const qreal maxSmudgeRate = m_smudgeRateOption.strengthValue();
-    const qreal fpOpacity = m_opacityOption.apply(info);
+    const QVector<KisColorSmudgeDabPipeline::PreparedMask> masks =
+        m_dabPipeline->prepareMasks(maskRequests);
 
-    KoColor paintColor = m_paintColor;
+    KIS_SAFE_ASSERT_RECOVER(masks.size() == m_pendingDabs.size()) {
+        m_pendingDabs.clear();
+        return;
+    }
 
-    m_gradientOption.apply(paintColor, m_gradient, info);
-    if (m_hsvTransform) {
-        Q_FOREACH (KisHSVOption *option, m_hsvOptions) {
-            option->apply(m_hsvTransform, info);
-        }
-        m_hsvTransform->transform(paintColor.data(), paintColor.data(), 1);
+    for (int i = 0; i < m_pendingDabs.size(); i++) {
+        m_strategy->setPreparedMask(masks[i].mask);
+        m_dstDabRect = masks[i].dstDabRect;
+        paintDab(m_pendingDabs[i]);
     }
 
-    const QVector<QRect> dirtyRects =
-            m_strategy->paintDab(srcDabRect, m_dstDabRect,
-                                 paintColor,
-                                 fpOpacity, colorRate,
-                                 smudgeRate,
-                                 maxSmudgeRate,
-                                 paintThickness,
-                                 smudgeRadiusPortion);
+    m_pendingDabs.clear();
+}
 
-    painter()->addDirtyRects(dirtyRects);
+void KisColorSmudgeOp::paintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, KisDistanceInformation *currentDistance)
+{
+    if (!m_dabPipeline) {
+        KisBrushBasedPaintOp::paintLine(pi1, pi2, currentDistance);
+        return;
+    }
 
-    return spacingInfo;
+    /**
+     * Only sampling and blending of the dabs must be done sequentially,
+     * so we first collect all the dabs of the line and then generate
+     * their masks in parallel
+     */
+    m_collectDabs = true;
+    KisBrushBasedPaintOp::paintLine(pi1, pi2, currentDistance);
+    m_collectDabs = false;
+
+    paintPendingDabs();
 }
 
 KisSpacingInformation KisColorSmudgeOp::updateSpacingImpl(const KisPaintInformation &info) const
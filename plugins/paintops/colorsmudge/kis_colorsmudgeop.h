@@ -14,6 +14,7 @@
 
 #include <kis_brush_based_paintop.h>
 #include <kis_types.h>
+#include <kis_paint_information.h>
 
 #include "KisOverlayPaintDeviceWrapper.h"
 #include <KisOpacityOption.h>
@@ -37,6 +38,7 @@ class KoColorSpace;
 class KisInterstrokeDataFactory;
 
 class KisColorSmudgeStrategy;
+class KisColorSmudgeDabPipeline;
 
 class KisColorSmudgeOp: public KisBrushBasedPaintOp
 {
@@ -46,12 +48,43 @@ public:
 
     static KisInterstrokeDataFactory* createInterstrokeDataFactory(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    void paintLine(const KisPaintInformation &pi1,
+                   const KisPaintInformation &pi2,
+                   KisDistanceInformation *currentDistance) override;
+
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
+    void paintAtBatch(const QVector<KisPaintInformation> &infos) override;
+    bool supportsBatchedPainting() const override;
+
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
 
+private:
+    /**
+     * All the parameters of a dab, calculated from its paint information,
+     * the dab is painted either immediately or after all the dabs of the
+     * current line have been collected (see m_collectDabs)
+     */
+    struct DabRequest {
+        KisPaintInformation info;
+        KisDabShape shape;
+        QPointF cursorPoint;
+        KoColor paintColor;
+        qreal opacity = 1.0;
+        qreal colorRate = 0.0;
+        qreal smudgeRate = 1.0;
+        qreal maxSmudgeRate = 1.0;
+        qreal paintThickness = 1.0;
+        qreal smudgeRadiusPortion = 0.0;
+        bool isFirstDab = false;
+    };
+
+    void paintDab(const DabRequest &request);
+    void processDabRequest(DabRequest &request);
+    void paintPendingDabs();
+
 private:
     bool                      m_firstRun;
 
@@ -79,6 +112,11 @@ private:
 
     KoColorTransformation *m_hsvTransform {0};
     QScopedPointer<KisColorSmudgeStrategy> m_strategy;
+
+    QScopedPointer<KisColorSmudgeDabPipeline> m_dabPipeline;
+    QVector<DabRequest> m_pendingDabs;
+    bool m_collectDabs {false};
+    bool m_supportsBatchedPainting {false};
 };
 
 #endif // _KIS_COLORSMUDGEOP_H_
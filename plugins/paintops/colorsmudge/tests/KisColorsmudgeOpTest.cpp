@@ -15,6 +15,10 @@
 #include <brushengine/kis_paintop_preset.h>
 #include <brushengine/kis_paintop_settings.h>
 #include <KoCanvasResourcesIds.h>
+#include <brushengine/kis_paintop.h>
+#include <brushengine/kis_random_source.h>
+#include <KisStandardOptionData.h>
+#include <KisSpacingOptionData.h>
 
 class TestColorsmudgeOp : public TestUtil::QImageBasedTest
 {
@@ -108,6 +112,65 @@ public:
         }
     }
 
+    /**
+     * Paints a few lines with a fuzzy dab rotation and isotropic spacing,
+     * with the batched painting of the lines enabled or disabled
+     */
+    KisPaintDeviceSP paintWithFuzzyRotation(const QString &presetFileName, bool batched) {
+        KisSurrogateUndoStore *undoStore = new KisSurrogateUndoStore();
+        KisImageSP image = createTrivialImage(undoStore);
+        image->initialRefreshGraph();
+
+        KisNodeSP paint1 = findNode(image->root(), "paint1");
+        KisPainter gc(paint1->paintDevice());
+
+        QScopedPointer<KoCanvasResourceProvider> manager(
+            utils::createResourceManager(image, 0, presetFileName));
+
+        KisPaintOpPresetSP preset =
+            manager->resource(KoCanvasResource::CurrentPaintOpPreset).value<KisPaintOpPresetSP>();
+
+        KisPaintOpSettingsSP settings = preset->settings()->clone();
+
+        KisRotationOptionData rotationData;
+        rotationData.read(settings.data());
+        rotationData.isChecked = true;
+        rotationData.useCurve = true;
+        rotationData.sensorStruct().sensorFuzzyPerDab.isActive = true;
+        rotationData.write(settings.data());
+
+        KisSpacingOptionData spacingData;
+        spacingData.read(settings.data());
+        spacingData.isotropicSpacing = true;
+        spacingData.write(settings.data());
+
+        preset->setSettings(settings);
+
+        KisResourcesSnapshotSP resources =
+            new KisResourcesSnapshot(image, paint1, manager.data());
+        resources->setupPainter(&gc);
+
+        gc.paintOp()->setBatchedPaintingEnabled(batched);
+
+        KisRandomSourceSP randomSource = new KisRandomSource(42);
+        KisDistanceInformation dist;
+
+        QVector<KisPaintInformation> points;
+        points << KisPaintInformation(QPointF(20, 20), 1.0);
+        points << KisPaintInformation(QPointF(180, 60), 0.8);
+        points << KisPaintInformation(QPointF(40, 180), 1.0);
+
+        for (KisPaintInformation &pi : points) {
+            pi.setRandomSource(randomSource);
+        }
+
+        for (int i = 1; i < points.size(); i++) {
+            gc.paintLine(points[i - 1], points[i], &dist);
+        }
+
+        return paint1->paintDevice();
+    }
+
     QString m_presetFileName;
     QString m_prefix;
 };
@@ -150,4 +213,26 @@ void KisColorsmudgeOpTest::test()
     t.test(testName, preset, overlay);
 }
 
+void KisColorsmudgeOpTest::testBatchedFuzzyRotation()
+{
+    /**
+     * Calculation of the spacing of a batch must not consume random
+     * values, otherwise the batched strokes will be different from the
+     * unbatched ones
+     */
+    const QString preset = "test_smudge_20px_dul_nsa_new.0001.kpp";
+
+    TestColorsmudgeOp t;
+    KisPaintDeviceSP batched = t.paintWithFuzzyRotation(preset, true);
+    KisPaintDeviceSP unbatched = t.paintWithFuzzyRotation(preset, false);
+
+    const QRect rc = batched->exactBounds() | unbatched->exactBounds();
+    QVERIFY(!rc.isEmpty());
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     unbatched->convertToQImage(0, rc),
+                                     batched->convertToQImage(0, rc)));
+}
+
 KISTEST_MAIN(KisColorsmudgeOpTest)
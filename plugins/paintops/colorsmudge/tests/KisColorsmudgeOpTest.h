@@ -16,6 +16,8 @@ private Q_SLOTS:
 
     void test();
     void test_data();
+
+    void testBatchedFuzzyRotation();
 };
 
 #endif // KISCOLORSMUDGEOPTEST_H
@@ -95,6 +95,28 @@ KisBrushOp::KisBrushOp(const KisPaintOpSettingsSP settings, KisPainter *painter,
                     painter->runnableStrokeJobsInterface(),
                     &m_mirrorOption,
                     &m_precisionOption));
+
+    /**
+     * The line can be painted in batches only when the spacing and timing
+     * are the same for all the dabs of the line and their calculation
+     * doesn't consume random values (updateSpacingImpl() evaluates the
+     * rotation). The dab size is also static, so we can check if it is
+     * too small right here.
+     */
+    using KisPaintOpPluginUtils::isStaticOption;
+
+    m_supportsBatchedPainting =
+        isStaticOption(m_sizeOption) &&
+        isStaticOption(m_spacingOption) &&
+        isStaticOption(m_rateOption) &&
+        (m_spacingOption.isotropicSpacing() ||
+         (isStaticOption(m_rotationOption) && isStaticOption(m_mirrorOption))) &&
+        !m_mirrorOption.isRandom() &&
+        !m_rotationOption.isRandom() &&
+        m_brush->brushType() != PIPE_MASK &&
+        m_brush->brushType() != PIPE_IMAGE &&
+        !checkSizeTooSmall(m_sizeOption.apply(KisPaintInformation()) *
+                           KisLodTransform::lodToScale(painter->device()));
 }
 
 KisBrushOp::~KisBrushOp()
@@ -150,6 +172,95 @@ KisSpacingInformation KisBrushOp::paintAt(const KisPaintInformation& info)
     return spacingInfo;
 }
 
+void KisBrushOp::paintAtBatch(const QVector<KisPaintInformation> &infos)
+{
+    if (!painter()->device()) return;
+
+    KisBrushSP brush = m_brush;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(brush);
+
+    const int numDabs = infos.size();
+
+    /**
+     * The size is static (see m_supportsBatchedPainting), so it can be
+     * calculated only once.
+     */
+    const qreal scale =
+        m_sizeOption.apply(infos.first()) * KisLodTransform::lodToScale(painter()->device());
+
+    /**
+     * The options that use random sources are still calculated dab-by-dab
+     * to keep the sequence of the random values the same as in paintAt()
+     */
+    const bool randomRotation = m_rotationOption.isRandom();
+    const bool randomRatio = m_ratioOption.isRandom();
+    const bool randomOpacity = m_opacityOption.isRandom();
+    const bool randomSoftness = m_softnessOption.isRandom();
+    const bool randomLightness = m_lightnessStrengthOption.isRandom();
+
+    std::vector<qreal> rotations(numDabs);
+    std::vector<qreal> ratios(numDabs);
+    std::vector<quint8> opacities(numDabs);
+    std::vector<quint8> flows(numDabs);
+    std::vector<qreal> softnessFactors(numDabs);
+    std::vector<qreal> lightnessStrengths(numDabs);
+
+    if (!randomRotation) m_rotationOption.apply(infos, rotations.data());
+    if (!randomRatio) m_ratioOption.apply(infos, ratios.data());
+    if (!randomOpacity) m_opacityOption.apply(infos, opacities.data(), flows.data());
+    if (!randomSoftness) m_softnessOption.apply(infos, softnessFactors.data());
+    if (!randomLightness) m_lightnessStrengthOption.apply(infos, lightnessStrengths.data());
+
+    const KoColor &paintColor = painter()->paintColor();
+    qreal spacing = -1.0;
+
+    for (int i = 0; i < numDabs; i++) {
+        const KisPaintInformation &info = infos[i];
+
+        if (!brush->canPaintFor(info)) continue;
+
+        const qreal rotation = randomRotation ? m_rotationOption.apply(info) : rotations[i];
+        const qreal ratio = randomRatio ? m_ratioOption.apply(info) : ratios[i];
+
+        KisDabShape shape(scale, ratio, rotation);
+        QPointF cursorPos =
+            m_scatterOption.apply(info,
+                                  brush->maskWidth(shape, 0, 0, info),
+                                  brush->maskHeight(shape, 0, 0, info));
+
+        quint8 dabOpacity = opacities[i];
+        quint8 dabFlow = flows[i];
+
+        if (randomOpacity) {
+            m_opacityOption.apply(info, &dabOpacity, &dabFlow);
+        }
+
+        const qreal softness = randomSoftness ? m_softnessOption.apply(info) : softnessFactors[i];
+        const qreal lightness = randomLightness ? m_lightnessStrengthOption.apply(info) : lightnessStrengths[i];
+
+        KisDabCacheUtils::DabRequestInfo request(paintColor,
+                                                 cursorPos,
+                                                 shape,
+                                                 info,
+                                                 softness,
+                                                 lightness);
+
+        m_dabExecutor->addDab(request, qreal(dabOpacity) / 255.0, qreal(dabFlow) / 255.0);
+
+        if (spacing < 0) {
+            spacing = effectiveSpacing(scale, rotation, &m_airbrushData, &m_spacingOption, info).scalarApprox();
+        }
+
+        // gather statistics about dabs
+        m_avgSpacing(spacing);
+    }
+}
+
+bool KisBrushOp::supportsBatchedPainting() const
+{
+    return m_supportsBatchedPainting;
+}
+
 struct KisBrushOp::UpdateSharedState
 {
     // rendering data
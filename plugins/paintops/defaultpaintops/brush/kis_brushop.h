@@ -46,6 +46,9 @@ public:
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
+    void paintAtBatch(const QVector<KisPaintInformation> &infos) override;
+    bool supportsBatchedPainting() const override;
+
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
 
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
@@ -88,6 +91,8 @@ private:
 
     const int m_minUpdatePeriod;
     const int m_maxUpdatePeriod;
+
+    bool m_supportsBatchedPainting {false};
 };
 
 #endif // KIS_BRUSHOP_H_
@@ -15,6 +15,9 @@
 #include <brushengine/kis_paintop_settings.h>
 #include <KisMirrorOptionData.h>
 #include <KisStandardOptionData.h>
+#include <KisSpacingOptionData.h>
+#include <brushengine/kis_paintop.h>
+#include <brushengine/kis_random_source.h>
 
 class TestBrushOp : public TestUtil::QImageBasedTest
 {
@@ -207,6 +210,73 @@ public:
     }
 };
 
+class TestBrushOpBatching : public TestUtil::QImageBasedTest
+{
+public:
+    TestBrushOpBatching()
+        : QImageBasedTest("brushop") {
+    }
+
+    /**
+     * Paints a few lines with a fuzzy dab rotation and isotropic spacing,
+     * with the batched painting of the lines enabled or disabled
+     */
+    KisPaintDeviceSP paint(const QString &presetFileName, bool batched) {
+        KisSurrogateUndoStore *undoStore = new KisSurrogateUndoStore();
+        KisImageSP image = createTrivialImage(undoStore);
+        image->initialRefreshGraph();
+
+        KisNodeSP paint1 = findNode(image->root(), "paint1");
+        KisPainter gc(paint1->paintDevice());
+
+        QScopedPointer<KoCanvasResourceProvider> manager(
+            utils::createResourceManager(image, 0, presetFileName));
+
+        KisPaintOpPresetSP preset =
+            manager->resource(KoCanvasResource::CurrentPaintOpPreset).value<KisPaintOpPresetSP>();
+
+        KisPaintOpSettingsSP settings = preset->settings()->clone();
+
+        KisRotationOptionData rotationData;
+        rotationData.read(settings.data());
+        rotationData.isChecked = true;
+        rotationData.useCurve = true;
+        rotationData.sensorStruct().sensorFuzzyPerDab.isActive = true;
+        rotationData.write(settings.data());
+
+        KisSpacingOptionData spacingData;
+        spacingData.read(settings.data());
+        spacingData.isotropicSpacing = true;
+        spacingData.write(settings.data());
+
+        preset->setSettings(settings);
+
+        KisResourcesSnapshotSP resources =
+            new KisResourcesSnapshot(image, paint1, manager.data());
+        resources->setupPainter(&gc);
+
+        gc.paintOp()->setBatchedPaintingEnabled(batched);
+
+        KisRandomSourceSP randomSource = new KisRandomSource(42);
+        KisDistanceInformation dist;
+
+        QVector<KisPaintInformation> points;
+        points << KisPaintInformation(QPointF(100, 100), 1.0);
+        points << KisPaintInformation(QPointF(200, 150), 0.8);
+        points << KisPaintInformation(QPointF(100, 350), 1.0);
+
+        for (KisPaintInformation &pi : points) {
+            pi.setRandomSource(randomSource);
+        }
+
+        for (int i = 1; i < points.size(); i++) {
+            gc.paintLine(points[i - 1], points[i], &dist);
+        }
+
+        return paint1->paintDevice();
+    }
+};
+
 #include <KoResourcePaths.h>
 void KisBrushOpTest::initTestCase()
 {
@@ -239,4 +309,24 @@ void KisBrushOpTest::testMagicSeven()
     t.test();
 }
 
+void KisBrushOpTest::testBatchedFuzzyRotation()
+{
+    /**
+     * Calculation of the spacing of a batch must not consume random
+     * values, otherwise the batched strokes will be different from the
+     * unbatched ones
+     */
+    TestBrushOpBatching t;
+    KisPaintDeviceSP batched = t.paint("LR_simple.kpp", true);
+    KisPaintDeviceSP unbatched = t.paint("LR_simple.kpp", false);
+
+    const QRect rc = batched->exactBounds() | unbatched->exactBounds();
+    QVERIFY(!rc.isEmpty());
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt,
+                                     unbatched->convertToQImage(0, rc),
+                                     batched->convertToQImage(0, rc)));
+}
+
 SIMPLE_TEST_MAIN(KisBrushOpTest)
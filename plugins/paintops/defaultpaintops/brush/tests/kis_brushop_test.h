@@ -18,6 +18,8 @@ private Q_SLOTS:
     void testRotationMirroring();
     void testRotationMirroringDrawingAngle();
     void testMagicSeven();
+
+    void testBatchedFuzzyRotation();
 };
 
 #endif /* __KIS_BRUSHOP_TEST_H */
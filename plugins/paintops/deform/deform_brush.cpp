@@ -11,15 +11,20 @@
 
 #include <KoColor.h>
 #include <KoColorSpace.h>
+#include <KoMixColorsOp.h>
+#include <KoColorConversionTransformation.h>
 
 #include <QRect>
+#include <QtMath>
 
 #include <kis_types.h>
 #include <kis_iterator_ng.h>
 #include <kis_cross_device_color_sampler.h>
+#include <krita_utils.h>
 
 #include <cmath>
 #include <ctime>
+#include <limits>
 #include <KoColorSpaceRegistry.h>
 
 const qreal degToRad = M_PI / 180.0;
@@ -154,6 +159,35 @@ bool DeformBrush::setupAction(
     return true;
 }
 
+namespace {
+
+/**
+ * The height of the row bands the dab is split into for
+ * processing in parallel
+ */
+const int rowBandHeight = 32;
+
+/**
+ * Small dabs are processed in the calling thread, the overhead of
+ * starting the threads is bigger than the gain
+ */
+const int minParallelDabArea = 64 * 64;
+
+/**
+ * The maximum size of the source snapshot. When the deformation
+ * reaches further than that (e.g. with a strong shrink), the source
+ * device is sampled directly.
+ */
+const qint64 maxSnapshotBytes = 64 * 1024 * 1024;
+
+/**
+ * The coordinates are clamped to avoid overflows when converting the
+ * results of degenerate transformations into integers
+ */
+const qreal maxSourceCoordinate = 1 << 28;
+
+}
+
 KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
         KisPaintDeviceSP layer,
         KisRandomSourceSP randomSource,
@@ -162,104 +196,334 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
         QPointF pos, qreal subPixelX, qreal subPixelY, int dabX, int dabY)
 {
     KisFixedPaintDeviceSP mask = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
-    KisCrossDeviceColorSampler colorSampler(layer, dab);
 
     qreal fWidth = maskWidth(scale);
     qreal fHeight = maskHeight(scale);
 
-    int dstWidth =  qRound(m_maskRect.width());
-    int dstHeight = qRound(m_maskRect.height());
+    DabGeometry g;
+
+    g.width = qRound(m_maskRect.width());
+    g.height = qRound(m_maskRect.height());
+    g.dabX = dabX;
+    g.dabY = dabY;
 
     // clear
-    if (dab->bounds().width() != dstWidth || dab->bounds().height() != dstHeight) {
+    if (dab->bounds().width() != g.width || dab->bounds().height() != g.height) {
         dab->setRect(m_maskRect.toRect());
         dab->lazyGrowBufferWithoutInitialization();
     }
 
-    qreal const centerX = dstWidth  * 0.5  + subPixelX;
-    qreal const centerY = dstHeight * 0.5  + subPixelY;
+    g.centerX = g.width  * 0.5  + subPixelX;
+    g.centerY = g.height * 0.5  + subPixelY;
 
-    qreal const majorAxis = 2.0 / fWidth;
-    qreal const minorAxis = 2.0 / fHeight;
+    g.majorAxis = 2.0 / fWidth;
+    g.minorAxis = 2.0 / fHeight;
 
-    qreal distance;
-
-    QTransform forwardRotationMatrix;
-    forwardRotationMatrix.rotate(rotation);
-    QTransform reverseRotationMatrix;
-    reverseRotationMatrix.rotate(-rotation);
+    g.pos = pos;
+    g.forwardRotation.rotate(rotation);
+    g.reverseRotation.rotate(-rotation);
 
     // if can't paint, stop
     if (!setupAction(DeformModes(m_properties->deformAction),
-                     pos, forwardRotationMatrix))
+                     pos, g.forwardRotation))
     {
         return 0;
     }
 
     mask->setRect(dab->bounds());
     mask->lazyGrowBufferWithoutInitialization();
-    quint8* maskPointer = mask->data();
-    qint8 maskPixelSize = mask->pixelSize();
 
-    quint8* dabPointer = dab->data();
-    int dabPixelSize = dab->colorSpace()->pixelSize();
+    const int numPixels = g.width * g.height;
+    m_sourcePoints.resize(numPixels);
+    m_sourceStates.resize(numPixels);
 
-    for (int y = 0; y <  dstHeight; y++) {
-        for (int x = 0; x < dstWidth; x++) {
-            qreal maskX = x - centerX;
-            qreal maskY = y - centerY;
-            forwardRotationMatrix.map(maskX, maskY, &maskX, &maskY);
-            distance = norme(maskX * majorAxis, maskY * minorAxis);
+    const bool parallel = numPixels >= minParallelDabArea;
 
-            if (distance > 1.0) {
-                // leave there OPACITY TRANSPARENT pixel (default pixel)
+    QVector<RowBand> bands;
+    for (int y = 0; y < g.height; y += rowBandHeight) {
+        RowBand band;
+        band.begin = y;
+        band.end = qMin(y + rowBandHeight, g.height);
+        bands << band;
+    }
+
+    /**
+     * 1) Calculate the deformed source position of every pixel of the dab.
+     *
+     *    The density check and the color deformation consume random values
+     *    for every pixel, so in such a case the positions are calculated
+     *    sequentially to keep the sequence of the random values stable.
+     */
+    const bool usesRandomSource =
+        m_sizeProperties->brushDensity != 1.0 ||
+        DeformModes(m_properties->deformAction) == DEFORM_COLOR;
+
+    quint8 *maskData = mask->data();
+    const int maskPixelSize = mask->pixelSize();
+
+    auto calculateBand = [&] (RowBand &band) {
+        calculateSourcePoints(g, band, randomSource, maskData, maskPixelSize);
+    };
+
+    if (parallel && !usesRandomSource) {
+        KritaUtils::parallelMap(bands, calculateBand);
+    } else {
+        std::for_each(bands.begin(), bands.end(), calculateBand);
+    }
+
+    /**
+     * 2) Copy the source area into a snapshot. Everything outside the
+     *    extent of the device is the default pixel, so there is no need
+     *    to copy it.
+     */
+    QRect sourceBounds;
+    Q_FOREACH (const RowBand &band, bands) {
+        sourceBounds |= band.sourceBounds;
+    }
 
-                colorSampler.sampleOldColor(x + dabX, y + dabY, dabPointer);
-                dabPointer += dabPixelSize;
+    m_snapshotRect = sourceBounds & layer->extent();
 
+    const qint64 snapshotBytes =
+        qint64(m_snapshotRect.width()) * m_snapshotRect.height() * layer->pixelSize();
+
+    if (snapshotBytes > maxSnapshotBytes) {
+        sampleDevice(g, layer, dab);
+    } else {
+        m_sourceSnapshot.resize(snapshotBytes);
+
+        if (!m_snapshotRect.isEmpty()) {
+            QVector<RowBand> snapshotBands;
+            for (int y = m_snapshotRect.top(); y <= m_snapshotRect.bottom(); y += rowBandHeight) {
+                RowBand band;
+                band.begin = y;
+                band.end = qMin(y + rowBandHeight, m_snapshotRect.bottom() + 1);
+                snapshotBands << band;
+            }
+
+            auto readBand = [&] (const RowBand &band) {
+                readSourceSnapshot(layer, band);
+            };
+
+            if (parallel) {
+                KritaUtils::parallelMap(snapshotBands, readBand);
+            } else {
+                std::for_each(snapshotBands.begin(), snapshotBands.end(), readBand);
+            }
+        }
+
+        /**
+         * 3) Sample the snapshot and write the result into the dab
+         */
+        auto sampleBand = [&] (const RowBand &band) {
+            sampleSnapshot(g, band, layer, dab);
+        };
+
+        if (parallel) {
+            KritaUtils::parallelMap(bands, sampleBand);
+        } else {
+            std::for_each(bands.begin(), bands.end(), sampleBand);
+        }
+    }
+
+    m_counter++;
+
+    return mask;
+
+}
+
+void DeformBrush::calculateSourcePoints(const DabGeometry &g, RowBand &band,
+                                        KisRandomSourceSP randomSource,
+                                        quint8 *mask, int maskPixelSize)
+{
+    qreal minX = std::numeric_limits<qreal>::max();
+    qreal minY = std::numeric_limits<qreal>::max();
+    qreal maxX = std::numeric_limits<qreal>::lowest();
+    qreal maxY = std::numeric_limits<qreal>::lowest();
+
+    for (int y = band.begin; y < band.end; y++) {
+        for (int x = 0; x < g.width; x++) {
+            const int index = y * g.width + x;
+            quint8 *maskPointer = mask + index * maskPixelSize;
+
+            qreal maskX = x - g.centerX;
+            qreal maskY = y - g.centerY;
+            g.forwardRotation.map(maskX, maskY, &maskX, &maskY);
+            const qreal distance = norme(maskX * g.majorAxis, maskY * g.minorAxis);
+
+            if (distance > 1.0) {
+                // leave there OPACITY TRANSPARENT pixel (default pixel)
+                m_sourcePoints[index] = QPointF(x + g.dabX, y + g.dabY);
+                m_sourceStates[index] = SourceOutside;
                 *maskPointer = OPACITY_TRANSPARENT_U8;
-                maskPointer += maskPixelSize;
+
+                minX = qMin(minX, qreal(x + g.dabX));
+                maxX = qMax(maxX, qreal(x + g.dabX));
+                minY = qMin(minY, qreal(y + g.dabY));
+                maxY = qMax(maxY, qreal(y + g.dabY));
                 continue;
             }
 
             if (m_sizeProperties->brushDensity != 1.0) {
                 if (m_sizeProperties->brushDensity < randomSource->generateNormalized()) {
-                    dabPointer += dabPixelSize;
+                    m_sourceStates[index] = SourceSkipped;
                     *maskPointer = OPACITY_TRANSPARENT_U8;
-                    maskPointer += maskPixelSize;
                     continue;
                 }
             }
 
             m_deformAction->transform(&maskX, &maskY, distance, randomSource);
-            reverseRotationMatrix.map(maskX, maskY, &maskX, &maskY);
+            g.reverseRotation.map(maskX, maskY, &maskX, &maskY);
 
-            maskX += pos.x();
-            maskY += pos.y();
+            maskX += g.pos.x();
+            maskY += g.pos.y();
 
             if (!m_properties->deformUseBilinear) {
                 maskX = qRound(maskX);
                 maskY = qRound(maskY);
             }
 
-            if (m_properties->deformUseOldData) {
-                colorSampler.sampleOldColor(maskX, maskY, dabPointer);
-            }
-            else {
-                colorSampler.sampleColor(maskX, maskY, dabPointer);
+            maskX = qBound(-maxSourceCoordinate, maskX, maxSourceCoordinate);
+            maskY = qBound(-maxSourceCoordinate, maskY, maxSourceCoordinate);
+
+            m_sourcePoints[index] = QPointF(maskX, maskY);
+            m_sourceStates[index] = SourceDeformed;
+            *maskPointer = OPACITY_OPAQUE_U8;
+
+            minX = qMin(minX, maskX);
+            maxX = qMax(maxX, maskX);
+            minY = qMin(minY, maskY);
+            maxY = qMax(maxY, maskY);
+        }
+    }
+
+    if (minX <= maxX && minY <= maxY) {
+        // bilinear sampling also reads the right and bottom neighbours
+        band.sourceBounds = QRect(QPoint(qFloor(minX), qFloor(minY)),
+                                  QPoint(qFloor(maxX) + 1, qFloor(maxY) + 1));
+    }
+}
+
+void DeformBrush::readSourceSnapshot(KisPaintDeviceSP layer, const RowBand &band)
+{
+    const int pixelSize = layer->pixelSize();
+    const int width = m_snapshotRect.width();
+    const bool useOldData = m_properties->deformUseOldData;
+
+    KisHLineConstIteratorSP it =
+        layer->createHLineConstIteratorNG(m_snapshotRect.x(), band.begin, width);
+
+    for (int y = band.begin; y < band.end; y++) {
+        quint8 *dst = m_sourceSnapshot.data() +
+            (qint64(y - m_snapshotRect.y()) * width) * pixelSize;
+
+        int x = 0;
+        do {
+            const int numPixels = qMin(it->nConseqPixels(), width - x);
+
+            memcpy(dst, useOldData ? it->oldRawData() : it->rawDataConst(), numPixels * pixelSize);
+            dst += numPixels * pixelSize;
+            x += numPixels;
+        } while (it->nextPixels(it->nConseqPixels()));
+
+        it->nextRow();
+    }
+}
+
+void DeformBrush::sampleSnapshot(const DabGeometry &g, const RowBand &band,
+                                 KisPaintDeviceSP layer, KisFixedPaintDeviceSP dab)
+{
+    const KoColorSpace *srcCS = layer->colorSpace();
+    const KoColorSpace *dstCS = dab->colorSpace();
+    const KoMixColorsOp *mixOp = srcCS->mixColorsOp();
+
+    const int srcPixelSize = srcCS->pixelSize();
+    const int dstPixelSize = dstCS->pixelSize();
+
+    const KoColor defaultPixel = layer->defaultPixel();
+    const quint8 *snapshot = m_sourceSnapshot.constData();
+    const QRect snapshotRect = m_snapshotRect;
+
+    auto pixelAt = [&] (int x, int y) {
+        return snapshotRect.contains(x, y) ?
+            snapshot + (qint64(y - snapshotRect.y()) * snapshotRect.width() + x - snapshotRect.x()) * srcPixelSize :
+            defaultPixel.data();
+    };
+
+    QVector<quint8> srcRow(g.width * srcPixelSize);
+    QVector<quint8> dstRow(g.width * dstPixelSize);
+
+    for (int y = band.begin; y < band.end; y++) {
+        const int rowStart = y * g.width;
+
+        for (int x = 0; x < g.width; x++) {
+            const int index = rowStart + x;
+            const QPointF &pt = m_sourcePoints[index];
+            quint8 *dst = srcRow.data() + x * srcPixelSize;
+
+            if (m_sourceStates[index] == SourceOutside) {
+                memcpy(dst, pixelAt(pt.x(), pt.y()), srcPixelSize);
+            } else if (m_sourceStates[index] == SourceDeformed) {
+                // the same sampling as KisRandomSubAccessor does
+                const int sx = qFloor(pt.x());
+                const int sy = qFloor(pt.y());
+
+                const qreal hsub = pt.x() - sx;
+                const qreal vsub = pt.y() - sy;
+
+                const quint8 *pixels[4];
+                qint16 weights[4];
+
+                weights[0] = qRound((1.0 - hsub) * (1.0 - vsub) * 255);
+                weights[1] = qRound((1.0 - vsub) * hsub * 255);
+                weights[2] = qRound(vsub * (1.0 - hsub) * 255);
+                weights[3] = qRound(hsub * vsub * 255);
+
+                pixels[0] = pixelAt(sx, sy);
+                pixels[1] = pixelAt(sx + 1, sy);
+                pixels[2] = pixelAt(sx, sy + 1);
+                pixels[3] = pixelAt(sx + 1, sy + 1);
+
+                const int sumOfWeights = weights[0] + weights[1] + weights[2] + weights[3];
+
+                mixOp->mixColors(pixels, weights, 4, dst, sumOfWeights);
             }
+        }
 
-            dabPointer += dabPixelSize;
+        srcCS->convertPixelsTo(srcRow.constData(), dstRow.data(), dstCS, g.width,
+                               KoColorConversionTransformation::internalRenderingIntent(),
+                               KoColorConversionTransformation::internalConversionFlags());
 
-            *maskPointer = OPACITY_OPAQUE_U8;
-            maskPointer += maskPixelSize;
+        quint8 *dabRow = dab->data() + rowStart * dstPixelSize;
 
+        for (int x = 0; x < g.width; x++) {
+            if (m_sourceStates[rowStart + x] != SourceSkipped) {
+                memcpy(dabRow + x * dstPixelSize, dstRow.constData() + x * dstPixelSize, dstPixelSize);
+            }
         }
     }
-    m_counter++;
+}
 
-    return mask;
+void DeformBrush::sampleDevice(const DabGeometry &g, KisPaintDeviceSP layer, KisFixedPaintDeviceSP dab)
+{
+    KisCrossDeviceColorSampler colorSampler(layer, dab);
+
+    quint8* dabPointer = dab->data();
+    const int dabPixelSize = dab->colorSpace()->pixelSize();
+
+    for (int i = 0; i < g.width * g.height; i++, dabPointer += dabPixelSize) {
+        const QPointF &pt = m_sourcePoints[i];
 
+        if (m_sourceStates[i] == SourceOutside) {
+            colorSampler.sampleOldColor(pt.x(), pt.y(), dabPointer);
+        } else if (m_sourceStates[i] == SourceDeformed) {
+            if (m_properties->deformUseOldData) {
+                colorSampler.sampleOldColor(pt.x(), pt.y(), dabPointer);
+            }
+            else {
+                colorSampler.sampleColor(pt.x(), pt.y(), dabPointer);
+            }
+        }
+    }
 }
 
 void DeformBrush::debugColor(const quint8* data, KoColorSpace * cs)
@@ -214,9 +214,61 @@ private:
         return x * x + y * y;
     }
 
+    /**
+     * The source sampling state of a pixel of the dab
+     */
+    enum SourceState : quint8 {
+        /// the pixel is outside the ellipse, it is copied from the same position
+        SourceOutside,
+        /// the pixel has been rejected by the density check and is not touched
+        SourceSkipped,
+        /// the pixel is sampled from the deformed position
+        SourceDeformed
+    };
+
+    struct RowBand {
+        int begin = 0;
+        int end = 0;
+
+        /// bounds of the source area accessed by the rows of the band
+        QRect sourceBounds;
+    };
+
+    struct DabGeometry {
+        int width = 0;
+        int height = 0;
+        int dabX = 0;
+        int dabY = 0;
+        qreal centerX = 0.0;
+        qreal centerY = 0.0;
+        qreal majorAxis = 0.0;
+        qreal minorAxis = 0.0;
+        QPointF pos;
+        QTransform forwardRotation;
+        QTransform reverseRotation;
+    };
+
+    void calculateSourcePoints(const DabGeometry &g, RowBand &band,
+                               KisRandomSourceSP randomSource, quint8 *mask, int maskPixelSize);
+
+    void readSourceSnapshot(KisPaintDeviceSP layer, const RowBand &band);
+
+    void sampleSnapshot(const DabGeometry &g, const RowBand &band,
+                        KisPaintDeviceSP layer, KisFixedPaintDeviceSP dab);
+
+    void sampleDevice(const DabGeometry &g, KisPaintDeviceSP layer, KisFixedPaintDeviceSP dab);
+
 
 private:
     KisRandomSubAccessorSP m_srcAcc;
+
+    // the buffers are kept between the dabs to avoid reallocations
+    QVector<QPointF> m_sourcePoints;
+    QVector<quint8> m_sourceStates;
+
+    /// a read-only copy of the source area accessed by the current dab
+    QVector<quint8> m_sourceSnapshot;
+    QRect m_snapshotRect;
     bool m_firstPaint {false};
     qreal m_prevX {0.0}, m_prevY {0.0};
     int m_counter {1}; // taken from the constructor
@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHairyBristleMath.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+KisHairyBristleMathBase::~KisHairyBristleMathBase()
+{
+}
+
+KisHairyBristleMathBase* KisHairyBristleMathFactory::create()
+{
+    return createOptimizedClass<KisHairyBristleMathFactoryImpl>();
+}
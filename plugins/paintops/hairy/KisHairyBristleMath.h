@@ -0,0 +1,82 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAIRYBRISTLEMATH_H
+#define KISHAIRYBRISTLEMATH_H
+
+#include <QTransform>
+
+/**
+ * The parameters of ink depletion that are shared by all the bristles
+ */
+struct KisHairyDepletionOptions
+{
+    float pressure {1.0f};
+    bool useWeights {false};
+    float pressureWeight {0.0f};
+    float bristleLengthWeight {0.0f};
+    float bristleInkAmountWeight {0.0f};
+    float inkDepletionWeight {0.0f};
+};
+
+/**
+ * @brief Per-bristle math of the hairy brush
+ *
+ * The math processes all the bristles of the brush at once, reading the
+ * state from the arrays of Bristles. The actual implementation is placed
+ * in class KisHairyBristleMath, which is compiled for every supported CPU
+ * architecture. Use KisHairyBristleMathFactory::create() to create a version
+ * optimized for the current CPU.
+ */
+class KisHairyBristleMathBase
+{
+public:
+    virtual ~KisHairyBristleMathBase();
+
+    /**
+     * Maps the positions of \p numBristles bristles into the dab. The position
+     * of a bristle is mapped with \p transform and its random offset is mapped
+     * with \p offsetTransform. The translation part of both transforms is ignored.
+     */
+    virtual void mapPositions(const float *x, const float *y,
+                              const float *offsetX, const float *offsetY,
+                              int numBristles,
+                              const QTransform &transform,
+                              const QTransform &offsetTransform,
+                              float *dstX, float *dstY) const = 0;
+
+    /**
+     * Calculates opacity and saturation of the ink for \p numSteps steps
+     * of \p numBristles bristles. The results are stored step by step, that
+     * is, the value for step `s` of bristle `i` is written at index
+     * `s * numBristles + i` of \p opacities and \p saturations.
+     *
+     * \p counters and \p inkAmounts describe the state of the bristles
+     * before the first step. \p depletionCurve must not be empty.
+     */
+    virtual void calculateInkDepletion(const float *depletionCurve, int curveSize,
+                                       const int *counters,
+                                       const float *lengths,
+                                       const float *inkAmounts,
+                                       int numBristles, int numSteps,
+                                       const KisHairyDepletionOptions &options,
+                                       float *opacities, float *saturations) const = 0;
+};
+
+class KisHairyBristleMathFactory
+{
+public:
+    static KisHairyBristleMathBase* create();
+};
+
+class KisHairyBristleMathFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisHairyBristleMathBase* create();
+};
+
+#endif // KISHAIRYBRISTLEMATH_H
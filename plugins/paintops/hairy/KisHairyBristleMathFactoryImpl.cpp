@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHairyBristleMath.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisHairyBristleMathImpl.h"
+
+template<>
+KisHairyBristleMathBase *
+KisHairyBristleMathFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisHairyBristleMath<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
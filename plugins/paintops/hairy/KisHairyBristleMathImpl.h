@@ -0,0 +1,235 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAIRYBRISTLEMATHIMPL_H
+#define KISHAIRYBRISTLEMATHIMPL_H
+
+#include "KisHairyBristleMath.h"
+
+#include <type_traits>
+
+#include <QtGlobal>
+
+#include "KoAlwaysInline.h"
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+/**
+ * Generic scalar implementation of the bristle math. It is used for
+ * the `xsimd::generic` architecture and as a tail-processor for the
+ * vectorized version.
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KisHairyBristleMath : public KisHairyBristleMathBase
+{
+public:
+    void mapPositions(const float *x, const float *y,
+                      const float *offsetX, const float *offsetY,
+                      int numBristles,
+                      const QTransform &transform,
+                      const QTransform &offsetTransform,
+                      float *dstX, float *dstY) const override
+    {
+        mapPositionsScalar(0, numBristles, x, y, offsetX, offsetY,
+                           transform, offsetTransform, dstX, dstY);
+    }
+
+    void calculateInkDepletion(const float *depletionCurve, int curveSize,
+                               const int *counters,
+                               const float *lengths,
+                               const float *inkAmounts,
+                               int numBristles, int numSteps,
+                               const KisHairyDepletionOptions &options,
+                               float *opacities, float *saturations) const override
+    {
+        for (int step = 0; step < numSteps; step++) {
+            calculateStepScalar(0, numBristles, step,
+                                depletionCurve, curveSize,
+                                counters, lengths, inkAmounts,
+                                options,
+                                opacities + step * numBristles,
+                                saturations + step * numBristles);
+        }
+    }
+
+protected:
+    static void mapPositionsScalar(int from, int to,
+                                   const float *x, const float *y,
+                                   const float *offsetX, const float *offsetY,
+                                   const QTransform &t,
+                                   const QTransform &o,
+                                   float *dstX, float *dstY)
+    {
+        for (int i = from; i < to; i++) {
+            dstX[i] = t.m11() * x[i] + t.m21() * y[i] + o.m11() * offsetX[i] + o.m21() * offsetY[i];
+            dstY[i] = t.m12() * x[i] + t.m22() * y[i] + o.m12() * offsetX[i] + o.m22() * offsetY[i];
+        }
+    }
+
+    /**
+     * Calculates \p step for bristles in range [\p from, \p to). The results
+     * are written into \p opacities and \p saturations of the step.
+     */
+    static void calculateStepScalar(int from, int to, int step,
+                                    const float *depletionCurve, int curveSize,
+                                    const int *counters,
+                                    const float *lengths,
+                                    const float *inkAmounts,
+                                    const KisHairyDepletionOptions &options,
+                                    float *opacities, float *saturations)
+    {
+        for (int i = from; i < to; i++) {
+            const int counter = counters[i] + step;
+            const float inkDepletion = depletionCurve[qMin(counter, curveSize - 1)];
+
+            // the ink amount is updated after every step of the bristle
+            const float inkAmount = step == 0 ?
+                inkAmounts[i] :
+                qBound(-1.0f, 1.0f - depletionCurve[qMin(counter - 1, curveSize - 1)], 1.0f);
+
+            const float length = lengths[i];
+
+            if (options.useWeights) {
+                const float value =
+                    options.pressure * options.pressureWeight +
+                    length * options.bristleLengthWeight +
+                    inkAmount * options.bristleInkAmountWeight +
+                    (1.0f - inkDepletion) * options.inkDepletionWeight;
+
+                opacities[i] = qBound(0.0f, value, 1.0f);
+                saturations[i] = value - 1.0f;
+            } else {
+                opacities[i] = qBound(0.0f, length * inkAmount, 1.0f);
+                saturations[i] = options.pressure * length * inkAmount * (1.0f - inkDepletion) - 1.0f;
+            }
+        }
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the bristle math. The bristles are processed
+ * in batches, every step of the ink depletion is calculated for all
+ * the bristles of the batch at once.
+ */
+template<typename _impl>
+class KisHairyBristleMath<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisHairyBristleMath<xsimd::generic>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+    using base_class = KisHairyBristleMath<xsimd::generic>;
+
+public:
+    void mapPositions(const float *x, const float *y,
+                      const float *offsetX, const float *offsetY,
+                      int numBristles,
+                      const QTransform &t,
+                      const QTransform &o,
+                      float *dstX, float *dstY) const override
+    {
+        const float_v t11(t.m11()), t12(t.m12()), t21(t.m21()), t22(t.m22());
+        const float_v o11(o.m11()), o12(o.m12()), o21(o.m21()), o22(o.m22());
+
+        int i = 0;
+        for (; i + static_cast<int>(float_v::size) <= numBristles; i += float_v::size) {
+            const float_v px = float_v::load_unaligned(x + i);
+            const float_v py = float_v::load_unaligned(y + i);
+            const float_v ox = float_v::load_unaligned(offsetX + i);
+            const float_v oy = float_v::load_unaligned(offsetY + i);
+
+            const float_v resultX = t11 * px + t21 * py + o11 * ox + o21 * oy;
+            const float_v resultY = t12 * px + t22 * py + o12 * ox + o22 * oy;
+
+            resultX.store_unaligned(dstX + i);
+            resultY.store_unaligned(dstY + i);
+        }
+
+        base_class::mapPositionsScalar(i, numBristles, x, y, offsetX, offsetY,
+                                       t, o, dstX, dstY);
+    }
+
+    void calculateInkDepletion(const float *depletionCurve, int curveSize,
+                               const int *counters,
+                               const float *lengths,
+                               const float *inkAmounts,
+                               int numBristles, int numSteps,
+                               const KisHairyDepletionOptions &options,
+                               float *opacities, float *saturations) const override
+    {
+        const int_v maxIndex(curveSize - 1);
+        const float_v zero(0.0f);
+        const float_v one(1.0f);
+        const float_v minusOne(-1.0f);
+
+        const float_v pressure(options.pressure);
+        const float_v pressureTerm(options.pressure * options.pressureWeight);
+        const float_v lengthWeight(options.bristleLengthWeight);
+        const float_v inkAmountWeight(options.bristleInkAmountWeight);
+        const float_v inkDepletionWeight(options.inkDepletionWeight);
+
+        for (int step = 0; step < numSteps; step++) {
+            float *stepOpacities = opacities + step * numBristles;
+            float *stepSaturations = saturations + step * numBristles;
+
+            const int_v stepOffset(step);
+
+            int i = 0;
+            for (; i + static_cast<int>(float_v::size) <= numBristles; i += float_v::size) {
+                const int_v counter = int_v::load_unaligned(counters + i) + stepOffset;
+                const float_v inkDepletion =
+                    float_v::gather(depletionCurve, xsimd::min(counter, maxIndex));
+
+                float_v inkAmount;
+                if (step == 0) {
+                    inkAmount = float_v::load_unaligned(inkAmounts + i);
+                } else {
+                    const float_v prevInkDepletion =
+                        float_v::gather(depletionCurve, xsimd::min(counter - int_v(1), maxIndex));
+                    inkAmount = xsimd::min(xsimd::max(one - prevInkDepletion, minusOne), one);
+                }
+
+                const float_v length = float_v::load_unaligned(lengths + i);
+
+                float_v opacity;
+                float_v saturation;
+
+                if (options.useWeights) {
+                    const float_v value =
+                        pressureTerm +
+                        length * lengthWeight +
+                        inkAmount * inkAmountWeight +
+                        (one - inkDepletion) * inkDepletionWeight;
+
+                    opacity = xsimd::min(xsimd::max(value, zero), one);
+                    saturation = value - one;
+                } else {
+                    const float_v lengthInk = length * inkAmount;
+
+                    opacity = xsimd::min(xsimd::max(lengthInk, zero), one);
+                    saturation = pressure * lengthInk * (one - inkDepletion) - one;
+                }
+
+                opacity.store_unaligned(stepOpacities + i);
+                saturation.store_unaligned(stepSaturations + i);
+            }
+
+            base_class::calculateStepScalar(i, numBristles, step,
+                                            depletionCurve, curveSize,
+                                            counters, lengths, inkAmounts,
+                                            options,
+                                            stepOpacities, stepSaturations);
+        }
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KISHAIRYBRISTLEMATHIMPL_H
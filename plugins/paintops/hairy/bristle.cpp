@@ -6,35 +6,24 @@
 
 #include "bristle.h"
 
-Bristle::Bristle(float x, float y, float length)
-    : m_x(x)
-    , m_y(y)
-    , m_prevX(x)
-    , m_prevY(y)
-    , m_length(length)
-{}
-
-Bristle::~Bristle()
-{
-}
-
-void Bristle::setLength(float length)
-{
-    m_length = length;
-}
-
-
-void Bristle::addInk(float value)
+void Bristles::append(float x, float y, float length, const KoColor &color)
 {
-    m_inkAmount = m_inkAmount + value;
+    m_x.append(x);
+    m_y.append(y);
+    m_prevX.append(x);
+    m_prevY.append(y);
+    m_length.append(length);
+    m_inkAmount.append(0.0f);
+    m_counter.append(0);
+    m_color.append(color);
 }
 
-void Bristle::removeInk(float value)
+void Bristles::setColor(int index, const KoColor &color)
 {
-    m_inkAmount = m_inkAmount - value;
+    m_color[index] = color;
 }
 
-void Bristle::setInkAmount(float inkAmount)
+float Bristles::boundInkAmount(float inkAmount)
 {
     if (inkAmount > 1.0f) {
         inkAmount = 1.0f;
@@ -43,16 +32,5 @@ void Bristle::setInkAmount(float inkAmount)
         inkAmount = -1.0f;
     }
 
-    m_inkAmount = inkAmount;
-}
-
-void Bristle::setColor(const KoColor &color)
-{
-    m_color = color;
-}
-
-
-void Bristle::setEnabled(bool enabled)
-{
-    m_enabled = enabled;
+    return inkAmount;
 }
@@ -7,101 +7,78 @@
 #ifndef _BRISTLE_H_
 #define _BRISTLE_H_
 
-#include <cmath>
+#include <QVector>
 #include <KoColor.h>
 
-class Bristle
+/**
+ * The state of all the bristles of the hairy brush. The state is stored
+ * in a structure-of-arrays layout, so the per-bristle math could process
+ * several bristles at once (see KisHairyBristleMathBase).
+ */
+class Bristles
 {
 
 public:
-    Bristle() = default;
-    Bristle(float x, float y, float length);
-    ~Bristle();
+    void append(float x, float y, float length, const KoColor &color);
 
-    inline float x() const {
-        return m_x;
+    inline int size() const {
+        return m_x.size();
     }
 
-    inline float y() const {
-        return m_y;
+    inline bool isEmpty() const {
+        return m_x.isEmpty();
     }
 
-    inline float prevX() const {
-        return m_prevX;
+    // coordinates of bristles
+    inline const float* x() const {
+        return m_x.constData();
     }
 
-    inline float prevY() const {
-        return m_prevY;
+    inline const float* y() const {
+        return m_y.constData();
     }
 
-    inline float length() const {
-        return m_length;
+    inline float* prevX() {
+        return m_prevX.data();
     }
 
-    inline  const KoColor &color() const {
-        return m_color;
+    inline float* prevY() {
+        return m_prevY.data();
     }
 
-    inline int counter() const {
-        return m_counter;
+    // z - coordinate
+    inline const float* length() const {
+        return m_length.constData();
     }
 
-    inline void upIncrement() {
-        m_counter++;
+    inline float* inkAmount() {
+        return m_inkAmount.data();
     }
 
-    inline float inkAmount() const {
-        return m_inkAmount;
-    };
-
-    inline float distanceCenter() {
-        return std::sqrt(m_x * m_x + m_y * m_y);
+    inline int* counter() {
+        return m_counter.data();
     }
 
-    inline void setX(float x) {
-        m_x = x;
-    }
-    inline void setY(float y) {
-        m_y = y;
+    inline const KoColor& color(int index) const {
+        return m_color[index];
     }
 
-    inline void setPrevX(float prevX) {
-        m_prevX = prevX;
-    }
-
-    inline void setPrevY(float prevY) {
-        m_prevY = prevY;
-    }
-
-    inline bool enabled() const {
-        return m_enabled;
-    }
-
-    void setLength(float length);
-    void setColor(const KoColor &color);
-
-    void addInk(float value);
-    void removeInk(float value);
-    void setInkAmount(float inkAmount);
-    void setEnabled(bool enabled);
+    void setColor(int index, const KoColor &color);
 
+    static float boundInkAmount(float inkAmount);
 
 private:
-    void init(float x, float y, float length);
-
-    // coordinates of bristle
-    float m_x{0.0f};
-    float m_y{0.0f};
-    float m_prevX{0.0f};
-    float m_prevY{0.0f};
-    float m_length{0.0f}; // z - coordinate
-    KoColor m_color;
-    float m_inkAmount{0.0f};
+    QVector<float> m_x;
+    QVector<float> m_y;
+    QVector<float> m_prevX;
+    QVector<float> m_prevY;
+    QVector<float> m_length;
+    QVector<float> m_inkAmount;
 
     // new dimension in bristle
-    int m_counter{0};
+    QVector<int> m_counter;
 
-    bool m_enabled{true};
+    QVector<KoColor> m_color;
 };
 
 #endif
@@ -14,18 +14,38 @@
 #include <QVariant>
 #include <QHash>
 #include <QVector>
+#include <QtMath>
 
 #include <kis_types.h>
 #include <kis_random_accessor_ng.h>
 #include <kis_cross_device_color_sampler.h>
 #include <kis_fixed_paint_device.h>
+#include <kis_image_config.h>
+#include <krita_utils.h>
 
 
 #include <cmath>
 #include <ctime>
 
+namespace {
+
+/**
+ * The segments of the bristles are binned by the tiles of the dab
+ * device, so the worker threads never write into the same tile
+ * simultaneously
+ */
+const int tileSize = 64;
+
+inline int tileIndex(int coordinate)
+{
+    return coordinate >= 0 ? coordinate / tileSize : (coordinate - tileSize + 1) / tileSize;
+}
+
+}
+
 
 HairyBrush::HairyBrush()
+    : m_bristleMath(KisHairyBristleMathFactory::create())
 {
     m_counter = 0;
     m_lastAngle = 0.0;
@@ -37,8 +57,6 @@ HairyBrush::HairyBrush()
 HairyBrush::~HairyBrush()
 {
     delete m_transfo;
-    qDeleteAll(m_bristles.begin(), m_bristles.end());
-    m_bristles.clear();
 }
 
 
@@ -53,6 +71,15 @@ void HairyBrush::initAndCache()
             m_saturationId = m_transfo->parameterId("s");
         }
     }
+
+    m_inkDepletionCurve.clear();
+    Q_FOREACH (qreal value, m_properties->inkDepletionCurve) {
+        m_inkDepletionCurve.append(value);
+    }
+
+    if (m_inkDepletionCurve.isEmpty()) {
+        m_inkDepletionCurve.append(0.0f);
+    }
 }
 
 void HairyBrush::fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density)
@@ -64,7 +91,6 @@ void HairyBrush::fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density)
     int centerY = height * 0.5;
 
     // make mask
-    Bristle * bristle = nullptr;
     qreal alpha;
 
     quint8 * dabPointer = dab->data();
@@ -81,10 +107,8 @@ void HairyBrush::fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density)
                 if (density == 1.0 || randomSource.generateNormalized() <= density) {
                     memcpy(bristleColor.data(), dabPointer, pixelSize);
 
-                    bristle = new Bristle(x - centerX, y - centerY, alpha); // using value from image as length of bristle
-                    bristle->setColor(bristleColor);
-
-                    m_bristles.append(bristle);
+                    // using value from image as length of bristle
+                    m_bristles.append(x - centerX, y - centerY, alpha, bristleColor);
                 }
             }
             dabPointer += pixelSize;
@@ -120,11 +144,6 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     // this pressure controls shear and ink depletion
     qreal pressure = mousePressure * (pi2.pressure() * 2);
 
-    Bristle *bristle = 0;
-    KoColor bristleColor(dab->colorSpace());
-
-    m_dabAccessor = dab->createRandomAccessorNG();
-
     m_dab = dab;
 
     // initialization block
@@ -146,46 +165,75 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
 
     KisRandomSourceSP randomSource = pi2.randomSource();
 
-    qreal fx1, fy1, fx2, fy2;
-    qreal randomX, randomY;
-    qreal shear;
+    const int bristleCount = m_bristles.size();
+
+    /**
+     * 1) Generate the random offsets of the bristles. The random values
+     *    are generated in the order of the bristles, so the result
+     *    depends on the seed of the random source only.
+     */
+    m_offsetX.resize(bristleCount);
+    m_offsetY.resize(bristleCount);
 
-    float inkDepletion = 0.0;
-    int inkDepletionSize = m_properties->inkDepletionCurve.size();
-    int bristleCount = m_bristles.size();
-    int bristlePathSize;
-    qreal threshold = 1.0 - pi2.pressure();
     for (int i = 0; i < bristleCount; i++) {
+        m_offsetX[i] = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+        m_offsetY[i] = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+    }
 
-        if (!m_bristles.at(i)->enabled()) continue;
-        bristle = m_bristles[i];
+    /**
+     * 2) Map all the bristles into the dab. The random offset is applied
+     *    after the shear, but before scaling and rotation.
+     */
+    const qreal shear = pressure * m_properties->shearFactor;
 
-        randomX = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
-        randomY = (randomSource->generateNormalized() * 2 - 1.0) * m_properties->randomFactor;
+    QTransform offsetTransform;
+    offsetTransform.rotateRadians(-angle);
+    offsetTransform.scale(scale, scale);
 
-        shear = pressure * m_properties->shearFactor;
+    QTransform transform = offsetTransform;
+    transform.shear(shear, shear);
 
-        m_transform.reset();
-        m_transform.rotateRadians(-angle);
-        m_transform.scale(scale, scale);
-        m_transform.translate(randomX, randomY);
-        m_transform.shear(shear, shear);
+    m_endX.resize(bristleCount);
+    m_endY.resize(bristleCount);
 
-        if (firstStroke() || (!m_properties->connectedPath)) {
-            // transform start dab
-            m_transform.map(bristle->x(), bristle->y(), &fx1, &fy1);
-            // transform end dab
-            m_transform.map(bristle->x(), bristle->y(), &fx2, &fy2);
-        }
-        else {
+    m_bristleMath->mapPositions(m_bristles.x(), m_bristles.y(),
+                                m_offsetX.constData(), m_offsetY.constData(),
+                                bristleCount,
+                                transform, offsetTransform,
+                                m_endX.data(), m_endY.data());
+
+    /**
+     * 3) Build the paths of the bristles
+     */
+    const bool continuePath = !firstStroke() && m_properties->connectedPath;
+    const qreal threshold = 1.0 - pi2.pressure();
+
+    float *prevX = m_bristles.prevX();
+    float *prevY = m_bristles.prevY();
+    const float *lengths = m_bristles.length();
+
+    m_segments.clear();
+    m_points.clear();
+    int maxSteps = 0;
+
+    for (int i = 0; i < bristleCount; i++) {
+        qreal fx1, fy1, fx2, fy2;
+
+        fx2 = m_endX[i];
+        fy2 = m_endY[i];
+
+        if (continuePath) {
             // continue the path of the bristle from the previous position
-            fx1 = bristle->prevX();
-            fy1 = bristle->prevY();
-            m_transform.map(bristle->x(), bristle->y(), &fx2, &fy2);
+            fx1 = prevX[i];
+            fy1 = prevY[i];
+        } else {
+            fx1 = fx2;
+            fy1 = fy2;
         }
+
         // remember the end point
-        bristle->setPrevX(fx2);
-        bristle->setPrevY(fy2);
+        prevX[i] = fx2;
+        prevY[i] = fy2;
 
         // all coords relative to device position
         fx1 += x1;
@@ -194,78 +242,187 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         fx2 += x2;
         fy2 += y2;
 
-        if (m_properties->threshold && (bristle->length() < threshold)) continue;
+        if (m_properties->threshold && (lengths[i] < threshold)) continue;
         // paint between first and last dab
-        const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
-        bristlePathSize = m_trajectory.size();
+        const QVector<QPointF> &bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
+        int bristlePathSize = m_trajectory.size();
 
         // avoid overlapping bristle caps with antialias on
         if (m_properties->antialias) {
             bristlePathSize -= 1;
         }
 
-        memcpy(bristleColor.data(), bristle->color().data() , m_pixelSize);
-        for (int i = 0; i < bristlePathSize ; i++) {
+        if (bristlePathSize <= 0) continue;
+
+        Segment segment;
+        segment.bristle = i;
+        segment.firstPoint = m_points.size();
+        segment.numPoints = bristlePathSize;
+
+        qreal minX = bristlePath[0].x();
+        qreal maxX = minX;
+        qreal minY = bristlePath[0].y();
+        qreal maxY = minY;
+
+        for (int step = 0; step < bristlePathSize; step++) {
+            const QPointF &pt = bristlePath[step];
+
+            minX = qMin(minX, pt.x());
+            maxX = qMax(maxX, pt.x());
+            minY = qMin(minY, pt.y());
+            maxY = qMax(maxY, pt.y());
+
+            m_points.append(pt);
+        }
+
+        // every step touches at most 2x2 pixels
+        segment.bounds = QRect(QPoint(qFloor(minX) - 1, qFloor(minY) - 1),
+                               QPoint(qCeil(maxX) + 1, qCeil(maxY) + 1));
+
+        m_segments.append(segment);
+        maxSteps = qMax(maxSteps, bristlePathSize);
+    }
+
+    /**
+     * 4) Calculate the ink depletion of all the steps of all the bristles
+     */
+    if (m_properties->inkDepletionEnabled) {
+        KisHairyDepletionOptions options;
+        options.pressure = pressure;
+        options.useWeights = m_properties->useWeights;
+        options.pressureWeight = m_properties->pressureWeight;
+        options.bristleLengthWeight = m_properties->bristleLengthWeight;
+        options.bristleInkAmountWeight = m_properties->bristleInkAmountWeight;
+        options.inkDepletionWeight = m_properties->inkDepletionWeight;
+
+        m_opacities.resize(maxSteps * bristleCount);
+        m_saturations.resize(maxSteps * bristleCount);
+
+        m_bristleMath->calculateInkDepletion(m_inkDepletionCurve.constData(), m_inkDepletionCurve.size(),
+                                             m_bristles.counter(), lengths, m_bristles.inkAmount(),
+                                             bristleCount, maxSteps,
+                                             options,
+                                             m_opacities.data(), m_saturations.data());
+    }
+
+    /**
+     * 5) Generate the colors of the steps. The saturation depletion is
+     *    applied to the color of the previous step, so the colors of
+     *    a single bristle are generated sequentially.
+     */
+    const int inkDepletionSize = m_inkDepletionCurve.size();
+    int *counters = m_bristles.counter();
+    float *inkAmounts = m_bristles.inkAmount();
+
+    KoColor bristleColor(dab->colorSpace());
+    m_colors.resize(m_points.size() * m_pixelSize);
+
+    Q_FOREACH (const Segment &segment, m_segments) {
+        const int i = segment.bristle;
+        quint8 *colors = m_colors.data() + segment.firstPoint * m_pixelSize;
+
+        memcpy(bristleColor.data(), m_bristles.color(i).data() , m_pixelSize);
+        for (int step = 0; step < segment.numPoints; step++) {
 
             if (m_properties->inkDepletionEnabled) {
-                inkDepletion = fetchInkDepletion(bristle, inkDepletionSize);
+                const int index = step * bristleCount + i;
 
                 if (m_properties->useSaturation && m_transfo != 0) {
-                    saturationDepletion(bristle, bristleColor, pressure, inkDepletion);
+                    saturationDepletion(bristleColor, m_saturations[index]);
                 }
 
                 if (m_properties->useOpacity) {
-                    opacityDepletion(bristle, bristleColor, pressure, inkDepletion);
+                    bristleColor.setOpacity(qreal(m_opacities[index]));
                 }
 
             }
             else {
                 if (bristleColor.opacityU8() != 0) {
-                    bristleColor.setOpacity(bristle->length());
+                    bristleColor.setOpacity(qreal(lengths[i]));
                 }
             }
 
-            addBristleInk(bristle, bristlePath.at(i), bristleColor);
-            bristle->setInkAmount(1.0 - inkDepletion);
-            bristle->upIncrement();
+            memcpy(colors, bristleColor.data(), m_pixelSize);
+            colors += m_pixelSize;
+        }
+
+        if (m_properties->inkDepletionEnabled) {
+            const int lastCounter = qMin(counters[i] + segment.numPoints - 1, inkDepletionSize - 1);
+            inkAmounts[i] = Bristles::boundInkAmount(1.0f - m_inkDepletionCurve[lastCounter]);
+        } else {
+            inkAmounts[i] = 1.0f;
         }
 
+        counters[i] += segment.numPoints;
     }
-    m_dab = nullptr;
-    m_dabAccessor = nullptr;
-}
 
+    /**
+     * 6) Bin the segments by the tiles of the dab and paint the bins in
+     *    parallel. Every bin keeps the segments in the order of bristles,
+     *    so every pixel of the dab gets the same sequence of writes as if
+     *    the bristles were painted sequentially.
+     */
+    struct Bin {
+        QRect rect;
+        QVector<int> segments;
+    };
+
+    QVector<Bin> bins;
+    QHash<QPair<int, int>, int> binIndexes;
+
+    for (int i = 0; i < m_segments.size(); i++) {
+        const QRect &bounds = m_segments[i].bounds;
+
+        for (int row = tileIndex(bounds.top()); row <= tileIndex(bounds.bottom()); row++) {
+            for (int col = tileIndex(bounds.left()); col <= tileIndex(bounds.right()); col++) {
+                auto it = binIndexes.find(qMakePair(row, col));
+
+                if (it == binIndexes.end()) {
+                    it = binIndexes.insert(qMakePair(row, col), bins.size());
+                    bins.append(Bin{QRect(col * tileSize, row * tileSize, tileSize, tileSize), {}});
+                }
 
-inline qreal HairyBrush::fetchInkDepletion(Bristle* bristle, int inkDepletionSize)
-{
-    if (bristle->counter() >= inkDepletionSize - 1) {
-        return m_properties->inkDepletionCurve[inkDepletionSize - 1];
+                bins[*it].segments.append(i);
+            }
+        }
+    }
+
+    auto paintBin = [this, dab] (const Bin &bin) {
+        paintSegments(dab, bin.segments, bin.rect);
+    };
+
+    if (bins.size() > 1 && KisImageConfig(true).maxNumberOfThreads() > 1) {
+        KritaUtils::parallelMap(bins, paintBin);
     } else {
-        return m_properties->inkDepletionCurve[bristle->counter()];
+        Q_FOREACH (const Bin &bin, bins) {
+            paintBin(bin);
+        }
     }
-}
 
+    m_dab = nullptr;
+}
 
-void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDepletion)
+void HairyBrush::paintSegments(KisPaintDeviceSP dab, const QVector<int> &segments, const QRect &clipRect)
 {
-    qreal saturation;
-    if (m_properties->useWeights) {
-        // new weighted way (experiment)
-        saturation = (
-                         (pressure * m_properties->pressureWeight) +
-                         (bristle->length() * m_properties->bristleLengthWeight) +
-                         (bristle->inkAmount() * m_properties->bristleInkAmountWeight) +
-                         ((1.0 - inkDepletion) * m_properties->inkDepletionWeight)) - 1.0;
-    }
-    else {
-        // old way of computing saturation
-        saturation = (
-                         pressure *
-                         bristle->length() *
-                         bristle->inkAmount() *
-                         (1.0 - inkDepletion)) - 1.0;
+    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
+    QVector<quint8> scratch(m_pixelSize);
+
+    Q_FOREACH (int index, segments) {
+        const Segment &segment = m_segments[index];
+
+        const QPointF *points = m_points.constData() + segment.firstPoint;
+        const quint8 *colors = m_colors.constData() + segment.firstPoint * m_pixelSize;
 
+        for (int step = 0; step < segment.numPoints; step++) {
+            addBristleInk(accessor, clipRect, points[step], colors, scratch.data());
+            colors += m_pixelSize;
+        }
     }
+}
+
+
+void HairyBrush::saturationDepletion(KoColor &bristleColor, qreal saturation)
+{
     m_transfo->setParameter(m_transfo->parameterId("h"), 0.0);
     m_transfo->setParameter(m_transfo->parameterId("v"), 0.0);
     m_transfo->setParameter(m_saturationId, saturation);
@@ -274,51 +431,33 @@ void HairyBrush::saturationDepletion(Bristle * bristle, KoColor &bristleColor, q
     m_transfo->transform(bristleColor.data(), bristleColor.data() , 1);
 }
 
-void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal pressure, qreal inkDepletion)
+inline void HairyBrush::addBristleInk(KisRandomAccessorSP &accessor, const QRect &clipRect, const QPointF &pos, const quint8 *color, quint8 *scratch)
 {
-    qreal opacity = OPACITY_OPAQUE_F;
-    if (m_properties->useWeights) {
-        opacity = pressure * m_properties->pressureWeight +
-                  bristle->length() * m_properties->bristleLengthWeight +
-                  bristle->inkAmount() * m_properties->bristleInkAmountWeight +
-                  (1.0 - inkDepletion) * m_properties->inkDepletionWeight;
-    }
-    else {
-        opacity =
-            bristle->length() *
-            bristle->inkAmount();
-    }
-
-    opacity = qBound(0.0, opacity, 1.0);
-    bristleColor.setOpacity(opacity);
-}
-
-inline void HairyBrush::addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color)
-{
-    Q_UNUSED(bristle);
     if (m_properties->antialias) {
         if (m_properties->useCompositing) {
-            paintParticle(pos, color);
+            paintParticle(accessor, clipRect, pos, color, scratch);
         } else {
-            paintParticle(pos, color, 1.0);
+            paintParticle(accessor, clipRect, pos, color, 1.0);
         }
     }
     else {
         int ix = qRound(pos.x());
         int iy = qRound(pos.y());
         if (m_properties->useCompositing) {
-            plotPixel(ix, iy, color);
+            plotPixel(accessor, clipRect, ix, iy, color);
         }
         else {
-            darkenPixel(ix, iy, color);
+            darkenPixel(accessor, clipRect, ix, iy, color);
         }
     }
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
+void HairyBrush::paintParticle(KisRandomAccessorSP &accessor, const QRect &clipRect, QPointF pos, const quint8 *color, qreal weight)
 {
+    const KoColorSpace * cs = m_dab->colorSpace();
+
     // opacity top left, right, bottom left, right
-    quint8 opacity = color.opacityU8();
+    quint8 opacity = cs->opacityU8(color);
     opacity *= weight;
 
     int ipx = int (pos.x());
@@ -331,34 +470,28 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    const KoColorSpace * cs = m_dab->colorSpace();
+    auto writePixel = [&] (int x, int y, quint8 pixelOpacity) {
+        if (!clipRect.contains(x, y)) return;
+
+        accessor->moveTo(x, y);
+        pixelOpacity = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, pixelOpacity + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+        memcpy(accessor->rawData(), color, m_pixelSize);
+        cs->setOpacity(accessor->rawData(), pixelOpacity, 1);
+    };
 
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
-
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    writePixel(ipx, ipy, btl);
+    writePixel(ipx + 1, ipy, btr);
+    writePixel(ipx, ipy + 1, bbl);
+    writePixel(ipx + 1, ipy + 1, bbr);
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
+void HairyBrush::paintParticle(KisRandomAccessorSP &accessor, const QRect &clipRect, QPointF pos, const quint8 *color, quint8 *scratch)
 {
+    const KoColorSpace * cs = m_dab->colorSpace();
+
     // opacity top left, right, bottom left, right
-    memcpy(m_color.data(), color.data(), m_pixelSize);
-    quint8 opacity = color.opacityU8();
+    memcpy(scratch, color, m_pixelSize);
+    quint8 opacity = cs->opacityU8(color);
 
     int ipx = int (pos.x());
     int ipy = int (pos.y());
@@ -370,31 +503,35 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    m_color.setOpacity(btl);
-    plotPixel(ipx  , ipy, m_color);
+    cs->setOpacity(scratch, btl, 1);
+    plotPixel(accessor, clipRect, ipx  , ipy, scratch);
 
-    m_color.setOpacity(btr);
-    plotPixel(ipx + 1  , ipy, m_color);
+    cs->setOpacity(scratch, btr, 1);
+    plotPixel(accessor, clipRect, ipx + 1  , ipy, scratch);
 
-    m_color.setOpacity(bbl);
-    plotPixel(ipx  , ipy + 1, m_color);
+    cs->setOpacity(scratch, bbl, 1);
+    plotPixel(accessor, clipRect, ipx  , ipy + 1, scratch);
 
-    m_color.setOpacity(bbr);
-    plotPixel(ipx + 1 , ipy + 1, m_color);
+    cs->setOpacity(scratch, bbr, 1);
+    plotPixel(accessor, clipRect, ipx + 1 , ipy + 1, scratch);
 }
 
 
-inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::plotPixel(KisRandomAccessorSP &accessor, const QRect &clipRect, int wx, int wy, const quint8 *color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
+    if (!clipRect.contains(wx, wy)) return;
+
+    accessor->moveTo(wx, wy);
+    m_compositeOp->composite(accessor->rawData(), m_pixelSize, color , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
 }
 
-inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::darkenPixel(KisRandomAccessorSP &accessor, const QRect &clipRect, int wx, int wy, const quint8 *color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
+    if (!clipRect.contains(wx, wy)) return;
+
+    accessor->moveTo(wx, wy);
+    if (m_dab->colorSpace()->opacityU8(accessor->rawData()) < m_dab->colorSpace()->opacityU8(color)) {
+        memcpy(accessor->rawData(), color, m_pixelSize);
     }
 }
 
@@ -420,15 +557,16 @@ void HairyBrush::colorifyBristles(KisPaintDeviceSP source, QPointF point)
     KoColor bristleColor(m_dab->colorSpace());
     KisCrossDeviceColorSamplerInt colorSampler(source, bristleColor);
 
-    Bristle *b = 0;
+    const float *bristleX = m_bristles.x();
+    const float *bristleY = m_bristles.y();
+
     int size = m_bristles.size();
     for (int i = 0; i < size; i++) {
-        b = m_bristles[i];
-        int x = qRound(b->x() + point.x());
-        int y = qRound(b->y() + point.y());
+        int x = qRound(bristleX[i] + point.x());
+        int y = qRound(bristleY[i] + point.y());
 
         colorSampler.sampleOldColor(x, y, bristleColor.data());
-        b->setColor(bristleColor);
+        m_bristles.setColor(i, bristleColor);
     }
 
 }
@@ -10,11 +10,13 @@
 #include <QVector>
 #include <QList>
 #include <QTransform>
+#include <QScopedPointer>
 
 #include <KoColor.h>
 
 #include "trajectory.h"
 #include "bristle.h"
+#include "KisHairyBristleMath.h"
 
 #include <kis_paint_device.h>
 #include <brushengine/kis_paint_information.h>
@@ -74,44 +76,60 @@ public:
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
 
 private:
-    /// paints single bristle
-    void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
+    /// the path of a single bristle painted in the current line
+    struct Segment {
+        int bristle;
+        int firstPoint;
+        int numPoints;
+        QRect bounds;
+    };
+
+    /// paints the steps of \p segments, the painting is limited by \p clipRect
+    void paintSegments(KisPaintDeviceSP dab, const QVector<int> &segments, const QRect &clipRect);
+    /// paints single step of a bristle
+    void addBristleInk(KisRandomAccessorSP &accessor, const QRect &clipRect, const QPointF &pos, const quint8 *color, quint8 *scratch);
     /// composite single pixel to dab
-    void plotPixel(int wx, int wy, const KoColor &color);
+    void plotPixel(KisRandomAccessorSP &accessor, const QRect &clipRect, int wx, int wy, const quint8 *color);
     /// check the opacity of dab pixel and if the opacity is less than color, it will copy color to dab
-    void darkenPixel(int wx, int wy, const KoColor &color);
+    void darkenPixel(KisRandomAccessorSP &accessor, const QRect &clipRect, int wx, int wy, const quint8 *color);
     /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
-    void paintParticle(QPointF pos, const KoColor& color, qreal weight);
+    void paintParticle(KisRandomAccessorSP &accessor, const QRect &clipRect, QPointF pos, const quint8 *color, qreal weight);
     /// paint wu particle using composite operation
-    void paintParticle(QPointF pos, const KoColor& color);
+    void paintParticle(KisRandomAccessorSP &accessor, const QRect &clipRect, QPointF pos, const quint8 *color, quint8 *scratch);
     /// similar to sample input color in spray
     void colorifyBristles(KisPaintDeviceSP source, QPointF point);
 
-    void repositionBristles(double angle, double slope);
     /// compute mouse pressure according distance
     double computeMousePressure(double distance);
 
     /// simulate running out of saturation
-    void saturationDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDepletion);
-    /// simulate running out of ink through opacity decreasing
-    void opacityDepletion(Bristle * bristle, KoColor &bristleColor, qreal pressure, qreal inkDepletion);
-    /// fetch actual ink status according depletion curve
-    qreal fetchInkDepletion(Bristle * bristle, int inkDepletionSize);
+    void saturationDepletion(KoColor &bristleColor, qreal saturation);
 
     void initAndCache();
 
 private:
     const KisHairyProperties * m_properties {nullptr};
 
-    QVector<Bristle*> m_bristles;
-    QTransform m_transform;
+    Bristles m_bristles;
+    QScopedPointer<KisHairyBristleMathBase> m_bristleMath;
+    QVector<float> m_inkDepletionCurve;
+
+    // per-line buffers, they are kept to avoid reallocations
+    QVector<float> m_offsetX;
+    QVector<float> m_offsetY;
+    QVector<float> m_endX;
+    QVector<float> m_endY;
+    QVector<float> m_opacities;
+    QVector<float> m_saturations;
+    QVector<Segment> m_segments;
+    QVector<QPointF> m_points;
+    QVector<quint8> m_colors;
 
     // used for interpolation the path of bristles
     Trajectory m_trajectory;
     QHash<QString, QVariant> m_params;
     // temporary device
     KisPaintDeviceSP m_dab;
-    KisRandomAccessorSP m_dabAccessor;
     const KoCompositeOp * m_compositeOp {nullptr};
     quint32 m_pixelSize {0};
 
@@ -9,6 +9,11 @@
 #include "KisCurveOptionData.h"
 #include "kis_algebra_2d.h"
 
+#include <QVarLengthArray>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
 #include <sensors/KisDynamicSensors.h>
 #include <sensors/KisDynamicSensorDrawingAngle.h>
 #include <sensors/KisDynamicSensorDistance.h>
@@ -56,6 +61,33 @@ std::vector<std::unique_ptr<KisDynamicSensor>> generateSensors(const KisCurveOpt
 
     return result;
 }
+
+/**
+ * Combines the values of the scaling sensors according to \p curveMode.
+ * The order of operations is the same for the scalar and batched
+ * versions of computeValueComponents() to get identical results.
+ */
+qreal combineScalingValues(int curveMode, const qreal *begin, const qreal *end)
+{
+    if (end - begin == 1) {
+        return *begin;
+    }
+
+    if (curveMode == 1) {           // add
+        return std::accumulate(begin, end, 0.0);
+    } else if (begin == end) {
+        return 1.0;
+    } else if (curveMode == 2) {    //max
+        return *std::max_element(begin, end);
+    } else if (curveMode == 3) {    //min
+        return *std::min_element(begin, end);
+    } else if (curveMode == 4) {    //difference
+        return *std::max_element(begin, end) - *std::min_element(begin, end);
+    }
+
+    // multiply - default
+    return std::accumulate(begin, end, 1.0, std::multiplies<qreal>());
+}
 }
 
 qreal KisCurveOption::ValueComponents::rotationLikeValue(qreal normalizedBaseAngle, bool absoluteAxesFlipped, qreal scalingPartCoeff, bool disableScalingPart) const {
@@ -104,7 +136,7 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
     ValueComponents components;
 
     if (m_useCurve) {
-        QList<double> sensorValues;
+        QVarLengthArray<qreal, 16> sensorValues;
         for (auto i = m_sensors.cbegin(); i != m_sensors.cend(); ++i) {
             KisDynamicSensor *s(i->get());
 
@@ -116,40 +148,12 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
                 components.absoluteOffset = valueFromCurve;
                 components.hasAbsoluteOffset =true;
             } else {
-                sensorValues << valueFromCurve;
+                sensorValues.append(valueFromCurve);
                 components.hasScaling = true;
             }
         }
 
-        if (sensorValues.count() == 1) {
-            components.scaling = sensorValues.first();
-        } else {
-
-            if (m_curveMode == 1){           // add
-                components.scaling = 0;
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling += i;
-                }
-            } else if (m_curveMode == 2){    //max
-                components.scaling = *std::max_element(sensorValues.begin(), sensorValues.end());
-
-            } else if (m_curveMode == 3){    //min
-                components.scaling = *std::min_element(sensorValues.begin(), sensorValues.end());
-
-            } else if (m_curveMode == 4){    //difference
-                double max = *std::max_element(sensorValues.begin(), sensorValues.end());
-                double min = *std::min_element(sensorValues.begin(), sensorValues.end());
-                components.scaling = max-min;
-
-            } else {                         //multuply - default
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling *= i;
-                }
-            }
-        }
-
+        components.scaling = combineScalingValues(m_curveMode, sensorValues.cbegin(), sensorValues.cend());
     }
 
     if (useStrengthValue) {
@@ -162,12 +166,82 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
     return components;
 }
 
+void KisCurveOption::computeValueComponents(const QVector<KisPaintInformation> &infos, ValueComponents *components, bool useStrengthValue) const
+{
+    const int numSamples = infos.size();
+
+    ValueComponents defaultComponents;
+
+    if (useStrengthValue) {
+        defaultComponents.constant = m_strengthValue;
+    }
+
+    defaultComponents.minSizeLikeValue = m_strengthMinValue;
+    defaultComponents.maxSizeLikeValue = m_strengthMaxValue;
+
+    std::fill(components, components + numSamples, defaultComponents);
+
+    if (!m_useCurve) return;
+
+    int numScalingSensors = 0;
+    for (auto i = m_sensors.cbegin(); i != m_sensors.cend(); ++i) {
+        if (!(*i)->isAdditive() && !(*i)->isAbsoluteRotation()) {
+            numScalingSensors++;
+        }
+    }
+
+    // the scaling values of every sample are stored together to be combined later
+    std::vector<qreal> scalingValues(numSamples * numScalingSensors);
+    std::vector<qreal> sensorValues(numSamples);
+
+    int scalingIndex = 0;
+
+    for (auto i = m_sensors.cbegin(); i != m_sensors.cend(); ++i) {
+        KisDynamicSensor *s(i->get());
+
+        s->parameters(infos, sensorValues.data());
+
+        if (s->isAdditive()) {
+            for (int j = 0; j < numSamples; j++) {
+                components[j].additive += sensorValues[j];
+                components[j].hasAdditive = true;
+            }
+        } else if (s->isAbsoluteRotation()) {
+            for (int j = 0; j < numSamples; j++) {
+                components[j].absoluteOffset = sensorValues[j];
+                components[j].hasAbsoluteOffset = true;
+            }
+        } else {
+            for (int j = 0; j < numSamples; j++) {
+                scalingValues[j * numScalingSensors + scalingIndex] = sensorValues[j];
+                components[j].hasScaling = true;
+            }
+            scalingIndex++;
+        }
+    }
+
+    for (int j = 0; j < numSamples; j++) {
+        const qreal *begin = scalingValues.data() + j * numScalingSensors;
+        components[j].scaling = combineScalingValues(m_curveMode, begin, begin + numScalingSensors);
+    }
+}
+
 qreal KisCurveOption::computeSizeLikeValue(const KisPaintInformation& info, bool useStrengthValue) const
 {
     const ValueComponents components = computeValueComponents(info, useStrengthValue);
     return components.sizeLikeValue();
 }
 
+void KisCurveOption::computeSizeLikeValues(const QVector<KisPaintInformation> &infos, qreal *values, bool useStrengthValue) const
+{
+    std::vector<ValueComponents> components(infos.size());
+    computeValueComponents(infos, components.data(), useStrengthValue);
+
+    for (int i = 0; i < infos.size(); i++) {
+        values[i] = components[i].sizeLikeValue();
+    }
+}
+
 qreal KisCurveOption::computeRotationLikeValue(const KisPaintInformation& info, qreal baseValue, bool absoluteAxesFlipped, qreal scalingPartCoeff, bool disableScalingPart) const
 {
     const ValueComponents components = computeValueComponents(info, true);
@@ -202,3 +276,8 @@ bool KisCurveOption::isRandom() const
     }
     return false;
 }
+
+bool KisCurveOption::dependsOnPaintInformation() const
+{
+    return m_useCurve && !m_sensors.empty();
+}
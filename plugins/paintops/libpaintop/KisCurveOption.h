@@ -55,6 +55,23 @@ public:
     qreal computeSizeLikeValue(const KisPaintInformation &info, bool useStrengthValue = true) const;
     qreal computeRotationLikeValue(const KisPaintInformation& info, qreal baseValue, bool absoluteAxesFlipped, qreal scalingPartCoeff, bool disableScalingPart) const;
 
+    /**
+     * Batched version of computeValueComponents(). The sensors are
+     * evaluated one by one for the whole batch of \p infos, the result
+     * is written into \p components.
+     *
+     * The random sensors use the random source of the paint information
+     * sequentially, so the batched version should not be used for random
+     * options (see isRandom()), otherwise the random values will be
+     * consumed in a different order.
+     */
+    void computeValueComponents(const QVector<KisPaintInformation> &infos, ValueComponents *components, bool useStrengthValue) const;
+
+    /**
+     * Batched version of computeSizeLikeValue()
+     */
+    void computeSizeLikeValues(const QVector<KisPaintInformation> &infos, qreal *values, bool useStrengthValue = true) const;
+
     qreal strengthValue() const;
     qreal strengthMinValue() const;
     qreal strengthMaxValue() const;
@@ -62,6 +79,13 @@ public:
     bool isChecked() const;
     bool isRandom() const;
 
+    /**
+     * \return true if the option has any active sensors, that is, its
+     * value may change from dab to dab. Please take into account that
+     * the check ignores isChecked() state of the option.
+     */
+    bool dependsOnPaintInformation() const;
+
 private:
     bool m_isChecked;
     bool m_useCurve;
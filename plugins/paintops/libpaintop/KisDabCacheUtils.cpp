@@ -47,6 +47,19 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
     KIS_SAFE_ASSERT_RECOVER_RETURN(*dab);
     const KoColorSpace *cs = (*dab)->colorSpace();
 
+    const bool usePersistentCache = di.usePersistentCache && !forceNormalizedRGBAImageStamp;
+    KisPersistentDabCache::Key persistentCacheKey;
+
+    if (usePersistentCache) {
+        persistentCacheKey = di.persistentCacheKey;
+        persistentCacheKey.colorSpace = cs;
+
+        KisFixedPaintDeviceSP cachedDab = KisPersistentDabCache::instance()->fetch(persistentCacheKey);
+        if (cachedDab) {
+            **dab = *cachedDab;
+            return;
+        }
+    }
 
     if (forceNormalizedRGBAImageStamp || resources->brush->brushApplication() == IMAGESTAMP) {
         *dab = resources->brush->paintDevice(cs, di.shape, di.info,
@@ -88,6 +101,10 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
         (*dab)->mirror(di.mirrorProperties.horizontalMirror,
                        di.mirrorProperties.verticalMirror);
     }
+
+    if (usePersistentCache) {
+        KisPersistentDabCache::instance()->insert(persistentCacheKey, new KisFixedPaintDevice(**dab));
+    }
 }
 
 void postProcessDab(KisFixedPaintDeviceSP dab,
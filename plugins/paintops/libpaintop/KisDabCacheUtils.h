@@ -16,6 +16,7 @@
 #include <kis_paint_information.h>
 #include <KisMirrorProperties.h>
 #include "kis_dab_shape.h"
+#include "KisPersistentDabCache.h"
 
 #include "kritapaintop_export.h"
 #include <functional>
@@ -93,6 +94,14 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal lightnessStrength = 1.0;
 
     bool needsPostprocessing = false;
+
+    /**
+     * If true, the dab may be fetched from (and is stored into)
+     * KisPersistentDabCache. The color space of the key is filled
+     * by generateDab()
+     */
+    bool usePersistentCache = false;
+    KisPersistentDabCache::Key persistentCacheKey;
 };
 
 PAINTOP_EXPORT QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
@@ -42,5 +42,25 @@ void KisFlowOpacityOption2::apply(const KisPaintInformation &info, quint8 *opaci
     *flow = quint8(m_flowOption.apply(info) * 255.0);
 }
 
+void KisFlowOpacityOption2::apply(const QVector<KisPaintInformation> &infos, quint8 *opacity, quint8 *flow)
+{
+    std::vector<qreal> values(infos.size());
+
+    m_opacityOption.computeSizeLikeValues(infos, values.data(), !m_indirectPaintingActive);
+    for (int i = 0; i < infos.size(); i++) {
+        opacity[i] = quint8(values[i] * 255.0);
+    }
+
+    m_flowOption.apply(infos, values.data());
+    for (int i = 0; i < infos.size(); i++) {
+        flow[i] = quint8(values[i] * 255.0);
+    }
+}
+
+bool KisFlowOpacityOption2::isRandom() const
+{
+    return m_opacityOption.isRandom() || m_flowOption.isRandom();
+}
+
 
 
@@ -18,6 +18,14 @@ public:
     void apply(KisPainter* painter, const KisPaintInformation& info);
     void apply(const KisPaintInformation &info, quint8 *opacity, quint8 *flow);
 
+    /**
+     * Batched version of apply(). Should be used for non-random
+     * options only, see KisCurveOption::computeValueComponents()
+     */
+    void apply(const QVector<KisPaintInformation> &infos, quint8 *opacity, quint8 *flow);
+
+    bool isRandom() const;
+
 private:
     KisOpacityOption m_opacityOption;
     KisFlowOption m_flowOption;
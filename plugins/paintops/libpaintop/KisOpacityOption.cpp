@@ -7,6 +7,14 @@
 
 #include <kis_painter.h>
 
+namespace {
+quint8 scaleOpacity(quint8 origOpacity, qreal value)
+{
+    qreal opacity = (qreal)(origOpacity * value);
+    return (quint8)qRound(qBound<qreal>(OPACITY_TRANSPARENT_U8, opacity, OPACITY_OPAQUE_U8));
+}
+}
+
 quint8 KisOpacityOption::apply(KisPainter* painter, const KisPaintInformation& info) const
 {
     if (!isChecked()) {
@@ -14,9 +22,23 @@ quint8 KisOpacityOption::apply(KisPainter* painter, const KisPaintInformation& i
     }
     quint8 origOpacity = painter->opacity();
 
-    qreal opacity = (qreal)(origOpacity * computeSizeLikeValue(info));
-    quint8 opacity2 = (quint8)qRound(qBound<qreal>(OPACITY_TRANSPARENT_U8, opacity, OPACITY_OPAQUE_U8));
+    quint8 opacity2 = scaleOpacity(origOpacity, computeSizeLikeValue(info));
 
     painter->setOpacityUpdateAverage(opacity2);
     return origOpacity;
 }
+
+void KisOpacityOption::apply(quint8 origOpacity, const QVector<KisPaintInformation> &infos, quint8 *opacities) const
+{
+    if (!isChecked()) {
+        std::fill(opacities, opacities + infos.size(), origOpacity);
+        return;
+    }
+
+    std::vector<qreal> values(infos.size());
+    computeSizeLikeValues(infos, values.data());
+
+    for (int i = 0; i < infos.size(); i++) {
+        opacities[i] = scaleOpacity(origOpacity, values[i]);
+    }
+}
@@ -19,6 +19,13 @@ public:
     using BaseClass::apply;
 
     quint8 apply(KisPainter* painter, const KisPaintInformation& info) const;
+
+    /**
+     * Batched version of apply(painter, info). Calculates the opacity
+     * the painter should be set to for each dab, the painter itself is
+     * not changed. Should not be used when the option is random.
+     */
+    void apply(quint8 origOpacity, const QVector<KisPaintInformation> &infos, quint8 *opacities) const;
 };
 
 #endif // KISOPACITYOPTION_H
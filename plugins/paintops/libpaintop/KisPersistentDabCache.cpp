@@ -0,0 +1,227 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPersistentDabCache.h"
+
+#include <list>
+
+#include <QGlobalStatic>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <KoColorSpace.h>
+#include <kis_assert.h>
+#include <kis_fixed_paint_device.h>
+
+
+namespace {
+
+/**
+ * The default limit is enough to keep the masks of a few
+ * huge brushes or of a few hundreds of the average ones
+ */
+const qint64 defaultMaxMemoryUsage = 64 * 1024 * 1024;
+
+inline void combineHash(uint &seed, uint value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+inline qint64 dabMemoryUsage(KisFixedPaintDeviceSP dab)
+{
+    const QRect bounds = dab->bounds();
+    return qint64(bounds.width()) * bounds.height() * dab->pixelSize();
+}
+
+}
+
+bool KisPersistentDabCache::Key::operator==(const Key &rhs) const
+{
+    return brushIndex == rhs.brushIndex &&
+        colorSpace == rhs.colorSpace &&
+        width == rhs.width &&
+        height == rhs.height &&
+        angle == rhs.angle &&
+        subPixelX == rhs.subPixelX &&
+        subPixelY == rhs.subPixelY &&
+        softnessFactor == rhs.softnessFactor &&
+        lightnessStrength == rhs.lightnessStrength &&
+        ratio == rhs.ratio &&
+        horizontalMirror == rhs.horizontalMirror &&
+        verticalMirror == rhs.verticalMirror &&
+        color == rhs.color &&
+        brushKey == rhs.brushKey;
+}
+
+uint qHash(const KisPersistentDabCache::Key &key, uint seed)
+{
+    uint result = qHash(key.brushKey, seed);
+
+    combineHash(result, qHash(key.brushIndex));
+    combineHash(result, qHash(reinterpret_cast<quintptr>(key.colorSpace)));
+    combineHash(result, qHashBits(key.color.data(), key.color.colorSpace()->pixelSize()));
+    combineHash(result, qHash(key.width));
+    combineHash(result, qHash(key.height));
+    combineHash(result, qHash(key.angle));
+    combineHash(result, qHash(key.subPixelX));
+    combineHash(result, qHash(key.subPixelY));
+    combineHash(result, qHash(key.softnessFactor));
+    combineHash(result, qHash(key.lightnessStrength));
+    combineHash(result, qHash(key.ratio));
+    combineHash(result, uint(key.horizontalMirror) | (uint(key.verticalMirror) << 1));
+
+    return result;
+}
+
+qreal KisPersistentDabCache::Statistics::hitRate() const
+{
+    const qint64 requests = hits + misses;
+    return requests > 0 ? qreal(hits) / requests : 0.0;
+}
+
+struct KisPersistentDabCache::Private
+{
+    struct Entry {
+        Key key;
+        KisFixedPaintDeviceSP dab;
+        qint64 memoryUsage = 0;
+    };
+
+    /// the most recently used entries are kept at the front
+    typedef std::list<Entry> EntriesList;
+
+    void evictEntries(qint64 maxMemoryUsage);
+
+    mutable QMutex mutex;
+
+    EntriesList entries;
+    QHash<Key, EntriesList::iterator> index;
+
+    qint64 maxMemoryUsage = defaultMaxMemoryUsage;
+    qint64 memoryUsage = 0;
+
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 evictions = 0;
+};
+
+void KisPersistentDabCache::Private::evictEntries(qint64 maxMemoryUsage)
+{
+    while (!entries.empty() && memoryUsage > maxMemoryUsage) {
+        const Entry &entry = entries.back();
+
+        memoryUsage -= entry.memoryUsage;
+        index.remove(entry.key);
+        entries.pop_back();
+
+        evictions++;
+    }
+}
+
+Q_GLOBAL_STATIC(KisPersistentDabCache, s_instance)
+
+KisPersistentDabCache::KisPersistentDabCache()
+    : m_d(new Private)
+{
+}
+
+KisPersistentDabCache::~KisPersistentDabCache()
+{
+}
+
+KisPersistentDabCache *KisPersistentDabCache::instance()
+{
+    return s_instance;
+}
+
+KisFixedPaintDeviceSP KisPersistentDabCache::fetch(const Key &key)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    auto it = m_d->index.find(key);
+    if (it == m_d->index.end()) {
+        m_d->misses++;
+        return KisFixedPaintDeviceSP();
+    }
+
+    m_d->hits++;
+
+    // move the entry to the front of the LRU list
+    m_d->entries.splice(m_d->entries.begin(), m_d->entries, *it);
+    return (*it)->dab;
+}
+
+void KisPersistentDabCache::insert(const Key &key, KisFixedPaintDeviceSP dab)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(dab);
+
+    const qint64 memoryUsage = dabMemoryUsage(dab);
+
+    QMutexLocker l(&m_d->mutex);
+
+    if (memoryUsage > m_d->maxMemoryUsage) return;
+
+    auto it = m_d->index.find(key);
+    if (it != m_d->index.end()) {
+        // another thread has generated the same dab
+        m_d->entries.splice(m_d->entries.begin(), m_d->entries, *it);
+        return;
+    }
+
+    m_d->entries.push_front(Private::Entry{key, dab, memoryUsage});
+    m_d->index.insert(key, m_d->entries.begin());
+    m_d->memoryUsage += memoryUsage;
+
+    m_d->evictEntries(m_d->maxMemoryUsage);
+}
+
+void KisPersistentDabCache::setMaxMemoryUsage(qint64 bytes)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->maxMemoryUsage = bytes;
+    m_d->evictEntries(m_d->maxMemoryUsage);
+}
+
+qint64 KisPersistentDabCache::maxMemoryUsage() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->maxMemoryUsage;
+}
+
+KisPersistentDabCache::Statistics KisPersistentDabCache::statistics() const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    Statistics stats;
+    stats.hits = m_d->hits;
+    stats.misses = m_d->misses;
+    stats.evictions = m_d->evictions;
+    stats.numEntries = m_d->index.size();
+    stats.memoryUsage = m_d->memoryUsage;
+    stats.maxMemoryUsage = m_d->maxMemoryUsage;
+
+    return stats;
+}
+
+void KisPersistentDabCache::resetStatistics()
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->hits = 0;
+    m_d->misses = 0;
+    m_d->evictions = 0;
+}
+
+void KisPersistentDabCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->index.clear();
+    m_d->entries.clear();
+    m_d->memoryUsage = 0;
+}
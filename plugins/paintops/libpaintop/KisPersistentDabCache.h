@@ -0,0 +1,116 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPERSISTENTDABCACHE_H
+#define KISPERSISTENTDABCACHE_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+
+#include <KoColor.h>
+#include <kis_types.h>
+
+#include "kritapaintop_export.h"
+
+class KoColorSpace;
+
+
+/**
+ * @brief A process-wide LRU cache of the brush masks
+ *
+ * KisDabCache and KisDabRenderingQueueCache can reuse only the dab that
+ * was generated right before the current one. This cache keeps the masks
+ * between the strokes and is shared by all the paintops, so switching
+ * between a few presets or repeating similar strokes doesn't regenerate
+ * the same masks over and over again.
+ *
+ * The masks are keyed by the identity of the brush (its MD5 sum and its
+ * serialized parameters) and by the shape parameters of the dab, quantized
+ * according to the precision level of the paintop (see KisDabCacheBase).
+ * The masks are stored before any postprocessing (texturing, sharpness),
+ * because the postprocessing depends on the position of the dab.
+ *
+ * The cache is bounded by the amount of memory the masks occupy. When the
+ * limit is reached, the least recently used masks are evicted.
+ *
+ * All the methods are thread-safe.
+ */
+class PAINTOP_EXPORT KisPersistentDabCache
+{
+public:
+    struct PAINTOP_EXPORT Key {
+        QByteArray brushKey;
+        int brushIndex = 0;
+
+        /// the color space of the generated dab
+        const KoColorSpace *colorSpace = nullptr;
+        KoColor color;
+
+        int width = 0;
+        int height = 0;
+
+        // the values quantized by the precision level
+        qint64 angle = 0;
+        qint64 subPixelX = 0;
+        qint64 subPixelY = 0;
+        qint64 softnessFactor = 0;
+        qint64 lightnessStrength = 0;
+        qint64 ratio = 0;
+
+        bool horizontalMirror = false;
+        bool verticalMirror = false;
+
+        bool operator==(const Key &rhs) const;
+    };
+
+    struct PAINTOP_EXPORT Statistics {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+
+        int numEntries = 0;
+        qint64 memoryUsage = 0;
+        qint64 maxMemoryUsage = 0;
+
+        /// the ratio of hits to the total number of requests
+        qreal hitRate() const;
+    };
+
+public:
+    KisPersistentDabCache();
+    ~KisPersistentDabCache();
+
+    static KisPersistentDabCache* instance();
+
+    /**
+     * Returns a cached mask for \p key or null if there is no such mask.
+     * The returned device is shared with the cache, so it must not be
+     * modified. The request is accounted in the hit-rate statistics.
+     */
+    KisFixedPaintDeviceSP fetch(const Key &key);
+
+    /**
+     * Puts \p dab into the cache. The cache takes ownership over the
+     * device, so the caller must not modify it afterwards.
+     */
+    void insert(const Key &key, KisFixedPaintDeviceSP dab);
+
+    void setMaxMemoryUsage(qint64 bytes);
+    qint64 maxMemoryUsage() const;
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+    void clear();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+PAINTOP_EXPORT uint qHash(const KisPersistentDabCache::Key &key, uint seed = 0);
+
+#endif // KISPERSISTENTDABCACHE_H
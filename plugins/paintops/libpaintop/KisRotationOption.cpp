@@ -52,6 +52,31 @@ qreal KisRotationOption::apply(const KisPaintInformation & info) const
     return normalizeAngle(value * M_PI);
  }
 
+void KisRotationOption::apply(const QVector<KisPaintInformation> &infos, qreal *values) const
+{
+    if (!isChecked()) {
+        for (int i = 0; i < infos.size(); i++) {
+            values[i] = kisDegreesToRadians(infos[i].canvasRotation());
+        }
+        return;
+    }
+
+    std::vector<ValueComponents> components(infos.size());
+    computeValueComponents(infos, components.data(), true);
+
+    for (int i = 0; i < infos.size(); i++) {
+        const KisPaintInformation &info = infos[i];
+
+        const bool absoluteAxesFlipped = info.canvasMirroredH() != info.canvasMirroredV();
+        const qreal normalizedBaseAngle = -info.canvasRotation() / 360.0;
+
+        qreal value = components[i].rotationLikeValue(normalizedBaseAngle, absoluteAxesFlipped, -1.0, info.isHoveringMode());
+        value = 1.0 - value;
+
+        values[i] = normalizeAngle(value * M_PI);
+    }
+}
+
 void KisRotationOption::applyFanCornersInfo(KisPaintOp *op)
 {
     if (!this->isChecked()) return;
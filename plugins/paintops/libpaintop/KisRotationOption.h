@@ -16,6 +16,7 @@ public:
     KisRotationOption(const KisPropertiesConfiguration *setting);
 
     qreal apply(const KisPaintInformation & info) const;
+    void apply(const QVector<KisPaintInformation> &infos, qreal *values) const;
     void applyFanCornersInfo(KisPaintOp *op);
 
 private:
@@ -29,6 +29,15 @@ public:
         if (!isChecked()) return 1.0;
         return computeSizeLikeValue(info);
     }
+
+    void apply(const QVector<KisPaintInformation> &infos, qreal *values) const
+    {
+        if (!isChecked()) {
+            std::fill(values, values + infos.size(), 1.0);
+            return;
+        }
+        computeSizeLikeValues(infos, values);
+    }
 };
 
 template <typename Data>
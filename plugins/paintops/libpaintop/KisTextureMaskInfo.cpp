@@ -107,6 +107,10 @@ QRect KisTextureMaskInfo::maskBounds() const {
     return m_maskBounds;
 }
 
+const quint8* KisTextureMaskInfo::flatMask() const {
+    return !m_flatMask.isEmpty() ? m_flatMask.constData() : nullptr;
+}
+
 bool KisTextureMaskInfo::fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface)
 {
     KisTextureOptionData data;
@@ -240,6 +244,13 @@ void KisTextureMaskInfo::recalculateMask()
         m_mask->convertFromQImage(mask, 0);
     }
     m_maskBounds = QRect(0, 0, width, height);
+
+    if (useAlpha) {
+        m_flatMask.clear();
+    } else {
+        m_flatMask.resize(width * height);
+        m_mask->readBytes(m_flatMask.data(), m_maskBounds);
+    }
 }
 
 bool KisTextureMaskInfo::hasAlpha() {
@@ -260,13 +271,23 @@ KisTextureMaskInfoCache *KisTextureMaskInfoCache::instance()
 KisTextureMaskInfoSP KisTextureMaskInfoCache::fetchCachedTextureInfo(KisTextureMaskInfoSP info) {
     QMutexLocker locker(&m_mutex);
 
-    KisTextureMaskInfoSP &cachedInfo =
-            info->levelOfDetail() > 0 ? m_lodInfo : m_mainInfo;
+    QList<KisTextureMaskInfoSP> &cachedInfos =
+            info->levelOfDetail() > 0 ? m_lodInfos : m_mainInfos;
+
+    for (int i = 0; i < cachedInfos.size(); i++) {
+        if (*cachedInfos[i] == *info) {
+            // move the info to the front of the LRU list
+            cachedInfos.move(i, 0);
+            return cachedInfos.first();
+        }
+    }
+
+    info->recalculateMask();
+    cachedInfos.prepend(info);
 
-    if (!cachedInfo || *cachedInfo != *info) {
-        cachedInfo = info;
-        cachedInfo->recalculateMask();
+    while (cachedInfos.size() > maxCachedInfos) {
+        cachedInfos.removeLast();
     }
 
-    return cachedInfo;
+    return info;
 }
@@ -11,6 +11,7 @@
 #include <kis_paint_device.h>
 #include <QSharedPointer>
 #include <QMutex>
+#include <QVector>
 
 
 #include <boost/operators.hpp>
@@ -42,6 +43,13 @@ public:
 
     QRect maskBounds() const;
 
+    /**
+     * The mask stored as a contiguous array of 8-bit alpha values with
+     * rows of maskBounds().width() pixels. The array is available for
+     * the masks that don't preserve alpha only, otherwise null is returned.
+     */
+    const quint8* flatMask() const;
+
     bool fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface);
 
     void recalculateMask();
@@ -66,6 +74,7 @@ private:
 
     KisPaintDeviceSP m_mask;
     QRect m_maskBounds;
+    QVector<quint8> m_flatMask;
 
 };
 
@@ -77,9 +86,15 @@ struct KisTextureMaskInfoCache
     KisTextureMaskInfoSP fetchCachedTextureInfo(KisTextureMaskInfoSP info);
 
 private:
+    /**
+     * The masks of a few recently used textures are kept, so
+     * switching between the presets doesn't regenerate them
+     */
+    static const int maxCachedInfos = 4;
+
     QMutex m_mutex;
-    QSharedPointer<KisTextureMaskInfo> m_lodInfo;
-    QSharedPointer<KisTextureMaskInfo> m_mainInfo;
+    QList<KisTextureMaskInfoSP> m_lodInfos;
+    QList<KisTextureMaskInfoSP> m_mainInfos;
 };
 
 #endif // KISTEXTUREMASKINFO_H
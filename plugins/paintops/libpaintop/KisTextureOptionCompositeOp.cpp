@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTextureOptionCompositeOp.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+KisMaskingBrushCompositeOpBase *KisTextureOptionCompositeOpFactory::create(KisTextureOptionData::TexturingMode mode, qreal strength)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return createOptimizedClass<KisTextureOptionCompositeOpFactoryImpl>(mode, strength);
+#else
+    // the kernels access the alpha channel as the most significant byte of a 32-bit word
+    Q_UNUSED(mode);
+    Q_UNUSED(strength);
+    return nullptr;
+#endif
+}
@@ -0,0 +1,45 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTEXTUREOPTIONCOMPOSITEOP_H
+#define KISTEXTUREOPTIONCOMPOSITEOP_H
+
+#include <QtGlobal>
+
+#include <KisTextureOptionData.h>
+
+#include "kritapaintop_export.h"
+
+class KisMaskingBrushCompositeOpBase;
+
+/**
+ * @brief Creates optimized composite ops for KisTextureOption
+ *
+ * The ops apply an 8-bit texture mask to the alpha channel of a dab
+ * with 8-bit BGRA pixels, which is the most common format of the
+ * dabs. They give exactly the same results as the ops created by
+ * KisMaskingBrushCompositeOpFactory::createForAlphaSrc(), but every
+ * texturing mode has a separate kernel compiled for every supported
+ * CPU architecture.
+ *
+ * The ops are implemented for the multiply, subtract and all the
+ * height texturing modes. For other modes the factory returns null,
+ * and the caller should fall back to the generic ops.
+ */
+class PAINTOP_EXPORT KisTextureOptionCompositeOpFactory
+{
+public:
+    static KisMaskingBrushCompositeOpBase* create(KisTextureOptionData::TexturingMode mode, qreal strength);
+};
+
+class KisTextureOptionCompositeOpFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisMaskingBrushCompositeOpBase* create(KisTextureOptionData::TexturingMode mode, qreal strength);
+};
+
+#endif // KISTEXTUREOPTIONCOMPOSITEOP_H
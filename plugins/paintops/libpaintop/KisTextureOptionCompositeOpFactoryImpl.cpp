@@ -0,0 +1,39 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTextureOptionCompositeOp.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisTextureOptionCompositeOpImpl.h"
+
+template<>
+KisMaskingBrushCompositeOpBase *
+KisTextureOptionCompositeOpFactoryImpl::create<xsimd::current_arch>(KisTextureOptionData::TexturingMode mode, qreal strength)
+{
+    using namespace KisTextureOptionCompositeOpDetail;
+    using _impl = xsimd::current_arch;
+
+    switch (mode) {
+    case KisTextureOptionData::MULTIPLY:
+        return new KisTextureOptionMultiplyOp<_impl>(strength);
+    case KisTextureOptionData::SUBTRACT:
+        return new KisTextureOptionHeightOp<_impl, false>(subtractTable(strength));
+    case KisTextureOptionData::HEIGHT:
+        return new KisTextureOptionHeightOp<_impl, false>(heightTable(strength));
+    case KisTextureOptionData::LINEAR_HEIGHT:
+        return new KisTextureOptionHeightOp<_impl, true>(heightTable(strength));
+    case KisTextureOptionData::HEIGHT_PHOTOSHOP:
+        return new KisTextureOptionHeightOp<_impl, false>(heightPhotoshopTable(strength));
+    case KisTextureOptionData::LINEAR_HEIGHT_PHOTOSHOP:
+        return new KisTextureOptionHeightOp<_impl, true>(heightPhotoshopTable(strength));
+    default:
+        return nullptr;
+    }
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,314 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTEXTUREOPTIONCOMPOSITEOPIMPL_H
+#define KISTEXTUREOPTIONCOMPOSITEOPIMPL_H
+
+#include "KisTextureOptionCompositeOp.h"
+
+#include <type_traits>
+
+#include <KoColorSpaceMaths.h>
+#include <KoIntegerMaths.h>
+#include <strokes/KisMaskingBrushCompositeOpBase.h>
+
+#include "KoAlwaysInline.h"
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+namespace KisTextureOptionCompositeOpDetail
+{
+
+/// the size of the BGRA8 pixel of the dab
+static constexpr int pixelSize = 4;
+
+/// the offset of the alpha channel in the BGRA8 pixel
+static constexpr int alphaOffset = 3;
+
+/**
+ * All the height-like modes (including subtract) can be written as
+ * `f(table[dst], src)`, where the table depends on the strength only,
+ * so it is calculated once per dab
+ */
+struct HeightTable {
+    int values[256];
+};
+
+namespace {
+
+/// KIS_MASKING_BRUSH_COMPOSITE_SUBTRACT: dst - inv(strength)
+inline HeightTable subtractTable(qreal strength)
+{
+    const int invertedStrength = 255 - KoColorSpaceMaths<qreal, quint8>::scaleToA(strength);
+
+    HeightTable table;
+    for (int i = 0; i < 256; i++) {
+        table.values[i] = i - invertedStrength;
+    }
+    return table;
+}
+
+/// KIS_MASKING_BRUSH_COMPOSITE_HEIGHT: div(dst, inv(strength)) - inv(strength)
+inline HeightTable heightTable(qreal strength)
+{
+    const int invertedStrength = 255 - KoColorSpaceMaths<qreal, quint8>::scaleToA(0.99 * strength);
+
+    HeightTable table;
+    for (int i = 0; i < 256; i++) {
+        table.values[i] = int(UINT8_DIVIDE(i, invertedStrength)) - invertedStrength;
+    }
+    return table;
+}
+
+/// KIS_MASKING_BRUSH_COMPOSITE_HEIGHT_PHOTOSHOP: dst * 10 * strength / unit
+inline HeightTable heightPhotoshopTable(qreal strength)
+{
+    const int weight = 10 * int(KoColorSpaceMaths<qreal, quint8>::scaleToA(strength));
+
+    HeightTable table;
+    for (int i = 0; i < 256; i++) {
+        table.values[i] = i * weight / 255;
+    }
+    return table;
+}
+
+}
+
+/**
+ * Generic scalar implementation of the multiply texturing mode. It
+ * is used for the `xsimd::generic` architecture and as a tail-processor
+ * for the vectorized version.
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KisTextureOptionMultiplyOp : public KisMaskingBrushCompositeOpBase
+{
+public:
+    KisTextureOptionMultiplyOp(qreal strength)
+        : m_strength(KoColorSpaceMaths<qreal, quint8>::scaleToA(strength))
+    {
+    }
+
+    void composite(const quint8 *srcRowStart, int srcRowStride,
+                   quint8 *dstRowStart, int dstRowStride,
+                   int columns, int rows) override
+    {
+        for (int y = 0; y < rows; y++) {
+            compositeRowScalar(srcRowStart, dstRowStart, columns);
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
+protected:
+    ALWAYS_INLINE void compositeRowScalar(const quint8 *src, quint8 *dst, int columns) const
+    {
+        dst += alphaOffset;
+
+        for (int x = 0; x < columns; x++) {
+            *dst = UINT8_MULT3(*src, *dst, m_strength);
+
+            src++;
+            dst += pixelSize;
+        }
+    }
+
+protected:
+    const quint8 m_strength;
+};
+
+/**
+ * Generic scalar implementation of the height-like texturing modes
+ * (subtract, height, linear height and their Photoshop versions)
+ */
+template<typename _impl, bool linear, typename EnableDummyType = void>
+class KisTextureOptionHeightOp : public KisMaskingBrushCompositeOpBase
+{
+public:
+    KisTextureOptionHeightOp(const HeightTable &table)
+        : m_table(table)
+    {
+    }
+
+    void composite(const quint8 *srcRowStart, int srcRowStride,
+                   quint8 *dstRowStart, int dstRowStride,
+                   int columns, int rows) override
+    {
+        for (int y = 0; y < rows; y++) {
+            compositeRowScalar(srcRowStart, dstRowStart, columns);
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
+protected:
+    ALWAYS_INLINE void compositeRowScalar(const quint8 *src, quint8 *dst, int columns) const
+    {
+        dst += alphaOffset;
+
+        for (int x = 0; x < columns; x++) {
+            const int modifiedDst = m_table.values[*dst];
+            int result = modifiedDst - *src;
+
+            if (linear) {
+                const int multiply = modifiedDst * (255 - *src) / 255;
+                result = qMax(multiply, result);
+            }
+
+            *dst = quint8(qBound(0, result, 255));
+
+            src++;
+            dst += pixelSize;
+        }
+    }
+
+protected:
+    const HeightTable m_table;
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+template<typename _impl>
+struct AlphaChannelAccessor
+{
+    using int_v = xsimd::batch<int, _impl>;
+    using uint_v = xsimd::batch<unsigned int, _impl>;
+
+    static ALWAYS_INLINE uint_v loadPixels(const quint8 *dst)
+    {
+        return uint_v::load_unaligned(reinterpret_cast<const quint32*>(dst));
+    }
+
+    static ALWAYS_INLINE int_v alpha(const uint_v &pixels)
+    {
+        return xsimd::bitwise_cast<int_v>(pixels >> 24);
+    }
+
+    /// \p alpha must be in range [0, 255]
+    static ALWAYS_INLINE void storePixels(const uint_v &pixels, const int_v &alpha, quint8 *dst)
+    {
+        const uint_v result = (pixels & uint_v(0x00FFFFFFu)) | (xsimd::bitwise_cast<uint_v>(alpha) << 24);
+        result.store_unaligned(reinterpret_cast<quint32*>(dst));
+    }
+};
+
+template<typename _impl>
+class KisTextureOptionMultiplyOp<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisTextureOptionMultiplyOp<xsimd::generic>
+{
+    using int_v = xsimd::batch<int, _impl>;
+    using uint_v = xsimd::batch<unsigned int, _impl>;
+    using accessor = AlphaChannelAccessor<_impl>;
+
+public:
+    KisTextureOptionMultiplyOp(qreal strength)
+        : KisTextureOptionMultiplyOp<xsimd::generic>(strength)
+    {
+    }
+
+    void composite(const quint8 *srcRowStart, int srcRowStride,
+                   quint8 *dstRowStart, int dstRowStride,
+                   int columns, int rows) override
+    {
+        const int_v strength(m_strength);
+        const int_v roundingOffset(0x7F5B);
+
+        for (int y = 0; y < rows; y++) {
+            const quint8 *src = srcRowStart;
+            quint8 *dst = dstRowStart;
+
+            int x = 0;
+            for (; x + static_cast<int>(int_v::size) <= columns; x += int_v::size) {
+                const uint_v pixels = accessor::loadPixels(dst);
+                const int_v srcAlpha = xsimd::load_and_extend<int_v>(src);
+
+                // the same as UINT8_MULT3()
+                const int_v t = srcAlpha * accessor::alpha(pixels) * strength + roundingOffset;
+                accessor::storePixels(pixels, ((t >> 7) + t) >> 16, dst);
+
+                src += int_v::size;
+                dst += int_v::size * pixelSize;
+            }
+
+            this->compositeRowScalar(src, dst, columns - x);
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+};
+
+template<typename _impl, bool linear>
+class KisTextureOptionHeightOp<
+        _impl,
+        linear,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisTextureOptionHeightOp<xsimd::generic, linear>
+{
+    using int_v = xsimd::batch<int, _impl>;
+    using uint_v = xsimd::batch<unsigned int, _impl>;
+    using float_v = xsimd::batch<float, _impl>;
+    using accessor = AlphaChannelAccessor<_impl>;
+
+public:
+    KisTextureOptionHeightOp(const HeightTable &table)
+        : KisTextureOptionHeightOp<xsimd::generic, linear>(table)
+    {
+    }
+
+    void composite(const quint8 *srcRowStart, int srcRowStride,
+                   quint8 *dstRowStart, int dstRowStride,
+                   int columns, int rows) override
+    {
+        const int_v zero(0);
+        const int_v unit(255);
+        const float_v unitF(255.0f);
+
+        for (int y = 0; y < rows; y++) {
+            const quint8 *src = srcRowStart;
+            quint8 *dst = dstRowStart;
+
+            int x = 0;
+            for (; x + static_cast<int>(int_v::size) <= columns; x += int_v::size) {
+                const uint_v pixels = accessor::loadPixels(dst);
+                const int_v srcAlpha = xsimd::load_and_extend<int_v>(src);
+
+                const int_v modifiedDst = int_v::gather(this->m_table.values, accessor::alpha(pixels));
+                int_v result = modifiedDst - srcAlpha;
+
+                if (linear) {
+                    /**
+                     * The product fits into 24 bits, so the float division
+                     * gives exactly the same result as the integer one
+                     */
+                    const int_v product = modifiedDst * (unit - srcAlpha);
+                    const int_v multiply = xsimd::batch_cast<int>(xsimd::batch_cast<float>(product) / unitF);
+                    result = xsimd::max(multiply, result);
+                }
+
+                accessor::storePixels(pixels, xsimd::min(xsimd::max(result, zero), unit), dst);
+
+                src += int_v::size;
+                dst += int_v::size * pixelSize;
+            }
+
+            this->compositeRowScalar(src, dst, columns - x);
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+}
+
+#endif // KISTEXTUREOPTIONCOMPOSITEOPIMPL_H
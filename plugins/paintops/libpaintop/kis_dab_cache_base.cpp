@@ -19,6 +19,11 @@
 
 #include <kundo2command.h>
 
+#include <cmath>
+
+#include <QCryptographicHash>
+#include <QDomDocument>
+
 struct PrecisionValues {
     qreal angle;
     qreal sizeFrac;
@@ -82,9 +87,40 @@ struct KisDabCacheBase::Private {
 
     SavedDabParameters lastSavedDabParameters;
 
+    KisBrushSP persistentKeyBrush;
+    QByteArray persistentBrushKey;
+
     static qreal positiveFraction(qreal x);
+    const QByteArray& brushKey(KisBrushSP brush);
 };
 
+const QByteArray& KisDabCacheBase::Private::brushKey(KisBrushSP brush)
+{
+    /**
+     * The key is calculated only once per brush object, because
+     * serialization of the brush is rather expensive
+     */
+    if (brush != persistentKeyBrush) {
+        QDomDocument doc;
+        QDomElement element = doc.createElement("brush");
+        brush->toXML(doc, element);
+        doc.appendChild(element);
+
+        QByteArray data = doc.toByteArray();
+        data += QByteArray::number(brush->scale()) + ';' + QByteArray::number(brush->angle());
+
+        // ephemeral brushes (e.g. auto brushes) have no MD5 sum
+        if (!brush->isEphemeral()) {
+            data += brush->md5Sum(false).toLatin1();
+        }
+
+        persistentKeyBrush = brush;
+        persistentBrushKey = QCryptographicHash::hash(data, QCryptographicHash::Md5);
+    }
+
+    return persistentBrushKey;
+}
+
 
 
 KisDabCacheBase::KisDabCacheBase()
@@ -283,6 +319,34 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
         m_d->lastSavedDabParameters = newParams;
     }
 
+    di->usePersistentCache = supportsCaching && di->solidColorFill;
+
+    if (di->usePersistentCache) {
+        const PrecisionValues &prec = precisionLevels[precisionLevel];
+
+        auto quantize = [] (qreal value, qreal step) {
+            return qint64(std::floor(value / step));
+        };
+
+        KisPersistentDabCache::Key &key = di->persistentCacheKey;
+        key.brushKey = m_d->brushKey(resources->brush);
+        key.brushIndex = newParams.index;
+
+        // the color doesn't affect image stamps
+        key.color = resources->brush->brushApplication() != IMAGESTAMP ? newParams.color : KoColor();
+
+        key.width = newParams.width;
+        key.height = newParams.height;
+        key.angle = quantize(newParams.angle, prec.angle);
+        key.subPixelX = quantize(newParams.subPixelX, prec.subPixel);
+        key.subPixelY = quantize(newParams.subPixelY, prec.subPixel);
+        key.softnessFactor = quantize(newParams.softnessFactor, prec.softnessFactor);
+        key.lightnessStrength = quantize(newParams.lightnessStrength, prec.lightnessStrength);
+        key.ratio = quantize(newParams.ratio, prec.ratio);
+        key.horizontalMirror = newParams.mirrorProperties.horizontalMirror;
+        key.verticalMirror = newParams.mirrorProperties.verticalMirror;
+    }
+
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
 
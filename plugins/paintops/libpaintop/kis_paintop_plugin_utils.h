@@ -98,6 +98,17 @@ KisTimingInformation effectiveTiming(const KisAirbrushOptionData *airbrushOption
     return KisPaintOpUtils::effectiveTiming(timingEnabled, timingInterval, rateExtraScale);
 }
 
+/**
+ * @return true if the value of the option is the same for all the dabs
+ *         of the stroke, that is, the option is either disabled or has
+ *         no active sensors. Such options do not prevent the paintop
+ *         from painting lines in batches (see KisPaintOp::paintAtBatch()).
+ */
+inline bool isStaticOption(const KisCurveOption &option)
+{
+    return !option.isChecked() || !option.dependsOnPaintInformation();
+}
+
 }
 
 #endif /* __KIS_PAINTOP_PLUGIN_UTILS_H */
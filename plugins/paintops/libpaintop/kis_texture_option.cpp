@@ -33,6 +33,7 @@
 #include "KoMixColorsOp.h"
 #include <strokes/KisMaskingBrushCompositeOpBase.h>
 #include <strokes/KisMaskingBrushCompositeOpFactory.h>
+#include "KisTextureOptionCompositeOp.h"
 #include <kis_random_accessor_ng.h>
 #include <KoCompositeOpRegistry.h>
 
@@ -153,6 +154,40 @@ bool KisTextureOption::applyingGradient(const KisPropertiesConfiguration *settin
     return data.texturingMode == KisTextureOptionData::GRADIENT;
 }
 
+void KisTextureOption::fillFlatMaskPatch(const QRect &rect)
+{
+    const QRect maskBounds = m_maskInfo->maskBounds();
+    const int maskWidth = maskBounds.width();
+    const int maskHeight = maskBounds.height();
+    const quint8 *flatMask = m_maskInfo->flatMask();
+
+    auto positiveModulo = [] (int value, int divisor) {
+        const int result = value % divisor;
+        return result >= 0 ? result : result + divisor;
+    };
+
+    m_flatMaskPatch.resize(rect.width() * rect.height());
+    quint8 *dstPtr = m_flatMaskPatch.data();
+
+    const int firstColumn = positiveModulo(rect.x(), maskWidth);
+
+    for (int row = 0; row < rect.height(); row++) {
+        const quint8 *maskRow = flatMask + positiveModulo(rect.y() + row, maskHeight) * maskWidth;
+
+        int srcX = firstColumn;
+        int columnsRemaining = rect.width();
+
+        while (columnsRemaining > 0) {
+            const int columns = qMin(columnsRemaining, maskWidth - srcX);
+            memcpy(dstPtr, maskRow + srcX, columns);
+
+            dstPtr += columns;
+            columnsRemaining -= columns;
+            srcX = 0;
+        }
+    }
+}
+
 void KisTextureOption::applyLightness(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info) {
     if (!m_enabled) return;
     if (!m_maskInfo->isValid()) return;
@@ -260,19 +295,11 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
     KisPaintDeviceSP mask = m_maskInfo->mask();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->alpha8(), m_cachedPaintDevice);
-    KisPaintDeviceSP maskPatch = g.device();
-
     int x = offset.x() % maskBounds.width() - m_offsetX;
     int y = offset.y() % maskBounds.height() - m_offsetY;
 
     const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
 
-    KisFillPainter fillPainter(maskPatch);
-    fillPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillPainter.end();
-
     // Compute final strength
     qreal strength = m_strengthOption.apply(info);
 
@@ -296,6 +323,35 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
 
     QScopedPointer<KisMaskingBrushCompositeOpBase> compositeOp;
 
+    /**
+     * The most common case: 8-bit BGRA dab. The mask patch is copied
+     * directly from the flat mask and applied by the optimized op
+     */
+    if (alphaChannelType == KoChannelInfo::UINT8 &&
+        alphaChannelOffset == 3 &&
+        dab->pixelSize() == 4 &&
+        m_maskInfo->flatMask()) {
+
+        compositeOp.reset(KisTextureOptionCompositeOpFactory::create(m_texturingMode, strength));
+
+        if (compositeOp) {
+            fillFlatMaskPatch(maskPatchRect);
+
+            compositeOp->composite(m_flatMaskPatch.constData(), rect.width(),
+                                   dab->data(), rect.width() * dab->pixelSize(),
+                                   rect.width(), rect.height());
+            return;
+        }
+    }
+
+    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->alpha8(), m_cachedPaintDevice);
+    KisPaintDeviceSP maskPatch = g.device();
+
+    KisFillPainter fillPainter(maskPatch);
+    fillPainter.setCompositeOpId(COMPOSITE_COPY);
+    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
+    fillPainter.end();
+
     switch (m_texturingMode) {
     case KisTextureOptionData::MULTIPLY:
         compositeOp.reset(KisMaskingBrushCompositeOpFactory::createForAlphaSrc(COMPOSITE_MULT, alphaChannelType, dab->pixelSize(), alphaChannelOffset, strength));
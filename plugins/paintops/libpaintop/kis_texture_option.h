@@ -19,6 +19,7 @@
 #include "KisTextureMaskInfo.h"
 
 #include <QRect>
+#include <QVector>
 
 class KoPattern;
 class KoResource;
@@ -56,6 +57,8 @@ private:
     void applyLightness(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info);
     void applyGradient(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info);
     void fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface, KoCanvasResourcesInterfaceSP canvasResourcesInterface);
+    /// copies the pattern into m_flatMaskPatch, \p rect is in the pattern coordinates
+    void fillFlatMaskPatch(const QRect &rect);
 private:
 
     int m_offsetX {0};
@@ -71,6 +74,7 @@ private:
     KisTextureMaskInfoSP m_maskInfo;
     KisBrushTextureFlags m_flags;
     KisCachedPaintDevice m_cachedPaintDevice;
+    QVector<quint8> m_flatMaskPatch;
 };
 
 #endif // KIS_TEXTURE_OPTION_H
@@ -7,19 +7,19 @@
 
 #include <kis_algebra_2d.h>
 #include <KisSensorData.h>
+#include <kis_paint_information.h>
 
 KisDynamicSensor::KisDynamicSensor(const KoID &id,
                                      const KisSensorData &data,
                                      std::optional<KisCubicCurve> curveOverride)
-    : m_id(id),
-      m_curve(curveOverride ?
-                  *curveOverride :
-                  KisCubicCurve(data.curve))
+    : m_id(id)
 {
     KIS_SAFE_ASSERT_RECOVER_NOOP(id == data.id);
 
-    if (m_curve->isIdentity()) {
-        m_curve = std::nullopt;
+    const KisCubicCurve curve = curveOverride ? *curveOverride : KisCubicCurve(data.curve);
+
+    if (!curve.isIdentity()) {
+        m_curveLut = KisSensorCurveLut::fetch(curve);
     }
 }
 
@@ -35,12 +35,11 @@ KoID KisDynamicSensor::id() const
 qreal KisDynamicSensor::parameter(const KisPaintInformation &info) const
 {
     const qreal val = value(info);
-    if (m_curve) {
+    if (m_curveLut) {
         qreal scaledVal = isAdditive() ? additiveToScaling(val) :
                           isAbsoluteRotation() ? KisAlgebra2D::wrapValue(val + 0.5, 0.0, 1.0) : val;
 
-        const QVector<qreal> transfer = m_curve->floatTransfer(256);
-        scaledVal = KisCubicCurve::interpolateLinear(scaledVal, transfer);
+        scaledVal = m_curveLut->value(scaledVal);
 
         return isAdditive() ? scalingToAdditive(scaledVal) :
                isAbsoluteRotation() ? KisAlgebra2D::wrapValue(scaledVal + 0.5, 0.0, 1.0) : scaledVal;
@@ -50,6 +49,25 @@ qreal KisDynamicSensor::parameter(const KisPaintInformation &info) const
     }
 }
 
+void KisDynamicSensor::parameters(const QVector<KisPaintInformation> &infos, qreal *values) const
+{
+    for (int i = 0; i < infos.size(); i++) {
+        values[i] = value(infos[i]);
+    }
+
+    if (!m_curveLut) return;
+
+    for (int i = 0; i < infos.size(); i++) {
+        const qreal val = values[i];
+
+        qreal scaledVal = isAdditive() ? additiveToScaling(val) :
+                          isAbsoluteRotation() ? KisAlgebra2D::wrapValue(val + 0.5, 0.0, 1.0) : val;
+        scaledVal = m_curveLut->value(scaledVal);
+        values[i] = isAdditive() ? scalingToAdditive(scaledVal) :
+                    isAbsoluteRotation() ? KisAlgebra2D::wrapValue(scaledVal + 0.5, 0.0, 1.0) : scaledVal;
+    }
+}
+
 bool KisDynamicSensor::isAdditive() const
 {
     return false;
@@ -9,6 +9,10 @@
 #include <optional>
 #include <kis_cubic_curve.h>
 #include <KoID.h>
+#include <QVector>
+#include <QSharedPointer>
+
+#include "KisSensorCurveLut.h"
 
 class KisPaintInformation;
 struct KisSensorData;
@@ -24,6 +28,12 @@ public:
     KoID id() const;
     qreal parameter(const KisPaintInformation &info) const;
 
+    /**
+     * Batched version of parameter(). Calculates the parameter for every
+     * sample of \p infos and writes it into \p values.
+     */
+    void parameters(const QVector<KisPaintInformation> &infos, qreal *values) const;
+
     virtual bool isAdditive() const;
     virtual bool isAbsoluteRotation() const;
 
@@ -43,7 +53,9 @@ public:
 
 private:
     KoID m_id;
-    std::optional<KisCubicCurve> m_curve;
+
+    /// the curve of the sensor, null if the curve is identity
+    QSharedPointer<const KisSensorCurveLut> m_curveLut;
 };
 
 #endif // KISDYNAMICSENSOR_H
@@ -0,0 +1,73 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisSensorCurveLut.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWeakPointer>
+
+#include <kis_cubic_curve.h>
+
+namespace {
+
+struct LutCache
+{
+    typedef QPair<QString, int> Key;
+
+    QMutex mutex;
+    QHash<Key, QWeakPointer<const KisSensorCurveLut>> luts;
+};
+
+Q_GLOBAL_STATIC(LutCache, s_cache)
+
+}
+
+KisSensorCurveLut::KisSensorCurveLut(const KisCubicCurve &curve, int size)
+    : m_samples(curve.floatTransfer(size))
+{
+}
+
+qreal KisSensorCurveLut::value(qreal x) const
+{
+    return KisCubicCurve::interpolateLinear(x, m_samples);
+}
+
+qreal KisSensorCurveLut::nearestValue(qreal x) const
+{
+    const qreal maxValue = m_samples.size() - 1;
+    return m_samples[qRound(qBound(0.0, maxValue * x, maxValue))];
+}
+
+int KisSensorCurveLut::size() const
+{
+    return m_samples.size();
+}
+
+QSharedPointer<const KisSensorCurveLut> KisSensorCurveLut::fetch(const KisCubicCurve &curve, int size)
+{
+    const LutCache::Key key(curve.toString(), size);
+
+    QMutexLocker l(&s_cache->mutex);
+
+    QSharedPointer<const KisSensorCurveLut> lut = s_cache->luts.value(key).toStrongRef();
+
+    if (!lut) {
+        // drop the LUTs of the curves that are not used anymore
+        for (auto it = s_cache->luts.begin(); it != s_cache->luts.end();) {
+            if (it.value().isNull()) {
+                it = s_cache->luts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        lut.reset(new KisSensorCurveLut(curve, size));
+        s_cache->luts.insert(key, lut);
+    }
+
+    return lut;
+}
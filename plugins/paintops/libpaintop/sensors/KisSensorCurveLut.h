@@ -0,0 +1,62 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISSENSORCURVELUT_H
+#define KISSENSORCURVELUT_H
+
+#include <QSharedPointer>
+#include <QVector>
+
+#include "kritapaintop_export.h"
+
+class KisCubicCurve;
+
+/**
+ * @brief A lookup table of a sensor curve
+ *
+ * The table is sampled from the curve once, when the sensor is created,
+ * so the evaluation of a sensor never touches the spline itself.
+ *
+ * The LUTs are immutable and shared between all the sensors and paintops
+ * of the process via fetch(), so creating the paintop for every stroke
+ * doesn't resample the same curves again.
+ */
+class PAINTOP_EXPORT KisSensorCurveLut
+{
+public:
+    /// the size of the LUT used by the sensors
+    static const int defaultSize = 256;
+
+    KisSensorCurveLut(const KisCubicCurve &curve, int size = defaultSize);
+
+    /**
+     * \return the value of the curve at \p x, linearly interpolated
+     *         between the two nearest samples. The result is exactly
+     *         the same as KisCubicCurve::interpolateLinear() returns
+     *         for the float transfer of the same size.
+     */
+    qreal value(qreal x) const;
+
+    /**
+     * \return the value of the nearest sample to \p x. It is cheaper
+     *         than value(), but the LUT should be much bigger to get
+     *         the same precision.
+     */
+    qreal nearestValue(qreal x) const;
+
+    int size() const;
+
+    /**
+     * \return the LUT for \p curve of size \p size. If some other sensor
+     *         in the process already uses the same curve, its LUT is
+     *         returned. The method is thread-safe.
+     */
+    static QSharedPointer<const KisSensorCurveLut> fetch(const KisCubicCurve &curve, int size = defaultSize);
+
+private:
+    QVector<qreal> m_samples;
+};
+
+#endif // KISSENSORCURVELUT_H
@@ -0,0 +1,127 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisPersistentDabCacheTest.h"
+
+#include <KoColorSpaceRegistry.h>
+#include <kis_fixed_paint_device.h>
+
+#include <KisPersistentDabCache.h>
+
+namespace {
+
+KisPersistentDabCache::Key createKey(int size)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->alpha8();
+
+    KisPersistentDabCache::Key key;
+    key.brushKey = "brush";
+    key.colorSpace = cs;
+    key.color = KoColor(Qt::black, cs);
+    key.width = size;
+    key.height = size;
+
+    return key;
+}
+
+KisFixedPaintDeviceSP createDab(int size)
+{
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    dab->setRect(QRect(0, 0, size, size));
+    dab->lazyGrowBufferWithoutInitialization();
+    return dab;
+}
+
+}
+
+void KisPersistentDabCacheTest::testFetchAndStatistics()
+{
+    KisPersistentDabCache cache;
+
+    QVERIFY(!cache.fetch(createKey(10)));
+
+    KisFixedPaintDeviceSP dab = createDab(10);
+    cache.insert(createKey(10), dab);
+
+    QVERIFY(cache.fetch(createKey(10)) == dab);
+    QVERIFY(cache.fetch(createKey(10)) == dab);
+    QVERIFY(!cache.fetch(createKey(11)));
+
+    KisPersistentDabCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.hits, qint64(2));
+    QCOMPARE(stats.misses, qint64(2));
+    QCOMPARE(stats.numEntries, 1);
+    QCOMPARE(stats.memoryUsage, qint64(100));
+    QCOMPARE(stats.hitRate(), 0.5);
+
+    cache.resetStatistics();
+    stats = cache.statistics();
+    QCOMPARE(stats.hits, qint64(0));
+    QCOMPARE(stats.misses, qint64(0));
+    QCOMPARE(stats.hitRate(), 0.0);
+    QCOMPARE(stats.numEntries, 1);
+
+    cache.clear();
+    QVERIFY(!cache.fetch(createKey(10)));
+    QCOMPARE(cache.statistics().memoryUsage, qint64(0));
+}
+
+void KisPersistentDabCacheTest::testLruEviction()
+{
+    KisPersistentDabCache cache;
+    cache.setMaxMemoryUsage(300);
+
+    cache.insert(createKey(10), createDab(10));
+    cache.insert(createKey(11), createDab(10));
+    cache.insert(createKey(12), createDab(10));
+
+    // touch the oldest entry, so the second one becomes the least recently used
+    QVERIFY(cache.fetch(createKey(10)));
+
+    cache.insert(createKey(13), createDab(10));
+
+    QVERIFY(cache.fetch(createKey(10)));
+    QVERIFY(!cache.fetch(createKey(11)));
+    QVERIFY(cache.fetch(createKey(12)));
+    QVERIFY(cache.fetch(createKey(13)));
+
+    QCOMPARE(cache.statistics().evictions, qint64(1));
+    QCOMPARE(cache.statistics().memoryUsage, qint64(300));
+
+    // the dabs bigger than the whole cache are not stored
+    cache.insert(createKey(20), createDab(20));
+    QVERIFY(!cache.fetch(createKey(20)));
+    QCOMPARE(cache.statistics().numEntries, 3);
+
+    cache.setMaxMemoryUsage(100);
+    QCOMPARE(cache.statistics().numEntries, 1);
+    QVERIFY(cache.fetch(createKey(13)));
+}
+
+void KisPersistentDabCacheTest::testKeyComparison()
+{
+    KisPersistentDabCache::Key key1 = createKey(10);
+    KisPersistentDabCache::Key key2 = createKey(10);
+
+    QVERIFY(key1 == key2);
+    QCOMPARE(qHash(key1), qHash(key2));
+
+    key2.angle = 1;
+    QVERIFY(!(key1 == key2));
+
+    key2 = key1;
+    key2.brushKey = "other brush";
+    QVERIFY(!(key1 == key2));
+
+    key2 = key1;
+    key2.color = KoColor(Qt::white, key1.colorSpace);
+    QVERIFY(!(key1 == key2));
+
+    key2 = key1;
+    key2.horizontalMirror = true;
+    QVERIFY(!(key1 == key2));
+}
+
+SIMPLE_TEST_MAIN(KisPersistentDabCacheTest)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISPERSISTENTDABCACHETEST_H
+#define KISPERSISTENTDABCACHETEST_H
+
+#include <simpletest.h>
+
+class KisPersistentDabCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFetchAndStatistics();
+    void testLruEviction();
+    void testKeyComparison();
+};
+
+#endif // KISPERSISTENTDABCACHETEST_H
@@ -0,0 +1,205 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisSensorCurveLutBenchmark.h"
+
+#include <simpletest.h>
+
+#include <kis_cubic_curve.h>
+#include <kis_paint_information.h>
+#include <KisCurveOption.h>
+#include <KisCurveOptionData.h>
+#include <sensors/KisSensorCurveLut.h>
+
+namespace {
+
+const QString testCurve = "0,0;0.25,0.6;0.6,0.3;1,1;";
+const int numSamples = 10000;
+
+QVector<qreal> generateSamples()
+{
+    QVector<qreal> samples;
+    samples.reserve(numSamples);
+
+    for (int i = 0; i < numSamples; i++) {
+        samples << qreal((i * 7919) % numSamples) / (numSamples - 1);
+    }
+
+    return samples;
+}
+
+QVector<KisPaintInformation> generatePaintInfos()
+{
+    QVector<KisPaintInformation> infos;
+    infos.reserve(numSamples);
+
+    for (int i = 0; i < numSamples; i++) {
+        const qreal t = qreal(i) / (numSamples - 1);
+
+        infos << KisPaintInformation(QPointF(100.0 + 500.0 * t, 100.0),
+                                     0.1 + 0.9 * t,
+                                     -60.0 + 120.0 * t,
+                                     60.0 - 120.0 * t,
+                                     360.0 * t,
+                                     t,
+                                     1.0 - 0.5 * t,
+                                     10.0 * i,
+                                     2.0 * t);
+    }
+
+    return infos;
+}
+
+/**
+ * An option with eight non-random sensors with non-identity curves,
+ * that is how some heavy presets look like
+ */
+KisCurveOptionData createHeavyOptionData()
+{
+    KisCurveOptionData data(KoID("Size"), true, true);
+
+    data.useCurve = true;
+    data.useSameCurve = false;
+
+    KisKritaSensorData &sensors = data.sensorStruct();
+
+    QList<KisSensorData*> activeSensors = {
+        &sensors.sensorPressure,
+        &sensors.sensorXTilt,
+        &sensors.sensorYTilt,
+        &sensors.sensorTiltDirection,
+        &sensors.sensorTiltElevation,
+        &sensors.sensorSpeed,
+        &sensors.sensorRotation,
+        &sensors.sensorTangentialPressure
+    };
+
+    int i = 0;
+    Q_FOREACH (KisSensorData *sensor, activeSensors) {
+        sensor->isActive = true;
+        sensor->curve = QString("0,0;0.25,%1;0.6,0.3;1,1;").arg(0.1 * ++i);
+    }
+
+    return data;
+}
+
+}
+
+void KisSensorCurveLutBenchmark::testLutMatchesTransfer()
+{
+    const KisCubicCurve curve(testCurve);
+    const QVector<qreal> transfer = curve.floatTransfer(KisSensorCurveLut::defaultSize);
+
+    KisSensorCurveLut lut(curve);
+    QCOMPARE(lut.size(), KisSensorCurveLut::defaultSize);
+
+    Q_FOREACH (qreal x, generateSamples()) {
+        QCOMPARE(lut.value(x), KisCubicCurve::interpolateLinear(x, transfer));
+        QVERIFY(qAbs(lut.nearestValue(x) - curve.value(x)) < 0.01);
+    }
+}
+
+void KisSensorCurveLutBenchmark::testLutIsShared()
+{
+    const KisCubicCurve curve(testCurve);
+
+    QSharedPointer<const KisSensorCurveLut> lut1 = KisSensorCurveLut::fetch(curve);
+    QSharedPointer<const KisSensorCurveLut> lut2 = KisSensorCurveLut::fetch(KisCubicCurve(testCurve));
+    QSharedPointer<const KisSensorCurveLut> lut3 = KisSensorCurveLut::fetch(curve, 1024);
+
+    QVERIFY(lut1 == lut2);
+    QVERIFY(lut1 != lut3);
+    QCOMPARE(lut3->size(), 1024);
+}
+
+void KisSensorCurveLutBenchmark::benchmarkCurveEvaluation_data()
+{
+    QTest::addColumn<QString>("method");
+
+    QTest::addRow("spline") << "spline";
+    QTest::addRow("transfer per call") << "transfer";
+    QTest::addRow("lut, linear") << "linear";
+    QTest::addRow("lut, nearest, 256") << "nearest";
+    QTest::addRow("lut, nearest, 4096") << "nearest-4096";
+}
+
+void KisSensorCurveLutBenchmark::benchmarkCurveEvaluation()
+{
+    QFETCH(QString, method);
+
+    const KisCubicCurve curve(testCurve);
+    const KisSensorCurveLut lut(curve);
+    const KisSensorCurveLut bigLut(curve, 4096);
+    const QVector<qreal> samples = generateSamples();
+
+    qreal sum = 0.0;
+
+    if (method == "spline") {
+        QBENCHMARK {
+            Q_FOREACH (qreal x, samples) {
+                sum += curve.value(x);
+            }
+        }
+    } else if (method == "transfer") {
+        // that is how KisDynamicSensor used to evaluate the curve
+        QBENCHMARK {
+            Q_FOREACH (qreal x, samples) {
+                const QVector<qreal> transfer = curve.floatTransfer(256);
+                sum += KisCubicCurve::interpolateLinear(x, transfer);
+            }
+        }
+    } else if (method == "linear") {
+        QBENCHMARK {
+            Q_FOREACH (qreal x, samples) {
+                sum += lut.value(x);
+            }
+        }
+    } else if (method == "nearest") {
+        QBENCHMARK {
+            Q_FOREACH (qreal x, samples) {
+                sum += lut.nearestValue(x);
+            }
+        }
+    } else if (method == "nearest-4096") {
+        QBENCHMARK {
+            Q_FOREACH (qreal x, samples) {
+                sum += bigLut.nearestValue(x);
+            }
+        }
+    }
+
+    QVERIFY(sum > 0.0);
+}
+
+void KisSensorCurveLutBenchmark::benchmarkCurveOption_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::addRow("per dab") << false;
+    QTest::addRow("batched") << true;
+}
+
+void KisSensorCurveLutBenchmark::benchmarkCurveOption()
+{
+    QFETCH(bool, batched);
+
+    KisCurveOption option(createHeavyOptionData());
+    const QVector<KisPaintInformation> infos = generatePaintInfos();
+    QVector<qreal> values(infos.size());
+
+    if (batched) {
+        QBENCHMARK {
+            option.computeSizeLikeValues(infos, values.data());
+        }
+    } else {
+        QBENCHMARK {
+            for (int i = 0; i < infos.size(); i++) {
+                values[i] = option.computeSizeLikeValue(infos[i]);
+            }
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisSensorCurveLutBenchmark)
@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISSENSORCURVELUTBENCHMARK_H
+#define KISSENSORCURVELUTBENCHMARK_H
+
+#include <QObject>
+
+class KisSensorCurveLutBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testLutMatchesTransfer();
+    void testLutIsShared();
+
+    void benchmarkCurveEvaluation_data();
+    void benchmarkCurveEvaluation();
+
+    void benchmarkCurveOption_data();
+    void benchmarkCurveOption();
+};
+
+#endif // KISSENSORCURVELUTBENCHMARK_H
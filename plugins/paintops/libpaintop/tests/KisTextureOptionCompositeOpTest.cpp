@@ -0,0 +1,85 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisTextureOptionCompositeOpTest.h"
+
+#include <QRandomGenerator>
+#include <QVector>
+
+#include <KoChannelInfo.h>
+#include <KoCompositeOpRegistry.h>
+#include <strokes/KisMaskingBrushCompositeOpBase.h>
+#include <strokes/KisMaskingBrushCompositeOpFactory.h>
+
+#include <KisTextureOptionCompositeOp.h>
+
+Q_DECLARE_METATYPE(KisTextureOptionData::TexturingMode)
+
+void KisTextureOptionCompositeOpTest::testMatchesGenericOps_data()
+{
+    QTest::addColumn<KisTextureOptionData::TexturingMode>("mode");
+    QTest::addColumn<QString>("compositeOpId");
+    QTest::addColumn<qreal>("strength");
+
+    for (qreal strength : {0.0, 0.37, 1.0}) {
+        const QString suffix = QString(" %1").arg(strength);
+
+        QTest::newRow(qPrintable("multiply" + suffix)) << KisTextureOptionData::MULTIPLY << QString(COMPOSITE_MULT) << strength;
+        QTest::newRow(qPrintable("subtract" + suffix)) << KisTextureOptionData::SUBTRACT << QString(COMPOSITE_SUBTRACT) << strength;
+        QTest::newRow(qPrintable("height" + suffix)) << KisTextureOptionData::HEIGHT << QString("height") << strength;
+        QTest::newRow(qPrintable("linear_height" + suffix)) << KisTextureOptionData::LINEAR_HEIGHT << QString("linear_height") << strength;
+        QTest::newRow(qPrintable("height_photoshop" + suffix)) << KisTextureOptionData::HEIGHT_PHOTOSHOP << QString("height_photoshop") << strength;
+        QTest::newRow(qPrintable("linear_height_photoshop" + suffix)) << KisTextureOptionData::LINEAR_HEIGHT_PHOTOSHOP << QString("linear_height_photoshop") << strength;
+    }
+}
+
+void KisTextureOptionCompositeOpTest::testMatchesGenericOps()
+{
+    QFETCH(KisTextureOptionData::TexturingMode, mode);
+    QFETCH(QString, compositeOpId);
+    QFETCH(qreal, strength);
+
+    // odd width to test the tail processing as well
+    const int width = 37;
+    const int height = 5;
+    const int pixelSize = 4;
+
+    QRandomGenerator random(1);
+
+    QVector<quint8> mask(width * height);
+    QVector<quint8> dab(width * height * pixelSize);
+
+    for (quint8 &value : mask) {
+        value = quint8(random.bounded(256));
+    }
+
+    for (quint8 &value : dab) {
+        value = quint8(random.bounded(256));
+    }
+
+    QVector<quint8> referenceDab = dab;
+
+    QScopedPointer<KisMaskingBrushCompositeOpBase> op(
+        KisTextureOptionCompositeOpFactory::create(mode, strength));
+    QVERIFY(op);
+
+    QScopedPointer<KisMaskingBrushCompositeOpBase> referenceOp(
+        KisMaskingBrushCompositeOpFactory::createForAlphaSrc(compositeOpId, KoChannelInfo::UINT8, pixelSize, 3, strength));
+    QVERIFY(referenceOp);
+
+    op->composite(mask.constData(), width, dab.data(), width * pixelSize, width, height);
+    referenceOp->composite(mask.constData(), width, referenceDab.data(), width * pixelSize, width, height);
+
+    QCOMPARE(dab, referenceDab);
+}
+
+void KisTextureOptionCompositeOpTest::testUnsupportedModes()
+{
+    QScopedPointer<KisMaskingBrushCompositeOpBase> op(
+        KisTextureOptionCompositeOpFactory::create(KisTextureOptionData::OVERLAY, 1.0));
+    QVERIFY(!op);
+}
+
+SIMPLE_TEST_MAIN(KisTextureOptionCompositeOpTest)
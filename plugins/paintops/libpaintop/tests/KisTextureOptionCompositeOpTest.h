@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISTEXTUREOPTIONCOMPOSITEOPTEST_H
+#define KISTEXTUREOPTIONCOMPOSITEOPTEST_H
+
+#include <simpletest.h>
+
+class KisTextureOptionCompositeOpTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMatchesGenericOps_data();
+    void testMatchesGenericOps();
+    void testUnsupportedModes();
+};
+
+#endif // KISTEXTUREOPTIONCOMPOSITEOPTEST_H
@@ -67,6 +67,13 @@ KisSpacingInformation KisMyPaintPaintOp::paintAt(const KisPaintInformation& info
     radius *= lodScale;
     mypaint_brush_set_base_value(m_brush->brush(), MYPAINT_BRUSH_SETTING_RADIUS_LOGARITHMIC, log(radius));
 
+    /**
+     * All the dabs generated by libmypaint for this segment are painted
+     * in one batch, so that the painted areas are written back to the
+     * device only once
+     */
+    mypaint_surface_begin_atomic(m_surface->surface());
+
     m_isStrokeStarted = mypaint_brush_get_state(m_brush->brush(), MYPAINT_BRUSH_STATE_STROKE_STARTED);
     if (!m_isStrokeStarted) {
 
@@ -82,6 +89,8 @@ KisSpacingInformation KisMyPaintPaintOp::paintAt(const KisPaintInformation& info
     mypaint_brush_stroke_to(m_brush->brush(), m_surface->surface(), info.pos().x(), info.pos().y(), info.pressure(),
                            info.xTilt(), info.yTilt(), m_dtime);
 
+    mypaint_surface_end_atomic(m_surface->surface(), nullptr);
+
     m_previousTime = info.currentTime();
 
     return computeSpacing(info, lodScale);
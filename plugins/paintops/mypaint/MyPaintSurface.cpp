@@ -11,11 +11,12 @@
 #include <KoColorSpaceMaths.h>
 #include <QtMath>
 #include <kis_algebra_2d.h>
+#include <kis_assert.h>
 #include <kis_cross_device_color_sampler.h>
 #include <kis_image.h>
 #include <kis_node.h>
-#include <kis_sequential_iterator.h>
 #include <kis_selection.h>
+#include <KisRegion.h>
 #include <qmath.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoMixColorsOp.h>
@@ -33,10 +34,11 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
     , m_imageDevice(paintNode)
     , m_image(image)
     , m_precisePainterWrapper(painter->device())
-    , m_dab(m_precisePainterWrapper.createPreciseCompositionSourceDevice())
     , m_tempPainter(new KisPainter(m_precisePainterWrapper.overlay()))
     , m_backgroundPainter(new KisPainter(m_precisePainterWrapper.createPreciseCompositionSourceDevice()))
+    , m_kernels(KisMyPaintSurfaceKernelsFactory::create())
 {
+    m_dab = KisFixedPaintDeviceSP(new KisFixedPaintDevice(m_precisePainterWrapper.overlayColorSpace()));
     m_blendDevice = KisFixedPaintDeviceSP(new KisFixedPaintDevice(m_precisePainterWrapper.overlayColorSpace()));
 
     m_backgroundPainter->setCompositeOpId(COMPOSITE_COPY);
@@ -51,6 +53,8 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
 
     m_surface->draw_dab = this->draw_dab;
     m_surface->get_color = this->get_color;
+    m_surface->begin_atomic = this->begin_atomic;
+    m_surface->end_atomic = this->end_atomic;
     m_surface->destroy = destroy_internal_surface_callback;
     m_surface->bitDepth = m_precisePainterWrapper.overlayColorSpace()->channels()[0]->channelValueType();
 
@@ -61,6 +65,7 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
 
 KisMyPaintSurface::~KisMyPaintSurface()
 {
+    flushPendingRects();
     mypaint_surface_unref(m_surface);
 }
 
@@ -114,6 +119,51 @@ void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float
     }
 }
 
+void KisMyPaintSurface::begin_atomic(MyPaintSurface *self)
+{
+    MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+    surface->m_owner->m_batchDepth++;
+}
+
+void KisMyPaintSurface::end_atomic(MyPaintSurface *self, MyPaintRectangle *roi)
+{
+    MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+    KisMyPaintSurface *owner = surface->m_owner;
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(owner->m_batchDepth > 0);
+    owner->m_batchDepth = qMax(0, owner->m_batchDepth - 1);
+
+    if (roi) {
+        QRect bounds;
+        Q_FOREACH (const QRect &rc, owner->m_pendingRects) {
+            bounds |= rc;
+        }
+
+        roi->x = bounds.x();
+        roi->y = bounds.y();
+        roi->width = bounds.width();
+        roi->height = bounds.height();
+    }
+
+    if (!owner->m_batchDepth) {
+        owner->flushPendingRects();
+    }
+}
+
+void KisMyPaintSurface::flushPendingRects()
+{
+    if (m_pendingRects.isEmpty()) return;
+
+    /**
+     * The dabs of a batch overlap heavily, so merge their rects
+     * to avoid converting the same pixels multiple times
+     */
+    const QVector<QRect> rects = KisRegion::fromOverlappingRects(m_pendingRects, 64).rects();
+    m_pendingRects.clear();
+
+    m_precisePainterWrapper.writeRects(rects);
+    painter()->addDirtyRects(rects);
+}
 
 /*GIMP's draw_dab and get_color code*/
 template <typename channelType>
@@ -150,10 +200,47 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
     const QRect dabRectAligned = QRect(pt, sz);
     const QPointF center = QPointF(x, y);
 
-    KisAlgebra2D::OuterCircle outer(center, radius);
     m_precisePainterWrapper.readRects(m_tempPainter->calculateAllMirroredRects(dabRectAligned));
-    m_tempPainter->copyAreaOptimized(dabRectAligned.topLeft(), m_tempPainter->device(), m_dab, dabRectAligned);
-    KisSequentialIterator it(m_dab, dabRectAligned);
+
+    m_dab->setRect(dabRectAligned);
+    m_dab->lazyGrowBufferWithoutInitialization();
+    m_tempPainter->device()->readBytes(m_dab->data(), dabRectAligned);
+
+    const int numPixels = dabRectAligned.width() * dabRectAligned.height();
+    m_dabAlpha.resize(numPixels);
+
+    if (radius < 3.0) {
+        // small dabs are antialiased, which is done pixel-by-pixel
+        KisAlgebra2D::OuterCircle outer(center, radius);
+        float *alphaPointer = m_dabAlpha.data();
+
+        for (int yp = dabRectAligned.top(); yp <= dabRectAligned.bottom(); yp++) {
+            for (int xp = dabRectAligned.left(); xp <= dabRectAligned.right(); xp++) {
+                *alphaPointer = 0.0f;
+
+                if (outer.fadeSq(QPoint(xp, yp)) <= 1.0f) {
+                    const float rr = calculate_rr_antialiased (xp, yp, x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
+                    *alphaPointer = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
+                }
+
+                alphaPointer++;
+            }
+        }
+    } else {
+        KisMyPaintDabShape shape;
+        shape.x = x;
+        shape.y = y;
+        shape.aspectRatio = aspect_ratio;
+        shape.sn = sn;
+        shape.cs = cs;
+        shape.oneOverRadius2 = one_over_radius2;
+        shape.hardness = hardness;
+        shape.segment1Slope = segment1_slope;
+        shape.segment2Slope = segment2_slope;
+        shape.outerRadius2 = pow2(radius + 1.0f);
+
+        m_kernels->calculateDabAlpha(dabRectAligned, shape, m_dabAlpha.data());
+    }
 
     quint8 maskUnitValue = KoColorSpaceMathsTraits<quint8>::unitValue; // because it's alpha8
 
@@ -165,36 +252,28 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
     m_maskDevice->setRect(dabRectAligned);
     m_maskDevice->lazyGrowBufferWithoutInitialization();
 
-
-    // Dmitry says that going with the pointer should be in the same order
-    // as using the sequential iterator
     quint8* maskPointer = m_maskDevice->data();
+    quint8* dabPointer = m_dab->data();
+    const float* alphaPointer = m_dabAlpha.constData();
+    const int pixelSize = m_dab->pixelSize();
 
-
-    while(it.nextPixel()) {
+    for (int i = 0; i < numPixels; i++, maskPointer++, dabPointer += pixelSize) {
 
         // first initialize to 0;
         *maskPointer = 0;
 
-        QPoint pt(it.x(), it.y());
+        const float base_alpha = alphaPointer[i];
 
-        if(outer.fadeSq(pt) > 1.0f) {
-            maskPointer++;
+        /**
+         * The pixels with zero opacity are either masked out or get
+         * exactly the same values as they had, so just skip them
+         */
+        if (!(base_alpha > 0.0f)) {
             continue;
         }
 
-        float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
-
-        if (radius < 3.0) {
-            rr = calculate_rr_antialiased (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
-        }
-        else {
-            rr = calculate_rr (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2);
-        }
-
-        base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
+        float alpha, dst_alpha, r, g, b, a;
 
-        m_tempPainter->selection();
         alpha = base_alpha * normal_mode;
 
         // set alpha to mask
@@ -202,7 +281,7 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
             *maskPointer = (quint8)(maskUnitValue);
         }
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
+        channelType* nativeArray = reinterpret_cast<channelType*>(dabPointer);
 
         b = nativeArray[0]/unitValue;
         g = nativeArray[1]/unitValue;
@@ -262,16 +341,19 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
         nativeArray[1] = KoColorSpaceMaths<float, channelType>::scaleToA(g);
         nativeArray[2] = KoColorSpaceMaths<float, channelType>::scaleToA(r);
         nativeArray[3] = KoColorSpaceMaths<float, channelType>::scaleToA(a);
-
-        maskPointer++;
     }
 
 
-    m_tempPainter->bitBltWithFixedSelection(dabRectAligned.x(), dabRectAligned.y(), m_dab, m_maskDevice, dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.width(), dabRectAligned.height());
-    m_tempPainter->renderMirrorMask(dabRectAligned, m_dab, dabRectAligned.x(), dabRectAligned.y(), m_maskDevice);
+    m_tempPainter->bltFixedWithFixedSelection(dabRectAligned.x(), dabRectAligned.y(), m_dab, m_maskDevice, dabRectAligned.width(), dabRectAligned.height());
+    m_tempPainter->renderMirrorMask(dabRectAligned, m_dab, m_maskDevice);
     const QVector<QRect> dirtyRects = m_tempPainter->takeDirtyRegion();
-    m_precisePainterWrapper.writeRects(dirtyRects);
-    painter()->addDirtyRects(dirtyRects);
+
+    if (m_batchDepth > 0) {
+        m_pendingRects += dirtyRects;
+    } else {
+        m_precisePainterWrapper.writeRects(dirtyRects);
+        painter()->addDirtyRects(dirtyRects);
+    }
     return 1;
 }
 
@@ -292,11 +374,11 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
 
 
     const QRect dabRectAligned = QRect(pt, sz);
-    const QPointF center = QPointF(x, y);
-    KisAlgebra2D::OuterCircle outer(center, radius);
 
-    const float one_over_radius2 = 1.0f / (radius * radius);
-    quint32 sum_weight = 0.0f;
+    if (!m_image && m_imageDevice) {
+        // the colors are sampled from the source device directly
+        flushPendingRects();
+    }
 
     m_precisePainterWrapper.readRect(dabRectAligned);
     KisPaintDeviceSP activeDev = m_precisePainterWrapper.overlay();
@@ -313,8 +395,6 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
         m_precisePainterWrapper.readRect(dabRectAligned);
     }
 
-    KisSequentialIterator it(activeDev, dabRectAligned);
-    QVector<float> surface_color_vec = {0,0,0,0};
     float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
     float maxValue = KoColorSpaceMathsTraits<channelType>::max;
 
@@ -323,28 +403,12 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
     m_blendDevice->lazyGrowBufferWithoutInitialization();
 
 
-    qint16* weights = new qint16[size];
-    quint32 num_colors = 0;
+    m_sampleWeights.resize(size);
+    qint16* weights = m_sampleWeights.data();
 
     activeDev->readBytes(m_blendDevice->data(), dabRectAligned);
 
-    while(it.nextPixel()) {
-
-        QPointF pt(it.x(), it.y());
-
-        float rr = 0.0;
-        if(outer.fadeSq(pt) <= 1.0) {
-            /* pixel_weight == a standard dab with hardness = 0.5, aspect_ratio = 1.0, and angle = 0.0 */
-            float yy = (it.y() + 0.5f - y);
-            float xx = (it.x() + 0.5f - x);
-
-            rr = qMax((yy * yy + xx * xx) * one_over_radius2, 0.0f);
-        }
-
-        weights[num_colors] = qRound((1.0f - rr) * 255);
-        sum_weight += weights[num_colors];
-        num_colors += 1;
-    }
+    const quint32 sum_weight = m_kernels->calculateSampleWeights(dabRectAligned, x, y, radius, weights);
 
     KoColor color = KoColor::createTransparent(activeDev->colorSpace());
     activeDev->colorSpace()->mixColorsOp()->mixColors(m_blendDevice->data(), weights, size, color.data(), sum_weight);
@@ -369,8 +433,6 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
             *color_a = CLAMP(a, 0.0f, 1.0f);
         }
     }
-
-    delete [] weights;
 }
 
 KisPainter* KisMyPaintSurface::painter() {
@@ -19,6 +19,8 @@
 #include <kis_sequential_iterator.h>
 #include <KisOverlayPaintDeviceWrapper.h>
 
+#include "MyPaintSurfaceKernels.h"
+
 #include <libmypaint/mypaint-brush.h>
 #include <libmypaint/mypaint-surface.h>
 
@@ -48,6 +50,24 @@ public:
     static void get_color(MyPaintSurface *self, float x, float y, float radius,
                             float * color_r, float * color_g, float * color_b, float * color_a);
 
+    /**
+     * mypaint_surface_begin_atomic:
+     *
+     * Starts a batch of dabs. While the batch is active, the painted
+     * areas are kept in the overlay device and are written back to the
+     * painter's device only when the batch ends.
+     */
+    static void begin_atomic(MyPaintSurface *self);
+
+    /**
+     * mypaint_surface_end_atomic:
+     *
+     * Ends the batch of dabs and writes all the painted areas back
+     * to the painter's device. \p roi is set to the bounding rect of
+     * the painted areas if non-null.
+     */
+    static void end_atomic(MyPaintSurface *self, MyPaintRectangle *roi);
+
     template <typename channelType>
     int drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
                                     float color_b, float opaque, float hardness, float color_a,
@@ -76,18 +96,27 @@ public:
 
     MyPaintSurface* surface();
 
+private:
+    void flushPendingRects();
+
 private:
     KisPainter *m_painter;
     KisPaintDeviceSP m_imageDevice;
     MyPaintSurfaceInternal *m_surface;
     KisImageSP m_image;
     KisOverlayPaintDeviceWrapper m_precisePainterWrapper;
-    KisPaintDeviceSP m_dab;
+    KisFixedPaintDeviceSP m_dab;
     QScopedPointer<KisPainter> m_tempPainter;
     QScopedPointer<KisPainter> m_backgroundPainter;
     KisFixedPaintDeviceSP m_blendDevice;
     KisFixedPaintDeviceSP m_maskDevice;
 
+    QScopedPointer<KisMyPaintSurfaceKernelsBase> m_kernels;
+    QVector<float> m_dabAlpha;
+    QVector<qint16> m_sampleWeights;
+
+    int m_batchDepth {0};
+    QVector<QRect> m_pendingRects;
 };
 
 #endif // KIS_MYPAINT_SURFACE_H
@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "MyPaintSurfaceKernels.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+KisMyPaintSurfaceKernelsBase::~KisMyPaintSurfaceKernelsBase()
+{
+}
+
+KisMyPaintSurfaceKernelsBase* KisMyPaintSurfaceKernelsFactory::create()
+{
+    return createOptimizedClass<KisMyPaintSurfaceKernelsFactoryImpl>();
+}
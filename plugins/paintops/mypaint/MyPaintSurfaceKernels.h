@@ -0,0 +1,82 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_MYPAINT_SURFACE_KERNELS_H
+#define KIS_MYPAINT_SURFACE_KERNELS_H
+
+#include <QRect>
+#include <QtGlobal>
+
+/**
+ * The shape of a single MyPaint dab, as passed by libmypaint
+ * to draw_dab() callback
+ */
+struct KisMyPaintDabShape
+{
+    float x {0.0f};
+    float y {0.0f};
+
+    float aspectRatio {1.0f};
+    float sn {0.0f};
+    float cs {1.0f};
+    float oneOverRadius2 {1.0f};
+
+    float hardness {1.0f};
+    float segment1Slope {0.0f};
+    float segment2Slope {0.0f};
+
+    /// the squared radius of the circle outside which no pixels are touched
+    float outerRadius2 {0.0f};
+};
+
+/**
+ * @brief Per-pixel math of KisMyPaintSurface
+ *
+ * The kernels calculate the opacity of the dab and the weights of the
+ * color sampling for the whole dab rect at once. The actual implementation
+ * is placed in class KisMyPaintSurfaceKernels, which is compiled for every
+ * supported CPU architecture. Use KisMyPaintSurfaceKernelsFactory::create()
+ * to create a version optimized for the current CPU.
+ */
+class KisMyPaintSurfaceKernelsBase
+{
+public:
+    virtual ~KisMyPaintSurfaceKernelsBase();
+
+    /**
+     * Calculates the base opacity of the dab for every pixel of \p rect.
+     * The values are written row by row into \p alpha. The pixels that are
+     * not covered by the dab get zero opacity.
+     *
+     * The kernel doesn't antialias the dab, so it should be used for the
+     * dabs with radius larger than 3 px only.
+     */
+    virtual void calculateDabAlpha(const QRect &rect, const KisMyPaintDabShape &shape, float *alpha) const = 0;
+
+    /**
+     * Calculates the weights of the pixels of \p rect for averaging the
+     * color under the dab in get_color() callback. The weights are written
+     * row by row into \p weights.
+     *
+     * \return the sum of all the weights
+     */
+    virtual int calculateSampleWeights(const QRect &rect, float x, float y, float radius, qint16 *weights) const = 0;
+};
+
+class KisMyPaintSurfaceKernelsFactory
+{
+public:
+    static KisMyPaintSurfaceKernelsBase* create();
+};
+
+class KisMyPaintSurfaceKernelsFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisMyPaintSurfaceKernelsBase* create();
+};
+
+#endif // KIS_MYPAINT_SURFACE_KERNELS_H
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "MyPaintSurfaceKernels.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "MyPaintSurfaceKernelsImpl.h"
+
+template<>
+KisMyPaintSurfaceKernelsBase *
+KisMyPaintSurfaceKernelsFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisMyPaintSurfaceKernels<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
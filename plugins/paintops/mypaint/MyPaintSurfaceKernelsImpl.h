@@ -0,0 +1,267 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_MYPAINT_SURFACE_KERNELS_IMPL_H
+#define KIS_MYPAINT_SURFACE_KERNELS_IMPL_H
+
+#include "MyPaintSurfaceKernels.h"
+
+#include <type_traits>
+
+#include <QtGlobal>
+
+#include "KoAlwaysInline.h"
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+/**
+ * Generic scalar implementation of the surface kernels. It is used for
+ * the `xsimd::generic` architecture and as a tail-processor for the
+ * vectorized version.
+ *
+ * The math repeats GIMP's and libmypaint's implementation of the
+ * non-antialiased dab, see KisMyPaintSurface::calculate_rr().
+ */
+template<typename _impl, typename EnableDummyType = void>
+class KisMyPaintSurfaceKernels : public KisMyPaintSurfaceKernelsBase
+{
+public:
+    void calculateDabAlpha(const QRect &rect, const KisMyPaintDabShape &shape, float *alpha) const override
+    {
+        for (int row = 0; row < rect.height(); row++) {
+            calculateDabAlphaScalar(rect.x(), rect.x() + rect.width(), rect.y() + row,
+                                    shape, alpha + row * rect.width());
+        }
+    }
+
+    int calculateSampleWeights(const QRect &rect, float x, float y, float radius, qint16 *weights) const override
+    {
+        const float oneOverRadius2 = 1.0f / (radius * radius);
+        const float outerRadius2 = (radius + 1.0f) * (radius + 1.0f);
+
+        int sumOfWeights = 0;
+
+        for (int row = 0; row < rect.height(); row++) {
+            sumOfWeights +=
+                calculateSampleWeightsScalar(rect.x(), rect.x() + rect.width(), rect.y() + row,
+                                             x, y, oneOverRadius2, outerRadius2,
+                                             weights + row * rect.width());
+        }
+
+        return sumOfWeights;
+    }
+
+protected:
+    /**
+     * Calculates alpha for pixels [\p from, \p to) of row \p yp. The
+     * value for pixel \p from is written into \p dst[0].
+     */
+    static void calculateDabAlphaScalar(int from, int to, int yp,
+                                        const KisMyPaintDabShape &s,
+                                        float *dst)
+    {
+        // the outer circle is checked against the corner of the pixel
+        const float dy = yp - s.y;
+        const float yy = yp + 0.5f - s.y;
+
+        for (int xp = from; xp < to; xp++, dst++) {
+            const float dx = xp - s.x;
+
+            if (dx * dx + dy * dy > s.outerRadius2) {
+                *dst = 0.0f;
+                continue;
+            }
+
+            const float xx = xp + 0.5f - s.x;
+            const float yyr = (yy * s.cs - xx * s.sn) * s.aspectRatio;
+            const float xxr = yy * s.sn + xx * s.cs;
+            const float rr = (yyr * yyr + xxr * xxr) * s.oneOverRadius2;
+
+            if (rr > 1.0f) {
+                *dst = 0.0f;
+            } else if (rr <= s.hardness) {
+                *dst = 1.0f + rr * s.segment1Slope;
+            } else {
+                *dst = rr * s.segment2Slope - s.segment2Slope;
+            }
+        }
+    }
+
+    /**
+     * The weight is a standard dab with hardness = 0.5, aspect_ratio = 1.0
+     * and angle = 0.0
+     */
+    static int calculateSampleWeightsScalar(int from, int to, int yp,
+                                            float x, float y,
+                                            float oneOverRadius2, float outerRadius2,
+                                            qint16 *dst)
+    {
+        const float dy = yp - y;
+        const float yy = yp + 0.5f - y;
+
+        int sumOfWeights = 0;
+
+        for (int xp = from; xp < to; xp++, dst++) {
+            const float dx = xp - x;
+
+            float rr = 0.0f;
+
+            if (dx * dx + dy * dy <= outerRadius2) {
+                const float xx = xp + 0.5f - x;
+                rr = qMax((yy * yy + xx * xx) * oneOverRadius2, 0.0f);
+            }
+
+            *dst = qRound((1.0f - rr) * 255);
+            sumOfWeights += *dst;
+        }
+
+        return sumOfWeights;
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+/**
+ * Vectorized version of the surface kernels. Every row of the dab is
+ * processed in batches, the tail of the row is processed by the scalar
+ * version.
+ */
+template<typename _impl>
+class KisMyPaintSurfaceKernels<
+        _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisMyPaintSurfaceKernels<xsimd::generic>
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+    using base_class = KisMyPaintSurfaceKernels<xsimd::generic>;
+
+public:
+    void calculateDabAlpha(const QRect &rect, const KisMyPaintDabShape &s, float *alpha) const override
+    {
+        const float_v zero(0.0f);
+        const float_v one(1.0f);
+        const float_v half(0.5f);
+        const float_v increment(static_cast<float>(float_v::size));
+
+        const float_v vX(s.x);
+        const float_v vSn(s.sn);
+        const float_v vCs(s.cs);
+        const float_v vAspectRatio(s.aspectRatio);
+        const float_v vOneOverRadius2(s.oneOverRadius2);
+        const float_v vHardness(s.hardness);
+        const float_v vSegment1Slope(s.segment1Slope);
+        const float_v vSegment2Slope(s.segment2Slope);
+        const float_v vOuterRadius2(s.outerRadius2);
+
+        const int width = rect.width();
+
+        for (int row = 0; row < rect.height(); row++) {
+            const int yp = rect.y() + row;
+            float *dst = alpha + row * width;
+
+            const float dy = yp - s.y;
+            const float yy = yp + 0.5f - s.y;
+
+            const float_v dy2(dy * dy);
+            const float_v yyCs(yy * s.cs);
+            const float_v yySn(yy * s.sn);
+
+            float_v xp = float_v(static_cast<float>(rect.x())) +
+                xsimd::detail::make_sequence_as_batch<float_v>();
+
+            int x = 0;
+            for (; x + static_cast<int>(float_v::size) <= width; x += float_v::size) {
+                const float_v dx = xp - vX;
+                const float_v xx = xp + half - vX;
+
+                const float_v yyr = (yyCs - xx * vSn) * vAspectRatio;
+                const float_v xxr = yySn + xx * vCs;
+                const float_v rr = (yyr * yyr + xxr * xxr) * vOneOverRadius2;
+
+                float_v result = xsimd::select(rr <= vHardness,
+                                               one + rr * vSegment1Slope,
+                                               rr * vSegment2Slope - vSegment2Slope);
+
+                result = xsimd::select((dx * dx + dy2 > vOuterRadius2) | (rr > one), zero, result);
+                result.store_unaligned(dst + x);
+
+                xp += increment;
+            }
+
+            base_class::calculateDabAlphaScalar(rect.x() + x, rect.x() + width, yp, s, dst + x);
+        }
+    }
+
+    int calculateSampleWeights(const QRect &rect, float x, float y, float radius, qint16 *weights) const override
+    {
+        const float oneOverRadius2 = 1.0f / (radius * radius);
+        const float outerRadius2 = (radius + 1.0f) * (radius + 1.0f);
+
+        const float_v zero(0.0f);
+        const float_v one(1.0f);
+        const float_v half(0.5f);
+        const float_v unit(255.0f);
+        const float_v increment(static_cast<float>(float_v::size));
+
+        const float_v vX(x);
+        const float_v vOneOverRadius2(oneOverRadius2);
+        const float_v vOuterRadius2(outerRadius2);
+
+        const int width = rect.width();
+
+        int_v sumOfWeights(0);
+        int tailSumOfWeights = 0;
+
+        alignas(64) int buffer[int_v::size];
+
+        for (int row = 0; row < rect.height(); row++) {
+            const int yp = rect.y() + row;
+            qint16 *dst = weights + row * width;
+
+            const float dy = yp - y;
+            const float yy = yp + 0.5f - y;
+
+            const float_v dy2(dy * dy);
+            const float_v yy2(yy * yy);
+
+            float_v xp = float_v(static_cast<float>(rect.x())) +
+                xsimd::detail::make_sequence_as_batch<float_v>();
+
+            int col = 0;
+            for (; col + static_cast<int>(float_v::size) <= width; col += float_v::size) {
+                const float_v dx = xp - vX;
+                const float_v xx = xp + half - vX;
+
+                float_v rr = xsimd::max((yy2 + xx * xx) * vOneOverRadius2, zero);
+                rr = xsimd::select(dx * dx + dy2 <= vOuterRadius2, rr, zero);
+
+                // the same rounding as qRound() does
+                const int_v weight = xsimd::batch_cast<int>(xsimd::floor((one - rr) * unit + half));
+                sumOfWeights += weight;
+
+                weight.store_aligned(buffer);
+                for (size_t i = 0; i < int_v::size; i++) {
+                    dst[col + static_cast<int>(i)] = static_cast<qint16>(buffer[i]);
+                }
+
+                xp += increment;
+            }
+
+            tailSumOfWeights +=
+                base_class::calculateSampleWeightsScalar(rect.x() + col, rect.x() + width, yp,
+                                                         x, y, oneOverRadius2, outerRadius2,
+                                                         dst + col);
+        }
+
+        return xsimd::reduce_add(sumOfWeights) + tailSumOfWeights;
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KIS_MYPAINT_SURFACE_KERNELS_IMPL_H
@@ -0,0 +1,152 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "MyPaintSurfaceBenchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColorSpaceRegistry.h>
+#include <KoMultiArchBuildSupport.h>
+#include <kis_global.h>
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+
+#include "MyPaintSurface.h"
+#include "MyPaintSurfaceKernels.h"
+
+namespace {
+
+void drawStroke(KisMyPaintSurface *surface, float radius, bool batched)
+{
+    const int numDabs = 1000;
+
+    /**
+     * libmypaint generates a few dabs per radius, so emulate
+     * that by painting ten dabs per paintAt() call
+     */
+    for (int i = 0; i < numDabs; i += 10) {
+        if (batched) {
+            mypaint_surface_begin_atomic(surface->surface());
+        }
+
+        for (int j = i; j < i + 10; j++) {
+            surface->draw_dab(surface->surface(),
+                              100 + 0.2 * radius * j, 100 + 0.1 * radius * j, radius,
+                              0.2f, 0.4f, 0.8f, 0.5f, 0.7f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        if (batched) {
+            mypaint_surface_end_atomic(surface->surface(), nullptr);
+        }
+    }
+}
+
+}
+
+void MyPaintSurfaceBenchmark::benchmarkDrawDabs_data()
+{
+    QTest::addColumn<float>("radius");
+    QTest::addColumn<bool>("batched");
+
+    for (float radius : {5.0f, 25.0f, 100.0f}) {
+        QTest::addRow("%d px, per-dab write-back", int(radius)) << radius << false;
+        QTest::addRow("%d px, batched", int(radius)) << radius << true;
+    }
+}
+
+void MyPaintSurfaceBenchmark::benchmarkDrawDabs()
+{
+    QFETCH(float, radius);
+    QFETCH(bool, batched);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QBENCHMARK {
+        KisPaintDeviceSP dev = new KisPaintDevice(cs);
+        KisPainter painter(dev);
+        KisMyPaintSurface surface(&painter);
+
+        drawStroke(&surface, radius, batched);
+    }
+}
+
+void MyPaintSurfaceBenchmark::benchmarkGetColor_data()
+{
+    QTest::addColumn<float>("radius");
+
+    QTest::addRow("5 px") << 5.0f;
+    QTest::addRow("25 px") << 25.0f;
+    QTest::addRow("100 px") << 100.0f;
+}
+
+void MyPaintSurfaceBenchmark::benchmarkGetColor()
+{
+    QFETCH(float, radius);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(QRect(0, 0, 1000, 1000), KoColor(Qt::red, cs));
+
+    KisPainter painter(dev);
+    KisMyPaintSurface surface(&painter);
+
+    float r, g, b, a;
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; i++) {
+            surface.get_color(surface.surface(), 500 + i, 500, radius, &r, &g, &b, &a);
+        }
+    }
+}
+
+void MyPaintSurfaceBenchmark::benchmarkDabAlphaKernel_data()
+{
+    QTest::addColumn<float>("radius");
+    QTest::addColumn<bool>("optimized");
+
+    for (float radius : {5.0f, 25.0f, 100.0f}) {
+        QTest::addRow("%d px, scalar", int(radius)) << radius << false;
+        QTest::addRow("%d px, optimized", int(radius)) << radius << true;
+    }
+}
+
+void MyPaintSurfaceBenchmark::benchmarkDabAlphaKernel()
+{
+    QFETCH(float, radius);
+    QFETCH(bool, optimized);
+
+    QScopedPointer<KisMyPaintSurfaceKernelsBase> kernels(
+        optimized ?
+            KisMyPaintSurfaceKernelsFactory::create() :
+            createScalarClass<KisMyPaintSurfaceKernelsFactoryImpl>());
+
+    const float hardness = 0.7f;
+
+    KisMyPaintDabShape shape;
+    shape.x = 500.3f;
+    shape.y = 500.6f;
+    shape.oneOverRadius2 = 1.0f / (radius * radius);
+    shape.hardness = hardness;
+    shape.segment1Slope = -(1.0f / hardness - 1.0f);
+    shape.segment2Slope = -hardness / (1.0f - hardness);
+    shape.outerRadius2 = pow2(radius + 1.0f);
+
+    const QRect rect(QPoint(shape.x - radius - 1, shape.y - radius - 1),
+                     QSize(2 * (radius + 1), 2 * (radius + 1)));
+
+    QVector<float> alpha(rect.width() * rect.height());
+    QVector<qint16> weights(rect.width() * rect.height());
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; i++) {
+            kernels->calculateDabAlpha(rect, shape, alpha.data());
+            kernels->calculateSampleWeights(rect, shape.x, shape.y, radius, weights.data());
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(MyPaintSurfaceBenchmark)
@@ -0,0 +1,26 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef MYPAINT_SURFACE_BENCHMARK_H
+#define MYPAINT_SURFACE_BENCHMARK_H
+
+#include <QObject>
+
+class MyPaintSurfaceBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkDrawDabs_data();
+    void benchmarkDrawDabs();
+
+    void benchmarkGetColor_data();
+    void benchmarkGetColor();
+
+    void benchmarkDabAlphaKernel_data();
+    void benchmarkDabAlphaKernel();
+};
+
+#endif // MYPAINT_SURFACE_BENCHMARK_H
@@ -21,9 +21,12 @@
 #include "kis_mypaintop_test.h"
 #include "MyPaintPaintOp.h"
 #include "MyPaintSurface.h"
+#include "MyPaintSurfaceKernels.h"
 #include "MyPaintPaintOpSettings.h"
 
 #include <qimage_test_util.h>
+#include <KoMultiArchBuildSupport.h>
+#include <kis_global.h>
 
 class KisMyPaintOpSettings;
 KisMyPaintOpTest::KisMyPaintOpTest(): TestUtil::QImageBasedTest("MyPaintOp")
@@ -86,4 +89,117 @@ void KisMyPaintOpTest::testLoading() {
     QVERIFY(brush->valid());
 }
 
+namespace {
+
+void drawDabLine(KisMyPaintSurface *surface, int numDabs, float radius)
+{
+    for (int i = 0; i < numDabs; i++) {
+        surface->draw_dab(surface->surface(), 100 + 7.3 * i, 120 + 3.1 * i, radius,
+                          0.2f, 0.4f, 0.8f, 0.5f, 0.7f, 1.0f, 1.5f, 30.0f, 0.0f, 0.0f);
+    }
+}
+
+}
+
+void KisMyPaintOpTest::testBatchedDabs()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP dev1 = new KisPaintDevice(cs);
+    KisPaintDeviceSP dev2 = new KisPaintDevice(cs);
+
+    KisPainter painter1(dev1);
+    KisPainter painter2(dev2);
+
+    {
+        QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter1));
+        drawDabLine(surface.data(), 30, 25.0f);
+        drawDabLine(surface.data(), 30, 2.5f);
+    }
+
+    {
+        QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter2));
+
+        mypaint_surface_begin_atomic(surface->surface());
+        drawDabLine(surface.data(), 30, 25.0f);
+        drawDabLine(surface.data(), 30, 2.5f);
+
+        // the device is updated only when the batch ends
+        QVERIFY(dev2->exactBounds().isEmpty());
+
+        MyPaintRectangle roi;
+        mypaint_surface_end_atomic(surface->surface(), &roi);
+
+        QVERIFY(QRect(roi.x, roi.y, roi.width, roi.height).contains(dev2->exactBounds()));
+    }
+
+    QVERIFY(!dev1->exactBounds().isEmpty());
+    QCOMPARE(dev2->exactBounds(), dev1->exactBounds());
+
+    QPoint errpoint;
+    const QRect rc = dev1->exactBounds();
+    if (!TestUtil::compareQImages(errpoint,
+                                  dev1->convertToQImage(0, rc),
+                                  dev2->convertToQImage(0, rc))) {
+        QFAIL(QString("Batched dabs differ from unbatched ones, first different pixel: %1,%2 \n").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisMyPaintOpTest::testSurfaceKernels()
+{
+    QScopedPointer<KisMyPaintSurfaceKernelsBase> scalar(
+        createScalarClass<KisMyPaintSurfaceKernelsFactoryImpl>());
+    QScopedPointer<KisMyPaintSurfaceKernelsBase> optimized(
+        KisMyPaintSurfaceKernelsFactory::create());
+
+    const float x = 50.3f;
+    const float y = 40.7f;
+    const float radius = 17.2f;
+    const float hardness = 0.6f;
+    const float angle = 0.5f;
+
+    // odd width to test the tail processing as well
+    const QRect rect(31, 21, 39, 40);
+    const int numPixels = rect.width() * rect.height();
+
+    KisMyPaintDabShape shape;
+    shape.x = x;
+    shape.y = y;
+    shape.aspectRatio = 1.7f;
+    shape.sn = std::sin(angle);
+    shape.cs = std::cos(angle);
+    shape.oneOverRadius2 = 1.0f / (radius * radius);
+    shape.hardness = hardness;
+    shape.segment1Slope = -(1.0f / hardness - 1.0f);
+    shape.segment2Slope = -hardness / (1.0f - hardness);
+    shape.outerRadius2 = pow2(radius + 1.0f);
+
+    QVector<float> scalarAlpha(numPixels);
+    QVector<float> optimizedAlpha(numPixels);
+
+    scalar->calculateDabAlpha(rect, shape, scalarAlpha.data());
+    optimized->calculateDabAlpha(rect, shape, optimizedAlpha.data());
+
+    for (int i = 0; i < numPixels; i++) {
+        QVERIFY2(qAbs(scalarAlpha[i] - optimizedAlpha[i]) < 1e-5f,
+                 qPrintable(QString("pixel %1: %2 vs %3").arg(i).arg(scalarAlpha[i]).arg(optimizedAlpha[i])));
+    }
+
+    QVector<qint16> scalarWeights(numPixels);
+    QVector<qint16> optimizedWeights(numPixels);
+
+    const int scalarSum = scalar->calculateSampleWeights(rect, x, y, radius, scalarWeights.data());
+    const int optimizedSum = optimized->calculateSampleWeights(rect, x, y, radius, optimizedWeights.data());
+
+    int realSum = 0;
+    for (int i = 0; i < numPixels; i++) {
+        // the weights may differ in rounding only
+        QVERIFY(qAbs(scalarWeights[i] - optimizedWeights[i]) <= 1);
+        realSum += optimizedWeights[i];
+    }
+
+    QCOMPARE(optimizedSum, realSum);
+    QVERIFY(qAbs(scalarSum - optimizedSum) <= numPixels / 100);
+}
+
 SIMPLE_TEST_MAIN(KisMyPaintOpTest)
@@ -24,6 +24,8 @@ private Q_SLOTS:
     void testDab();
     void testGetColor();
     void testLoading();
+    void testBatchedDabs();
+    void testSurfaceKernels();
 };
 
 #endif // KIS_MYPAINTOP_TEST_H
@@ -125,6 +125,75 @@ KisSpacingInformation KisSprayPaintOp::updateSpacingImpl(const KisPaintInformati
     return computeSpacing(info, KisLodTransform::lodToScale(painter()->device()));
 }
 
+void KisSprayPaintOp::paintAtBatch(const QVector<KisPaintInformation> &infos)
+{
+    const int numDabs = infos.size();
+
+    /**
+     * The options that use random sources are still calculated dab-by-dab
+     * to keep the sequence of the random values the same as in paintAt().
+     * The spray brush itself is always painted dab-by-dab.
+     */
+    const bool batchedRotation = !m_rotationOption.isRandom();
+    const bool batchedOpacity = !m_opacityOption.isRandom();
+    const bool batchedSize = !m_sizeOption.isRandom();
+
+    const quint8 origOpacity = painter()->opacity();
+
+    std::vector<qreal> rotations(numDabs);
+    std::vector<quint8> opacities(numDabs);
+    std::vector<qreal> scales(numDabs);
+
+    if (batchedRotation) m_rotationOption.apply(infos, rotations.data());
+    if (batchedOpacity) m_opacityOption.apply(origOpacity, infos, opacities.data());
+    if (batchedSize) m_sizeOption.apply(infos, scales.data());
+
+    const qreal lodScale = KisLodTransform::lodToScale(painter()->device());
+
+    for (int i = 0; i < numDabs; i++) {
+        const KisPaintInformation &info = infos[i];
+
+        if (!m_dab) {
+            m_dab = source()->createCompositionSourceDevice();
+        }
+        else {
+            m_dab->clear();
+        }
+
+        const qreal rotation = batchedRotation ? rotations[i] : m_rotationOption.apply(info);
+
+        if (!batchedOpacity) {
+            m_opacityOption.apply(painter(), info);
+        } else if (m_opacityOption.isChecked()) {
+            painter()->setOpacityUpdateAverage(opacities[i]);
+        }
+
+        const qreal scale = batchedSize ? scales[i] : m_sizeOption.apply(info);
+
+        m_sprayBrush.paint(m_dab,
+                           m_node->paintDevice(),
+                           info,
+                           rotation,
+                           scale, lodScale,
+                           painter()->paintColor(),
+                           painter()->backgroundColor());
+
+        QRect rc = m_dab->extent();
+        painter()->bitBlt(rc.topLeft(), m_dab, rc);
+        painter()->renderMirrorMask(rc, m_dab);
+        painter()->setOpacity(origOpacity);
+    }
+}
+
+bool KisSprayPaintOp::supportsBatchedPainting() const
+{
+    /**
+     * The spacing of the spray brush doesn't depend on the dab, so only
+     * the timing can change from dab to dab
+     */
+    return m_isPresetValid && KisPaintOpPluginUtils::isStaticOption(m_rateOption);
+}
+
 KisTimingInformation KisSprayPaintOp::updateTimingImpl(const KisPaintInformation &info) const
 {
     return KisPaintOpPluginUtils::effectiveTiming(&m_airbrushData, &m_rateOption, info);
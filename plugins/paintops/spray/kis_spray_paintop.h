@@ -38,6 +38,9 @@ protected:
 
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
+    void paintAtBatch(const QVector<KisPaintInformation> &infos) override;
+    bool supportsBatchedPainting() const override;
+
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
 
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
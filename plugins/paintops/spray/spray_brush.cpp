@@ -18,6 +18,7 @@
 #include <QHash>
 #include <QTransform>
 #include <QImage>
+#include <QMutexLocker>
 
 #include <kis_random_accessor_ng.h>
 #include <kis_random_sub_accessor.h>
@@ -28,6 +29,8 @@
 #include <brushengine/kis_paint_information.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_cross_device_color_sampler.h>
+#include <kis_image_config.h>
+#include <krita_utils.h>
 
 #include "kis_spray_paintop_settings.h"
 
@@ -36,16 +39,84 @@
 
 #include <QtGlobal>
 
+namespace {
+
+/**
+ * The particles are binned by the tiles of the dab device, so
+ * the worker threads never write into the same tile simultaneously
+ */
+const int tileSize = 64;
+
+inline int tileIndex(int coordinate)
+{
+    return coordinate >= 0 ? coordinate / tileSize : (coordinate - tileSize + 1) / tileSize;
+}
+
+void setHsvParameters(KoColorTransformation *transfo, qreal hue, qreal saturation, qreal value)
+{
+    QHash<QString, QVariant> params;
+    params["h"] = hue;
+    params["s"] = saturation;
+    params["v"] = value;
+    transfo->setParameters(params);
+    transfo->setParameter(3, 1);//sets the type to HSV. For some reason 0 is not an option.
+    transfo->setParameter(4, false);//sets the colorize to false.
+}
+
+}
+
+struct SprayBrush::Particle
+{
+    enum Type {
+        Path,
+        WuParticle,
+        Pixel,
+        ImageStamp,
+        BrushStamp
+    };
+
+    Type type {Path};
+    QPointF pos;
+    qreal rotation {0.0};
+    qreal scale {1.0};
+    KoColor color;
+    quint8 opacity {OPACITY_OPAQUE_U8};
+
+    /// random HSV adjustment applied to the stamps
+    qreal hue {0.0};
+    qreal saturation {0.0};
+    qreal value {0.0};
+
+    /// the outline of the ellipse and rectangle particles
+    QPainterPath path;
+
+    /// subpixel offset of the brush-tip stamps
+    qreal xFraction {0.0};
+    qreal yFraction {0.0};
+
+    KisFixedPaintDeviceSP stamp;
+    QPoint stampPos;
+
+    /// the area of the dab touched by the particle
+    QRect bounds;
+};
+
+struct SprayBrush::StampResources
+{
+    KisBrushSP brush;
+    QScopedPointer<KoColorTransformation> transfo;
+};
+
 SprayBrush::SprayBrush()
 {
-    m_painter = nullptr;
     m_transfo = nullptr;
 }
 
 SprayBrush::~SprayBrush()
 {
-    delete m_painter;
     delete m_transfo;
+    qDeleteAll(m_painters);
+    qDeleteAll(m_stampResources);
 }
 
 void SprayBrush::setProperties(KisSprayOpOptionData * properties,
@@ -63,9 +134,22 @@ void SprayBrush::setProperties(KisSprayOpOptionData * properties,
     m_brush = brush;
     if (m_brush) {
         m_brush->notifyStrokeStarted();
+
+        if (!m_shapeProperties->enabled && canPrepareBrushStampsConcurrently()) {
+            m_brush->notifyBrushIsGoingToBeClonedForStroke();
+        }
     }
 }
 
+bool SprayBrush::canPrepareBrushStampsConcurrently() const
+{
+    /**
+     * Pipe brushes change their state with every stamp, so their
+     * stamps cannot be generated out of order
+     */
+    return m_brush && (m_brush->brushType() == MASK || m_brush->brushType() == IMAGE);
+}
+
 qreal SprayBrush::rotationAngle(KisRandomSourceSP randomSource)
 {
     qreal rotation = 0.0;
@@ -154,11 +238,10 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
     const QSize effectiveSize = m_shapeProperties->effectiveSize(m_sprayOpOptionData->diameter, m_sprayOpOptionData->scale);
 
-    // initializing painter
-    if (!m_painter) {
-        m_painter = new KisPainter(dab);
-        m_painter->setFillStyle(KisPainter::FillStyleForegroundColor);
-        m_painter->setMaskImageSize(effectiveSize.width(), effectiveSize.height());
+    // initializing resources
+    if (!m_dab) {
+        m_dab = dab;
+        m_effectiveSize = effectiveSize;
         m_dabPixelSize = dab->colorSpace()->pixelSize();
         if (m_colorProperties->useRandomHSV) {
             m_transfo = dab->colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>());
@@ -168,13 +251,13 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
         if (!m_brushQImage.isNull()) {
             m_brushQImage = m_brushQImage.scaled(effectiveSize);
         }
-        m_imageDevice = new KisPaintDevice(dab->colorSpace());
     }
 
+    // the painters of the worker threads are bound to the dab device
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_dab == dab);
 
     qreal x = info.pos().x();
     qreal y = info.pos().y();
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
 
     Q_ASSERT(color.colorSpace()->pixelSize() == dab->pixelSize());
     m_inkColor = color;
@@ -199,7 +282,6 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
         m_particlesCount = m_sprayOpOption->data.particleCount;
     }
 
-    QHash<QString, QVariant> params;
     qreal nx, ny;
     int ix, iy;
 
@@ -208,12 +290,32 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
     qreal rotationZ = 0.0;
     qreal particleScale = 1.0;
 
+    qreal hue = 0.0;
+    qreal saturation = 0.0;
+    qreal value = 0.0;
+
+    /**
+     * All the random values are generated sequentially in the same order
+     * as the particles are painted, so the result of the stroke depends
+     * on the seed of the random source only. The particles are painted
+     * later by renderParticles().
+     */
+    QVector<Particle> particles;
+    particles.reserve(m_particlesCount + 1);
+
     bool shouldColor = true;
     if (m_colorProperties->fillBackground) {
-        m_painter->setPaintColor(bgColor);
-        paintCircle(m_painter, x, y, m_radius);
+        Particle particle;
+        particle.path = circlePath(x, y, m_radius);
+        particle.bounds = particle.path.boundingRect().toAlignedRect().adjusted(-1, -1, 1, 1);
+        particle.color = bgColor;
+        particle.opacity = m_opacity;
+        particles.append(particle);
     }
 
+    const bool canPrepareStampsConcurrently =
+        m_shapeProperties->enabled || canPrepareBrushStampsConcurrently();
+
     QTransform m;
     m.reset();
     m.rotateRadians(-rotation + deg2rad(m_sprayOpOption->data.brushRotation));
@@ -280,143 +382,341 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             }
 
             if (m_colorProperties->useRandomHSV && m_transfo) {
-                params["h"] = (m_colorProperties->hue / 180.0) * randomSource->generateNormalized();
-                params["s"] = (m_colorProperties->saturation / 100.0) * randomSource->generateNormalized();
-                params["v"] = (m_colorProperties->value / 100.0) * randomSource->generateNormalized();
-                m_transfo->setParameters(params);
-                m_transfo->setParameter(3, 1);//sets the type to HSV. For some reason 0 is not an option.
-                m_transfo->setParameter(4, false);//sets the colorize to false.
+                hue = (m_colorProperties->hue / 180.0) * randomSource->generateNormalized();
+                saturation = (m_colorProperties->saturation / 100.0) * randomSource->generateNormalized();
+                value = (m_colorProperties->value / 100.0) * randomSource->generateNormalized();
+                setHsvParameters(m_transfo, hue, saturation, value);
                 m_transfo->transform(m_inkColor.data(), m_inkColor.data() , 1);
             }
 
             if (m_colorProperties->useRandomOpacity) {
                 quint8 alpha = qRound(randomSource->generateNormalized() * OPACITY_OPAQUE_U8);
                 m_inkColor.setOpacity(alpha);
-                m_painter->setOpacity(alpha);
+                m_opacity = alpha;
             }
 
             if (!m_colorProperties->colorPerParticle) {
                 shouldColor = false;
             }
-
-            m_painter->setPaintColor(m_inkColor);
         }
 
         qreal jitteredWidth = qMax(1.0 * additionalScale, effectiveSize.width() * particleScale * additionalScale);
         qreal jitteredHeight = qMax(1.0 * additionalScale, effectiveSize.height() * particleScale * additionalScale);
 
+        Particle particle;
+        particle.pos = QPointF(nx + x, ny + y);
+        particle.rotation = rotationZ;
+        particle.color = m_inkColor;
+        particle.opacity = m_opacity;
+        particle.hue = hue;
+        particle.saturation = saturation;
+        particle.value = value;
+
+        bool hasParticle = true;
+
         if (m_shapeProperties->enabled){
         switch (m_shapeProperties->shape){
             // ellipse
             case 0:
             {
                 if (effectiveSize.width() == effectiveSize.height()){
-                    paintCircle(m_painter, nx + x, ny + y, jitteredWidth * 0.5);
+                    particle.path = circlePath(nx + x, ny + y, jitteredWidth * 0.5);
                 }
                 else {
-                    paintEllipse(m_painter, nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
+                    particle.path = ellipsePath(nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
                 }
+                particle.bounds = particle.path.boundingRect().toAlignedRect().adjusted(-1, -1, 1, 1);
                 break;
             }
             // rectangle
             case 1:
             {
-                paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                particle.path = rectanglePath(nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                particle.bounds = particle.path.boundingRect().toAlignedRect().adjusted(-1, -1, 1, 1);
                 break;
             }
             // wu-particle
             case 2: {
-                paintParticle(accessor, m_inkColor, nx + x, ny + y);
+                particle.type = Particle::WuParticle;
+                particle.bounds = QRect(int(nx + x), int(ny + y), 2, 2);
                 break;
             }
             // pixel
             case 3: {
                 ix = qRound(nx + x);
                 iy = qRound(ny + y);
-                accessor->moveTo(ix, iy);
-                memcpy(accessor->rawData(), m_inkColor.data(), m_dabPixelSize);
+                particle.type = Particle::Pixel;
+                particle.bounds = QRect(ix, iy, 1, 1);
                 break;
             }
             case 4: {
                 if (!m_brushQImage.isNull()) {
-
-                    QTransform m;
-                    m.rotate(rad2deg(rotationZ));
-                    m.scale(additionalScale, additionalScale);
+                    particle.type = Particle::ImageStamp;
+                    particle.scale = additionalScale;
 
                     if (m_shapeDynamicsProperties->randomSize) {
-                        m.scale(particleScale, particleScale);
+                        particle.scale *= particleScale;
                     }
-                    m_transformed = m_brushQImage.transformed(m, Qt::SmoothTransformation);
-                    m_imageDevice->convertFromQImage(m_transformed, 0);
-                    KisRandomAccessorSP ac = m_imageDevice->createRandomAccessorNG();
-                    QRect rc = m_transformed.rect();
-
-                    if (m_colorProperties->useRandomHSV && m_transfo) {
-
-                        for (int y = rc.y(); y < rc.y() + rc.height(); y++) {
-                            for (int x = rc.x(); x < rc.x() + rc.width(); x++) {
-                                ac->moveTo(x, y);
-                                m_transfo->transform(ac->rawData(), ac->rawData() , 1);
-                            }
-                        }
-                    }
-
-                    ix = qRound(nx + x - rc.width() * 0.5);
-                    iy = qRound(ny + y - rc.height() * 0.5);
-                    m_painter->bitBlt(QPoint(ix, iy), m_imageDevice, rc);
-                    m_imageDevice->clear();
                     break;
                 }
+                hasParticle = false;
+                break;
             }
+            default:
+                hasParticle = false;
             }
             // Auto-brush
         }
         else {
             KisDabShape shape(particleScale * additionalScale, 1.0, -rotationZ);
             QPointF hotSpot = m_brush->hotSpot(shape, info);
-            QPointF pos(nx + x, ny + y);
-            QPointF pt = pos - hotSpot;
+            QPointF pt = particle.pos - hotSpot;
 
-            qint32 ix;
-            qreal xFraction;
-            qint32 iy;
-            qreal yFraction;
+            KisPaintOp::splitCoordinate(pt.x(), &ix, &particle.xFraction);
+            KisPaintOp::splitCoordinate(pt.y(), &iy, &particle.yFraction);
 
-            KisPaintOp::splitCoordinate(pt.x(), &ix, &xFraction);
-            KisPaintOp::splitCoordinate(pt.y(), &iy, &yFraction);
-
-            m_brush->prepareForSeqNo(info, m_dabSeqNo);
-
-            //KisFixedPaintDeviceSP dab;
-            if (m_brush->brushApplication() == IMAGESTAMP) {
-                m_fixedDab = m_brush->paintDevice(m_fixedDab->colorSpace(),
-                          shape, info, xFraction, yFraction);
-
-                if (m_colorProperties->useRandomHSV && m_transfo) {
-                    quint8 * dabPointer = m_fixedDab->data();
-                    int pixelCount = m_fixedDab->bounds().width() * m_fixedDab->bounds().height();
-                    m_transfo->transform(dabPointer, dabPointer, pixelCount);
-                }
+            particle.type = Particle::BrushStamp;
+            particle.scale = particleScale * additionalScale;
+            particle.stampPos = QPoint(ix, iy);
 
+            if (!canPrepareStampsConcurrently) {
+                prepareStamp(particle, info, nullptr);
             }
-            else {
-                m_brush->mask(m_fixedDab, m_inkColor, shape,
-                              info, xFraction, yFraction);
-            }
-            m_painter->bltFixed(QPoint(ix, iy), m_fixedDab, m_fixedDab->bounds());
         }
+
+        if (hasParticle) {
+            particles.append(particle);
+        }
+
         if (m_colorProperties->colorPerParticle){
             m_inkColor=color;//reset color//
         }
     }
     // recover from jittering of color,
     // m_inkColor.opacity is recovered with every paint
+
+    renderParticles(particles, info);
+}
+
+void SprayBrush::prepareStamp(Particle &particle, const KisPaintInformation &info, StampResources *resources)
+{
+    KoColorTransformation *transfo = resources ? resources->transfo.data() : m_transfo;
+    bool needsHsvAdjustment = transfo != nullptr;
+
+    if (particle.type == Particle::ImageStamp) {
+        QTransform m;
+        m.rotate(rad2deg(particle.rotation));
+        m.scale(particle.scale, particle.scale);
+
+        const QImage transformed = m_brushQImage.transformed(m, Qt::SmoothTransformation);
+
+        particle.stamp = new KisFixedPaintDevice(m_dab->colorSpace());
+        particle.stamp->convertFromQImage(transformed, QString());
+
+        particle.stampPos = QPoint(qRound(particle.pos.x() - transformed.width() * 0.5),
+                                   qRound(particle.pos.y() - transformed.height() * 0.5));
+    } else {
+        KisBrushSP brush = resources ? resources->brush : m_brush;
+        KisDabShape shape(particle.scale, 1.0, -particle.rotation);
+
+        brush->prepareForSeqNo(info, m_dabSeqNo);
+
+        if (brush->brushApplication() == IMAGESTAMP) {
+            particle.stamp = brush->paintDevice(m_fixedDab->colorSpace(),
+                                                shape, info, particle.xFraction, particle.yFraction);
+        } else {
+            particle.stamp = new KisFixedPaintDevice(m_fixedDab->colorSpace());
+            brush->mask(particle.stamp, particle.color, shape,
+                        info, particle.xFraction, particle.yFraction);
+
+            // the mask is already filled with the adjusted color
+            needsHsvAdjustment = false;
+        }
+    }
+
+    if (needsHsvAdjustment) {
+        setHsvParameters(transfo, particle.hue, particle.saturation, particle.value);
+
+        const QRect rc = particle.stamp->bounds();
+        transfo->transform(particle.stamp->data(), particle.stamp->data(), rc.width() * rc.height());
+    }
+
+    particle.bounds = QRect(particle.stampPos, particle.stamp->bounds().size());
 }
 
+void SprayBrush::renderParticles(QVector<Particle> &particles, const KisPaintInformation &info)
+{
+    const bool useThreads = KisImageConfig(true).maxNumberOfThreads() > 1;
+    Particle *particlesData = particles.data();
+
+    /**
+     * 1) Generate the stamps of the image and brush-tip particles. The
+     *    stamps of pipe brushes have already been generated in order.
+     */
+    QVector<int> stampParticles;
+    for (int i = 0; i < particles.size(); i++) {
+        const Particle &particle = particles[i];
 
+        if ((particle.type == Particle::ImageStamp || particle.type == Particle::BrushStamp) &&
+            !particle.stamp) {
 
-void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry)
+            stampParticles.append(i);
+        }
+    }
+
+    if (useThreads && stampParticles.size() > 1) {
+        auto prepareStampJob = [this, particlesData, &info] (int index) {
+            StampResources *resources = fetchStampResources();
+            prepareStamp(particlesData[index], info, resources);
+            putStampResources(resources);
+        };
+
+        KritaUtils::parallelMap(stampParticles, prepareStampJob);
+    } else {
+        Q_FOREACH (int index, stampParticles) {
+            prepareStamp(particlesData[index], info, nullptr);
+        }
+    }
+
+    /**
+     * 2) Bin the particles by the tiles of the dab. Every bin keeps the
+     *    particles in the order of their generation, so every pixel of the
+     *    dab gets exactly the same sequence of compositions as if all the
+     *    particles were painted sequentially.
+     */
+    struct Bin {
+        QRect rect;
+        QVector<int> particles;
+    };
+
+    QVector<Bin> bins;
+    QHash<QPair<int, int>, int> binIndexes;
+
+    for (int i = 0; i < particles.size(); i++) {
+        const QRect bounds = particles[i].bounds;
+        if (bounds.isEmpty()) continue;
+
+        for (int row = tileIndex(bounds.top()); row <= tileIndex(bounds.bottom()); row++) {
+            for (int col = tileIndex(bounds.left()); col <= tileIndex(bounds.right()); col++) {
+                auto it = binIndexes.find(qMakePair(row, col));
+
+                if (it == binIndexes.end()) {
+                    it = binIndexes.insert(qMakePair(row, col), bins.size());
+                    bins.append(Bin{QRect(col * tileSize, row * tileSize, tileSize, tileSize), {}});
+                }
+
+                bins[*it].particles.append(i);
+            }
+        }
+    }
+
+    /**
+     * 3) Paint the bins. The bins never share any tiles of the
+     *    dab, so they can be painted concurrently.
+     */
+    auto paintBin = [this, &particles] (const Bin &bin) {
+        KisPainter *painter = fetchPainter();
+        paintParticles(painter, particles, bin.particles, bin.rect);
+        putPainter(painter);
+    };
+
+    if (useThreads && bins.size() > 1) {
+        KritaUtils::parallelMap(bins, paintBin);
+    } else {
+        Q_FOREACH (const Bin &bin, bins) {
+            paintBin(bin);
+        }
+    }
+}
+
+void SprayBrush::paintParticles(KisPainter *painter,
+                                const QVector<Particle> &particles,
+                                const QVector<int> &indexes,
+                                const QRect &clipRect)
+{
+    KisRandomAccessorSP accessor = m_dab->createRandomAccessorNG();
+
+    Q_FOREACH (int index, indexes) {
+        const Particle &particle = particles[index];
+
+        switch (particle.type) {
+        case Particle::Path:
+            painter->setPaintColor(particle.color);
+            painter->setOpacity(particle.opacity);
+            painter->fillPainterPath(particle.path, particle.bounds & clipRect);
+            break;
+        case Particle::WuParticle:
+            paintParticle(accessor, particle.color, particle.pos.x(), particle.pos.y(), clipRect);
+            break;
+        case Particle::Pixel:
+            accessor->moveTo(particle.bounds.x(), particle.bounds.y());
+            memcpy(accessor->rawData(), particle.color.data(), m_dabPixelSize);
+            break;
+        case Particle::ImageStamp:
+        case Particle::BrushStamp: {
+            const QRect rc = particle.bounds & clipRect;
+            const QPoint srcOffset = particle.stamp->bounds().topLeft() - particle.stampPos;
+
+            painter->setOpacity(particle.opacity);
+            painter->bltFixed(rc.x(), rc.y(), particle.stamp,
+                              rc.x() + srcOffset.x(), rc.y() + srcOffset.y(),
+                              rc.width(), rc.height());
+            break;
+        }
+        }
+    }
+}
+
+KisPainter* SprayBrush::fetchPainter()
+{
+    {
+        QMutexLocker l(&m_resourcesMutex);
+        if (!m_painters.isEmpty()) {
+            return m_painters.takeLast();
+        }
+    }
+
+    KisPainter *painter = new KisPainter(m_dab);
+    painter->setFillStyle(KisPainter::FillStyleForegroundColor);
+    painter->setMaskImageSize(m_effectiveSize.width(), m_effectiveSize.height());
+    return painter;
+}
+
+void SprayBrush::putPainter(KisPainter *painter)
+{
+    QMutexLocker l(&m_resourcesMutex);
+    m_painters.append(painter);
+}
+
+SprayBrush::StampResources* SprayBrush::fetchStampResources()
+{
+    {
+        QMutexLocker l(&m_resourcesMutex);
+        if (!m_stampResources.isEmpty()) {
+            return m_stampResources.takeLast();
+        }
+    }
+
+    StampResources *resources = new StampResources();
+
+    if (!m_shapeProperties->enabled) {
+        resources->brush = m_brush->clone().dynamicCast<KisBrush>();
+    }
+
+    if (m_colorProperties->useRandomHSV) {
+        resources->transfo.reset(m_dab->colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>()));
+    }
+
+    return resources;
+}
+
+void SprayBrush::putStampResources(StampResources *resources)
+{
+    QMutexLocker l(&m_resourcesMutex);
+    m_stampResources.append(resources);
+}
+
+void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry, const QRect &clipRect)
 {
     // opacity top left, right, bottom left, right
     KoColor pcolor(color);
@@ -436,51 +736,46 @@ void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor
     // to each other, the pixel with lower opacity can override other pixel.
     // Maybe some kind of compositing using here would be cool
 
-    pcolor.setOpacity(btl);
-    writeAccessor->moveTo(ipx  , ipy);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
-
-    pcolor.setOpacity(btr);
-    writeAccessor->moveTo(ipx + 1, ipy);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    auto writePixel = [&] (int x, int y, qreal opacity) {
+        if (!clipRect.contains(x, y)) return;
 
-    pcolor.setOpacity(bbl);
-    writeAccessor->moveTo(ipx, ipy + 1);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+        pcolor.setOpacity(opacity);
+        writeAccessor->moveTo(x, y);
+        memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    };
 
-    pcolor.setOpacity(bbr);
-    writeAccessor->moveTo(ipx + 1, ipy + 1);
-    memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
+    writePixel(ipx, ipy, btl);
+    writePixel(ipx + 1, ipy, btr);
+    writePixel(ipx, ipy + 1, bbl);
+    writePixel(ipx + 1, ipy + 1, bbr);
 }
 
-void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius)
+QPainterPath SprayBrush::circlePath(qreal x, qreal y, qreal radius) const
 {
     QPainterPath path;
     path.addEllipse(QPointF(x,y),radius,radius);
-    painter->fillPainterPath(path);
+    return path;
 }
 
 
-void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qreal b, qreal angle)
+QPainterPath SprayBrush::ellipsePath(qreal x, qreal y, qreal a, qreal b, qreal angle) const
 {
     QPainterPath path;
     path.addEllipse(QPointF(), a, b);
     QTransform t;
     t.translate(x, y);
     t.rotateRadians(angle);
-    path = t.map(path);
-    painter->fillPainterPath(path);
+    return t.map(path);
 }
 
-void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal width, qreal height, qreal angle)
+QPainterPath SprayBrush::rectanglePath(qreal x, qreal y, qreal width, qreal height, qreal angle) const
 {
     QPainterPath path;
     path.addRect(QRectF(-0.5 * width, -0.5 * height, width, height));
     QTransform t;
     t.translate(x, y);
     t.rotateRadians(angle);
-    path = t.map(path);
-    painter->fillPainterPath(path);
+    return t.map(path);
 }
 
 
@@ -24,6 +24,9 @@
 
 
 #include <QImage>
+#include <QMutex>
+#include <QPainterPath>
+#include <QVector>
 #include <kis_brush.h>
 
 class KisPaintInformation;
@@ -51,20 +54,32 @@ public:
 
     void setFixedDab(KisFixedPaintDeviceSP dab);
 
+private:
+    struct Particle;
+    struct StampResources;
+
 private:
     int m_dabSeqNo {0};
     KoColor m_inkColor;
     qreal m_radius {1.0};
     quint32 m_particlesCount {1};
     quint8 m_dabPixelSize {1};
+    quint8 m_opacity {OPACITY_OPAQUE_U8};
+    QSize m_effectiveSize;
 
-    KisPainter * m_painter {nullptr};
-    KisPaintDeviceSP m_imageDevice;
+    KisPaintDeviceSP m_dab;
     QImage m_brushQImage;
-    QImage m_transformed;
 
     KoColorTransformation* m_transfo {nullptr};
 
+    /**
+     * The painters and stamp generation resources used by the worker
+     * threads. The resources are reused for all the dabs of the stroke.
+     */
+    QMutex m_resourcesMutex;
+    QList<KisPainter*> m_painters;
+    QList<StampResources*> m_stampResources;
+
     const KisSprayOpOptionData * m_sprayOpOptionData {nullptr};
     KisSprayOpOption * m_sprayOpOption {nullptr};
     const KisColorOptionData * m_colorProperties {nullptr};
@@ -98,11 +113,28 @@ private:
                    const RadialDistribution &radialDistribution);
     /// rotation in radians according the settings (gauss distribution, uniform distribution or fixed angle)
     qreal rotationAngle(KisRandomSourceSP randomSource);
+
+    bool canPrepareBrushStampsConcurrently() const;
+    /// generates the brush-tip or image stamp of the particle
+    void prepareStamp(Particle &particle, const KisPaintInformation &info, StampResources *resources);
+    /// paints all the \p particles into the dab in parallel
+    void renderParticles(QVector<Particle> &particles, const KisPaintInformation &info);
+    /// paints \p indexes of \p particles, the painting is limited by \p clipRect
+    void paintParticles(KisPainter *painter,
+                        const QVector<Particle> &particles,
+                        const QVector<int> &indexes,
+                        const QRect &clipRect);
+
+    KisPainter* fetchPainter();
+    void putPainter(KisPainter *painter);
+    StampResources* fetchStampResources();
+    void putStampResources(StampResources *resources);
+
     /// Paints Wu Particle
-    void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry);
-    void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius);
-    void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle);
-    void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry, const QRect &clipRect);
+    QPainterPath circlePath(qreal x, qreal y, qreal radius) const;
+    QPainterPath ellipsePath(qreal x, qreal y, qreal a, qreal b, qreal angle) const;
+    QPainterPath rectanglePath(qreal x, qreal y, qreal width, qreal height, qreal angle) const;
 
     void paintOutline(KisPaintDeviceSP dev, const KoColor& painterColor, qreal posX, qreal posY, qreal radius);
 
@@ -9,6 +9,7 @@
 #include <simpletest.h>
 
 #include <QDir>
+#include <QFileInfo>
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
@@ -84,7 +85,8 @@ KoCanvasResourceProvider* utils::createResourceManager(KisImageWSP image,
     KisPaintOpPresetSP preset;
 
     if (!presetFileName.isEmpty()) {
-        QString fullFileName = TestUtil::fetchDataFileLazy(presetFileName);
+        QString fullFileName = QFileInfo(presetFileName).isAbsolute() ?
+            presetFileName : TestUtil::fetchDataFileLazy(presetFileName);
         preset = KisPaintOpPresetSP(new KisPaintOpPreset(fullFileName));
         bool presetValid = preset->load(KisGlobalResourcesInterface::instance());
         Q_ASSERT(presetValid); Q_UNUSED(presetValid);